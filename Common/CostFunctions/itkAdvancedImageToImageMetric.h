@@ -36,10 +36,14 @@
 #include "itkAdvancedCombinationTransform.h"
 
 #include "elxDefaultConstruct.h"
+#include "elxProfiler.h"
 
 #include <cassert>
+#include <functional>
+#include <vector>
 #include <memory> // For unique_ptr.
 #include <typeinfo>
+#include <utility> // For pair.
 
 namespace itk
 {
@@ -311,6 +315,36 @@ public:
   itkGetConstReferenceMacro(UseMultiThread, bool);
   itkBooleanMacro(UseMultiThread);
 
+  /** Select sparse accumulation of the per-thread derivatives. When set, metrics that support it
+   * store the derivative contributions of each thread in blocks of parameters, which are only
+   * allocated once a thread touches them, instead of in a dense vector of all parameters per thread.
+   * This bounds the per-thread memory by the parameters actually touched, which pays off for
+   * transforms with many parameters and local support, like the B-spline. Only has effect when
+   * multi-threading is used, and for metrics that support it; default: false.
+   */
+  itkSetMacro(UseSparseDerivativeAccumulation, bool);
+  itkGetConstReferenceMacro(UseSparseDerivativeAccumulation, bool);
+  itkBooleanMacro(UseSparseDerivativeAccumulation);
+
+  /** Use a cache of the B-spline transform weights at the fixed image samples, built by Initialize(). Only has effect
+   * when the sampler selects the same samples in each iteration (like the grid and full samplers), and the transform
+   * is a B-spline; default: false. */
+  itkSetMacro(UseBSplineWeightCache, bool);
+  itkGetConstMacro(UseBSplineWeightCache, bool);
+  itkBooleanMacro(UseBSplineWeightCache);
+
+  /** Set the maximum size of the B-spline weight cache, in bytes. The cache is not built when it would be larger. Note
+   * that metrics that share the transform also share its cache, which holds the samples of all these metrics. */
+  itkSetMacro(MaximumBSplineWeightCacheSize, SizeValueType);
+  itkGetConstMacro(MaximumBSplineWeightCacheSize, SizeValueType);
+
+  /** Returns the size (in bytes) that the B-spline weight cache required at the last Initialize(), or zero when the
+   * cache was not applicable. */
+  itkGetConstMacro(BSplineWeightCacheSize, SizeValueType);
+
+  /** Returns whether Initialize() has built the B-spline weight cache. */
+  itkGetConstMacro(BSplineWeightCacheIsBuilt, bool);
+
   /** Contains calls from GetValueAndDerivative that are thread-unsafe,
    * together with preparation for multi-threading.
    * Note that the only reason why this function is not protected, is
@@ -325,6 +359,34 @@ public:
     m_RandomVariateGenerator = &randomVariateGenerator;
   }
 
+  /** Set the profiler that measures the phases of the metric computation. When it is null (the default), or when it is
+   * disabled, nothing is measured. */
+  void
+  SetProfiler(elastix::Profiler * const profiler)
+  {
+    m_Profiler = profiler;
+  }
+
+  elastix::Profiler *
+  GetProfiler() const
+  {
+    return m_Profiler;
+  }
+
+  /** The extrema (minimum, maximum) of an image, and the type of a function that returns the extrema of the specified
+   * fixed or moving image, either by retrieving them from a cache, or by calling computeExtrema(). */
+  using ImageExtremaType = std::pair<double, double>;
+  using ImageExtremaFunctionType =
+    std::function<ImageExtremaType(const DataObject & image, const std::function<ImageExtremaType()> & computeExtrema)>;
+
+  /** Set the function that returns the extrema of the fixed and moving image, for the limiters and the normalization.
+   * It is not used for the extrema within a mask. When it is empty (the default), the extrema are just computed. */
+  void
+  SetImageExtremaFunction(ImageExtremaFunctionType imageExtremaFunction)
+  {
+    m_ImageExtremaFunction = std::move(imageExtremaFunction);
+  }
+
 protected:
   /** Constructor. */
   AdvancedImageToImageMetric();
@@ -376,6 +438,10 @@ protected:
   /** Member variable for TransformPenaltyTerm::CheckForBSplineTransform2 */
   mutable bool m_TransformIsBSpline{ false };
 
+  /** Variables that describe the B-spline weight cache, set by InitializeBSplineWeightCache(). */
+  SizeValueType m_BSplineWeightCacheSize{ 0 };
+  bool          m_BSplineWeightCacheIsBuilt{ false };
+
   /** Variables for the Limiters. */
   FixedImagePixelType          m_FixedImageTrueMin{ 0 };
   FixedImagePixelType          m_FixedImageTrueMax{ 1 };
@@ -431,6 +497,44 @@ protected:
   /** Variables for multi-threading. */
   bool m_UseMetricSingleThreaded{ true };
   bool m_UseMultiThread{ false };
+  bool m_UseSparseDerivativeAccumulation{ false };
+
+  /** Inheriting classes that accumulate their per-thread derivative through UpdateThreadDerivative()
+   * should set this to true, in their constructor or before InitializeThreadingParameters() is called. */
+  bool m_SupportsSparseDerivativeAccumulation{ false };
+
+  /** The per-thread derivatives are stored in blocks of 2^SparseDerivativeBlockSizeLog2 parameters
+   * when sparse derivative accumulation is used. */
+  static constexpr unsigned int SparseDerivativeBlockSizeLog2{ 8 };
+  static constexpr unsigned int SparseDerivativeBlockSize{ 1u << SparseDerivativeBlockSizeLog2 };
+
+  /** Returns whether the per-thread derivatives are accumulated sparsely. */
+  bool
+  GetUseSparseDerivativeAccumulationInternally() const
+  {
+    return m_UseSparseDerivativeAccumulation && m_SupportsSparseDerivativeAccumulation && m_UseMultiThread;
+  }
+
+  /** Adds factor * imageJacobian to the derivative, at the parameters given by nzji. This is the accumulation of
+   * the dense derivatives, both single-threaded and per thread. */
+  static void
+  AccumulateDerivativeTerms(const DerivativeValueType          factor,
+                            const DerivativeType &             imageJacobian,
+                            const NonZeroJacobianIndicesType & nzji,
+                            DerivativeType &                   derivative);
+
+  /** Adds factor * imageJacobian to the derivative of the specified thread, at the parameters given by nzji.
+   * Writes to st_Derivative, or to the touched derivative blocks when sparse accumulation is used. */
+  void
+  UpdateThreadDerivative(const ThreadIdType                 threadId,
+                         const DerivativeValueType          factor,
+                         const DerivativeType &             imageJacobian,
+                         const NonZeroJacobianIndicesType & nzji) const;
+
+  /** Returns the derivative blocks that were touched during the last iteration to the pool
+   * of each thread, so that they can be reused during the next iteration. */
+  void
+  RecycleDerivativeBlocks() const;
 
   /** Helper structs that multi-threads the computation of
    * the metric derivative using ITK threads.
@@ -460,6 +564,12 @@ protected:
     SizeValueType  st_NumberOfPixelsCounted;
     MeasureType    st_Value;
     DerivativeType st_Derivative;
+
+    // Used for sparse derivative accumulation only: the derivative blocks of this thread (null
+    // when untouched), the indices of the touched blocks, and a pool of blocks for reuse.
+    std::vector<std::unique_ptr<DerivativeValueType[]>> st_DerivativeBlocks;
+    std::vector<unsigned int>                           st_TouchedDerivativeBlocks;
+    std::vector<std::unique_ptr<DerivativeValueType[]>> st_FreeDerivativeBlocks;
   };
   itkPadStruct(ITK_CACHE_LINE_ALIGNMENT,
                GetValueAndDerivativePerThreadStruct,
@@ -549,6 +659,11 @@ protected:
   void
   CheckForBSplineTransform() const;
 
+  /** Build the weight cache of the B-spline transform at the fixed image samples, when requested. Called by
+   * Initialize. Inheriting classes may override it to cache other coefficient-independent data at their samples. */
+  virtual void
+  InitializeBSplineWeightCache();
+
   /** Transform a point from FixedImage domain to MovingImage domain. */
   MovingImagePointType
   TransformPoint(const FixedImagePointType & fixedImagePoint) const;
@@ -573,6 +688,14 @@ protected:
   void
   InitializeLimiters();
 
+  /** Compute m_{Fixed,Moving}ImageTrueMin and m_{Fixed,Moving}ImageTrueMax, the extrema of the image within its mask.
+   * The extrema of an image without a mask are obtained from the image extrema function, when it is specified. */
+  void
+  ComputeFixedImageExtrema();
+
+  void
+  ComputeMovingImageExtrema();
+
   /** Inheriting classes can specify whether they use the image limiter functionality
    * Make sure to set it before calling Initialize; default: false. */
   itkSetMacro(UseFixedImageLimiter, bool);
@@ -648,9 +771,15 @@ private:
 
   MovingImageDerivativeScalesType m_MovingImageDerivativeScales{ MovingImageDerivativeScalesType::Filled(1.0) };
 
+  bool          m_UseBSplineWeightCache{ false };
+  SizeValueType m_MaximumBSplineWeightCacheSize{ SizeValueType{ 512 } * 1024 * 1024 };
+
   mutable elx::DefaultConstruct<Statistics::MersenneTwisterRandomVariateGenerator> m_DefaultRandomVariateGenerator{};
   Statistics::MersenneTwisterRandomVariateGenerator * m_RandomVariateGenerator{ &m_DefaultRandomVariateGenerator };
 
+  elastix::Profiler * m_Profiler{ nullptr };
+  ImageExtremaFunctionType m_ImageExtremaFunction{};
+
   // Private using-declarations, to avoid `-Woverloaded-virtual` warnings from GCC (GCC 11.4) or clang (macos-12).
   using Superclass::TransformPoint;
 
@@ -27,6 +27,7 @@
 
 #include <algorithm> // For min.
 #include <cassert>
+#include <limits>
 
 namespace itk
 {
@@ -78,6 +79,9 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
   /** Check if the transform is a B-spline transform. */
   this->CheckForBSplineTransform();
 
+  /** Cache the B-spline weights at the fixed image samples, if requested. */
+  this->InitializeBSplineWeightCache();
+
   /** Initialize some threading related parameters. */
   if (m_UseMultiThread)
   {
@@ -123,18 +127,89 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeThreadingParame
     m_GetValueAndDerivativePerThreadVariablesSize = numberOfThreads;
   }
 
-  /** Some initialization. */
+  /** Some initialization. With sparse derivative accumulation, the dense per-thread derivatives
+   * are released, and the derivative blocks are allocated on demand, in UpdateThreadDerivative().
+   */
+  const bool         useSparseDerivativeAccumulation = this->GetUseSparseDerivativeAccumulationInternally();
+  const unsigned int numberOfDerivativeBlocks =
+    (this->GetNumberOfParameters() + SparseDerivativeBlockSize - 1) >> SparseDerivativeBlockSizeLog2;
   for (ThreadIdType i = 0; i < numberOfThreads; ++i)
   {
-    m_GetValueAndDerivativePerThreadVariables[i].st_NumberOfPixelsCounted = SizeValueType{};
-    m_GetValueAndDerivativePerThreadVariables[i].st_Value = MeasureType{};
-    m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.SetSize(this->GetNumberOfParameters());
-    m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.Fill(0.0);
+    auto & perThreadVariables = m_GetValueAndDerivativePerThreadVariables[i];
+    perThreadVariables.st_NumberOfPixelsCounted = SizeValueType{};
+    perThreadVariables.st_Value = MeasureType{};
+    perThreadVariables.st_DerivativeBlocks.clear();
+    perThreadVariables.st_TouchedDerivativeBlocks.clear();
+    perThreadVariables.st_FreeDerivativeBlocks.clear();
+    if (useSparseDerivativeAccumulation)
+    {
+      perThreadVariables.st_Derivative.SetSize(0);
+      perThreadVariables.st_DerivativeBlocks.resize(numberOfDerivativeBlocks);
+    }
+    else
+    {
+      perThreadVariables.st_Derivative.SetSize(this->GetNumberOfParameters());
+      perThreadVariables.st_Derivative.Fill(0.0);
+    }
   }
 
 } // end InitializeThreadingParameters()
 
 
+/**
+ * ****************** ComputeFixedImageExtrema *****************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::ComputeFixedImageExtrema()
+{
+  const auto computeExtrema = [this]() -> ImageExtremaType {
+    const auto computeFixedImageExtrema = ComputeImageExtremaFilter<FixedImageType>::New();
+    computeFixedImageExtrema->SetInput(this->GetFixedImage());
+    computeFixedImageExtrema->SetImageSpatialMask(this->GetFixedImageMask());
+    computeFixedImageExtrema->Update();
+    return { static_cast<double>(computeFixedImageExtrema->GetMinimum()),
+             static_cast<double>(computeFixedImageExtrema->GetMaximum()) };
+  };
+
+  const ImageExtremaType extrema = (m_ImageExtremaFunction && this->GetFixedImageMask() == nullptr)
+                                     ? m_ImageExtremaFunction(*(this->GetFixedImage()), computeExtrema)
+                                     : computeExtrema();
+
+  m_FixedImageTrueMin = static_cast<FixedImagePixelType>(extrema.first);
+  m_FixedImageTrueMax = static_cast<FixedImagePixelType>(extrema.second);
+
+} // end ComputeFixedImageExtrema()
+
+
+/**
+ * ****************** ComputeMovingImageExtrema *****************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovingImageExtrema()
+{
+  const auto computeExtrema = [this]() -> ImageExtremaType {
+    const auto computeMovingImageExtrema = ComputeImageExtremaFilter<MovingImageType>::New();
+    computeMovingImageExtrema->SetInput(this->GetMovingImage());
+    computeMovingImageExtrema->SetImageSpatialMask(this->GetMovingImageMask());
+    computeMovingImageExtrema->Update();
+    return { static_cast<double>(computeMovingImageExtrema->GetMinimum()),
+             static_cast<double>(computeMovingImageExtrema->GetMaximum()) };
+  };
+
+  const ImageExtremaType extrema = (m_ImageExtremaFunction && this->GetMovingImageMask() == nullptr)
+                                     ? m_ImageExtremaFunction(*(this->GetMovingImage()), computeExtrema)
+                                     : computeExtrema();
+
+  m_MovingImageTrueMin = static_cast<MovingImagePixelType>(extrema.first);
+  m_MovingImageTrueMax = static_cast<MovingImagePixelType>(extrema.second);
+
+} // end ComputeMovingImageExtrema()
+
+
 /**
  * ****************** InitializeLimiters *****************************
  */
@@ -151,13 +226,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeLimiters()
       itkExceptionMacro("No fixed image limiter has been set!");
     }
 
-    const auto computeFixedImageExtrema = ComputeImageExtremaFilter<FixedImageType>::New();
-    computeFixedImageExtrema->SetInput(this->GetFixedImage());
-    computeFixedImageExtrema->SetImageSpatialMask(this->GetFixedImageMask());
-    computeFixedImageExtrema->Update();
-
-    m_FixedImageTrueMax = computeFixedImageExtrema->GetMaximum();
-    m_FixedImageTrueMin = computeFixedImageExtrema->GetMinimum();
+    this->ComputeFixedImageExtrema();
 
     m_FixedImageMinLimit = static_cast<FixedImageLimiterOutputType>(
       m_FixedImageTrueMin - m_FixedLimitRangeRatio * (m_FixedImageTrueMax - m_FixedImageTrueMin));
@@ -180,13 +249,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeLimiters()
       itkExceptionMacro("No moving image limiter has been set!");
     }
 
-    const auto computeMovingImageExtrema = ComputeImageExtremaFilter<MovingImageType>::New();
-    computeMovingImageExtrema->SetInput(this->GetMovingImage());
-    computeMovingImageExtrema->SetImageSpatialMask(this->GetMovingImageMask());
-    computeMovingImageExtrema->Update();
-
-    m_MovingImageTrueMax = computeMovingImageExtrema->GetMaximum();
-    m_MovingImageTrueMin = computeMovingImageExtrema->GetMinimum();
+    this->ComputeMovingImageExtrema();
 
     m_MovingImageMinLimit = static_cast<MovingImageLimiterOutputType>(
       m_MovingImageTrueMin - m_MovingLimitRangeRatio * (m_MovingImageTrueMax - m_MovingImageTrueMin));
@@ -387,6 +450,64 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::CheckForBSplineTransform(
 } // end CheckForBSplineTransform()
 
 
+/**
+ * ****************** InitializeBSplineWeightCache **********************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeBSplineWeightCache()
+{
+  m_BSplineWeightCacheSize = 0;
+  m_BSplineWeightCacheIsBuilt = false;
+
+  /** Find the B-spline transform. When it is composed with an initial transform, it is evaluated at the samples
+   * mapped by the initial transform.
+   */
+  using BSplineTransformBaseType = AdvancedBSplineDeformableTransformBase<ScalarType, FixedImageDimension>;
+  const AdvancedTransformType * initialTransform = nullptr;
+  auto * bsplineTransform = dynamic_cast<BSplineTransformBaseType *>(m_AdvancedTransform.GetPointer());
+  if (auto * const combinationTransform = dynamic_cast<CombinationTransformType *>(m_AdvancedTransform.GetPointer()))
+  {
+    bsplineTransform = dynamic_cast<BSplineTransformBaseType *>(combinationTransform->GetModifiableCurrentTransform());
+    if (combinationTransform->GetUseComposition())
+    {
+      initialTransform = combinationTransform->GetInitialTransform();
+    }
+  }
+  if (bsplineTransform == nullptr)
+  {
+    return;
+  }
+
+  /** The cache only pays off when the same samples are used in each iteration. The transform may be shared with other
+   * metrics, so the points of this metric are added to the points of the other metrics, rather than replacing them.
+   * When this metric does not use the cache, its points (of a previous resolution) are removed.
+   */
+  std::vector<FixedImagePointType> points;
+  if (m_UseBSplineWeightCache && m_UseImageSampler && !m_ImageSampler->SelectingNewSamplesOnUpdateSupported())
+  {
+    m_ImageSampler->Update();
+    const ImageSampleContainerType & samples = *(m_ImageSampler->GetOutput());
+
+    points.reserve(samples.size());
+    for (const auto & sample : samples)
+    {
+      const FixedImagePointType & fixedPoint = sample.m_ImageCoordinates;
+      points.push_back(initialTransform ? initialTransform->TransformPoint(fixedPoint) : fixedPoint);
+    }
+  }
+
+  const SizeValueType cacheSize = bsplineTransform->BuildWeightCache(this, points, m_MaximumBSplineWeightCacheSize);
+  if (!points.empty())
+  {
+    m_BSplineWeightCacheSize = cacheSize;
+    m_BSplineWeightCacheIsBuilt = bsplineTransform->GetWeightCacheSize() > 0;
+  }
+
+} // end InitializeBSplineWeightCache()
+
+
 /**
  * ******************* EvaluateMovingImageValueAndDerivativeWithOptionalThreadId ******************
  */
@@ -611,7 +732,13 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::BeforeThreadedGetValueAnd
     this->SetTransformParameters(parameters);
     if (m_UseImageSampler)
     {
+      const elastix::ProfilerScope profilerScope(m_Profiler, "ImageSampler::Update");
       m_ImageSampler->Update();
+      if (m_Profiler)
+      {
+        m_Profiler->AddCounterValue("ImageSampler::NumberOfSamples",
+                                    static_cast<double>(m_ImageSampler->GetOutput()->Size()));
+      }
     }
   }
 
@@ -651,6 +778,8 @@ template <typename TFixedImage, typename TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueThreaderCallback() const
 {
+  const elastix::ProfilerScope profilerScope(m_Profiler, "Metric::ThreadedGetValue");
+
   /** Setup threader and launch. */
   Superclass::m_Threader->SetSingleMethodAndExecute(this->GetValueThreaderCallback, &m_ThreaderMetricParameters);
 
@@ -690,6 +819,14 @@ template <typename TFixedImage, typename TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueAndDerivativeThreaderCallback() const
 {
+  /** Make the derivative blocks of the previous iteration available again. */
+  if (this->GetUseSparseDerivativeAccumulationInternally())
+  {
+    this->RecycleDerivativeBlocks();
+  }
+
+  const elastix::ProfilerScope profilerScope(m_Profiler, "Metric::ThreadedGetValueAndDerivative");
+
   /** Setup threader and launch. */
   Superclass::m_Threader->SetSingleMethodAndExecute(this->GetValueAndDerivativeThreaderCallback,
                                                     &m_ThreaderMetricParameters);
@@ -697,6 +834,119 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueAndDerivati
 } // end LaunchGetValueAndDerivativeThreaderCallback()
 
 
+/**
+ * *********************** AccumulateDerivativeTerms ***************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativeTerms(
+  const DerivativeValueType          factor,
+  const DerivativeType &             imageJacobian,
+  const NonZeroJacobianIndicesType & nzji,
+  DerivativeType &                   derivative)
+{
+  const unsigned int numberOfParameters = derivative.GetSize();
+
+  if (nzji.size() == numberOfParameters)
+  {
+    /** Loop over all Jacobians. */
+    for (unsigned int mu = 0; mu < numberOfParameters; ++mu)
+    {
+      derivative[mu] += factor * imageJacobian[mu];
+    }
+  }
+  else
+  {
+    /** Only pick the nonzero Jacobians. */
+    for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
+    {
+      derivative[nzji[i]] += factor * imageJacobian[i];
+    }
+  }
+
+} // end AccumulateDerivativeTerms()
+
+
+/**
+ * *********************** UpdateThreadDerivative ***************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::UpdateThreadDerivative(
+  const ThreadIdType                 threadId,
+  const DerivativeValueType          factor,
+  const DerivativeType &             imageJacobian,
+  const NonZeroJacobianIndicesType & nzji) const
+{
+  auto & perThreadVariables = m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  if (!this->GetUseSparseDerivativeAccumulationInternally())
+  {
+    AccumulateDerivativeTerms(factor, imageJacobian, nzji, perThreadVariables.st_Derivative);
+    return;
+  }
+
+  /** The nonzero Jacobian indices come in runs of consecutive parameters,
+   * so the block lookup is only done when a run crosses a block boundary.
+   */
+  unsigned int          currentBlockIndex = std::numeric_limits<unsigned int>::max();
+  DerivativeValueType * currentBlock = nullptr;
+  for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
+  {
+    const unsigned int index = nzji[i];
+    const unsigned int blockIndex = index >> SparseDerivativeBlockSizeLog2;
+    if (blockIndex != currentBlockIndex)
+    {
+      auto & block = perThreadVariables.st_DerivativeBlocks[blockIndex];
+      if (block == nullptr)
+      {
+        /** Take a block from the pool, or allocate a new (zero-initialized) one. */
+        auto & freeBlocks = perThreadVariables.st_FreeDerivativeBlocks;
+        if (freeBlocks.empty())
+        {
+          block = std::make_unique<DerivativeValueType[]>(SparseDerivativeBlockSize);
+        }
+        else
+        {
+          block = std::move(freeBlocks.back());
+          freeBlocks.pop_back();
+          std::fill_n(block.get(), SparseDerivativeBlockSize, DerivativeValueType{});
+        }
+        perThreadVariables.st_TouchedDerivativeBlocks.push_back(blockIndex);
+      }
+      currentBlockIndex = blockIndex;
+      currentBlock = block.get();
+    }
+    currentBlock[index & (SparseDerivativeBlockSize - 1)] += factor * imageJacobian[i];
+  }
+
+} // end UpdateThreadDerivative()
+
+
+/**
+ * *********************** RecycleDerivativeBlocks ***************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::RecycleDerivativeBlocks() const
+{
+  for (ThreadIdType i = 0; i < m_GetValueAndDerivativePerThreadVariablesSize; ++i)
+  {
+    auto & perThreadVariables = m_GetValueAndDerivativePerThreadVariables[i];
+    for (const unsigned int blockIndex : perThreadVariables.st_TouchedDerivativeBlocks)
+    {
+      perThreadVariables.st_FreeDerivativeBlocks.push_back(
+        std::move(perThreadVariables.st_DerivativeBlocks[blockIndex]));
+    }
+    perThreadVariables.st_TouchedDerivativeBlocks.clear();
+  }
+
+} // end RecycleDerivativeBlocks()
+
+
 /**
  *********** AccumulateDerivativesThreaderCallback *************
  */
@@ -716,8 +966,50 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativesThre
   assert(userData.st_Metric);
   Self & metric = *(userData.st_Metric);
 
-  const unsigned int numPar = metric.GetNumberOfParameters();
-  const auto         subSize =
+  const elastix::ProfilerScope profilerScope(metric.m_Profiler, "Metric::AccumulateDerivatives");
+
+  const unsigned int        numPar = metric.GetNumberOfParameters();
+  const DerivativeValueType normalization = 1.0 / userData.st_NormalizationFactor;
+
+  if (metric.GetUseSparseDerivativeAccumulationInternally())
+  {
+    /** This thread accumulates a range of whole derivative blocks, so that no two threads
+     * write to the same block. Blocks that were not touched by a thread contribute zero;
+     * they are reset when they are taken from the pool again.
+     */
+    const unsigned int numBlocks = (numPar + SparseDerivativeBlockSize - 1) >> SparseDerivativeBlockSizeLog2;
+    const auto         subSize =
+      static_cast<unsigned int>(std::ceil(static_cast<double>(numBlocks) / static_cast<double>(nrOfThreads)));
+    const unsigned int bmin = threadID * subSize;
+    const unsigned int bmax = std::min((threadID + 1) * subSize, numBlocks);
+
+    for (unsigned int b = bmin; b < bmax; ++b)
+    {
+      const unsigned int          blockStart = b << SparseDerivativeBlockSizeLog2;
+      const unsigned int          blockSize = std::min(SparseDerivativeBlockSize, numPar - blockStart);
+      DerivativeValueType * const derivativeBlock = userData.st_DerivativePointer + blockStart;
+      std::fill_n(derivativeBlock, blockSize, DerivativeValueType{});
+
+      for (ThreadIdType i = 0; i < nrOfThreads; ++i)
+      {
+        const auto & perThreadVariables = metric.m_GetValueAndDerivativePerThreadVariables[i];
+        if (const DerivativeValueType * const block = perThreadVariables.st_DerivativeBlocks[b].get())
+        {
+          for (unsigned int j = 0; j < blockSize; ++j)
+          {
+            derivativeBlock[j] += block[j];
+          }
+        }
+      }
+      for (unsigned int j = 0; j < blockSize; ++j)
+      {
+        derivativeBlock[j] *= normalization;
+      }
+    }
+    return ITK_THREAD_RETURN_DEFAULT_VALUE;
+  }
+
+  const auto subSize =
     static_cast<unsigned int>(std::ceil(static_cast<double>(numPar) / static_cast<double>(nrOfThreads)));
   const unsigned int jmin = threadID * subSize;
   const unsigned int jmax = std::min((threadID + 1) * subSize, numPar);
@@ -725,7 +1017,6 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativesThre
   /** This thread accumulates all sub-derivatives into a single one, for the
    * range [ jmin, jmax [. Additionally, the sub-derivatives are reset.
    */
-  const DerivativeValueType normalization = 1.0 / userData.st_NormalizationFactor;
   for (unsigned int j = jmin; j < jmax; ++j)
   {
     DerivativeValueType sum{};
@@ -212,6 +212,16 @@ public:
   itkSetMacro(FiniteDifferencePerturbation, double);
   itkGetConstMacro(FiniteDifferencePerturbation, double);
 
+  /** For computing the finite difference derivative, the maximum amount of memory
+   * (in megabytes) that may be used by the incremental pdfs. The transform parameters
+   * are then processed in blocks that fit within this budget, at the cost of an extra
+   * pass over the samples for each block. Multi-threaded, each work unit processes its
+   * own blocks, and the budget is shared by all work units.
+   * This option should be set before calling Initialize(); Default: 0, meaning no limit.
+   */
+  itkSetMacro(FiniteDifferenceDerivativeMaximumMemory, SizeValueType);
+  itkGetConstMacro(FiniteDifferenceDerivativeMaximumMemory, SizeValueType);
+
 protected:
   /** The constructor. */
   ParzenWindowHistogramImageToImageMetric();
@@ -264,22 +274,32 @@ protected:
 
   /** Protected variables **************************** */
 
+  /** The incremental pdfs and perturbed alphas of one block of consecutive transform
+   * parameters, used for the finite difference derivative. The first index of the
+   * incremental pdfs is the parameter number, relative to st_FirstParameter.
+   */
+  struct FiniteDifferenceParameterBlockType
+  {
+    unsigned int                  st_FirstParameter{ 0 };
+    unsigned int                  st_NumberOfParameters{ 0 };
+    DerivativeType                st_PerturbedAlphaRight{};
+    DerivativeType                st_PerturbedAlphaLeft{};
+    JointPDFDerivativesPointer    st_IncrementalJointPDFRight{};
+    JointPDFDerivativesPointer    st_IncrementalJointPDFLeft{};
+    IncrementalMarginalPDFPointer st_FixedIncrementalMarginalPDFRight{};
+    IncrementalMarginalPDFPointer st_MovingIncrementalMarginalPDFRight{};
+    IncrementalMarginalPDFPointer st_FixedIncrementalMarginalPDFLeft{};
+    IncrementalMarginalPDFPointer st_MovingIncrementalMarginalPDFLeft{};
+  };
+
   /** Variables for Alpha (the normalization factor of the histogram). */
-  mutable double         m_Alpha{ 0.0 };
-  mutable DerivativeType m_PerturbedAlphaRight{};
-  mutable DerivativeType m_PerturbedAlphaLeft{};
+  mutable double m_Alpha{ 0.0 };
 
   /** Variables for the pdfs (actually: histograms). */
   mutable MarginalPDFType       m_FixedImageMarginalPDF{};
   mutable MarginalPDFType       m_MovingImageMarginalPDF{};
   JointPDFPointer               m_JointPDF{ nullptr };
   JointPDFDerivativesPointer    m_JointPDFDerivatives{ nullptr };
-  JointPDFDerivativesPointer    m_IncrementalJointPDFRight{};
-  JointPDFDerivativesPointer    m_IncrementalJointPDFLeft{};
-  IncrementalMarginalPDFPointer m_FixedIncrementalMarginalPDFRight{ nullptr };
-  IncrementalMarginalPDFPointer m_MovingIncrementalMarginalPDFRight{ nullptr };
-  IncrementalMarginalPDFPointer m_FixedIncrementalMarginalPDFLeft{ nullptr };
-  IncrementalMarginalPDFPointer m_MovingIncrementalMarginalPDFLeft{ nullptr };
   mutable JointPDFRegionType    m_JointPDFWindow{}; // no need for mutable anymore?
   double                        m_MovingImageNormalizedMin{ 0.0 };
   double                        m_FixedImageNormalizedMin{ 0.0 };
@@ -288,6 +308,10 @@ protected:
   double                        m_FixedParzenTermToIndexOffset{ 0.5 };
   double                        m_MovingParzenTermToIndexOffset{ -1.0 };
 
+  /** Buffers for the finite difference derivative: one parameter block per work unit. */
+  mutable std::vector<FiniteDifferenceParameterBlockType> m_FiniteDifferenceParameterBlocks{};
+  unsigned int                                            m_FiniteDifferenceParameterBlockSize{ 0 };
+
   /** Kernels for computing Parzen histograms and derivatives. */
   KernelFunctionPointer m_FixedKernel{ nullptr };
   KernelFunctionPointer m_MovingKernel{ nullptr };
@@ -334,25 +358,27 @@ protected:
                                const NonZeroJacobianIndicesType * nzji,
                                JointPDFType *                     jointPDF) const;
 
-  /** Update the joint PDF and the incremental pdfs.
+  /** Update the incremental pdfs of a parameter block.
    * The input is a pixel pair (fixed, moving, moving mask) and
    * a set of moving image/mask values when using mu+delta*e_k, for
    * each k that has a nonzero Jacobian. And for mu-delta*e_k of course.
-   * Also updates the PerturbedAlpha's
+   * Only the k inside the parameter block are taken into account.
+   * Also updates the PerturbedAlpha's of the block.
    * This function is used when UseFiniteDifferenceDerivative is true.
    *
    * \todo The IsInsideMovingMask return bools are converted to doubles (1 or 0) to
    * simplify the computation. But this may not be necessary.
    */
   virtual void
-  UpdateJointPDFAndIncrementalPDFs(RealType                           fixedImageValue,
-                                   RealType                           movingImageValue,
-                                   RealType                           movingMaskValue,
-                                   const DerivativeType &             movingImageValuesRight,
-                                   const DerivativeType &             movingImageValuesLeft,
-                                   const DerivativeType &             movingMaskValuesRight,
-                                   const DerivativeType &             movingMaskValuesLeft,
-                                   const NonZeroJacobianIndicesType & nzji) const;
+  UpdateIncrementalPDFs(RealType                             fixedImageValue,
+                        RealType                             movingImageValue,
+                        RealType                             movingMaskValue,
+                        const DerivativeType &               movingImageValuesRight,
+                        const DerivativeType &               movingImageValuesLeft,
+                        const DerivativeType &               movingMaskValuesRight,
+                        const DerivativeType &               movingMaskValuesLeft,
+                        const NonZeroJacobianIndicesType &   nzji,
+                        FiniteDifferenceParameterBlockType & block) const;
 
   /** Update the pdf derivatives
    * adds -image_jac[mu]*factor to the bin
@@ -400,19 +426,20 @@ protected:
   virtual void
   ComputePDFsAndPDFDerivatives(const ParametersType & parameters) const;
 
-  /** Compute PDFs and incremental pdfs (which you can use to compute finite
-   * difference estimate of the derivative).
-   * Loops over the fixed image samples and constructs the m_JointPDF,
-   * m_IncrementalJointPDF<Right/Left>, m_Alpha, and m_PerturbedAlpha<Right/Left>.
+  /** Compute the incremental pdfs (which you can use to compute finite
+   * difference estimate of the derivative) of one block of parameters.
+   * Loops over the fixed image samples and constructs the incremental joint pdfs,
+   * the incremental marginal pdfs, and the perturbed alphas of the block.
+   * Assumes that ComputePDFs() has been called already, for the same parameters.
    *
    * mu = input parameters vector
    * jh(mu) = m_JointPDF(:,:) = joint histogram
-   * ihr(k) = m_IncrementalJointPDFRight(k,:,:)
-   * ihl(k) = m_IncrementalJointPDFLeft(k,:,:)
+   * ihr(k) = st_IncrementalJointPDFRight(k - st_FirstParameter,:,:)
+   * ihl(k) = st_IncrementalJointPDFLeft(k - st_FirstParameter,:,:)
    * a(mu) = m_Alpha
-   * par(k) = m_PerturbedAlphaRight(k)
-   * pal(k) = m_PerturbedAlphaLeft(k)
-   * size(ihr) = = size(ihl) = nrofparams * nrofmovingbins * nroffixedbins
+   * par(k) = st_PerturbedAlphaRight(k - st_FirstParameter)
+   * pal(k) = st_PerturbedAlphaLeft(k - st_FirstParameter)
+   * size(ihr) = = size(ihl) = blocksize * nrofmovingbins * nroffixedbins
    *
    * ihr and ihl are determined such that:
    * jh(mu+delta*e_k) = jh(mu) + ihr(k)
@@ -424,7 +451,25 @@ protected:
    * p(mu-delta*e_k) = ( pal(k) ) * jh(mu-delta*e_k)
    */
   virtual void
-  ComputePDFsAndIncrementalPDFs(const ParametersType & parameters) const;
+  ComputeIncrementalPDFs(FiniteDifferenceParameterBlockType & block, ThreadIdType threadId) const;
+
+  /** Compute the finite difference derivative, block by block. The blocks are
+   * distributed over the work units, each work unit using its own buffers.
+   * For each block, ComputeIncrementalPDFs() is followed by
+   * UpdateFiniteDifferenceDerivative(). Assumes that ComputePDFs() has been called
+   * already, for the same parameters.
+   */
+  void
+  ComputeFiniteDifferenceDerivative(DerivativeType & derivative) const;
+
+  /** Compute the derivative entries of one parameter block from its incremental pdfs.
+   * Called by ComputeFiniteDifferenceDerivative(), possibly from multiple threads
+   * simultaneously, for distinct blocks. Implement this method in subclasses.
+   */
+  virtual void
+  UpdateFiniteDifferenceDerivative(const FiniteDifferenceParameterBlockType & itkNotUsed(block),
+                                   DerivativeType &                           itkNotUsed(derivative)) const
+  {}
 
   /** Compute PDFs; Loops over the fixed image samples and constructs
    * the m_JointPDF and m_Alpha
@@ -476,10 +521,19 @@ private:
    */
   struct ParzenWindowHistogramMultiThreaderParameterType // can't we use the one from AdvancedImageToImageMetric ?
   {
-    Self * m_Metric;
+    Self *           m_Metric;
+    DerivativeType * m_Derivative;
   };
   ParzenWindowHistogramMultiThreaderParameterType m_ParzenWindowHistogramThreaderParameters{};
 
+  /** Computes the derivative of the parameter blocks assigned to the work unit. */
+  void
+  ThreadedComputeFiniteDifferenceDerivative(ThreadIdType threadId, DerivativeType & derivative) const;
+
+  /** Helper function to launch the threads. */
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  ComputeFiniteDifferenceDerivativeThreaderCallback(void * arg);
+
   struct ParzenWindowHistogramGetValueAndDerivativePerThreadStruct
   {
     SizeValueType   st_NumberOfPixelsCounted;
@@ -503,6 +557,7 @@ private:
   bool          m_UseExplicitPDFDerivatives{ true };
   bool          m_UseFiniteDifferenceDerivative{ false };
   double        m_FiniteDifferencePerturbation{ 1.0 };
+  SizeValueType m_FiniteDifferenceDerivativeMaximumMemory{ 0 };
 };
 
 } // end namespace itk
@@ -25,6 +25,7 @@
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkImageScanlineIterator.h"
 #include <vnl/vnl_math.h>
+#include <algorithm>
 #include <cassert>
 
 namespace itk
@@ -97,20 +98,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
   /** Set up the Parzen windows. */
   this->InitializeKernels();
 
-  /** If the user plans to use a finite difference derivative,
-   * allocate some memory for the perturbed alpha variables.
-   */
-  if (this->GetUseDerivative() && this->GetUseFiniteDifferenceDerivative())
-  {
-    this->m_PerturbedAlphaRight.SetSize(this->GetNumberOfParameters());
-    this->m_PerturbedAlphaLeft.SetSize(this->GetNumberOfParameters());
-  }
-  else
-  {
-    this->m_PerturbedAlphaRight.SetSize(0);
-    this->m_PerturbedAlphaLeft.SetSize(0);
-  }
-
 } // end Initialize()
 
 
@@ -180,11 +167,9 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::InitializeHi
 
   /** Allocate memory for the joint PDF and joint PDF derivatives. */
 
-  /** First set these ones to zero */
-  this->m_FixedIncrementalMarginalPDFRight = nullptr;
-  this->m_MovingIncrementalMarginalPDFRight = nullptr;
-  this->m_FixedIncrementalMarginalPDFLeft = nullptr;
-  this->m_MovingIncrementalMarginalPDFLeft = nullptr;
+  /** First release the finite difference buffers. */
+  this->m_FiniteDifferenceParameterBlocks.clear();
+  this->m_FiniteDifferenceParameterBlockSize = 0;
 
   /** For the joint PDF define a region starting from {0,0}
    * with size {this->m_NumberOfMovingHistogramBins, this->m_NumberOfFixedHistogramBins}
@@ -206,8 +191,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::InitializeHi
      * m_NumberOfFixedHistogramBins}. The dimension represents transform parameters,
      * moving image Parzen window index and fixed image Parzen window index,
      * respectively.
-     * For the incremental pdfs (used for finite difference derivative estimation)
-     * the same size happens to be valid.
      */
 
     const JointPDFDerivativesSizeType jointPDFDerivativesSize{ this->GetNumberOfParameters(),
@@ -218,41 +201,70 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::InitializeHi
     {
       this->m_JointPDFDerivatives = nullptr;
 
-      this->m_IncrementalJointPDFRight = JointPDFDerivativesType::New();
-      this->m_IncrementalJointPDFLeft = JointPDFDerivativesType::New();
-      this->m_IncrementalJointPDFRight->SetRegions(jointPDFDerivativesSize);
-      this->m_IncrementalJointPDFLeft->SetRegions(jointPDFDerivativesSize);
-      this->m_IncrementalJointPDFRight->Allocate();
-      this->m_IncrementalJointPDFLeft->Allocate();
-
-      /** Also initialize the incremental marginal pdfs. */
-      const IncrementalMarginalPDFSizeType fixedIMPDFSize{ this->GetNumberOfParameters(),
-                                                           m_NumberOfFixedHistogramBins };
-      const IncrementalMarginalPDFSizeType movingIMPDFSize{ this->GetNumberOfParameters(),
-                                                            m_NumberOfMovingHistogramBins };
-
-      this->m_FixedIncrementalMarginalPDFRight = IncrementalMarginalPDFType::New();
-      this->m_MovingIncrementalMarginalPDFRight = IncrementalMarginalPDFType::New();
-      this->m_FixedIncrementalMarginalPDFLeft = IncrementalMarginalPDFType::New();
-      this->m_MovingIncrementalMarginalPDFLeft = IncrementalMarginalPDFType::New();
-
-      this->m_FixedIncrementalMarginalPDFRight->SetRegions(fixedIMPDFSize);
-      this->m_MovingIncrementalMarginalPDFRight->SetRegions(movingIMPDFSize);
-      this->m_FixedIncrementalMarginalPDFLeft->SetRegions(fixedIMPDFSize);
-      this->m_MovingIncrementalMarginalPDFLeft->SetRegions(movingIMPDFSize);
-
-      this->m_FixedIncrementalMarginalPDFRight->Allocate();
-      this->m_MovingIncrementalMarginalPDFRight->Allocate();
-      this->m_FixedIncrementalMarginalPDFLeft->Allocate();
-      this->m_MovingIncrementalMarginalPDFLeft->Allocate();
+      /** The incremental pdfs (used for finite difference derivative estimation) are
+       * computed for blocks of parameters, one block per work unit at a time. By default
+       * the parameters are simply divided over the work units, which requires the same
+       * amount of memory as a single block of all parameters. When a memory budget is
+       * specified, the block size is reduced until all buffers fit within the budget.
+       */
+      const auto         numberOfParameters = static_cast<unsigned int>(this->GetNumberOfParameters());
+      const ThreadIdType numberOfBlockBuffers = Superclass::m_UseMultiThread ? Self::GetNumberOfWorkUnits() : 1;
+
+      unsigned int blockSize = (numberOfParameters + numberOfBlockBuffers - 1) / numberOfBlockBuffers;
+      if (this->m_FiniteDifferenceDerivativeMaximumMemory > 0)
+      {
+        /** Two incremental joint pdfs, four incremental marginal pdfs and two perturbed alphas per parameter. */
+        const double bytesPerParameter =
+          2.0 * sizeof(PDFDerivativeValueType) * m_NumberOfMovingHistogramBins * m_NumberOfFixedHistogramBins +
+          2.0 * sizeof(PDFValueType) * (m_NumberOfMovingHistogramBins + m_NumberOfFixedHistogramBins) +
+          2.0 * sizeof(typename DerivativeType::ValueType);
+        const double maximumNumberOfBytes = 1024.0 * 1024.0 * this->m_FiniteDifferenceDerivativeMaximumMemory;
+        const double maximumBlockSize = std::floor(maximumNumberOfBytes / (numberOfBlockBuffers * bytesPerParameter));
+        blockSize = std::min(blockSize, static_cast<unsigned int>(std::max(maximumBlockSize, 1.0)));
+      }
+      blockSize = std::max(blockSize, 1U);
+      this->m_FiniteDifferenceParameterBlockSize = blockSize;
+
+      const JointPDFDerivativesSizeType    incrementalPDFSize{ blockSize,
+                                                            m_NumberOfMovingHistogramBins,
+                                                            m_NumberOfFixedHistogramBins };
+      const IncrementalMarginalPDFSizeType fixedIMPDFSize{ blockSize, m_NumberOfFixedHistogramBins };
+      const IncrementalMarginalPDFSizeType movingIMPDFSize{ blockSize, m_NumberOfMovingHistogramBins };
+
+      this->m_FiniteDifferenceParameterBlocks.resize(numberOfBlockBuffers);
+      for (auto & block : this->m_FiniteDifferenceParameterBlocks)
+      {
+        block.st_PerturbedAlphaRight.SetSize(blockSize);
+        block.st_PerturbedAlphaLeft.SetSize(blockSize);
+
+        block.st_IncrementalJointPDFRight = JointPDFDerivativesType::New();
+        block.st_IncrementalJointPDFLeft = JointPDFDerivativesType::New();
+        block.st_IncrementalJointPDFRight->SetRegions(incrementalPDFSize);
+        block.st_IncrementalJointPDFLeft->SetRegions(incrementalPDFSize);
+        block.st_IncrementalJointPDFRight->Allocate();
+        block.st_IncrementalJointPDFLeft->Allocate();
+
+        /** Also initialize the incremental marginal pdfs. */
+        block.st_FixedIncrementalMarginalPDFRight = IncrementalMarginalPDFType::New();
+        block.st_MovingIncrementalMarginalPDFRight = IncrementalMarginalPDFType::New();
+        block.st_FixedIncrementalMarginalPDFLeft = IncrementalMarginalPDFType::New();
+        block.st_MovingIncrementalMarginalPDFLeft = IncrementalMarginalPDFType::New();
+
+        block.st_FixedIncrementalMarginalPDFRight->SetRegions(fixedIMPDFSize);
+        block.st_MovingIncrementalMarginalPDFRight->SetRegions(movingIMPDFSize);
+        block.st_FixedIncrementalMarginalPDFLeft->SetRegions(fixedIMPDFSize);
+        block.st_MovingIncrementalMarginalPDFLeft->SetRegions(movingIMPDFSize);
+
+        block.st_FixedIncrementalMarginalPDFRight->Allocate();
+        block.st_MovingIncrementalMarginalPDFRight->Allocate();
+        block.st_FixedIncrementalMarginalPDFLeft->Allocate();
+        block.st_MovingIncrementalMarginalPDFLeft->Allocate();
+      }
     } // end if this->GetUseFiniteDifferenceDerivative()
     else
     {
       if (this->m_UseExplicitPDFDerivatives)
       {
-        this->m_IncrementalJointPDFRight = nullptr;
-        this->m_IncrementalJointPDFLeft = nullptr;
-
         this->m_JointPDFDerivatives = JointPDFDerivativesType::New();
         this->m_JointPDFDerivatives->SetRegions(jointPDFDerivativesSize);
         this->m_JointPDFDerivatives->Allocate();
@@ -273,8 +285,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::InitializeHi
   else
   {
     this->m_JointPDFDerivatives = nullptr;
-    this->m_IncrementalJointPDFRight = nullptr;
-    this->m_IncrementalJointPDFLeft = nullptr;
   }
 
 } // end InitializeHistograms()
@@ -710,7 +720,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputeIncre
   IncMargIteratorType fixincit(fixedIncrementalMarginalPDF, fixedIncrementalMarginalPDF->GetLargestPossibleRegion());
   IncMargIteratorType movincit(movingIncrementalMarginalPDF, movingIncrementalMarginalPDF->GetLargestPossibleRegion());
 
-  const auto numberOfParameters = this->GetNumberOfParameters();
+  const auto numberOfParameters = incrementalPDF->GetLargestPossibleRegion().GetSize()[0];
 
   /** Loop over the incremental pdf and update the incremental marginal pdfs. */
   for (unsigned int f = 0; f < this->m_NumberOfFixedHistogramBins; ++f)
@@ -736,24 +746,30 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputeIncre
 
 
 /**
- * ******************* UpdateJointPDFAndIncrementalPDFs *******************
+ * ******************* UpdateIncrementalPDFs *******************
  */
 
 template <typename TFixedImage, typename TMovingImage>
 void
-ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointPDFAndIncrementalPDFs(
-  RealType                           fixedImageValue,
-  RealType                           movingImageValue,
-  RealType                           movingMaskValue,
-  const DerivativeType &             movingImageValuesRight,
-  const DerivativeType &             movingImageValuesLeft,
-  const DerivativeType &             movingMaskValuesRight,
-  const DerivativeType &             movingMaskValuesLeft,
-  const NonZeroJacobianIndicesType & nzji) const
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateIncrementalPDFs(
+  RealType                             fixedImageValue,
+  RealType                             movingImageValue,
+  RealType                             movingMaskValue,
+  const DerivativeType &               movingImageValuesRight,
+  const DerivativeType &               movingImageValuesLeft,
+  const DerivativeType &               movingMaskValuesRight,
+  const DerivativeType &               movingMaskValuesLeft,
+  const NonZeroJacobianIndicesType &   nzji,
+  FiniteDifferenceParameterBlockType & block) const
 {
+  JointPDFDerivativesType & incrementalJointPDFRight = *block.st_IncrementalJointPDFRight;
+  JointPDFDerivativesType & incrementalJointPDFLeft = *block.st_IncrementalJointPDFLeft;
+  const unsigned int        firstParameter = block.st_FirstParameter;
+  const unsigned int        endParameter = firstParameter + block.st_NumberOfParameters;
+
   /** Pointers to the first pixels in the incremental joint pdfs. */
-  PDFDerivativeValueType * incRightBasePtr = this->m_IncrementalJointPDFRight->GetBufferPointer();
-  PDFDerivativeValueType * incLeftBasePtr = this->m_IncrementalJointPDFLeft->GetBufferPointer();
+  PDFDerivativeValueType * incRightBasePtr = incrementalJointPDFRight.GetBufferPointer();
+  PDFDerivativeValueType * incLeftBasePtr = incrementalJointPDFLeft.GetBufferPointer();
 
   /** The Parzen value containers. */
   ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
@@ -786,9 +802,9 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
 
     /** Loop over the Parzen window region and do the following update:
      *
-     * m_JointPDF(M,F) += movingMask * fixedParzen(F) * movingParzen(M);
-     * m_IncrementalJointPDF<Right/Left>(k,M,F) -= movingMask * fixedParzen(F) * movingParzen(M);
-     * for all k with nonzero Jacobian.
+     * st_IncrementalJointPDF<Right/Left>(k,M,F) -= movingMask * fixedParzen(F) * movingParzen(M);
+     * for all k in the block with nonzero Jacobian.
+     * The joint pdf itself is computed by ComputePDFs().
      */
     for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
     {
@@ -796,21 +812,24 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
       {
         const auto fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
-        this->m_JointPDF->GetPixel(pdfIndex) += fv_mask_mv;
 
-        auto offset = static_cast<unsigned long>(pdfIndex[0] * this->m_IncrementalJointPDFRight->GetOffsetTable()[1] +
-                                                 pdfIndex[1] * this->m_IncrementalJointPDFRight->GetOffsetTable()[2]);
+        auto offset = static_cast<unsigned long>(pdfIndex[0] * incrementalJointPDFRight.GetOffsetTable()[1] +
+                                                 pdfIndex[1] * incrementalJointPDFRight.GetOffsetTable()[2]);
 
         /** Get the pointer to the element with index [0, pdfIndex[0], pdfIndex[1]]. */
         PDFDerivativeValueType * incRightPtr = incRightBasePtr + offset;
         PDFDerivativeValueType * incLeftPtr = incLeftBasePtr + offset;
 
-        /** Loop only over the non-zero Jacobians. */
+        /** Loop only over the non-zero Jacobians inside the block. */
         for (unsigned int i = 0; i < nzji.size(); ++i)
         {
-          const unsigned int       mu = nzji[i];
-          PDFDerivativeValueType * rPtr = incRightPtr + mu;
-          PDFDerivativeValueType * lPtr = incLeftPtr + mu;
+          const unsigned int mu = nzji[i];
+          if (mu < firstParameter || mu >= endParameter)
+          {
+            continue;
+          }
+          PDFDerivativeValueType * rPtr = incRightPtr + (mu - firstParameter);
+          PDFDerivativeValueType * lPtr = incLeftPtr + (mu - firstParameter);
           *(rPtr) -= fv_mask_mv;
           *(lPtr) -= fv_mask_mv;
         } // end for i
@@ -825,12 +844,12 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
 
   } // end if movingMaskValue > 1e-10
 
-  /** Loop only over the non-zero Jacobians and update the incremental pdfs and
-   * update the perturbed alphas:
+  /** Loop only over the non-zero Jacobians inside the block and update the
+   * incremental pdfs and update the perturbed alphas:
    *
-   * m_IncrementalJointPDF<Right/Left>(k,M,F) +=
+   * st_IncrementalJointPDF<Right/Left>(k,M,F) +=
    *   movingMask<Right/Left>[k] * fixedParzen(F) * movingParzen<Right/Left>(M)[k];
-   * m_PerturbedAlpha<Right/Left>[k] += movingMask<Right/Left>[k] - movingMask;
+   * st_PerturbedAlpha<Right/Left>[k] += movingMask<Right/Left>[k] - movingMask;
    * for all k with nonzero Jacobian.
    */
   JointPDFDerivativesIndexType rindex;
@@ -838,6 +857,11 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   for (unsigned int i = 0; i < nzji.size(); ++i)
   {
     const unsigned int mu = nzji[i];
+    if (mu < firstParameter || mu >= endParameter)
+    {
+      continue;
+    }
+    const unsigned int k = mu - firstParameter;
     const double       maskr = movingMaskValuesRight[i];
     const double       maskl = movingMaskValuesLeft[i];
 
@@ -852,7 +876,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
         movParzenWindowTermRight, movParzenWindowIndexRight, *m_MovingKernel, movingParzenValues.data_block());
 
       /** Initialize index in IncrementalJointPDFRight. */
-      rindex[0] = mu;
+      rindex[0] = k;
       rindex[1] = movParzenWindowIndexRight;
       rindex[2] = fixedImageParzenWindowIndex;
 
@@ -863,7 +887,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
         for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
         {
           const auto fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
-          this->m_IncrementalJointPDFRight->GetPixel(rindex) += fv_mask_mv;
+          incrementalJointPDFRight.GetPixel(rindex) += fv_mask_mv;
           ++(rindex[1]);
         } // end for m
 
@@ -884,7 +908,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
         movParzenWindowTermLeft, movParzenWindowIndexLeft, *m_MovingKernel, movingParzenValues.data_block());
 
       /** Initialize index in IncrementalJointPDFLeft. */
-      lindex[0] = mu;
+      lindex[0] = k;
       lindex[1] = movParzenWindowIndexLeft;
       lindex[2] = fixedImageParzenWindowIndex;
 
@@ -895,7 +919,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
         for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
         {
           const auto fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
-          this->m_IncrementalJointPDFLeft->GetPixel(lindex) += fv_mask_mv;
+          incrementalJointPDFLeft.GetPixel(lindex) += fv_mask_mv;
           ++(lindex[1]);
         } // end for m
 
@@ -906,11 +930,11 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
     } // end if maskl
 
     /** Update the perturbed alphas. */
-    this->m_PerturbedAlphaRight[mu] += (maskr - movingMaskValue);
-    this->m_PerturbedAlphaLeft[mu] += (maskl - movingMaskValue);
+    block.st_PerturbedAlphaRight[k] += (maskr - movingMaskValue);
+    block.st_PerturbedAlphaLeft[k] += (maskl - movingMaskValue);
   } // end for i
 
-} // end UpdateJointPDFAndIncrementalPDFs()
+} // end UpdateIncrementalPDFs()
 
 
 /**
@@ -1308,25 +1332,24 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputePDFsA
 
 
 /**
- * ************************ ComputePDFsAndIncrementalPDFs *******************
+ * ************************ ComputeIncrementalPDFs *******************
  */
 
 template <typename TFixedImage, typename TMovingImage>
 void
-ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputePDFsAndIncrementalPDFs(
-  const ParametersType & parameters) const
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputeIncrementalPDFs(
+  FiniteDifferenceParameterBlockType & block,
+  const ThreadIdType                   threadId) const
 {
   /** Initialize some variables. */
-  this->m_JointPDF->FillBuffer(0.0);
-  this->m_IncrementalJointPDFRight->FillBuffer(0.0);
-  this->m_IncrementalJointPDFLeft->FillBuffer(0.0);
-  this->m_Alpha = 0.0;
-  this->m_PerturbedAlphaRight.Fill(0.0);
-  this->m_PerturbedAlphaLeft.Fill(0.0);
+  block.st_IncrementalJointPDFRight->FillBuffer(0.0);
+  block.st_IncrementalJointPDFLeft->FillBuffer(0.0);
+  block.st_PerturbedAlphaRight.Fill(0.0);
+  block.st_PerturbedAlphaLeft.Fill(0.0);
 
-  Superclass::m_NumberOfPixelsCounted = 0;
-  double       sumOfMovingMaskValues = 0.0;
-  const double delta = this->GetFiniteDifferencePerturbation();
+  const double       delta = this->GetFiniteDifferencePerturbation();
+  const unsigned int firstParameter = block.st_FirstParameter;
+  const unsigned int endParameter = firstParameter + block.st_NumberOfParameters;
 
   /** sparse jacobian+indices. */
   NonZeroJacobianIndicesType nzji(Superclass::m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices());
@@ -1338,20 +1361,12 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputePDFsA
   DerivativeType movingMaskValuesRight(nzji.size());
   DerivativeType movingMaskValuesLeft(nzji.size());
 
-  /** Call non-thread-safe stuff, such as:
-   *   this->SetTransformParameters( parameters );
-   *   this->GetImageSampler()->Update();
-   * Because of these calls GetValueAndDerivative itself is not thread-safe,
-   * so cannot be called multiple times simultaneously.
-   * This is however needed in the CombinationImageToImageMetric.
-   * In that case, you need to:
-   * - switch the use of this function to on, using m_UseMetricSingleThreaded = true
-   * - call BeforeThreadedGetValueAndDerivative once (single-threaded) before
-   *   calling GetValueAndDerivative
-   * - switch the use of this function to off, using m_UseMetricSingleThreaded = false
-   * - Now you can call GetValueAndDerivative multi-threaded.
-   */
-  this->BeforeThreadedGetValueAndDerivative(parameters);
+  /** Moving image evaluation; only the multi-threaded version is safe to call from multiple threads. */
+  const auto evaluateMovingImageValue = [this, threadId](const MovingImagePointType & point, RealType & value) {
+    return Superclass::m_UseMultiThread
+             ? this->FastEvaluateMovingImageValueAndDerivative(point, value, nullptr, threadId)
+             : this->Superclass::EvaluateMovingImageValueAndDerivative(point, value, nullptr);
+  };
 
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
@@ -1362,169 +1377,239 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputePDFsA
     /** Read fixed coordinates. */
     const FixedImagePointType & fixedPoint = fixedImageSample.m_ImageCoordinates;
 
-    /** Transform point and check if it is inside the B-spline support region.
-     * if not, skip this sample.
-     */
+    /** Transform point. */
     const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
 
+    /** Get the fixed image value and make sure the value falls within the histogram range. */
+    auto fixedImageValue = static_cast<RealType>(fixedImageSample.m_ImageValue);
+    fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
+
+    /** Check if the point is inside the moving mask. */
+    bool sampleOk = this->IsInsideMovingMask(mappedPoint);
+    auto movingMaskValue = static_cast<RealType>(static_cast<unsigned char>(sampleOk));
+
+    /** Compute the moving image value M(T(x)) and check if
+     * the point is inside the moving image buffer.
+     */
+    RealType movingImageValue{};
+    if (sampleOk)
     {
-      /** Get the fixed image value and make sure the value falls within the histogram range. */
-      auto fixedImageValue = static_cast<RealType>(fixedImageSample.m_ImageValue);
-      fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
+      sampleOk = evaluateMovingImageValue(mappedPoint, movingImageValue);
+      if (sampleOk)
+      {
+        movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue);
+      }
+    }
 
-      /** Check if the point is inside the moving mask. */
-      bool sampleOk = this->IsInsideMovingMask(mappedPoint);
-      auto movingMaskValue = static_cast<RealType>(static_cast<unsigned char>(sampleOk));
+    /** Stop with this sample. It may be possible that with a perturbed parameter
+     * a valid voxel pair is obtained, but:
+     * - this chance is small,
+     * - quitting now saves a lot of time, especially because this situation
+     *   occurs at border pixels (there are a lot of those)
+     * - if we would analytically compute the gradient the same choice is
+     *   somehow made.
+     * The same choice is made by ComputePDFs(), so m_NumberOfPixelsCounted
+     * equals the sum of the moving mask values of the used samples.
+     */
+    if (!sampleOk)
+    {
+      continue;
+    }
 
-      /** Compute the moving image value M(T(x)) and check if
-       * the point is inside the moving image buffer.
-       */
-      RealType movingImageValue{};
+    /** Get the TransformJacobian dT/dmu. We assume the transform is a linear
+     * function of its parameters, so that we can evaluate T(x;\mu+delta_ek)
+     * as T(x) + delta * dT/dmu_k.
+     */
+    this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
+
+    /** Skip the sample if it does not affect any parameter of this block. */
+    const bool affectsBlock = std::any_of(
+      nzji.begin(), nzji.end(), [firstParameter, endParameter](const unsigned int mu) {
+        return mu >= firstParameter && mu < endParameter;
+      });
+    if (!affectsBlock)
+    {
+      continue;
+    }
+
+    MovingImagePointType mappedPointRight;
+    MovingImagePointType mappedPointLeft;
+
+    /** Loop over all parameters to perturb (parameters in the block with nonzero Jacobian). */
+    for (unsigned int i = 0; i < nzji.size(); ++i)
+    {
+      if (nzji[i] < firstParameter || nzji[i] >= endParameter)
+      {
+        continue;
+      }
+
+      /** Compute the transformed input point after perturbation. */
+      for (unsigned int j = 0; j < MovingImageDimension; ++j)
+      {
+        const double delta_jac = delta * jacobian[j][i];
+        mappedPointRight[j] = mappedPoint[j] + delta_jac;
+        mappedPointLeft[j] = mappedPoint[j] - delta_jac;
+      }
+
+      /** Compute the moving mask 'value' and moving image value at the right perturbed positions. */
+      sampleOk = this->IsInsideMovingMask(mappedPointRight);
+      auto movingMaskValueRight = static_cast<RealType>(static_cast<unsigned char>(sampleOk));
       if (sampleOk)
       {
-        sampleOk = this->Superclass::EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, nullptr);
+        RealType movingImageValueRight = 0.0;
+        sampleOk = evaluateMovingImageValue(mappedPointRight, movingImageValueRight);
         if (sampleOk)
         {
-          movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue);
+          movingImageValueRight = this->GetMovingImageLimiter()->Evaluate(movingImageValueRight);
+          movingImageValuesRight[i] = movingImageValueRight;
         }
         else
         {
           /** this movingImageValueRight is invalid, even though the mask indicated it is valid. */
-          movingMaskValue = 0.0;
+          movingMaskValueRight = 0.0;
         }
       }
+      movingMaskValuesRight[i] = movingMaskValueRight;
 
-      /** Stop with this sample. It may be possible that with a perturbed parameter
-       * a valid voxel pair is obtained, but:
-       * - this chance is small,
-       * - quitting now saves a lot of time, especially because this situation
-       *   occurs at border pixels (there are a lot of those)
-       * - if we would analytically compute the gradient the same choice is
-       *   somehow made.
-       */
-      if (!sampleOk)
+      /** Compute the moving mask and moving image value at the left perturbed positions. */
+      sampleOk = this->IsInsideMovingMask(mappedPointLeft);
+      auto movingMaskValueLeft = static_cast<RealType>(static_cast<unsigned char>(sampleOk));
+      if (sampleOk)
       {
-        continue;
+        RealType movingImageValueLeft = 0.0;
+        sampleOk = evaluateMovingImageValue(mappedPointLeft, movingImageValueLeft);
+        if (sampleOk)
+        {
+          movingImageValueLeft = this->GetMovingImageLimiter()->Evaluate(movingImageValueLeft);
+          movingImageValuesLeft[i] = movingImageValueLeft;
+        }
+        else
+        {
+          /** this movingImageValueLeft is invalid, even though the mask indicated it is valid. */
+          movingMaskValueLeft = 0.0;
+        }
       }
+      movingMaskValuesLeft[i] = movingMaskValueLeft;
 
-      /** Count how many samples were used. */
-      sumOfMovingMaskValues += movingMaskValue;
-      Superclass::m_NumberOfPixelsCounted += static_cast<unsigned int>(sampleOk);
+    } // next parameter to perturb
 
-      /** Get the TransformJacobian dT/dmu. We assume the transform is a linear
-       * function of its parameters, so that we can evaluate T(x;\mu+delta_ek)
-       * as T(x) + delta * dT/dmu_k.
-       */
-      this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
+    /** Update the incremental joint pdfs and the perturbed alpha arrays. */
+    this->UpdateIncrementalPDFs(fixedImageValue,
+                                movingImageValue,
+                                movingMaskValue,
+                                movingImageValuesRight,
+                                movingImageValuesLeft,
+                                movingMaskValuesRight,
+                                movingMaskValuesLeft,
+                                nzji,
+                                block);
 
-      MovingImagePointType mappedPointRight;
-      MovingImagePointType mappedPointLeft;
+  } // end iterating over fixed image spatial sample container for loop
 
-      /** Loop over all parameters to perturb (parameters with nonzero Jacobian). */
-      for (unsigned int i = 0; i < nzji.size(); ++i)
-      {
-        /** Compute the transformed input point after perturbation. */
-        for (unsigned int j = 0; j < MovingImageDimension; ++j)
-        {
-          const double delta_jac = delta * jacobian[j][i];
-          mappedPointRight[j] = mappedPoint[j] + delta_jac;
-          mappedPointLeft[j] = mappedPoint[j] - delta_jac;
-        }
+  /** Compute the perturbed alphas. */
+  const auto sumOfMovingMaskValues = static_cast<double>(Superclass::m_NumberOfPixelsCounted);
+  for (unsigned int k = 0; k < block.st_NumberOfParameters; ++k)
+  {
+    auto & perturbedAlphaRight = block.st_PerturbedAlphaRight[k];
+    auto & perturbedAlphaLeft = block.st_PerturbedAlphaLeft[k];
+    perturbedAlphaRight += sumOfMovingMaskValues;
+    perturbedAlphaLeft += sumOfMovingMaskValues;
+    perturbedAlphaRight = perturbedAlphaRight > 1e-10 ? 1.0 / perturbedAlphaRight : 0.0;
+    perturbedAlphaLeft = perturbedAlphaLeft > 1e-10 ? 1.0 / perturbedAlphaLeft : 0.0;
+  }
 
-        /** Compute the moving mask 'value' and moving image value at the right perturbed positions. */
-        sampleOk = this->IsInsideMovingMask(mappedPointRight);
-        auto movingMaskValueRight = static_cast<RealType>(static_cast<unsigned char>(sampleOk));
-        if (sampleOk)
-        {
-          RealType movingImageValueRight = 0.0;
-          sampleOk =
-            this->Superclass::EvaluateMovingImageValueAndDerivative(mappedPointRight, movingImageValueRight, nullptr);
-          if (sampleOk)
-          {
-            movingImageValueRight = this->GetMovingImageLimiter()->Evaluate(movingImageValueRight);
-            movingImageValuesRight[i] = movingImageValueRight;
-          }
-          else
-          {
-            /** this movingImageValueRight is invalid, even though the mask indicated it is valid. */
-            movingMaskValueRight = 0.0;
-          }
-        }
-        movingMaskValuesRight[i] = movingMaskValueRight;
+  /** Compute the fixed and moving incremental marginal pdfs by summing over the
+   * incremental histogram. Do it for Right and Left.
+   */
+  this->ComputeIncrementalMarginalPDFs(block.st_IncrementalJointPDFRight,
+                                       block.st_FixedIncrementalMarginalPDFRight,
+                                       block.st_MovingIncrementalMarginalPDFRight);
+  this->ComputeIncrementalMarginalPDFs(block.st_IncrementalJointPDFLeft,
+                                       block.st_FixedIncrementalMarginalPDFLeft,
+                                       block.st_MovingIncrementalMarginalPDFLeft);
 
-        /** Compute the moving mask and moving image value at the left perturbed positions. */
-        sampleOk = this->IsInsideMovingMask(mappedPointLeft);
-        auto movingMaskValueLeft = static_cast<RealType>(static_cast<unsigned char>(sampleOk));
-        if (sampleOk)
-        {
-          RealType movingImageValueLeft = 0.0;
-          sampleOk =
-            this->Superclass::EvaluateMovingImageValueAndDerivative(mappedPointLeft, movingImageValueLeft, nullptr);
-          if (sampleOk)
-          {
-            movingImageValueLeft = this->GetMovingImageLimiter()->Evaluate(movingImageValueLeft);
-            movingImageValuesLeft[i] = movingImageValueLeft;
-          }
-          else
-          {
-            /** this movingImageValueLeft is invalid, even though the mask indicated it is valid. */
-            movingMaskValueLeft = 0.0;
-          }
-        }
-        movingMaskValuesLeft[i] = movingMaskValueLeft;
+} // end ComputeIncrementalPDFs()
 
-      } // next parameter to perturb
 
-      /** Update the joint pdf and the incremental joint pdfs, and the
-       * perturbed alpha arrays.
-       */
-      this->UpdateJointPDFAndIncrementalPDFs(fixedImageValue,
-                                             movingImageValue,
-                                             movingMaskValue,
-                                             movingImageValuesRight,
-                                             movingImageValuesLeft,
-                                             movingMaskValuesRight,
-                                             movingMaskValuesLeft,
-                                             nzji);
+/**
+ * ************************ ComputeFiniteDifferenceDerivative *******************
+ */
 
-    } // end if-block check sampleOk
-  } // end iterating over fixed image spatial sample container for loop
+template <typename TFixedImage, typename TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputeFiniteDifferenceDerivative(
+  DerivativeType & derivative) const
+{
+  if (!Superclass::m_UseMultiThread)
+  {
+    this->ThreadedComputeFiniteDifferenceDerivative(0, derivative);
+    return;
+  }
 
-  /** Check if enough samples were valid. */
-  this->CheckNumberOfSamples();
+  /** Setup threader and launch. */
+  ParzenWindowHistogramMultiThreaderParameterType userData{ const_cast<Self *>(this), &derivative };
+  this->m_Threader->SetSingleMethodAndExecute(this->ComputeFiniteDifferenceDerivativeThreaderCallback, &userData);
 
-  /** Compute alpha and its perturbed versions. */
-  this->m_Alpha = 0.0;
-  if (sumOfMovingMaskValues > 1e-14)
+} // end ComputeFiniteDifferenceDerivative()
+
+
+/**
+ * ******************* ThreadedComputeFiniteDifferenceDerivative *******************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComputeFiniteDifferenceDerivative(
+  const ThreadIdType threadId,
+  DerivativeType &   derivative) const
+{
+  /** Each work unit has its own buffers, and processes every n-th block. */
+  const auto numberOfBlockBuffers = static_cast<ThreadIdType>(this->m_FiniteDifferenceParameterBlocks.size());
+  if (threadId >= numberOfBlockBuffers)
   {
-    this->m_Alpha = 1.0 / sumOfMovingMaskValues;
+    return;
   }
+  const ThreadIdType numberOfWorkUnits =
+    Superclass::m_UseMultiThread ? std::min(Self::GetNumberOfWorkUnits(), numberOfBlockBuffers) : 1;
 
-  const auto numberOfParameters = this->GetNumberOfParameters();
+  FiniteDifferenceParameterBlockType & block = this->m_FiniteDifferenceParameterBlocks[threadId];
+  const auto                           numberOfParameters = static_cast<unsigned int>(this->GetNumberOfParameters());
+  const unsigned int                   blockSize = this->m_FiniteDifferenceParameterBlockSize;
 
-  for (unsigned int i = 0; i < numberOfParameters; ++i)
+  for (unsigned int firstParameter = threadId * blockSize; firstParameter < numberOfParameters;
+       firstParameter += numberOfWorkUnits * blockSize)
   {
-    this->m_PerturbedAlphaRight[i] += sumOfMovingMaskValues;
-    this->m_PerturbedAlphaLeft[i] += sumOfMovingMaskValues;
-    if (this->m_PerturbedAlphaRight[i] > 1e-10)
-    {
-      this->m_PerturbedAlphaRight[i] = 1.0 / this->m_PerturbedAlphaRight[i];
-    }
-    else
-    {
-      this->m_PerturbedAlphaRight[i] = 0.0;
-    }
-    if (this->m_PerturbedAlphaLeft[i] > 1e-10)
-    {
-      this->m_PerturbedAlphaLeft[i] = 1.0 / this->m_PerturbedAlphaLeft[i];
-    }
-    else
-    {
-      this->m_PerturbedAlphaLeft[i] = 0.0;
-    }
+    block.st_FirstParameter = firstParameter;
+    block.st_NumberOfParameters = std::min(blockSize, numberOfParameters - firstParameter);
+
+    this->ComputeIncrementalPDFs(block, threadId);
+    this->UpdateFiniteDifferenceDerivative(block, derivative);
   }
 
-} // end ComputePDFsAndIncrementalPDFs()
+} // end ThreadedComputeFiniteDifferenceDerivative()
+
+
+/**
+ * **************** ComputeFiniteDifferenceDerivativeThreaderCallback *******
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ComputeFiniteDifferenceDerivativeThreaderCallback(
+  void * arg)
+{
+  assert(arg);
+  const auto & infoStruct = *static_cast<ThreadInfoType *>(arg);
+  ThreadIdType threadId = infoStruct.WorkUnitID;
+
+  assert(infoStruct.UserData);
+  const auto & userData = *static_cast<ParzenWindowHistogramMultiThreaderParameterType *>(infoStruct.UserData);
+
+  userData.m_Metric->ThreadedComputeFiniteDifferenceDerivative(threadId, *userData.m_Derivative);
+
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end ComputeFiniteDifferenceDerivativeThreaderCallback()
 
 
 } // end namespace itk
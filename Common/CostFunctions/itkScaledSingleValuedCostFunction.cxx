@@ -37,6 +37,8 @@ ScaledSingleValuedCostFunction::GetValue(const ParametersType & parameters) cons
 {
   /** F(y)= f(y/s) */
 
+  const elastix::ProfilerScope profilerScope(m_Profiler, "CostFunction::GetValue");
+
   /** This function also checks if the UnscaledCostFunction has been set */
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   if (parameters.GetSize() != numberOfParameters)
@@ -75,6 +77,8 @@ ScaledSingleValuedCostFunction::GetDerivative(const ParametersType & parameters,
 {
   /** dF/dy(y)= 1/s * df/dx(y/s) */
 
+  const elastix::ProfilerScope profilerScope(m_Profiler, "CostFunction::GetDerivative");
+
   /** This function also checks if the UnscaledCostFunction has been set */
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   if (parameters.GetSize() != numberOfParameters)
@@ -119,6 +123,8 @@ ScaledSingleValuedCostFunction::GetValueAndDerivative(const ParametersType & par
   /** F(y)= f(y/s) */
   /** dF/dy(y)= 1/s * df/dx(y/s) */
 
+  const elastix::ProfilerScope profilerScope(m_Profiler, "CostFunction::GetValueAndDerivative");
+
   /** This function also checks if the UnscaledCostFunction has been set */
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   if (parameters.GetSize() != numberOfParameters)
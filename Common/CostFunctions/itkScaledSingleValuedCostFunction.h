@@ -21,6 +21,7 @@
 
 #include "itkSingleValuedCostFunction.h"
 #include "itkIntTypes.h" //temp, needed for IdentifierType
+#include "elxProfiler.h"
 
 namespace itk
 {
@@ -124,6 +125,14 @@ public:
   /** Get the flag to negate the cost function or not. */
   itkGetConstMacro(NegateCostFunction, bool);
 
+  /** Set the profiler that measures the cost function evaluations. When it is null (the default), or when it is
+   * disabled, nothing is measured. */
+  void
+  SetProfiler(elastix::Profiler * const profiler)
+  {
+    m_Profiler = profiler;
+  }
+
   /** Convert the parameters from scaled to unscaled: x = y/s. */
   virtual void
   ConvertScaledToUnscaledParameters(ParametersType & parameters) const;
@@ -149,6 +158,7 @@ private:
   SingleValuedCostFunctionPointer m_UnscaledCostFunction{ nullptr };
   bool                            m_UseScales{ false };
   bool                            m_NegateCostFunction{ false };
+  elastix::Profiler *             m_Profiler{ nullptr };
 };
 
 } // end namespace itk
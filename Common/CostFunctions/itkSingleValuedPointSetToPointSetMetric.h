@@ -40,6 +40,10 @@
 #include "itkImageMaskSpatialObject.h"
 #include "itkPointSet.h"
 #include "itkDeref.h"
+#include <itkMultiThreaderBase.h>
+
+#include <memory> // For unique_ptr.
+#include <vector>
 
 namespace itk
 {
@@ -169,6 +173,24 @@ public:
   itkGetConstReferenceMacro(UseMetricSingleThreaded, bool);
   itkBooleanMacro(UseMetricSingleThreaded);
 
+  /** Select whether the points are processed by multiple threads, by the metrics that support it. */
+  itkSetMacro(UseMultiThread, bool);
+  itkGetConstReferenceMacro(UseMultiThread, bool);
+  itkBooleanMacro(UseMultiThread);
+
+  /** Set/Get the number of work units over which the points are distributed. */
+  void
+  SetNumberOfWorkUnits(const ThreadIdType numberOfWorkUnits)
+  {
+    this->m_Threader->SetNumberOfWorkUnits(numberOfWorkUnits);
+  }
+
+  ThreadIdType
+  GetNumberOfWorkUnits() const
+  {
+    return this->m_Threader->GetNumberOfWorkUnits();
+  }
+
 protected:
   SingleValuedPointSetToPointSetMetric() = default;
   ~SingleValuedPointSetToPointSetMetric() override = default;
@@ -201,6 +223,48 @@ protected:
     return Deref(m_MovingPointSet->GetPoints()).CastToSTLConstContainer();
   }
 
+  /** The contributions of a contiguous chunk of points to the measure and its derivative. The derivative is stored in
+   * blocks of parameters that are only allocated when touched, so that each work unit only needs memory for the
+   * parameters that affect its points, for transforms with a compact support.
+   */
+  struct PointContributionsType
+  {
+    MeasureType                                         measure{};
+    SizeValueType                                       numberOfPointsCounted{};
+    std::vector<std::unique_ptr<DerivativeValueType[]>> derivativeBlocks{};
+
+    void
+    AddToDerivative(const unsigned int parameterIndex, const DerivativeValueType value)
+    {
+      auto & block = derivativeBlocks[parameterIndex >> DerivativeBlockSizeLog2];
+      if (block == nullptr)
+      {
+        // Value-initialized, so filled with zeros.
+        block = std::make_unique<DerivativeValueType[]>(DerivativeBlockSize);
+      }
+      block[parameterIndex & (DerivativeBlockSize - 1)] += value;
+    }
+  };
+
+  /** Calls function(index) for each index in [0, numberOfIndices), distributed over the work units when
+   * multi-threading is enabled. The calls for different indices must be independent.
+   */
+  template <typename TFunction>
+  void
+  ParallelizeOverIndices(const SizeValueType numberOfIndices, TFunction && function) const;
+
+  /** Divides the point indices [0, numberOfPoints) into contiguous chunks, one per work unit (or a single chunk, when
+   * multi-threading is disabled), and calls accumulateChunk(beginIndex, endIndex, contributions) for each chunk, with
+   * its own contributions. The contributions of the chunks are then added in chunk order, which makes the result
+   * independent of the scheduling of the threads. Adds the derivative contributions to the derivative, when it is not
+   * null, sets m_NumberOfPointsCounted, and returns the measure.
+   */
+  template <typename TAccumulateChunk>
+  MeasureType
+  AccumulatePointContributions(const SizeValueType numberOfPoints,
+                               DerivativeType *    derivative,
+                               TAccumulateChunk && accumulateChunk) const;
+
   /** Member variables. */
   FixedPointSetConstPointer   m_FixedPointSet{ nullptr };
   MovingPointSetConstPointer  m_MovingPointSet{ nullptr };
@@ -211,7 +275,13 @@ protected:
   mutable unsigned int m_NumberOfPointsCounted{ 0 };
 
   /** Variables for multi-threading. */
-  bool m_UseMetricSingleThreaded{ true };
+  bool                       m_UseMetricSingleThreaded{ true };
+  bool                       m_UseMultiThread{ false };
+  MultiThreaderBase::Pointer m_Threader{ MultiThreaderBase::New() };
+
+private:
+  static constexpr unsigned int DerivativeBlockSizeLog2{ 8 };
+  static constexpr unsigned int DerivativeBlockSize{ 1u << DerivativeBlockSizeLog2 };
 };
 
 } // end namespace itk
@@ -34,6 +34,7 @@
 #define itkSingleValuedPointSetToPointSetMetric_hxx
 
 #include "itkSingleValuedPointSetToPointSetMetric.h"
+#include <algorithm> // For max and min.
 
 namespace itk
 {
@@ -106,6 +107,100 @@ SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::BeforeThr
 } // end BeforeThreadedGetValueAndDerivative()
 
 
+/**
+ * *********************** ParallelizeOverIndices ***********************
+ */
+
+template <typename TFixedPointSet, typename TMovingPointSet>
+template <typename TFunction>
+void
+SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::ParallelizeOverIndices(
+  const SizeValueType numberOfIndices,
+  TFunction &&        function) const
+{
+  if (this->m_UseMultiThread && numberOfIndices > 1)
+  {
+    this->m_Threader->ParallelizeArray(0, numberOfIndices, function, nullptr);
+  }
+  else
+  {
+    for (SizeValueType index = 0; index < numberOfIndices; ++index)
+    {
+      function(index);
+    }
+  }
+
+} // end ParallelizeOverIndices()
+
+
+/**
+ * *********************** AccumulatePointContributions ***********************
+ */
+
+template <typename TFixedPointSet, typename TMovingPointSet>
+template <typename TAccumulateChunk>
+auto
+SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::AccumulatePointContributions(
+  const SizeValueType numberOfPoints,
+  DerivativeType *    derivative,
+  TAccumulateChunk && accumulateChunk) const -> MeasureType
+{
+  const unsigned int  numberOfParameters = this->GetNumberOfParameters();
+  const SizeValueType numberOfBlocks = (numberOfParameters + DerivativeBlockSize - 1) >> DerivativeBlockSizeLog2;
+
+  /** The chunks do not depend on the scheduling of the threads, only on the number of work units. */
+  const SizeValueType numberOfChunks =
+    this->m_UseMultiThread
+      ? std::max(SizeValueType{ 1 }, std::min<SizeValueType>(this->m_Threader->GetNumberOfWorkUnits(), numberOfPoints))
+      : 1;
+
+  std::vector<PointContributionsType> contributionsPerChunk(numberOfChunks);
+
+  this->ParallelizeOverIndices(
+    numberOfChunks,
+    [numberOfPoints, numberOfChunks, numberOfBlocks, &contributionsPerChunk, &accumulateChunk](
+      const SizeValueType chunkIndex) {
+      PointContributionsType & contributions = contributionsPerChunk[chunkIndex];
+      contributions.derivativeBlocks.resize(numberOfBlocks);
+      accumulateChunk(chunkIndex * numberOfPoints / numberOfChunks,
+                      (chunkIndex + 1) * numberOfPoints / numberOfChunks,
+                      contributions);
+    });
+
+  /** Add the contributions in chunk order. */
+  MeasureType measure{};
+  this->m_NumberOfPointsCounted = 0;
+  for (const PointContributionsType & contributions : contributionsPerChunk)
+  {
+    measure += contributions.measure;
+    this->m_NumberOfPointsCounted += contributions.numberOfPointsCounted;
+  }
+
+  if (derivative != nullptr)
+  {
+    /** Each block of the derivative is reduced independently, by adding the blocks of the chunks in chunk order. */
+    this->ParallelizeOverIndices(
+      numberOfBlocks, [numberOfParameters, derivative, &contributionsPerChunk](const SizeValueType blockIndex) {
+        const SizeValueType beginIndex = blockIndex << DerivativeBlockSizeLog2;
+        const SizeValueType blockSize = std::min<SizeValueType>(DerivativeBlockSize, numberOfParameters - beginIndex);
+
+        for (const PointContributionsType & contributions : contributionsPerChunk)
+        {
+          if (const auto & block = contributions.derivativeBlocks[blockIndex])
+          {
+            for (SizeValueType i = 0; i < blockSize; ++i)
+            {
+              (*derivative)[beginIndex + i] += block[i];
+            }
+          }
+        }
+      });
+  }
+  return measure;
+
+} // end AccumulatePointContributions()
+
+
 /**
  * ******************* PrintSelf ***********************
  */
@@ -121,6 +216,7 @@ SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::PrintSelf
   os << "Fixed mask: " << this->m_FixedImageMask.GetPointer() << std::endl;
   os << "Moving mask: " << this->m_MovingImageMask.GetPointer() << std::endl;
   os << "Transform: " << this->m_Transform.GetPointer() << std::endl;
+  os << "UseMultiThread: " << this->m_UseMultiThread << std::endl;
 
 } // end PrintSelf()
 
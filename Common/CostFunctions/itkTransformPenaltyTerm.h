@@ -24,6 +24,9 @@
 #include "itkAdvancedBSplineDeformableTransform.h"
 #include "itkAdvancedCombinationTransform.h"
 
+#include <array>
+#include <vector>
+
 namespace itk
 {
 /**
@@ -38,6 +41,15 @@ namespace itk
  * Therefore, the transformation is required to be of itk::AdvancedTransform
  * type.
  *
+ * When the B-spline weight cache is enabled (SetUseBSplineWeightCache), a penalty term that evaluates a spatial
+ * derivative of the transform at its samples may cache the coefficient-independent part of the Jacobian of that
+ * derivative for each sample instead, see GetSampleDerivativeOrder(). For a B-spline transform, these are the
+ * (derivatives of the) B-spline weights, which do not change during a resolution when the sampler selects the same
+ * samples in each iteration. The evaluation of the penalty term then reduces to sparse products of the cached data with
+ * the current coefficients. With an initial transform, the cached Jacobian includes the initial transform, and the
+ * spatial derivative of the displacement of the initial transform is cached as well, as a coefficient-independent
+ * offset.
+ *
  * \ingroup Metrics
  */
 
@@ -91,6 +103,7 @@ public:
   using typename Superclass::ImageSampleContainerType;
   using typename Superclass::ImageSampleContainerPointer;
   using typename Superclass::ThreadInfoType;
+  using typename Superclass::NumberOfParametersType;
 
   /** Typedef's for the B-spline transform. */
   using typename Superclass::CombinationTransformType;
@@ -134,6 +147,66 @@ protected:
   /** A function to check if the transform is B-spline, for speedup. */
   virtual bool
   CheckForBSplineTransform2(BSplineOrder3TransformPointer & bspline) const;
+
+  /** A buffer for a spatial derivative of all transform components at a sample, as computed by
+   * ComputeCachedSampleDerivative(). Large enough for the spatial Hessians.
+   */
+  using CachedSampleDerivativeType =
+    std::array<double, FixedImageDimension * FixedImageDimension * FixedImageDimension>;
+
+  /** Returns the order of the spatial derivative of the transform that the penalty term evaluates at its samples: 0 for
+   * the displacement, 1 for the spatial Jacobian and 2 for the spatial Hessian. Returns a negative number by default,
+   * which means that the penalty term does not use the sample derivative cache.
+   */
+  virtual int
+  GetSampleDerivativeOrder() const
+  {
+    return -1;
+  }
+
+  /** Builds the sample derivative cache, when requested, for a penalty term that specifies its sample derivative
+   * order. For other penalty terms, it builds the weight cache of the B-spline transform, just like the superclass.
+   */
+  void
+  InitializeBSplineWeightCache() override;
+
+  /** Returns whether the sample derivative cache is built for the specified samples. */
+  bool
+  SampleDerivativeCacheIsUsable(const ImageSampleContainerType & samples) const;
+
+  /** Computes the spatial derivative of the displacement at the sample with the specified index, from the sample
+   * derivative cache and the specified parameters. The derivative of transform component k is stored at
+   * result[k * FixedImageDimension^order], as a (row-major) vector, row of the spatial Jacobian, or spatial Hessian.
+   */
+  void
+  ComputeCachedSampleDerivative(const SizeValueType    sampleIndex,
+                                const ParametersType & parameters,
+                                double * const         result) const;
+
+  /** Adds the inner product of the specified gradient and the Jacobian of the spatial derivative at the sample with the
+   * specified index to the derivative. The gradient is laid out like the result of ComputeCachedSampleDerivative().
+   */
+  void
+  AddCachedSampleDerivativeProduct(const SizeValueType  sampleIndex,
+                                   const double * const gradient,
+                                   DerivativeType &     derivative) const;
+
+private:
+  /** The sample derivative cache: for each sample, the indices of the parameters of the first transform component that
+   * affect the sample, and the corresponding blocks of FixedImageDimension^order derivative weights. The weights are
+   * the same for the other transform components, whose parameters follow those of the first component.
+   */
+  unsigned int                                                 m_CachedDerivativeBlockSize{ 0 };
+  unsigned int                                                 m_NumberOfCachedWeightsPerSample{ 0 };
+  SizeValueType                                                m_NumberOfCachedSamples{ 0 };
+  SizeValueType                                                m_NumberOfParametersPerDimension{ 0 };
+  std::vector<typename NonZeroJacobianIndicesType::value_type> m_CachedParameterIndices{};
+  std::vector<double>                                          m_CachedSampleDerivatives{};
+
+  /** Only when there is an initial transform: for each sample, the spatial derivative of the displacement of the
+   * initial transform, laid out like the result of ComputeCachedSampleDerivative().
+   */
+  std::vector<double> m_CachedSampleOffsets{};
 };
 
 } // end namespace itk
@@ -20,6 +20,8 @@
 
 #include "itkTransformPenaltyTerm.h"
 
+#include <algorithm> // For copy_n and fill_n.
+
 namespace itk
 {
 
@@ -63,6 +65,272 @@ TransformPenaltyTerm<TFixedImage, TScalarType>::CheckForBSplineTransform2(BSplin
 } // end CheckForBSplineTransform()
 
 
+/**
+ * ****************** InitializeBSplineWeightCache *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+void
+TransformPenaltyTerm<TFixedImage, TScalarType>::InitializeBSplineWeightCache()
+{
+  /** Release the cache of the previous resolution. */
+  m_CachedDerivativeBlockSize = 0;
+  m_NumberOfCachedWeightsPerSample = 0;
+  m_NumberOfCachedSamples = 0;
+  m_CachedParameterIndices = {};
+  m_CachedSampleDerivatives = {};
+  m_CachedSampleOffsets = {};
+
+  const int derivativeOrder = this->GetSampleDerivativeOrder();
+  if (derivativeOrder < 0)
+  {
+    return this->Superclass::InitializeBSplineWeightCache();
+  }
+  if (derivativeOrder > 2)
+  {
+    itkExceptionMacro("The sample derivative cache does not support derivatives of order " << derivativeOrder << '.');
+  }
+
+  Superclass::m_BSplineWeightCacheSize = 0;
+  Superclass::m_BSplineWeightCacheIsBuilt = false;
+
+  /** The cache only pays off when the same samples are used in each iteration. */
+  if (!this->GetUseBSplineWeightCache() || !this->GetUseImageSampler() ||
+      Superclass::m_ImageSampler->SelectingNewSamplesOnUpdateSupported() || !Superclass::m_TransformIsBSpline)
+  {
+    return;
+  }
+
+  /** With an initial transform, the spatial derivative of the displacement is affine in the coefficients, rather than
+   * linear. Its Jacobian is obtained from the combination transform, which includes the (spatial derivatives of the)
+   * initial transform. The coefficient-independent part is the spatial derivative of the displacement of the initial
+   * transform itself, which is cached as an offset per sample.
+   */
+  const TransformType * initialTransform = nullptr;
+  if (const auto * const combinationTransform =
+        dynamic_cast<const CombinationTransformType *>(Superclass::m_AdvancedTransform.GetPointer()))
+  {
+    initialTransform = combinationTransform->GetInitialTransform();
+  }
+
+  const TransformType &        transform = *(Superclass::m_AdvancedTransform);
+  const NumberOfParametersType numberOfNonZeroJacobianIndices = transform.GetNumberOfNonZeroJacobianIndices();
+  const unsigned int           numberOfWeights = numberOfNonZeroJacobianIndices / FixedImageDimension;
+  unsigned int                 blockSize = 1;
+  for (int i = 0; i < derivativeOrder; ++i)
+  {
+    blockSize *= FixedImageDimension;
+  }
+
+  Superclass::m_ImageSampler->Update();
+  const ImageSampleContainerType & samples = *(Superclass::m_ImageSampler->GetOutput());
+  const SizeValueType              numberOfSamples = samples.size();
+
+  /** Only build the cache when it does not exceed the maximum size. */
+  const SizeValueType numberOfOffsetsPerSample = (initialTransform == nullptr) ? 0 : FixedImageDimension * blockSize;
+  Superclass::m_BSplineWeightCacheSize =
+    numberOfSamples * (numberOfWeights * (blockSize * sizeof(double) +
+                                          sizeof(typename NonZeroJacobianIndicesType::value_type)) +
+                       numberOfOffsetsPerSample * sizeof(double));
+  if (Superclass::m_BSplineWeightCacheSize > this->GetMaximumBSplineWeightCacheSize())
+  {
+    return;
+  }
+
+  m_CachedParameterIndices.resize(numberOfSamples * numberOfWeights);
+  m_CachedSampleDerivatives.resize(numberOfSamples * numberOfWeights * blockSize);
+  m_CachedSampleOffsets.resize(numberOfSamples * numberOfOffsetsPerSample);
+
+  TransformJacobianType         jacobian(FixedImageDimension, numberOfNonZeroJacobianIndices);
+  JacobianOfSpatialJacobianType jacobianOfSpatialJacobian(numberOfNonZeroJacobianIndices);
+  JacobianOfSpatialHessianType  jacobianOfSpatialHessian(numberOfNonZeroJacobianIndices);
+  NonZeroJacobianIndicesType    nonZeroJacobianIndices(numberOfNonZeroJacobianIndices);
+  SpatialJacobianType           spatialJacobian;
+  SpatialHessianType            spatialHessian;
+
+  /** For a B-spline transform, the first numberOfWeights nonzero Jacobian indices are those of the first transform
+   * component, and only the first row (or matrix) of their derivatives is nonzero.
+   */
+  for (SizeValueType sampleIndex = 0; sampleIndex < numberOfSamples; ++sampleIndex)
+  {
+    const FixedImagePointType & fixedPoint = samples[sampleIndex].m_ImageCoordinates;
+    double * const derivatives = m_CachedSampleDerivatives.data() + sampleIndex * numberOfWeights * blockSize;
+
+    switch (derivativeOrder)
+    {
+      case 0:
+        // GetJacobian does not reset the Jacobian for a point outside the valid region.
+        jacobian.fill(0.0);
+        transform.GetJacobian(fixedPoint, jacobian, nonZeroJacobianIndices);
+        for (unsigned int mu = 0; mu < numberOfWeights; ++mu)
+        {
+          derivatives[mu] = jacobian(0, mu);
+        }
+        break;
+      case 1:
+        transform.GetJacobianOfSpatialJacobian(fixedPoint, jacobianOfSpatialJacobian, nonZeroJacobianIndices);
+        for (unsigned int mu = 0; mu < numberOfWeights; ++mu)
+        {
+          for (unsigned int j = 0; j < FixedImageDimension; ++j)
+          {
+            derivatives[mu * blockSize + j] = jacobianOfSpatialJacobian[mu](0, j);
+          }
+        }
+        break;
+      default:
+        transform.GetJacobianOfSpatialHessian(fixedPoint, jacobianOfSpatialHessian, nonZeroJacobianIndices);
+        for (unsigned int mu = 0; mu < numberOfWeights; ++mu)
+        {
+          std::copy_n(
+            jacobianOfSpatialHessian[mu][0].GetVnlMatrix().data_block(), blockSize, derivatives + mu * blockSize);
+        }
+        break;
+    }
+    std::copy_n(nonZeroJacobianIndices.cbegin(),
+                numberOfWeights,
+                m_CachedParameterIndices.begin() + sampleIndex * numberOfWeights);
+
+    if (initialTransform == nullptr)
+    {
+      continue;
+    }
+
+    /** The spatial derivative of the displacement of the initial transform, laid out like the result of
+     * ComputeCachedSampleDerivative().
+     */
+    double * const offsets = m_CachedSampleOffsets.data() + sampleIndex * numberOfOffsetsPerSample;
+    switch (derivativeOrder)
+    {
+      case 0:
+      {
+        const auto mappedPoint = initialTransform->TransformPoint(fixedPoint);
+        for (unsigned int k = 0; k < FixedImageDimension; ++k)
+        {
+          offsets[k] = mappedPoint[k] - fixedPoint[k];
+        }
+        break;
+      }
+      case 1:
+        initialTransform->GetSpatialJacobian(fixedPoint, spatialJacobian);
+        for (unsigned int k = 0; k < FixedImageDimension; ++k)
+        {
+          for (unsigned int j = 0; j < FixedImageDimension; ++j)
+          {
+            offsets[k * blockSize + j] = spatialJacobian(k, j) - (k == j ? 1.0 : 0.0);
+          }
+        }
+        break;
+      default:
+        initialTransform->GetSpatialHessian(fixedPoint, spatialHessian);
+        for (unsigned int k = 0; k < FixedImageDimension; ++k)
+        {
+          std::copy_n(spatialHessian[k].GetVnlMatrix().data_block(), blockSize, offsets + k * blockSize);
+        }
+        break;
+    }
+  }
+
+  m_CachedDerivativeBlockSize = blockSize;
+  m_NumberOfCachedWeightsPerSample = numberOfWeights;
+  m_NumberOfCachedSamples = numberOfSamples;
+  m_NumberOfParametersPerDimension = transform.GetNumberOfParameters() / FixedImageDimension;
+  Superclass::m_BSplineWeightCacheIsBuilt = true;
+
+} // end InitializeBSplineWeightCache()
+
+
+/**
+ * ****************** SampleDerivativeCacheIsUsable *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+bool
+TransformPenaltyTerm<TFixedImage, TScalarType>::SampleDerivativeCacheIsUsable(
+  const ImageSampleContainerType & samples) const
+{
+  return m_CachedDerivativeBlockSize > 0 && samples.size() == m_NumberOfCachedSamples;
+
+} // end SampleDerivativeCacheIsUsable()
+
+
+/**
+ * ****************** ComputeCachedSampleDerivative *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+void
+TransformPenaltyTerm<TFixedImage, TScalarType>::ComputeCachedSampleDerivative(const SizeValueType    sampleIndex,
+                                                                             const ParametersType & parameters,
+                                                                             double * const         result) const
+{
+  const SizeValueType first = sampleIndex * m_NumberOfCachedWeightsPerSample;
+  const auto * const  parameterIndices = m_CachedParameterIndices.data() + first;
+  const double *      derivatives = m_CachedSampleDerivatives.data() + first * m_CachedDerivativeBlockSize;
+  const unsigned int  blockSize = m_CachedDerivativeBlockSize;
+
+  /** Start from the part that does not depend on the coefficients: zero, unless there is an initial transform. */
+  if (m_CachedSampleOffsets.empty())
+  {
+    std::fill_n(result, FixedImageDimension * blockSize, 0.0);
+  }
+  else
+  {
+    std::copy_n(m_CachedSampleOffsets.data() + sampleIndex * FixedImageDimension * blockSize,
+                FixedImageDimension * blockSize,
+                result);
+  }
+
+  /** Multiply the sparse Jacobian of the derivative by the parameters. */
+  for (unsigned int mu = 0; mu < m_NumberOfCachedWeightsPerSample; ++mu, derivatives += blockSize)
+  {
+    for (unsigned int k = 0; k < FixedImageDimension; ++k)
+    {
+      const double   parameter = parameters[parameterIndices[mu] + k * m_NumberOfParametersPerDimension];
+      double * const resultOfComponent = result + k * blockSize;
+      for (unsigned int e = 0; e < blockSize; ++e)
+      {
+        resultOfComponent[e] += derivatives[e] * parameter;
+      }
+    }
+  }
+
+} // end ComputeCachedSampleDerivative()
+
+
+/**
+ * ****************** AddCachedSampleDerivativeProduct *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+void
+TransformPenaltyTerm<TFixedImage, TScalarType>::AddCachedSampleDerivativeProduct(const SizeValueType  sampleIndex,
+                                                                                const double * const gradient,
+                                                                                DerivativeType &     derivative) const
+{
+  const SizeValueType first = sampleIndex * m_NumberOfCachedWeightsPerSample;
+  const auto * const  parameterIndices = m_CachedParameterIndices.data() + first;
+  const double *      derivatives = m_CachedSampleDerivatives.data() + first * m_CachedDerivativeBlockSize;
+  const unsigned int  blockSize = m_CachedDerivativeBlockSize;
+
+  /** Multiply the gradient by the transpose of the sparse Jacobian of the derivative. */
+  for (unsigned int mu = 0; mu < m_NumberOfCachedWeightsPerSample; ++mu, derivatives += blockSize)
+  {
+    for (unsigned int k = 0; k < FixedImageDimension; ++k)
+    {
+      const double * const gradientOfComponent = gradient + k * blockSize;
+
+      double product = 0.0;
+      for (unsigned int e = 0; e < blockSize; ++e)
+      {
+        product += derivatives[e] * gradientOfComponent[e];
+      }
+      derivative[parameterIndices[mu] + k * m_NumberOfParametersPerDimension] += product;
+    }
+  }
+
+} // end AddCachedSampleDerivativeProduct()
+
+
 } // end namespace itk
 
 #endif // #ifndef itkTransformPenaltyTerm_hxx
@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "elxDerivedDataCache.h"
+#include "GTesting/elxCoreMainGTestUtilities.h"
+#include <itkImage.h>
+#include <gtest/gtest.h>
+
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::CreateImage;
+
+
+// Tests that RetrieveOrCreate only calls the create function when there is no entry for the kind of data, the source
+// object (including its modification time) and the parameters.
+GTEST_TEST(DerivedDataCache, RetrieveOrCreate)
+{
+  using ImageType = itk::Image<unsigned char, 2>;
+
+  const auto cache = CheckNew<elx::DerivedDataCache>();
+  const auto source = CreateImage<unsigned char>(itk::Size<2>::Filled(4));
+
+  unsigned int numberOfCreations{};
+  const auto   create = [&numberOfCreations] {
+    ++numberOfCreations;
+    return ImageType::New();
+  };
+
+  const auto created = cache->RetrieveOrCreate<ImageType>("kind", *source, "parameters", create);
+  EXPECT_EQ(numberOfCreations, 1U);
+  EXPECT_EQ(cache->GetNumberOfHits(), 0U);
+
+  EXPECT_EQ(cache->RetrieveOrCreate<ImageType>("kind", *source, "parameters", create), created);
+  EXPECT_EQ(numberOfCreations, 1U);
+  EXPECT_EQ(cache->GetNumberOfHits(), 1U);
+  EXPECT_GE(cache->GetSavedTimeInSeconds(), 0.0);
+
+  EXPECT_NE(cache->RetrieveOrCreate<ImageType>("other kind", *source, "parameters", create), created);
+  EXPECT_NE(cache->RetrieveOrCreate<ImageType>("kind", *source, "other parameters", create), created);
+  EXPECT_EQ(numberOfCreations, 3U);
+
+  // After a modification of the source, its derived data must be computed again.
+  source->Modified();
+  EXPECT_NE(cache->RetrieveOrCreate<ImageType>("kind", *source, "parameters", create), created);
+  EXPECT_EQ(numberOfCreations, 4U);
+  EXPECT_EQ(cache->GetNumberOfHits(), 1U);
+  EXPECT_EQ(cache->GetNumberOfEntries(), 4U);
+
+  cache->Clear();
+  EXPECT_EQ(cache->GetNumberOfEntries(), 0U);
+}
+
+
+// Tests that RemoveUnusedEntries only removes the entries that are not stored or retrieved since its previous call.
+GTEST_TEST(DerivedDataCache, RemoveUnusedEntries)
+{
+  using ImageType = itk::Image<unsigned char, 2>;
+
+  const auto cache = CheckNew<elx::DerivedDataCache>();
+  const auto source = CreateImage<unsigned char>(itk::Size<2>::Filled(4));
+  const auto create = [] { return ImageType::New(); };
+
+  const auto retrieved = cache->RetrieveOrCreate<ImageType>("retrieved", *source, "", create);
+  cache->RetrieveOrCreate<ImageType>("unused", *source, "", create);
+
+  // Entries that are just stored are kept.
+  cache->RemoveUnusedEntries();
+  EXPECT_EQ(cache->GetNumberOfEntries(), 2U);
+
+  EXPECT_EQ(cache->RetrieveOrCreate<ImageType>("retrieved", *source, "", create), retrieved);
+  cache->RemoveUnusedEntries();
+  EXPECT_EQ(cache->GetNumberOfEntries(), 1U);
+  EXPECT_EQ(cache->RetrieveOrCreate<ImageType>("retrieved", *source, "", create), retrieved);
+
+  cache->RemoveUnusedEntries();
+  cache->RemoveUnusedEntries();
+  EXPECT_EQ(cache->GetNumberOfEntries(), 0U);
+}
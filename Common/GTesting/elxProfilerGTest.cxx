@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "elxProfiler.h"
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// The classes to be tested:
+using elastix::Profiler;
+using elastix::ProfilerScope;
+
+
+GTEST_TEST(Profiler, IsDisabledByDefault)
+{
+  EXPECT_FALSE(Profiler().IsEnabled());
+}
+
+
+GTEST_TEST(Profiler, IgnoresEventsWhenDisabled)
+{
+  Profiler profiler;
+  profiler.SetEnabled(true);
+  profiler.SetEnabled(false);
+  {
+    const ProfilerScope profilerScope(&profiler, "Phase");
+  }
+  {
+    const ProfilerScope profilerScope(nullptr, "PhaseWithoutProfiler");
+  }
+  profiler.AddCounterValue("Counter", 1.0);
+
+  EXPECT_EQ(profiler.GetSummary(0).find("Phase [ms]"), std::string::npos);
+  EXPECT_EQ(profiler.GetSummary(0).find("PhaseWithoutProfiler"), std::string::npos);
+  EXPECT_EQ(profiler.GetSummary(0).find("Counter"), std::string::npos);
+}
+
+
+GTEST_TEST(Profiler, AggregatesEventsPerResolution)
+{
+  Profiler profiler;
+  profiler.SetEnabled(true);
+  profiler.SetCurrentResolution(0);
+  {
+    const ProfilerScope profilerScope(&profiler, "PhaseOfResolution0");
+  }
+  profiler.SetCurrentResolution(1);
+  for (int i{}; i < 2; ++i)
+  {
+    const ProfilerScope profilerScope(&profiler, "PhaseOfResolution1");
+    profiler.AddCounterValue("CounterOfResolution1", 3.0);
+  }
+  profiler.SetEnabled(false);
+  profiler.SetCurrentResolution(0);
+
+  const std::string summary0 = profiler.GetSummary(0);
+  const std::string summary1 = profiler.GetSummary(1);
+  EXPECT_NE(summary0.find("PhaseOfResolution0 [ms]"), std::string::npos);
+  EXPECT_EQ(summary0.find("PhaseOfResolution1"), std::string::npos);
+  EXPECT_NE(summary1.find("PhaseOfResolution1 [ms]"), std::string::npos);
+  EXPECT_NE(summary1.find("CounterOfResolution1"), std::string::npos);
+  EXPECT_EQ(summary1.find("PhaseOfResolution0"), std::string::npos);
+
+  const std::string trace = profiler.ToChromeTrace();
+  EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+  EXPECT_NE(trace.find("\"name\":\"PhaseOfResolution0\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ph\":\"C\",\"args\":{\"value\":3.000}"), std::string::npos);
+}
+
+
+// Tests that the summary merges the events that are added by multiple threads, and that the trace has a separate
+// thread index for each of them.
+GTEST_TEST(Profiler, MergesEventsOfThreads)
+{
+  constexpr unsigned int numberOfThreads{ 4 };
+  constexpr unsigned int numberOfEventsPerThread{ 100 };
+
+  Profiler profiler;
+  profiler.SetEnabled(true);
+
+  std::vector<std::thread> threads;
+  for (unsigned int threadNumber{}; threadNumber < numberOfThreads; ++threadNumber)
+  {
+    threads.emplace_back([&profiler, threadNumber] {
+      for (unsigned int i{}; i < numberOfEventsPerThread; ++i)
+      {
+        profiler.AddCounterValue("Counter", threadNumber + 1.0);
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  const std::string summary = profiler.GetSummary(0);
+  const auto        position = summary.find("\nCounter ");
+  ASSERT_NE(position, std::string::npos);
+
+  std::istringstream inputStream(summary.substr(position));
+  std::string        name;
+  std::size_t        count{};
+  double             total{};
+  double             mean{};
+  double             maximum{};
+  inputStream >> name >> count >> total >> mean >> maximum;
+  EXPECT_EQ(count, numberOfThreads * numberOfEventsPerThread);
+  EXPECT_EQ(total, 1000.0);
+  EXPECT_EQ(mean, 2.5);
+  EXPECT_EQ(maximum, 4.0);
+
+  const std::string trace = profiler.ToChromeTrace();
+  for (unsigned int threadIndex{}; threadIndex < numberOfThreads; ++threadIndex)
+  {
+    EXPECT_NE(trace.find("\"tid\":" + std::to_string(threadIndex) + ','), std::string::npos);
+  }
+  EXPECT_EQ(trace.find("\"tid\":" + std::to_string(numberOfThreads) + ','), std::string::npos);
+}
+
+
+// Tests that enabling a profiler does not affect the events of another profiler.
+GTEST_TEST(Profiler, ProfilersAreIndependent)
+{
+  Profiler profiler1;
+  Profiler profiler2;
+  profiler1.SetEnabled(true);
+  profiler1.AddCounterValue("Counter1", 1.0);
+  profiler2.SetEnabled(true);
+  profiler2.SetCurrentResolution(1);
+  profiler2.AddCounterValue("Counter2", 2.0);
+
+  EXPECT_NE(profiler1.GetSummary(0).find("Counter1"), std::string::npos);
+  EXPECT_EQ(profiler1.GetSummary(0).find("Counter2"), std::string::npos);
+  EXPECT_EQ(profiler2.GetSummary(0).find("Counter1"), std::string::npos);
+  EXPECT_NE(profiler2.GetSummary(1).find("Counter2"), std::string::npos);
+}
+
+
+// Tests that a thread that alternates between profilers keeps using its own buffer of each profiler, also while other
+// profilers are created and destroyed.
+GTEST_TEST(Profiler, ThreadAlternatesBetweenProfilers)
+{
+  Profiler profiler1;
+  Profiler profiler2;
+  profiler1.SetEnabled(true);
+  profiler2.SetEnabled(true);
+
+  for (unsigned int i{}; i < 3; ++i)
+  {
+    profiler1.AddCounterValue("Counter1", 1.0);
+    profiler2.AddCounterValue("Counter2", 2.0);
+
+    Profiler temporaryProfiler;
+    temporaryProfiler.SetEnabled(true);
+    temporaryProfiler.AddCounterValue("Counter3", 3.0);
+  }
+
+  for (const auto * const profiler : { &profiler1, &profiler2 })
+  {
+    const std::string trace = profiler->ToChromeTrace();
+    EXPECT_NE(trace.find("\"tid\":0,"), std::string::npos);
+    EXPECT_EQ(trace.find("\"tid\":1,"), std::string::npos);
+    EXPECT_EQ(trace.find("Counter3"), std::string::npos);
+  }
+
+  const std::string summary = profiler1.GetSummary(0);
+  const auto        position = summary.find("\nCounter1 ");
+  ASSERT_NE(position, std::string::npos);
+
+  std::istringstream inputStream(summary.substr(position));
+  std::string        name;
+  std::size_t        count{};
+  inputStream >> name >> count;
+  EXPECT_EQ(count, 3U);
+}
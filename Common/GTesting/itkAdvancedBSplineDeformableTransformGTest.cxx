@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkRecursiveBSplineTransform.h"
+#include "../Core/Main/GTesting/elxCoreMainGTestUtilities.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath> // For sin.
+#include <vector>
+
+// Using-declarations:
+using elx::CoreMainGTestUtilities::CheckNew;
+
+
+namespace
+{
+using PointType = itk::Point<double, 2>;
+
+
+// Places the grid of the specified B-spline transform at arbitrary (but fixed) positions.
+template <typename TTransform>
+void
+SetArbitraryGrid(TTransform & transform)
+{
+  transform.SetGridOrigin(itk::MakeFilled<PointType>(-15.0));
+  transform.SetGridSpacing(itk::MakeFilled<itk::Vector<double, 2>>(12.0));
+  transform.SetGridRegion(itk::ImageRegion<2>(itk::Size<2>::Filled(12)));
+}
+
+
+// Returns arbitrary nonzero parameters.
+itk::OptimizerParameters<double>
+CreateArbitraryParameters(const itk::SizeValueType numberOfParameters)
+{
+  itk::OptimizerParameters<double> parameters(numberOfParameters);
+  for (itk::SizeValueType i = 0; i < numberOfParameters; ++i)
+  {
+    parameters[i] = 3.0 * std::sin(0.7 * i + 0.3);
+  }
+  return parameters;
+}
+
+
+// Returns the points of a regular grid, partly outside the valid region of the B-spline transform.
+std::vector<PointType>
+CreatePoints()
+{
+  std::vector<PointType> points;
+  for (double y = -25.0; y < 130.0; y += 2.5)
+  {
+    for (double x = -25.0; x < 130.0; x += 1.5)
+    {
+      points.push_back(itk::MakePoint(x, y));
+    }
+  }
+  return points;
+}
+
+
+// Expects that a transform that has cached its weights at the points yields exactly the same results at those points
+// as a transform that has not.
+template <typename TTransform>
+void
+ExpectCachedEvaluationEqualsUncachedEvaluation()
+{
+  const auto uncachedTransform = CheckNew<TTransform>();
+  const auto cachedTransform = CheckNew<TTransform>();
+  SetArbitraryGrid(*uncachedTransform);
+  SetArbitraryGrid(*cachedTransform);
+
+  // The parameters are assumed to be maintained by the caller.
+  const auto parameters = CreateArbitraryParameters(uncachedTransform->GetNumberOfParameters());
+  uncachedTransform->SetParameters(parameters);
+  cachedTransform->SetParameters(parameters);
+
+  // Let two owners (like two metrics) register overlapping parts of the points, which together cover all points.
+  const auto                   points = CreatePoints();
+  const auto                   middle = points.cbegin() + points.size() / 2;
+  const std::vector<PointType> firstPoints(points.cbegin(), middle + 100);
+  const std::vector<PointType> lastPoints(middle - 100, points.cend());
+  const auto                   firstOwner = itk::Object::New();
+  const auto                   lastOwner = itk::Object::New();
+  constexpr auto               maximumSize = itk::NumericTraits<itk::SizeValueType>::max();
+  EXPECT_GT(cachedTransform->BuildWeightCache(firstOwner, firstPoints, maximumSize), 0U);
+  EXPECT_GT(cachedTransform->BuildWeightCache(lastOwner, lastPoints, maximumSize), 0U);
+  EXPECT_GT(cachedTransform->GetWeightCacheSize(), 0U);
+  EXPECT_EQ(uncachedTransform->GetWeightCacheSize(), 0U);
+
+  const auto nnzji = uncachedTransform->GetNumberOfNonZeroJacobianIndices();
+  typename TTransform::MovingImageGradientType movingImageGradient;
+  movingImageGradient[0] = 0.3;
+  movingImageGradient[1] = -1.2;
+
+  for (const auto & point : points)
+  {
+    EXPECT_EQ(cachedTransform->TransformPoint(point), uncachedTransform->TransformPoint(point));
+
+    typename TTransform::JacobianType               expectedJacobian;
+    typename TTransform::JacobianType               actualJacobian;
+    typename TTransform::NonZeroJacobianIndicesType expectedIndices;
+    typename TTransform::NonZeroJacobianIndicesType actualIndices;
+    uncachedTransform->GetJacobian(point, expectedJacobian, expectedIndices);
+    cachedTransform->GetJacobian(point, actualJacobian, actualIndices);
+    EXPECT_EQ(actualJacobian, expectedJacobian);
+    EXPECT_EQ(actualIndices, expectedIndices);
+
+    typename TTransform::DerivativeType expectedImageJacobian(nnzji);
+    typename TTransform::DerivativeType actualImageJacobian(nnzji);
+    expectedImageJacobian.Fill(0.0);
+    actualImageJacobian.Fill(0.0);
+    uncachedTransform->EvaluateJacobianWithImageGradientProduct(
+      point, movingImageGradient, expectedImageJacobian, expectedIndices);
+    cachedTransform->EvaluateJacobianWithImageGradientProduct(
+      point, movingImageGradient, actualImageJacobian, actualIndices);
+    EXPECT_EQ(actualImageJacobian, expectedImageJacobian);
+    EXPECT_EQ(actualIndices, expectedIndices);
+
+    typename TTransform::SpatialJacobianType expectedSpatialJacobian;
+    typename TTransform::SpatialJacobianType actualSpatialJacobian;
+    uncachedTransform->GetSpatialJacobian(point, expectedSpatialJacobian);
+    cachedTransform->GetSpatialJacobian(point, actualSpatialJacobian);
+    EXPECT_EQ(actualSpatialJacobian, expectedSpatialJacobian);
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(AdvancedBSplineDeformableTransform, CachedWeightsYieldSameResults)
+{
+  ExpectCachedEvaluationEqualsUncachedEvaluation<itk::AdvancedBSplineDeformableTransform<double, 2, 1>>();
+  ExpectCachedEvaluationEqualsUncachedEvaluation<itk::AdvancedBSplineDeformableTransform<double, 2, 3>>();
+}
+
+
+GTEST_TEST(RecursiveBSplineTransform, CachedWeightsYieldSameResults)
+{
+  ExpectCachedEvaluationEqualsUncachedEvaluation<itk::RecursiveBSplineTransform<double, 2, 1>>();
+  ExpectCachedEvaluationEqualsUncachedEvaluation<itk::RecursiveBSplineTransform<double, 2, 3>>();
+}
+
+
+GTEST_TEST(RecursiveBSplineTransform, WeightCacheRespectsMaximumSizeAndIsClearedByGridChange)
+{
+  const auto transform = CheckNew<itk::RecursiveBSplineTransform<double, 2, 3>>();
+  SetArbitraryGrid(*transform);
+
+  // The parameters are assumed to be maintained by the caller.
+  const auto parameters = CreateArbitraryParameters(transform->GetNumberOfParameters());
+  transform->SetParameters(parameters);
+
+  const auto               points = CreatePoints();
+  const itk::SizeValueType requiredSize = transform->BuildWeightCache(nullptr, points, 0);
+  EXPECT_GT(requiredSize, 0U);
+  EXPECT_EQ(transform->GetWeightCacheSize(), 0U);
+
+  EXPECT_EQ(transform->BuildWeightCache(nullptr, points, requiredSize), requiredSize);
+  EXPECT_GT(transform->GetWeightCacheSize(), 0U);
+  EXPECT_LE(transform->GetWeightCacheSize(), requiredSize);
+
+  transform->SetGridSpacing(itk::MakeFilled<itk::Vector<double, 2>>(10.0));
+  EXPECT_EQ(transform->GetWeightCacheSize(), 0U);
+}
+
+
+// Tests that the weight cache holds the union of the points of its owners, and that an owner that registers its points
+// again replaces its previous points.
+GTEST_TEST(RecursiveBSplineTransform, WeightCacheHoldsUnionOfPointsOfOwners)
+{
+  using TransformType = itk::RecursiveBSplineTransform<double, 2, 3>;
+  constexpr auto maximumSize = itk::NumericTraits<itk::SizeValueType>::max();
+
+  const auto                   points = CreatePoints();
+  const auto                   middle = points.cbegin() + points.size() / 2;
+  const std::vector<PointType> firstPoints(points.cbegin(), middle + 100);
+  const std::vector<PointType> lastPoints(middle - 100, points.cend());
+
+  const auto expectedSizeOf = [](const std::vector<PointType> & expectedPoints) {
+    const auto transform = CheckNew<TransformType>();
+    SetArbitraryGrid(*transform);
+    return transform->BuildWeightCache(nullptr, expectedPoints, maximumSize);
+  };
+
+  const auto transform = CheckNew<TransformType>();
+  SetArbitraryGrid(*transform);
+  const auto firstOwner = itk::Object::New();
+  const auto lastOwner = itk::Object::New();
+
+  EXPECT_EQ(transform->BuildWeightCache(firstOwner, firstPoints, maximumSize), expectedSizeOf(firstPoints));
+  EXPECT_EQ(transform->BuildWeightCache(lastOwner, lastPoints, maximumSize), expectedSizeOf(points));
+
+  // Registering the same points again does not add anything.
+  EXPECT_EQ(transform->BuildWeightCache(firstOwner, firstPoints, maximumSize), expectedSizeOf(points));
+
+  // An owner that registers other points (or no points at all) replaces its previous points.
+  EXPECT_EQ(transform->BuildWeightCache(lastOwner, firstPoints, maximumSize), expectedSizeOf(firstPoints));
+  EXPECT_EQ(transform->BuildWeightCache(firstOwner, {}, maximumSize), expectedSizeOf(firstPoints));
+  EXPECT_EQ(transform->BuildWeightCache(lastOwner, {}, maximumSize), 0U);
+  EXPECT_EQ(transform->GetWeightCacheSize(), 0U);
+}
@@ -0,0 +1,227 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
+#include "../Core/Main/GTesting/elxCoreMainGTestUtilities.h"
+
+#include <itkBSplineDecompositionImageFilter.h>
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+#include <itkImageBufferRange.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// The template to be tested.
+using itk::AdvancedBSplineInterpolateImageFunction;
+
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::CreateImage;
+
+namespace
+{
+constexpr unsigned int ImageDimension{ 3 };
+using ImageType = itk::Image<float, ImageDimension>;
+using CoefficientImageType = itk::Image<double, ImageDimension>;
+using InterpolatorType = AdvancedBSplineInterpolateImageFunction<ImageType>;
+
+
+auto
+CreateRandomImage()
+{
+  const auto                            image = CreateImage<float>(itk::Size<ImageDimension>{ { 17, 11, 13 } });
+  const itk::ImageBufferRange           imageBufferRange{ *image };
+  std::mt19937                          randomNumberEngine{};
+  std::uniform_real_distribution<float> distribution{ -100.0f, 100.0f };
+  std::generate(imageBufferRange.begin(), imageBufferRange.end(), [&distribution, &randomNumberEngine] {
+    return distribution(randomNumberEngine);
+  });
+  return image;
+}
+
+
+auto
+CopyImage(const ImageType & image)
+{
+  const auto                  copy = CreateImage<float>(image.GetLargestPossibleRegion().GetSize());
+  const itk::ImageBufferRange imageBufferRange{ image };
+  const itk::ImageBufferRange copyBufferRange{ *copy };
+  std::copy(imageBufferRange.cbegin(), imageBufferRange.cend(), copyBufferRange.begin());
+  return copy;
+}
+
+
+template <typename TImage>
+std::vector<typename TImage::PixelType>
+GetPixelValues(const TImage & image)
+{
+  const itk::ImageBufferRange imageBufferRange{ image };
+  return { imageBufferRange.cbegin(), imageBufferRange.cend() };
+}
+
+} // namespace
+
+
+GTEST_TEST(MultiOrderBSplineDecompositionImageFilter, MultiThreadedEqualsSingleThreaded)
+{
+  using FilterType = itk::MultiOrderBSplineDecompositionImageFilter<ImageType, CoefficientImageType>;
+
+  const auto image = CreateRandomImage();
+
+  for (unsigned int splineOrder{}; splineOrder <= 5; ++splineOrder)
+  {
+    const auto computeCoefficients = [&image, splineOrder](const itk::ThreadIdType numberOfWorkUnits) {
+      const auto filter = CheckNew<FilterType>();
+      filter->SetSplineOrder(splineOrder);
+      filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+      filter->SetInput(image);
+      filter->Update();
+      return GetPixelValues(*(filter->GetOutput()));
+    };
+
+    const auto singleThreadedCoefficients = computeCoefficients(1);
+    EXPECT_EQ(computeCoefficients(4), singleThreadedCoefficients);
+    EXPECT_EQ(computeCoefficients(64), singleThreadedCoefficients);
+  }
+}
+
+
+GTEST_TEST(MultiOrderBSplineDecompositionImageFilter, EqualsBSplineDecompositionImageFilter)
+{
+  const auto image = CreateRandomImage();
+
+  for (unsigned int splineOrder{}; splineOrder <= 5; ++splineOrder)
+  {
+    const auto filter = CheckNew<itk::MultiOrderBSplineDecompositionImageFilter<ImageType, CoefficientImageType>>();
+    filter->SetSplineOrder(splineOrder);
+    filter->SetInput(image);
+    filter->Update();
+
+    const auto referenceFilter = CheckNew<itk::BSplineDecompositionImageFilter<ImageType, CoefficientImageType>>();
+    referenceFilter->SetSplineOrder(splineOrder);
+    referenceFilter->SetInput(image);
+    referenceFilter->Update();
+
+    const auto coefficients = GetPixelValues(*(filter->GetOutput()));
+    const auto referenceCoefficients = GetPixelValues(*(referenceFilter->GetOutput()));
+    ASSERT_EQ(coefficients.size(), referenceCoefficients.size());
+
+    for (std::size_t i{}; i < coefficients.size(); ++i)
+    {
+      EXPECT_NEAR(coefficients[i], referenceCoefficients[i], 1e-9);
+    }
+  }
+}
+
+
+GTEST_TEST(AdvancedBSplineInterpolateImageFunction, EvaluateEqualsBSplineInterpolateImageFunction)
+{
+  const auto image = CreateRandomImage();
+
+  for (unsigned int splineOrder{ 1 }; splineOrder <= 5; ++splineOrder)
+  {
+    const auto interpolator = CheckNew<InterpolatorType>();
+    interpolator->SetSplineOrder(splineOrder);
+    interpolator->SetInputImage(image);
+
+    const auto referenceInterpolator = CheckNew<itk::BSplineInterpolateImageFunction<ImageType>>();
+    referenceInterpolator->SetSplineOrder(splineOrder);
+    referenceInterpolator->SetInputImage(image);
+
+    for (const double x : { 0.0, 1.25, 7.5, 15.75 })
+    {
+      InterpolatorType::ContinuousIndexType continuousIndex;
+      continuousIndex[0] = x;
+      continuousIndex[1] = 0.4 * x;
+      continuousIndex[2] = 0.7 * x;
+
+      EXPECT_NEAR(interpolator->EvaluateAtContinuousIndex(continuousIndex),
+                  referenceInterpolator->EvaluateAtContinuousIndex(continuousIndex),
+                  1e-9);
+    }
+  }
+}
+
+
+GTEST_TEST(AdvancedBSplineInterpolateImageFunction, ReusesSharedCoefficientsOfEqualImage)
+{
+  const auto image = CreateRandomImage();
+
+  const auto source = CheckNew<InterpolatorType>();
+  source->SetSplineOrder(3);
+  source->SetInputImage(image);
+
+  const auto interpolator = CheckNew<InterpolatorType>();
+  interpolator->SetSplineOrder(3);
+  interpolator->ShareCoefficientsOf(source);
+
+  // Another image object, but with the same geometry and pixel values.
+  interpolator->SetInputImage(CopyImage(*image));
+
+  ASSERT_NE(source->GetCoefficients(), nullptr);
+  EXPECT_EQ(interpolator->GetCoefficients(), source->GetCoefficients());
+}
+
+
+GTEST_TEST(AdvancedBSplineInterpolateImageFunction, DoesNotReuseSharedCoefficientsOfOtherImageOrOrder)
+{
+  const auto image = CreateRandomImage();
+
+  const auto source = CheckNew<InterpolatorType>();
+  source->SetSplineOrder(3);
+  source->SetInputImage(image);
+
+  const auto referenceInterpolator = CheckNew<InterpolatorType>();
+
+  // Another spline order.
+  {
+    const auto interpolator = CheckNew<InterpolatorType>();
+    interpolator->SetSplineOrder(2);
+    interpolator->ShareCoefficientsOf(source);
+    interpolator->SetInputImage(image);
+
+    referenceInterpolator->SetSplineOrder(2);
+    referenceInterpolator->SetInputImage(image);
+
+    EXPECT_NE(interpolator->GetCoefficients(), source->GetCoefficients());
+    EXPECT_EQ(GetPixelValues(*(interpolator->GetCoefficients())),
+              GetPixelValues(*(referenceInterpolator->GetCoefficients())));
+  }
+
+  // Another pixel value.
+  {
+    const auto otherImage = CopyImage(*image);
+    otherImage->SetPixel({}, otherImage->GetPixel({}) + 1.0f);
+
+    const auto interpolator = CheckNew<InterpolatorType>();
+    interpolator->SetSplineOrder(3);
+    interpolator->ShareCoefficientsOf(source);
+    interpolator->SetInputImage(otherImage);
+
+    referenceInterpolator->SetSplineOrder(3);
+    referenceInterpolator->SetInputImage(otherImage);
+
+    EXPECT_NE(interpolator->GetCoefficients(), source->GetCoefficients());
+    EXPECT_EQ(GetPixelValues(*(interpolator->GetCoefficients())),
+              GetPixelValues(*(referenceInterpolator->GetCoefficients())));
+  }
+}
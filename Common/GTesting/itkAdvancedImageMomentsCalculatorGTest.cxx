@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkAdvancedImageMomentsCalculator.h"
+#include "GTesting/elxCoreMainGTestUtilities.h"
+#include <itkImage.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <gtest/gtest.h>
+
+#include <cmath> // For abs.
+
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::CreateImageFilledWithSequenceOfNaturalNumbers;
+
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using CalculatorType = itk::AdvancedImageMomentsCalculator<ImageType>;
+
+
+// Creates an image of which the number of pixels spans multiple blocks, with an arbitrary spacing and origin.
+ImageType::Pointer
+CreateArbitraryImage()
+{
+  const auto image = CreateImageFilledWithSequenceOfNaturalNumbers<float>(itk::Size<3>{ { 20, 30, 40 } });
+  image->SetSpacing(itk::MakeVector(0.5, 1.5, 2.0));
+  image->SetOrigin(itk::MakePoint(-3.0, 4.0, 7.5));
+  return image;
+}
+
+
+void
+ExpectNear(const CalculatorType & actual, const CalculatorType & expected, const double relativeTolerance)
+{
+  const double totalMass = expected.GetTotalMass();
+  EXPECT_NEAR(actual.GetTotalMass(), totalMass, relativeTolerance * totalMass);
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    EXPECT_NEAR(actual.GetCenterOfGravity()[i], expected.GetCenterOfGravity()[i], relativeTolerance * 100.0);
+    EXPECT_NEAR(actual.GetFirstMoments()[i], expected.GetFirstMoments()[i], relativeTolerance * 100.0);
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      EXPECT_NEAR(actual.GetCentralMoments()[i][j], expected.GetCentralMoments()[i][j], relativeTolerance * 1e4);
+      EXPECT_NEAR(actual.GetSecondMoments()[i][j], expected.GetSecondMoments()[i][j], relativeTolerance * 1e4);
+    }
+  }
+}
+
+} // namespace
+
+
+// Tests that the multi-threaded computation over all pixels yields the results of the single-threaded computation, up
+// to round-off, and that its results are identical for any number of work units.
+GTEST_TEST(AdvancedImageMomentsCalculator, MultiThreadedComputationUsingAllPixels)
+{
+  const auto image = CreateArbitraryImage();
+
+  const auto singleThreadedCalculator = CheckNew<CalculatorType>();
+  singleThreadedCalculator->SetImage(image);
+  singleThreadedCalculator->ComputeSingleThreaded();
+
+  const auto referenceCalculator = CheckNew<CalculatorType>();
+  referenceCalculator->SetImage(image);
+  referenceCalculator->SetNumberOfSamplesForCenteredTransformInitialization(0);
+  referenceCalculator->SetNumberOfWorkUnits(1);
+  referenceCalculator->Compute();
+  ExpectNear(*referenceCalculator, *singleThreadedCalculator, 1e-12);
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 2U, 3U, 8U })
+  {
+    const auto calculator = CheckNew<CalculatorType>();
+    calculator->SetImage(image);
+    calculator->SetNumberOfSamplesForCenteredTransformInitialization(0);
+    calculator->SetNumberOfWorkUnits(numberOfWorkUnits);
+    calculator->Compute();
+
+    EXPECT_EQ(calculator->GetTotalMass(), referenceCalculator->GetTotalMass());
+    EXPECT_EQ(calculator->GetCenterOfGravity(), referenceCalculator->GetCenterOfGravity());
+    EXPECT_EQ(calculator->GetFirstMoments(), referenceCalculator->GetFirstMoments());
+    EXPECT_EQ(calculator->GetCentralMoments(), referenceCalculator->GetCentralMoments());
+    EXPECT_EQ(calculator->GetSecondMoments(), referenceCalculator->GetSecondMoments());
+  }
+}
+
+
+// Tests that a number of samples that is at least the number of pixels yields the same results as using all pixels,
+// and that a smaller number of samples also computes the moments in index coordinates.
+GTEST_TEST(AdvancedImageMomentsCalculator, SampledComputation)
+{
+  const auto image = CreateArbitraryImage();
+
+  const auto fullCalculator = CheckNew<CalculatorType>();
+  fullCalculator->SetImage(image);
+  fullCalculator->SetNumberOfSamplesForCenteredTransformInitialization(0);
+  fullCalculator->Compute();
+
+  const auto calculator = CheckNew<CalculatorType>();
+  calculator->SetImage(image);
+  calculator->SetNumberOfSamplesForCenteredTransformInitialization(image->GetBufferedRegion().GetNumberOfPixels());
+  calculator->Compute();
+  EXPECT_EQ(calculator->GetTotalMass(), fullCalculator->GetTotalMass());
+  EXPECT_EQ(calculator->GetCenterOfGravity(), fullCalculator->GetCenterOfGravity());
+
+  // With about one sample per two pixels along each dimension, the moments should still roughly correspond.
+  calculator->SetNumberOfSamplesForCenteredTransformInitialization(3000);
+  calculator->Compute();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    EXPECT_NEAR(calculator->GetCenterOfGravity()[i], fullCalculator->GetCenterOfGravity()[i], 2.5);
+    EXPECT_NEAR(calculator->GetFirstMoments()[i], fullCalculator->GetFirstMoments()[i], 1.5);
+  }
+}
+
+
+// Tests that the lower threshold is applied to the pixel values, without affecting the input image, so that a second
+// computation yields the same center of gravity.
+GTEST_TEST(AdvancedImageMomentsCalculator, LowerThresholdDoesNotAffectRepeatedComputation)
+{
+  const auto             image = CreateArbitraryImage();
+  constexpr float        lowerThreshold{ 15000.0f };
+  itk::Vector<double, 3> expectedCenter{};
+  double                 numberOfPixelsAboveThreshold{};
+
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() >= lowerThreshold)
+    {
+      itk::Point<double, 3> point;
+      image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      expectedCenter += point.GetVectorFromOrigin();
+      ++numberOfPixelsAboveThreshold;
+    }
+  }
+  expectedCenter /= numberOfPixelsAboveThreshold;
+
+  const auto calculator = CheckNew<CalculatorType>();
+  calculator->SetImage(image);
+  calculator->SetNumberOfSamplesForCenteredTransformInitialization(0);
+  calculator->SetCenterOfGravityUsesLowerThreshold(true);
+  calculator->SetLowerThresholdForCenterGravity(lowerThreshold);
+
+  for (unsigned int computation = 0; computation < 2; ++computation)
+  {
+    calculator->Compute();
+    EXPECT_EQ(calculator->GetTotalMass(), numberOfPixelsAboveThreshold);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      EXPECT_NEAR(calculator->GetCenterOfGravity()[i], expectedCenter[i], 1e-9 * (1.0 + std::abs(expectedCenter[i])));
+    }
+  }
+}
@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "../Core/Main/GTesting/elxCoreMainGTestUtilities.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIndexRange.h>
+#include <itkTranslationTransform.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // For count.
+#include <random>
+#include <vector>
+
+// Using-declarations:
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::CreateImage;
+
+
+namespace
+{
+using PixelType = short;
+using ImageType = itk::Image<PixelType, 3>;
+using InterpolatorType = itk::AdvancedRayCastInterpolateImageFunction<ImageType>;
+
+
+// Fills a ball in the centre of the image with random values.
+void
+FillBall(ImageType & image)
+{
+  std::mt19937                         randomNumberEngine{};
+  std::uniform_int_distribution<short> distribution(-100, 1000);
+
+  for (const auto & index : itk::ImageRegionIndexRange<3>(image.GetBufferedRegion()))
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      squaredDistance += (index[i] - 20.0) * (index[i] - 20.0);
+    }
+    if (squaredDistance < 100.0)
+    {
+      image.SetPixel(index, distribution(randomNumberEngine));
+    }
+  }
+}
+
+
+// Returns the integrals along rays through the centre of the image.
+std::vector<double>
+GetIntegrals(const InterpolatorType & interpolator)
+{
+  std::vector<double> integrals;
+  for (double y = -15.0; y <= 15.0; y += 1.25)
+  {
+    for (double x = -15.0; x <= 15.0; x += 1.25)
+    {
+      integrals.push_back(interpolator.Evaluate(itk::MakePoint(x, y, 200.0)));
+    }
+  }
+  return integrals;
+}
+
+
+itk::SmartPointer<InterpolatorType>
+CreateInterpolator(const ImageType & image, const bool useEmptySpaceSkipping)
+{
+  const auto interpolator = CheckNew<InterpolatorType>();
+  interpolator->SetUseEmptySpaceSkipping(useEmptySpaceSkipping);
+  interpolator->SetTransform(CheckNew<itk::TranslationTransform<double, 3>>());
+  interpolator->SetFocalPoint(itk::MakePoint(0.0, 0.0, -200.0));
+  interpolator->SetThreshold(0.0);
+  interpolator->SetInputImage(&image);
+  return interpolator;
+}
+
+} // namespace
+
+
+// Checks that skipping the empty space (the bricks of voxels below the threshold) does not change the integrals.
+GTEST_TEST(AdvancedRayCastInterpolateImageFunction, EmptySpaceSkippingDoesNotChangeResult)
+{
+  // A volume of "air", with a ball of random values in its centre.
+  const auto image = CreateImage<PixelType>(itk::Size<3>::Filled(40));
+  image->FillBuffer(-1000);
+  FillBall(*image);
+
+  const auto expectedIntegrals = GetIntegrals(*CreateInterpolator(*image, false));
+  EXPECT_EQ(GetIntegrals(*CreateInterpolator(*image, true)), expectedIntegrals);
+
+  // Sanity check: some of the rays pass through the ball.
+  const auto numberOfZeroIntegrals = std::count(expectedIntegrals.cbegin(), expectedIntegrals.cend(), 0.0);
+  EXPECT_LT(static_cast<std::size_t>(numberOfZeroIntegrals), expectedIntegrals.size());
+}
+
+
+// Checks that the empty space map is computed again when the image is modified after SetInputImage.
+GTEST_TEST(AdvancedRayCastInterpolateImageFunction, EmptySpaceMapFollowsModifiedImage)
+{
+  const auto image = CreateImage<PixelType>(itk::Size<3>::Filled(40));
+  image->FillBuffer(-1000);
+
+  const auto interpolator = CreateInterpolator(*image, true);
+  const auto integralsOfAir = GetIntegrals(*interpolator);
+  EXPECT_EQ(static_cast<std::size_t>(std::count(integralsOfAir.cbegin(), integralsOfAir.cend(), 0.0)),
+            integralsOfAir.size());
+
+  // Modify the pixels, without calling SetInputImage again.
+  FillBall(*image);
+  image->Modified();
+
+  EXPECT_EQ(GetIntegrals(*interpolator), GetIntegrals(*CreateInterpolator(*image, false)));
+}
+
+
+// Checks that the empty space map is computed when empty space skipping is switched on after SetInputImage, as it is
+// only computed by SetInputImage when empty space skipping is used at that moment.
+GTEST_TEST(AdvancedRayCastInterpolateImageFunction, EmptySpaceSkippingSwitchedOnAfterSetInputImage)
+{
+  const auto image = CreateImage<PixelType>(itk::Size<3>::Filled(40));
+  image->FillBuffer(-1000);
+  FillBall(*image);
+
+  const auto interpolator = CreateInterpolator(*image, false);
+  const auto expectedIntegrals = GetIntegrals(*interpolator);
+
+  interpolator->UseEmptySpaceSkippingOn();
+  EXPECT_EQ(GetIntegrals(*interpolator), expectedIntegrals);
+}
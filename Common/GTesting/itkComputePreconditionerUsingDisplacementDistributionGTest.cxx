@@ -0,0 +1,157 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkComputePreconditionerUsingDisplacementDistribution.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedSimilarity2DTransform.h"
+#include "../Core/Main/GTesting/elxCoreMainGTestUtilities.h"
+
+#include <itkImage.h>
+#include <itkSingleValuedCostFunction.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath> // For sin.
+
+// Using-declarations:
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::CreateImage;
+
+
+namespace
+{
+// A cost function whose derivative is a fixed, arbitrary, function of the parameter index.
+class TestCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(TestCostFunction);
+
+  using Self = TestCostFunction;
+  using Superclass = itk::SingleValuedCostFunction;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(TestCostFunction);
+
+  itkSetMacro(NumberOfParameters, unsigned int);
+
+  unsigned int
+  GetNumberOfParameters() const override
+  {
+    return m_NumberOfParameters;
+  }
+
+  MeasureType
+  GetValue(const ParametersType &) const override
+  {
+    return 0.0;
+  }
+
+  void
+  GetDerivative(const ParametersType &, DerivativeType & derivative) const override
+  {
+    derivative.set_size(m_NumberOfParameters);
+    for (unsigned int i = 0; i < m_NumberOfParameters; ++i)
+    {
+      derivative[i] = std::sin(0.7 * i + 0.3);
+    }
+  }
+
+protected:
+  TestCostFunction() = default;
+
+private:
+  unsigned int m_NumberOfParameters{};
+};
+
+
+// Computes the preconditioner by both the multi-threaded implementation (for various numbers of work units) and the
+// original single-threaded loop, and expects identical results.
+template <typename TTransform>
+void
+ExpectMultiThreadedComputeEqualsSingleThreadedCompute(TTransform & transform)
+{
+  using ImageType = itk::Image<float, 2>;
+  using PreconditionerType = itk::ComputePreconditionerUsingDisplacementDistribution<ImageType, TTransform>;
+  using ParametersType = typename PreconditionerType::ParametersType;
+
+  const auto image = CreateImage<float>(itk::Size<2>{ 100, 100 });
+
+  const auto numberOfParameters = static_cast<unsigned int>(transform.GetNumberOfParameters());
+
+  const auto costFunction = CheckNew<TestCostFunction>();
+  costFunction->SetNumberOfParameters(numberOfParameters);
+
+  const auto preconditionerEstimator = CheckNew<PreconditionerType>();
+  preconditionerEstimator->SetFixedImage(image);
+  preconditionerEstimator->SetFixedImageRegion(image->GetBufferedRegion());
+  preconditionerEstimator->SetTransform(&transform);
+  preconditionerEstimator->SetCostFunction(costFunction);
+  preconditionerEstimator->SetNumberOfJacobianMeasurements(6000);
+  preconditionerEstimator->SetRegularizationKappa(0.8);
+  preconditionerEstimator->SetMaximumStepLength(1.0);
+  preconditionerEstimator->SetConditionNumber(2.0);
+  preconditionerEstimator->SetUseScales(false);
+
+  const ParametersType mu(numberOfParameters, 0.0);
+
+  double         expectedMaxJJ{};
+  ParametersType expectedPreconditioner(numberOfParameters, 0.0);
+  preconditionerEstimator->ComputeSingleThreaded(mu, expectedMaxJJ, expectedPreconditioner);
+  EXPECT_GT(expectedMaxJJ, 0.0);
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 2U, 3U, 8U })
+  {
+    preconditionerEstimator->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+    double         actualMaxJJ{};
+    ParametersType actualPreconditioner(numberOfParameters, 0.0);
+    preconditionerEstimator->Compute(mu, actualMaxJJ, actualPreconditioner);
+
+    EXPECT_EQ(actualMaxJJ, expectedMaxJJ);
+    EXPECT_EQ(actualPreconditioner, expectedPreconditioner);
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(ComputePreconditionerUsingDisplacementDistribution, MultiThreadedEqualsSingleThreadedForBSpline)
+{
+  const auto transform = CheckNew<itk::AdvancedBSplineDeformableTransform<double, 2, 3>>();
+  transform->SetGridOrigin(itk::MakeFilled<itk::Point<double, 2>>(-15.0));
+  transform->SetGridSpacing(itk::MakeFilled<itk::Vector<double, 2>>(12.0));
+  transform->SetGridRegion(itk::ImageRegion<2>(itk::Size<2>::Filled(12)));
+
+  // The parameters are assumed to be maintained by the caller.
+  const itk::OptimizerParameters<double> parameters(transform->GetNumberOfParameters(), 0.0);
+  transform->SetParameters(parameters);
+
+  ExpectMultiThreadedComputeEqualsSingleThreadedCompute(*transform);
+}
+
+
+GTEST_TEST(ComputePreconditionerUsingDisplacementDistribution, MultiThreadedEqualsSingleThreadedForSimilarity)
+{
+  const auto transform = CheckNew<itk::AdvancedSimilarity2DTransform<double>>();
+  transform->SetCenter(itk::MakeFilled<itk::Point<double, 2>>(50.0));
+
+  ExpectMultiThreadedComputeEqualsSingleThreadedCompute(*transform);
+}
@@ -18,11 +18,14 @@
 
 // First include the header file to be tested:
 #include "CorrespondingPointsEuclideanDistanceMetric/itkCorrespondingPointsEuclideanDistancePointMetric.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
 #include "itkAdvancedTranslationTransform.h"
 #include "elxDefaultConstruct.h"
 #include <itkPointSet.h>
 #include <gtest/gtest.h>
 
+#include <random>
+
 // The template to be tested.
 using itk::CorrespondingPointsEuclideanDistancePointMetric;
 
@@ -41,6 +44,7 @@ GTEST_TEST(CorrespondingPointsEuclideanDistancePointMetric, DefaultConstruct)
   EXPECT_EQ(pointSetToPointSetMetric.GetMovingImageMask(), nullptr);
   EXPECT_EQ(pointSetToPointSetMetric.GetTransform(), nullptr);
   EXPECT_TRUE(pointSetToPointSetMetric.GetUseMetricSingleThreaded());
+  EXPECT_FALSE(pointSetToPointSetMetric.GetUseMultiThread());
 
   // Note: `pointSetToPointSetMetric.m_NumberOfPointsCounted` is not public, and does not have a Get member function to
   // test its value.
@@ -71,3 +75,85 @@ GTEST_TEST(CorrespondingPointsEuclideanDistancePointMetric, MinimalPointSets)
   metric.Initialize();
   EXPECT_EQ(metric.GetValue(transform.GetParameters()), 0);
 }
+
+
+// Checks that the multi-threaded evaluation of CorrespondingPointsEuclideanDistancePointMetric, with a B-spline
+// transform, is deterministic, and equal to the single-threaded evaluation, apart from rounding errors.
+GTEST_TEST(CorrespondingPointsEuclideanDistancePointMetric, MultiThreadedEqualsSingleThreaded)
+{
+  using PointSetType = itk::PointSet<double>;
+  using PointType = PointSetType::PointType;
+  using PointsVectorContainerType = PointSetType::PointsVectorContainer;
+  using MetricType = CorrespondingPointsEuclideanDistancePointMetric<PointSetType, PointSetType>;
+  constexpr auto Dimension = PointSetType::PointDimension;
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, Dimension, 3>;
+
+  elx::DefaultConstruct<TransformType> transform{};
+  transform.SetGridOrigin(itk::MakeFilled<itk::Point<double, Dimension>>(-15.0));
+  transform.SetGridSpacing(itk::MakeFilled<itk::Vector<double, Dimension>>(12.0));
+  transform.SetGridRegion(itk::ImageRegion<Dimension>(itk::Size<Dimension>::Filled(12)));
+
+  std::mt19937                           randomNumberEngine{};
+  std::uniform_real_distribution<double> parameterDistribution(-2.0, 2.0);
+  std::uniform_real_distribution<double> coordinateDistribution(0.0, 100.0);
+
+  // The parameters are assumed to be maintained by the caller.
+  TransformType::ParametersType parameters(transform.GetNumberOfParameters());
+  for (auto & parameter : parameters)
+  {
+    parameter = parameterDistribution(randomNumberEngine);
+  }
+  transform.SetParameters(parameters);
+
+  elx::DefaultConstruct<PointsVectorContainerType> fixedPointsVectorContainer{};
+  elx::DefaultConstruct<PointsVectorContainerType> movingPointsVectorContainer{};
+
+  for (unsigned int i = 0; i < 1000; ++i)
+  {
+    for (auto * const pointsVectorContainer : { &fixedPointsVectorContainer, &movingPointsVectorContainer })
+    {
+      PointType point;
+      for (auto & coordinate : point)
+      {
+        coordinate = coordinateDistribution(randomNumberEngine);
+      }
+      pointsVectorContainer->CastToSTLContainer().push_back(point);
+    }
+  }
+
+  elx::DefaultConstruct<PointSetType> fixedPointSet{};
+  fixedPointSet.SetPoints(&fixedPointsVectorContainer);
+  elx::DefaultConstruct<PointSetType> movingPointSet{};
+  movingPointSet.SetPoints(&movingPointsVectorContainer);
+  elx::DefaultConstruct<MetricType> metric{};
+  metric.SetFixedPointSet(&fixedPointSet);
+  metric.SetMovingPointSet(&movingPointSet);
+  metric.SetTransform(&transform);
+  metric.Initialize();
+
+  const auto getValueAndDerivative = [&metric, &parameters](const bool useMultiThread) {
+    metric.SetUseMultiThread(useMultiThread);
+    MetricType::MeasureType    value{};
+    MetricType::DerivativeType derivative;
+    metric.GetValueAndDerivative(parameters, value, derivative);
+    EXPECT_EQ(metric.GetValue(parameters), value);
+    return std::make_pair(value, derivative);
+  };
+
+  metric.SetNumberOfWorkUnits(4);
+
+  const auto expected = getValueAndDerivative(false);
+  const auto actual = getValueAndDerivative(true);
+
+  EXPECT_GT(expected.first, 0.0);
+  EXPECT_DOUBLE_EQ(actual.first, expected.first);
+  ASSERT_EQ(actual.second.size(), expected.second.size());
+
+  for (unsigned int i = 0; i < expected.second.size(); ++i)
+  {
+    EXPECT_NEAR(actual.second[i], expected.second[i], 1e-12);
+  }
+
+  // The multi-threaded result does not depend on the scheduling of the threads.
+  EXPECT_EQ(getValueAndDerivative(true), actual);
+}
@@ -0,0 +1,261 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkGenericMultiResolutionPyramidImageFilter.h"
+#include "GTesting/elxCoreMainGTestUtilities.h"
+#include "elxDefaultConstruct.h"
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <gtest/gtest.h>
+
+#include <algorithm> // For max.
+#include <cmath>     // For abs, cos, round and sin.
+
+using elx::CoreMainGTestUtilities::CreateImage;
+using itk::Deref;
+
+
+namespace
+{
+// Creates an image whose pixel values increase linearly with the index.
+template <typename TImage>
+auto
+CreateRampImage(const typename TImage::SizeType & imageSize)
+{
+  const auto image = CreateImage<typename TImage::PixelType>(imageSize);
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(static_cast<typename TImage::PixelType>(index[0] + 2 * index[1]));
+  }
+  return image;
+}
+
+
+// Creates an image whose pixel values vary sinusoidally with the index, with the specified angular frequencies (in
+// radians per pixel), so that its pyramid levels depend strongly on the amount of smoothing.
+template <typename TImage>
+auto
+CreateSinusoidImage(const typename TImage::SizeType & imageSize, const double frequency0, const double frequency1)
+{
+  const auto image = CreateImage<typename TImage::PixelType>(imageSize);
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    const double value =
+      1000.0 + 500.0 * std::sin(frequency0 * index[0]) * std::cos(frequency1 * index[1]) + 3.0 * index[0];
+    it.Set(static_cast<typename TImage::PixelType>(std::round(value)));
+  }
+  return image;
+}
+} // namespace
+
+
+// Checks that a pyramid restricted to a region of interest yields the same pixel values as the full pyramid, within
+// that region.
+GTEST_TEST(GenericMultiResolutionPyramidImageFilter, RegionOfInterestYieldsSameValuesAsFullPyramid)
+{
+  static constexpr auto Dimension = 2U;
+  using ImageType = itk::Image<float, Dimension>;
+  using PyramidType = itk::GenericMultiResolutionPyramidImageFilter<ImageType, ImageType>;
+
+  const auto image = CreateRampImage<ImageType>(itk::Size<Dimension>{ 128, 96 });
+
+  elx::DefaultConstruct<PyramidType> fullPyramid{};
+  fullPyramid.SetNumberOfLevels(3);
+  fullPyramid.SetInput(image);
+  fullPyramid.Update();
+
+  elx::DefaultConstruct<PyramidType> roiPyramid{};
+  roiPyramid.SetNumberOfLevels(3);
+  roiPyramid.SetRegionOfInterest(itk::MakePoint(50.0, 40.0), itk::MakePoint(70.0, 55.0));
+  roiPyramid.UseRegionOfInterestOn();
+  roiPyramid.SetInput(image);
+  roiPyramid.Update();
+
+  for (unsigned int level = 0; level < 3; ++level)
+  {
+    const ImageType & fullOutput = Deref(fullPyramid.GetOutput(level));
+    const ImageType & roiOutput = Deref(roiPyramid.GetOutput(level));
+
+    const auto & roiRegion = roiOutput.GetLargestPossibleRegion();
+    ASSERT_TRUE(fullOutput.GetLargestPossibleRegion().IsInside(roiRegion));
+    EXPECT_LT(roiRegion.GetNumberOfPixels(), fullOutput.GetLargestPossibleRegion().GetNumberOfPixels());
+    EXPECT_EQ(roiOutput.GetSpacing(), fullOutput.GetSpacing());
+    EXPECT_EQ(roiOutput.GetOrigin(), fullOutput.GetOrigin());
+
+    for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(&roiOutput, roiRegion); !it.IsAtEnd(); ++it)
+    {
+      EXPECT_NEAR(it.Get(), fullOutput.GetPixel(it.GetIndex()), 0.1);
+    }
+  }
+}
+
+
+// Checks that a region of interest outside the image falls back to the full image.
+GTEST_TEST(GenericMultiResolutionPyramidImageFilter, RegionOfInterestOutsideImageYieldsFullRegion)
+{
+  static constexpr auto Dimension = 2U;
+  using ImageType = itk::Image<float, Dimension>;
+  using PyramidType = itk::GenericMultiResolutionPyramidImageFilter<ImageType, ImageType>;
+
+  const auto image = CreateRampImage<ImageType>(itk::Size<Dimension>{ 32, 32 });
+
+  elx::DefaultConstruct<PyramidType> fullPyramid{};
+  fullPyramid.SetNumberOfLevels(2);
+  fullPyramid.SetInput(image);
+  fullPyramid.Update();
+
+  elx::DefaultConstruct<PyramidType> roiPyramid{};
+  roiPyramid.SetNumberOfLevels(2);
+  roiPyramid.SetRegionOfInterest(itk::MakePoint(100.0, 100.0), itk::MakePoint(110.0, 110.0));
+  roiPyramid.UseRegionOfInterestOn();
+  roiPyramid.SetInput(image);
+  roiPyramid.Update();
+
+  for (unsigned int level = 0; level < 2; ++level)
+  {
+    EXPECT_EQ(Deref(roiPyramid.GetOutput(level)).GetLargestPossibleRegion(),
+              Deref(fullPyramid.GetOutput(level)).GetLargestPossibleRegion());
+  }
+}
+
+
+// Checks that the cascaded pyramid, which derives each level from the next finer level, closely approximates the
+// default pyramid, away from the image border. The tolerance is exceeded by a pyramid whose sigmas are 10% too large.
+GTEST_TEST(GenericMultiResolutionPyramidImageFilter, CascadedSmoothingApproximatesDefaultPyramid)
+{
+  static constexpr auto Dimension = 2U;
+  using ImageType = itk::Image<float, Dimension>;
+  using PyramidType = itk::GenericMultiResolutionPyramidImageFilter<ImageType, ImageType>;
+
+  static constexpr unsigned int numberOfLevels{ 3 };
+  static constexpr double       tolerance{ 1.0 };
+
+  const auto image = CreateSinusoidImage<ImageType>(itk::Size<Dimension>{ 128, 96 }, 0.3, 0.25);
+
+  elx::DefaultConstruct<PyramidType> defaultPyramid{};
+  defaultPyramid.SetNumberOfLevels(numberOfLevels);
+  defaultPyramid.SetInput(image);
+  defaultPyramid.Update();
+
+  elx::DefaultConstruct<PyramidType> cascadedPyramid{};
+  cascadedPyramid.SetNumberOfLevels(numberOfLevels);
+  cascadedPyramid.UseCascadedSmoothingOn();
+  cascadedPyramid.SetInput(image);
+  cascadedPyramid.Update();
+
+  elx::DefaultConstruct<PyramidType> wrongSigmaPyramid{};
+  wrongSigmaPyramid.SetNumberOfLevels(numberOfLevels);
+  wrongSigmaPyramid.SetSmoothingSchedule(defaultPyramid.GetSmoothingSchedule() * 1.1);
+  wrongSigmaPyramid.SetInput(image);
+  wrongSigmaPyramid.Update();
+
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    const ImageType & defaultOutput = Deref(defaultPyramid.GetOutput(level));
+    const ImageType & cascadedOutput = Deref(cascadedPyramid.GetOutput(level));
+    const ImageType & wrongSigmaOutput = Deref(wrongSigmaPyramid.GetOutput(level));
+
+    ASSERT_EQ(cascadedOutput.GetLargestPossibleRegion(), defaultOutput.GetLargestPossibleRegion());
+    EXPECT_EQ(cascadedOutput.GetSpacing(), defaultOutput.GetSpacing());
+    EXPECT_EQ(cascadedOutput.GetOrigin(), defaultOutput.GetOrigin());
+
+    // Skip the border, where the smoothing is affected by the boundary conditions.
+    auto interiorRegion = defaultOutput.GetLargestPossibleRegion();
+    interiorRegion.ShrinkByRadius(6);
+
+    double maximumCascadedDifference{};
+    double maximumWrongSigmaDifference{};
+
+    for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(&defaultOutput, interiorRegion); !it.IsAtEnd(); ++it)
+    {
+      const auto & index = it.GetIndex();
+      const double defaultValue = it.Get();
+      maximumCascadedDifference =
+        std::max(maximumCascadedDifference, std::abs(cascadedOutput.GetPixel(index) - defaultValue));
+      maximumWrongSigmaDifference =
+        std::max(maximumWrongSigmaDifference, std::abs(wrongSigmaOutput.GetPixel(index) - defaultValue));
+    }
+
+    EXPECT_LT(maximumCascadedDifference, tolerance);
+
+    // The finest level is not smoothed at all.
+    if (level + 1 < numberOfLevels)
+    {
+      EXPECT_GT(maximumWrongSigmaDifference, tolerance);
+    }
+  }
+}
+
+
+// Checks that the levels of an integer output type are the levels of a floating point output type, rounded to the
+// nearest integer, both for the default pipeline (smoother and shrinker) and for a region of interest (resampler).
+GTEST_TEST(GenericMultiResolutionPyramidImageFilter, IntegerOutputIsRoundedFloatingPointOutput)
+{
+  static constexpr auto Dimension = 2U;
+  using ShortImageType = itk::Image<short, Dimension>;
+  using FloatImageType = itk::Image<float, Dimension>;
+
+  const auto image = CreateSinusoidImage<ShortImageType>(itk::Size<Dimension>{ 64, 48 }, 0.7, 0.45);
+
+  for (const bool useRegionOfInterest : { false, true })
+  {
+    elx::DefaultConstruct<itk::GenericMultiResolutionPyramidImageFilter<ShortImageType, ShortImageType>> shortPyramid{};
+    elx::DefaultConstruct<itk::GenericMultiResolutionPyramidImageFilter<ShortImageType, FloatImageType>> floatPyramid{};
+
+    const auto configure = [image, useRegionOfInterest](auto & pyramid) {
+      pyramid.SetNumberOfLevels(3);
+      pyramid.SetRegionOfInterest(itk::MakePoint(10.0, 8.0), itk::MakePoint(40.0, 30.0));
+      pyramid.SetUseRegionOfInterest(useRegionOfInterest);
+      pyramid.SetInput(image);
+      pyramid.Update();
+    };
+    configure(shortPyramid);
+    configure(floatPyramid);
+
+    unsigned int numberOfRoundedPixels{};
+
+    for (unsigned int level = 0; level < 3; ++level)
+    {
+      const ShortImageType & shortOutput = Deref(shortPyramid.GetOutput(level));
+      const FloatImageType & floatOutput = Deref(floatPyramid.GetOutput(level));
+
+      const auto & region = shortOutput.GetLargestPossibleRegion();
+      ASSERT_EQ(region, floatOutput.GetLargestPossibleRegion());
+      EXPECT_EQ(shortOutput.GetSpacing(), floatOutput.GetSpacing());
+      EXPECT_EQ(shortOutput.GetOrigin(), floatOutput.GetOrigin());
+
+      for (itk::ImageRegionConstIteratorWithIndex<ShortImageType> it(&shortOutput, region); !it.IsAtEnd(); ++it)
+      {
+        const float floatValue = floatOutput.GetPixel(it.GetIndex());
+        EXPECT_EQ(it.Get(), static_cast<short>(std::round(floatValue)));
+
+        if (it.Get() > static_cast<short>(floatValue))
+        {
+          ++numberOfRoundedPixels;
+        }
+      }
+    }
+
+    // Truncation would never yield a value above the floating point value, for these positive pixel values.
+    EXPECT_GT(numberOfRoundedPixels, 0U);
+  }
+}
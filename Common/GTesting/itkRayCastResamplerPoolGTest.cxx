@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkRayCastResamplerPool.h"
+#include "itkAdvancedEuler3DTransform.h"
+#include "../Core/Main/GTesting/elxCoreMainGTestUtilities.h"
+
+#include <itkImage.h>
+#include <itkImageBufferRange.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// Using-declarations:
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::CreateImage;
+using elx::CoreMainGTestUtilities::CreateImageFilledWithSequenceOfNaturalNumbers;
+
+
+// Checks that the copies of the pool, evaluated concurrently, produce the same projections as the original ray cast
+// resampler, for a combination transform whose current transform is an Euler transform.
+GTEST_TEST(RayCastResamplerPool, ConcurrentProjectionsEqualOriginalProjections)
+{
+  using ImageType = itk::Image<float, 3>;
+  using PoolType = itk::RayCastResamplerPool<ImageType, ImageType>;
+  using ParametersType = PoolType::ParametersType;
+
+  const auto movingImage = CreateImageFilledWithSequenceOfNaturalNumbers<float>(itk::Size<3>::Filled(24));
+
+  // A single slice "detector", behind the moving image, as seen from the focal point.
+  const auto outputGrid = CreateImage<float>(itk::Size<3>{ 16, 16, 1 });
+  outputGrid->SetOrigin(itk::MakePoint(4.0, 4.0, 100.0));
+
+  const auto eulerTransform = CheckNew<itk::AdvancedEuler3DTransform<double>>();
+  eulerTransform->SetCenter(itk::MakePoint(12.0, 12.0, 12.0));
+
+  const auto combinationTransform = CheckNew<itk::AdvancedCombinationTransform<double, 3>>();
+  combinationTransform->SetCurrentTransform(eulerTransform);
+
+  const auto rayCaster = CheckNew<PoolType::RayCastInterpolatorType>();
+  rayCaster->SetTransform(combinationTransform);
+  rayCaster->SetFocalPoint(itk::MakePoint(12.0, 12.0, -100.0));
+  rayCaster->SetThreshold(0.0);
+  rayCaster->SetInputImage(movingImage);
+
+  PoolType pool;
+  ASSERT_TRUE(pool.Initialize(*rayCaster, *movingImage, *outputGrid, 2));
+  ASSERT_EQ(pool.GetNumberOfCopies(), 2U);
+
+  std::vector<ParametersType> parametersPerEvaluation;
+  for (const double angle : { 0.0, 0.05, -0.1, 0.2, 0.15 })
+  {
+    ParametersType parameters(6, 0.0);
+    parameters[0] = angle;
+    parameters[2] = -angle;
+    parameters[3] = 10.0 * angle;
+    parametersPerEvaluation.push_back(parameters);
+  }
+
+  std::vector<std::vector<float>> actualProjections(parametersPerEvaluation.size());
+
+  const auto threader = itk::MultiThreaderBase::New();
+  threader->SetNumberOfWorkUnits(2);
+
+  pool.EvaluateConcurrently(
+    *threader,
+    parametersPerEvaluation.size(),
+    [&pool, &parametersPerEvaluation, &actualProjections](const unsigned int copyIndex, const itk::SizeValueType i) {
+      pool.SetParameters(copyIndex, parametersPerEvaluation[i]);
+      ImageType & output = *pool.GetOutput(copyIndex);
+      output.UpdateLargestPossibleRegion();
+      const itk::ImageBufferRange<const ImageType> range(output);
+      actualProjections[i].assign(range.cbegin(), range.cend());
+    });
+
+  const auto resampler = itk::ResampleImageFilter<ImageType, ImageType>::New();
+  resampler->SetTransform(combinationTransform);
+  resampler->SetInterpolator(rayCaster);
+  resampler->SetInput(movingImage);
+  resampler->SetOutputParametersFromImage(outputGrid);
+
+  for (std::size_t i = 0; i < parametersPerEvaluation.size(); ++i)
+  {
+    combinationTransform->SetParameters(parametersPerEvaluation[i]);
+    resampler->Modified();
+    resampler->Update();
+
+    const itk::ImageBufferRange<const ImageType> expectedProjection(*resampler->GetOutput());
+    EXPECT_EQ(actualProjections[i], std::vector<float>(expectedProjection.cbegin(), expectedProjection.cend()));
+  }
+
+  // Sanity check: the rays pass through the moving image.
+  EXPECT_NE(actualProjections.front(), std::vector<float>(actualProjections.front().size()));
+}
@@ -0,0 +1,206 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "StatisticalShapePenalty/itkStatisticalShapePointPenalty.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "elxDefaultConstruct.h"
+#include <itkPointSet.h>
+#include <gtest/gtest.h>
+
+#include <cmath> // For abs.
+#include <random>
+
+// The template to be tested.
+using itk::StatisticalShapePointPenalty;
+
+
+namespace
+{
+constexpr unsigned int Dimension{ 3 };
+constexpr unsigned int NumberOfPoints{ 6 };
+
+using PointSetType = itk::PointSet<double, Dimension>;
+using MetricType = StatisticalShapePointPenalty<PointSetType, PointSetType>;
+using TransformType = itk::AdvancedBSplineDeformableTransform<double, Dimension, 3>;
+
+
+// Creates a random symmetric positive definite covariance matrix. The metric takes ownership of the matrix.
+const vnl_matrix<double> *
+CreateCovarianceMatrix(const unsigned int size, std::mt19937 & randomNumberEngine)
+{
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+  vnl_matrix<double> factor(size, size);
+  for (auto & element : factor)
+  {
+    element = distribution(randomNumberEngine);
+  }
+
+  auto * const covarianceMatrix = new vnl_matrix<double>(factor * factor.transpose() / size);
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    (*covarianceMatrix)(i, i) += 0.5;
+  }
+  return covarianceMatrix;
+}
+
+
+// Creates a random mean vector, in the range of the proposal vector of the metric. The metric takes ownership of the
+// vector.
+const vnl_vector<double> *
+CreateMeanVector(const bool normalizedShapeModel, std::mt19937 & randomNumberEngine)
+{
+  constexpr unsigned int shapeLength{ Dimension * NumberOfPoints };
+
+  if (normalizedShapeModel)
+  {
+    // The aligned and normalized shape, followed by the centroid and the size of the shape.
+    std::uniform_real_distribution<double> shapeDistribution(-1.5, 1.5);
+    std::uniform_real_distribution<double> centroidDistribution(12.0, 22.0);
+    std::uniform_real_distribution<double> sizeDistribution(6.0, 10.0);
+
+    auto * const meanVector = new vnl_vector<double>(shapeLength + Dimension + 1);
+    for (unsigned int i = 0; i < shapeLength; ++i)
+    {
+      (*meanVector)[i] = shapeDistribution(randomNumberEngine);
+    }
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      (*meanVector)[shapeLength + d] = centroidDistribution(randomNumberEngine);
+    }
+    (*meanVector)[shapeLength + Dimension] = sizeDistribution(randomNumberEngine);
+    return meanVector;
+  }
+
+  std::uniform_real_distribution<double> coordinateDistribution(5.0, 30.0);
+
+  auto * const meanVector = new vnl_vector<double>(shapeLength);
+  for (auto & element : *meanVector)
+  {
+    element = coordinateDistribution(randomNumberEngine);
+  }
+  return meanVector;
+}
+} // namespace
+
+
+// Checks that the derivative of StatisticalShapePointPenalty matches its central finite difference approximation, for
+// each combination of shape model calculation and normalization that is supported, with a B-spline transform.
+GTEST_TEST(StatisticalShapePointPenalty, DerivativeEqualsFiniteDifferences)
+{
+  using PointType = PointSetType::PointType;
+  using PointsVectorContainerType = PointSetType::PointsVectorContainer;
+
+  for (const int shapeModelCalculation : { 0, 1, 2 })
+  {
+    for (const bool normalizedShapeModel : { false, true })
+    {
+      std::mt19937                           randomNumberEngine{};
+      std::uniform_real_distribution<double> parameterDistribution(-1.0, 1.0);
+      std::uniform_real_distribution<double> coordinateDistribution(5.0, 30.0);
+
+      elx::DefaultConstruct<TransformType> transform{};
+      transform.SetGridOrigin(itk::MakeFilled<itk::Point<double, Dimension>>(-15.0));
+      transform.SetGridSpacing(itk::MakeFilled<itk::Vector<double, Dimension>>(12.0));
+      transform.SetGridRegion(itk::ImageRegion<Dimension>(itk::Size<Dimension>::Filled(10)));
+
+      // The parameters are assumed to be maintained by the caller.
+      TransformType::ParametersType parameters(transform.GetNumberOfParameters());
+      for (auto & parameter : parameters)
+      {
+        parameter = parameterDistribution(randomNumberEngine);
+      }
+      transform.SetParameters(parameters);
+
+      elx::DefaultConstruct<PointsVectorContainerType> pointsVectorContainer{};
+      for (unsigned int i = 0; i < NumberOfPoints; ++i)
+      {
+        PointType point;
+        for (auto & coordinate : point)
+        {
+          coordinate = coordinateDistribution(randomNumberEngine);
+        }
+        pointsVectorContainer.CastToSTLContainer().push_back(point);
+      }
+
+      elx::DefaultConstruct<PointSetType> pointSet{};
+      pointSet.SetPoints(&pointsVectorContainer);
+
+      const unsigned int proposalLength = Dimension * NumberOfPoints + (normalizedShapeModel ? Dimension + 1 : 0);
+
+      elx::DefaultConstruct<MetricType> metric{};
+      metric.SetFixedPointSet(&pointSet);
+      metric.SetMovingPointSet(&pointSet);
+      metric.SetTransform(&transform);
+      metric.SetMeanVector(CreateMeanVector(normalizedShapeModel, randomNumberEngine));
+      metric.SetCovarianceMatrix(CreateCovarianceMatrix(proposalLength, randomNumberEngine));
+      metric.SetShapeModelCalculation(shapeModelCalculation);
+      metric.SetNormalizedShapeModel(normalizedShapeModel);
+      metric.SetShrinkageIntensity(0.3);
+      metric.SetBaseVariance(1.0);
+      metric.SetCentroidXVariance(4.0);
+      metric.SetCentroidYVariance(4.0);
+      metric.SetCentroidZVariance(4.0);
+      metric.SetSizeVariance(2.0);
+
+      // Shape model calculation 1 requires an unnormalized, and 2 a normalized shape model.
+      if ((shapeModelCalculation == 1 && normalizedShapeModel) || (shapeModelCalculation == 2 && !normalizedShapeModel))
+      {
+        EXPECT_THROW(metric.Initialize(), itk::ExceptionObject);
+        continue;
+      }
+      metric.Initialize();
+
+      MetricType::MeasureType    value{};
+      MetricType::DerivativeType derivative;
+      metric.GetValueAndDerivative(parameters, value, derivative);
+
+      EXPECT_GT(value, 0.0);
+      EXPECT_DOUBLE_EQ(metric.GetValue(parameters), value);
+      ASSERT_EQ(derivative.size(), parameters.size());
+
+      constexpr double stepSize{ 1e-5 };
+      auto             shiftedParameters = parameters;
+      unsigned int     numberOfNonZeroDerivatives{};
+
+      for (unsigned int i = 0; i < parameters.size(); ++i)
+      {
+        shiftedParameters[i] = parameters[i] + stepSize;
+        const double forwardValue = metric.GetValue(shiftedParameters);
+        shiftedParameters[i] = parameters[i] - stepSize;
+        const double backwardValue = metric.GetValue(shiftedParameters);
+        shiftedParameters[i] = parameters[i];
+
+        const double finiteDifference = (forwardValue - backwardValue) / (2.0 * stepSize);
+        EXPECT_NEAR(derivative[i], finiteDifference, 1e-6 + 1e-5 * std::abs(finiteDifference))
+          << " shapeModelCalculation = " << shapeModelCalculation
+          << ", normalizedShapeModel = " << normalizedShapeModel << ", parameter index = " << i;
+
+        if (derivative[i] != 0.0)
+        {
+          ++numberOfNonZeroDerivatives;
+        }
+      }
+
+      // Only the parameters in the support of the points have a nonzero derivative.
+      EXPECT_GT(numberOfNonZeroDerivatives, 0U);
+      EXPECT_LT(numberOfNonZeroDerivatives, parameters.size());
+    }
+  }
+}
@@ -0,0 +1,263 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "BendingEnergyPenalty/itkTransformBendingEnergyPenaltyTerm.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+#include "itkAdvancedTranslationTransform.h"
+#include "itkImageFullSampler.h"
+#include "GTesting/elxCoreMainGTestUtilities.h"
+#include "elxGTestUtilities.h"
+#include "elxDefaultConstruct.h"
+#include <itkImage.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
+#include <gtest/gtest.h>
+
+#include <cmath> // For abs.
+
+using elx::CoreMainGTestUtilities::CreateImage;
+using elx::GTestUtilities::GeneratePseudoRandomParameters;
+using elx::GTestUtilities::InitializeMetric;
+using elx::GTestUtilities::ValueAndDerivative;
+
+
+namespace
+{
+constexpr unsigned int imageDimension{ 2 };
+using ImageType = itk::Image<float, imageDimension>;
+using TransformType = itk::AdvancedBSplineDeformableTransform<double, imageDimension, 3>;
+using PenaltyType = itk::TransformBendingEnergyPenaltyTerm<ImageType, double>;
+
+constexpr double gridSpacing[] = { 2.0, 3.0 };
+
+
+// Sets an anisotropic grid, of which the valid region encloses the fixed image of PenaltyComponents.
+void
+SetGrid(TransformType & transform)
+{
+  transform.SetGridOrigin(itk::MakeFilled<TransformType::OriginType>(-3.0));
+  transform.SetGridSpacing(itk::MakeVector(gridSpacing[0], gridSpacing[1]));
+  transform.SetGridRegion(TransformType::RegionType(itk::Size<imageDimension>::Filled(9)));
+}
+
+
+// Holds the components that the penalty term needs, in addition to the transform.
+struct PenaltyComponents
+{
+  ImageType::Pointer fixedImage{ CreateImage<float>(itk::Size<imageDimension>::Filled(8)) };
+
+  elx::DefaultConstruct<itk::NearestNeighborInterpolateImageFunction<ImageType>> interpolator{};
+  elx::DefaultConstruct<itk::ImageFullSampler<ImageType>>                          imageSampler{};
+
+  void
+  InitializePenalty(PenaltyType & penalty, itk::AdvancedTransform<double, imageDimension, imageDimension> & transform)
+  {
+    InitializeMetric(
+      penalty, *fixedImage, *fixedImage, imageSampler, transform, interpolator, fixedImage->GetBufferedRegion());
+  }
+};
+
+} // namespace
+
+
+// Tests that the grid-based evaluation yields the exact bending energy of a B-spline transform whose coefficients are
+// quadratic in the grid index, for which the spatial Hessian is constant. The sampled evaluation yields the same value.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, GridBasedEvaluationIsExactForQuadraticCoefficients)
+{
+  // A cubic B-spline reproduces quadratic polynomials, so coefficients a * i^2 and b * i * j yield displacements
+  // a * u^2 + constant and b * u * v, where (u, v) is the continuous grid index.
+  constexpr double a{ 0.3 };
+  constexpr double b{ -0.2 };
+  const double     expectedValue = 4.0 * a * a / std::pow(gridSpacing[0], 4) +
+                               2.0 * b * b / (gridSpacing[0] * gridSpacing[0] * gridSpacing[1] * gridSpacing[1]);
+
+  for (const bool useGridBasedEvaluation : { false, true })
+  {
+    elx::DefaultConstruct<TransformType> transform{};
+    SetGrid(transform);
+
+    itk::OptimizerParameters<double> parameters(transform.GetNumberOfParameters());
+    const unsigned int               numberOfCoefficients = parameters.size() / imageDimension;
+    for (unsigned int n = 0; n < numberOfCoefficients; ++n)
+    {
+      const double i = n % 9;
+      const double j = n / 9;
+      parameters[n] = a * i * i;
+      parameters[n + numberOfCoefficients] = b * i * j;
+    }
+    transform.SetParameters(parameters);
+
+    PenaltyComponents                  components;
+    elx::DefaultConstruct<PenaltyType> penalty{};
+    penalty.SetUseGridBasedEvaluation(useGridBasedEvaluation);
+    components.InitializePenalty(penalty, transform);
+
+    EXPECT_NEAR(penalty.GetValue(parameters), expectedValue, 1e-9 * expectedValue);
+    EXPECT_NEAR(ValueAndDerivative::FromCostFunction(penalty, parameters).value, expectedValue, 1e-9 * expectedValue);
+  }
+}
+
+
+// Tests that the derivative of the grid-based evaluation corresponds with central finite differences of its value.
+// As the bending energy is a quadratic form in the coefficients, central differences are exact, up to round-off.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, GridBasedDerivativeCorrespondsWithFiniteDifferences)
+{
+  elx::DefaultConstruct<TransformType> transform{};
+  SetGrid(transform);
+
+  auto parameters = GeneratePseudoRandomParameters(transform.GetNumberOfParameters(), -2.0, 2.0);
+  transform.SetParameters(parameters);
+
+  PenaltyComponents                  components;
+  elx::DefaultConstruct<PenaltyType> penalty{};
+  penalty.SetUseGridBasedEvaluation(true);
+  components.InitializePenalty(penalty, transform);
+
+  const auto valueAndDerivative = ValueAndDerivative::FromCostFunction(penalty, parameters);
+  EXPECT_EQ(valueAndDerivative.value, penalty.GetValue(parameters));
+
+  constexpr double delta{ 1e-3 };
+  for (unsigned int n = 0; n < parameters.size(); n += 7)
+  {
+    const double originalParameter = parameters[n];
+    parameters[n] = originalParameter + delta;
+    const double valueAfter = penalty.GetValue(parameters);
+    parameters[n] = originalParameter - delta;
+    const double valueBefore = penalty.GetValue(parameters);
+    parameters[n] = originalParameter;
+
+    const double expectedDerivative = (valueAfter - valueBefore) / (2.0 * delta);
+    EXPECT_NEAR(valueAndDerivative.derivative[n], expectedDerivative, 1e-6 * (1.0 + std::abs(expectedDerivative)));
+  }
+}
+
+
+// Tests that the grid-based evaluation requires a B-spline transform.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, GridBasedEvaluationThrowsWithoutBSplineTransform)
+{
+  elx::DefaultConstruct<itk::AdvancedTranslationTransform<double, imageDimension>> transform{};
+
+  PenaltyComponents                  components;
+  elx::DefaultConstruct<PenaltyType> penalty{};
+  penalty.SetUseGridBasedEvaluation(true);
+  EXPECT_THROW(components.InitializePenalty(penalty, transform), itk::ExceptionObject);
+}
+
+
+// Tests that the sample derivative cache, used when the B-spline weight cache is enabled, yields the same value and
+// derivative as the regular evaluation, up to round-off, both single-threaded and multi-threaded.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, SampleDerivativeCacheYieldsSameResults)
+{
+  elx::DefaultConstruct<TransformType> transform{};
+  SetGrid(transform);
+
+  const auto parameters = GeneratePseudoRandomParameters(transform.GetNumberOfParameters(), -2.0, 2.0);
+  transform.SetParameters(parameters);
+
+  for (const bool useMultiThread : { false, true })
+  {
+    PenaltyComponents                  components;
+    elx::DefaultConstruct<PenaltyType> uncachedPenalty{};
+    elx::DefaultConstruct<PenaltyType> cachedPenalty{};
+    uncachedPenalty.SetUseMultiThread(useMultiThread);
+    cachedPenalty.SetUseMultiThread(useMultiThread);
+    cachedPenalty.SetUseBSplineWeightCache(true);
+    components.InitializePenalty(uncachedPenalty, transform);
+    components.InitializePenalty(cachedPenalty, transform);
+    EXPECT_FALSE(uncachedPenalty.GetBSplineWeightCacheIsBuilt());
+    EXPECT_TRUE(cachedPenalty.GetBSplineWeightCacheIsBuilt());
+
+    const double expectedValue = uncachedPenalty.GetValue(parameters);
+    EXPECT_NEAR(cachedPenalty.GetValue(parameters), expectedValue, 1e-12 * expectedValue);
+
+    const auto expected = ValueAndDerivative::FromCostFunction(uncachedPenalty, parameters);
+    const auto actual = ValueAndDerivative::FromCostFunction(cachedPenalty, parameters);
+    EXPECT_NEAR(actual.value, expected.value, 1e-12 * expected.value);
+    ASSERT_EQ(actual.derivative.size(), expected.derivative.size());
+
+    for (unsigned int n = 0; n < expected.derivative.size(); ++n)
+    {
+      EXPECT_NEAR(actual.derivative[n], expected.derivative[n], 1e-12 * (1.0 + std::abs(expected.derivative[n])));
+    }
+  }
+}
+
+
+// Tests that the sample derivative cache also yields the same value and derivative as the regular evaluation when the
+// B-spline transform is combined with an initial transform, by composition and by addition. The affine initial
+// transform only affects the cached Jacobian of the spatial Hessian, whereas the spatial Hessian of the B-spline
+// initial transform also yields a coefficient-independent offset.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, SampleDerivativeCacheYieldsSameResultsWithInitialTransform)
+{
+  using AffineTransformType = itk::AdvancedMatrixOffsetTransformBase<double, imageDimension, imageDimension>;
+  using CombinationTransformType = itk::AdvancedCombinationTransform<double, imageDimension>;
+
+  const auto                      affineTransform = AffineTransformType::New();
+  AffineTransformType::MatrixType matrix;
+  matrix(0, 0) = 1.1;
+  matrix(0, 1) = 0.1;
+  matrix(1, 0) = -0.05;
+  matrix(1, 1) = 0.95;
+  affineTransform->SetMatrix(matrix);
+  affineTransform->SetTranslation(itk::MakeVector(0.3, 0.4));
+
+  const auto initialBSplineTransform = TransformType::New();
+  SetGrid(*initialBSplineTransform);
+  const auto initialParameters =
+    GeneratePseudoRandomParameters(initialBSplineTransform->GetNumberOfParameters(), -0.3, 0.3);
+  initialBSplineTransform->SetParameters(initialParameters);
+
+  const auto bsplineTransform = TransformType::New();
+  SetGrid(*bsplineTransform);
+  const auto parameters = GeneratePseudoRandomParameters(bsplineTransform->GetNumberOfParameters(), -2.0, 2.0);
+  bsplineTransform->SetParameters(parameters);
+
+  for (CombinationTransformType::InitialTransformType * const initialTransform :
+       { static_cast<CombinationTransformType::InitialTransformType *>(affineTransform.GetPointer()),
+         static_cast<CombinationTransformType::InitialTransformType *>(initialBSplineTransform.GetPointer()) })
+  {
+    for (const bool useComposition : { true, false })
+    {
+      elx::DefaultConstruct<CombinationTransformType> transform{};
+      transform.SetCurrentTransform(bsplineTransform);
+      transform.SetInitialTransform(initialTransform);
+      transform.SetUseComposition(useComposition);
+
+      PenaltyComponents                  components;
+      elx::DefaultConstruct<PenaltyType> uncachedPenalty{};
+      elx::DefaultConstruct<PenaltyType> cachedPenalty{};
+      cachedPenalty.SetUseBSplineWeightCache(true);
+      components.InitializePenalty(uncachedPenalty, transform);
+      components.InitializePenalty(cachedPenalty, transform);
+      EXPECT_TRUE(cachedPenalty.GetBSplineWeightCacheIsBuilt());
+
+      const auto expected = ValueAndDerivative::FromCostFunction(uncachedPenalty, parameters);
+      const auto actual = ValueAndDerivative::FromCostFunction(cachedPenalty, parameters);
+      EXPECT_GT(expected.value, 0.0);
+      EXPECT_NEAR(actual.value, expected.value, 1e-10 * expected.value);
+      ASSERT_EQ(actual.derivative.size(), expected.derivative.size());
+
+      for (unsigned int n = 0; n < expected.derivative.size(); ++n)
+      {
+        EXPECT_NEAR(actual.derivative[n], expected.derivative[n], 1e-10 * (1.0 + std::abs(expected.derivative[n])));
+      }
+    }
+  }
+}
@@ -23,6 +23,7 @@
 #include "itkArray.h"
 #include "itkMetaDataObject.h"
 #include "itkVersion.h"
+#include "itkMultiThreaderBase.h"
 #include "itkNumericTraits.h"
 
 // developed using gdcm 2.0 and libtiff 3.8.2
@@ -44,6 +45,8 @@
 #include "gdcmException.h"
 #include "gdcmFileMetaInformation.h"
 
+#include <algorithm>
+#include <cstdio> // For SEEK_CUR and SEEK_END.
 #include <sstream>
 #include <string>
 #include <vector>
@@ -55,6 +58,143 @@
 
 #include <itksys/SystemTools.hxx>
 
+#if TIFFLIB_VERSION >= 20191103
+namespace
+{
+// An in-memory file, used by libtiff to compress a single tile, independently of the other tiles of the image.
+struct TIFFMemoryFile
+{
+  std::vector<unsigned char> data{};
+  std::size_t                position{};
+};
+
+
+tmsize_t
+ReadTIFFMemoryFile(thandle_t handle, void * buffer, tmsize_t size)
+{
+  auto &            file = *static_cast<TIFFMemoryFile *>(handle);
+  const std::size_t available = (file.position < file.data.size()) ? file.data.size() - file.position : 0;
+  const std::size_t count = std::min(static_cast<std::size_t>(size), available);
+  if (count > 0)
+  {
+    memcpy(buffer, file.data.data() + file.position, count);
+  }
+  file.position += count;
+  return static_cast<tmsize_t>(count);
+}
+
+
+tmsize_t
+WriteTIFFMemoryFile(thandle_t handle, void * buffer, tmsize_t size)
+{
+  auto & file = *static_cast<TIFFMemoryFile *>(handle);
+  if (file.position + size > file.data.size())
+  {
+    file.data.resize(file.position + size);
+  }
+  if (size > 0)
+  {
+    memcpy(file.data.data() + file.position, buffer, size);
+  }
+  file.position += size;
+  return size;
+}
+
+
+toff_t
+SeekTIFFMemoryFile(thandle_t handle, toff_t offset, int whence)
+{
+  auto & file = *static_cast<TIFFMemoryFile *>(handle);
+  switch (whence)
+  {
+    case SEEK_CUR:
+      file.position += offset;
+      break;
+    case SEEK_END:
+      file.position = file.data.size() + offset;
+      break;
+    default:
+      file.position = offset;
+  }
+  return file.position;
+}
+
+
+int
+CloseTIFFMemoryFile(thandle_t)
+{
+  return 0;
+}
+
+
+toff_t
+GetTIFFMemoryFileSize(thandle_t handle)
+{
+  return static_cast<TIFFMemoryFile *>(handle)->data.size();
+}
+
+
+int
+MapTIFFMemoryFile(thandle_t, void **, toff_t *)
+{
+  return 0;
+}
+
+
+void
+UnmapTIFFMemoryFile(thandle_t, void *, toff_t)
+{}
+
+
+// Compresses the specified tile by LZW, as TIFFWriteTile would do, and stores the result in encodedTile. Leaves
+// encodedTile empty when the compression fails.
+void
+EncodeTileLZW(std::vector<unsigned char> & tile,
+              const unsigned int           tileWidth,
+              const unsigned int           tileLength,
+              const unsigned int           bitsPerSample,
+              const uint16_t               sampleFormat,
+              std::vector<unsigned char> & encodedTile)
+{
+  TIFFMemoryFile file;
+  TIFF * const   tiff = TIFFClientOpen("tile",
+                                     "w",
+                                     &file,
+                                     ReadTIFFMemoryFile,
+                                     WriteTIFFMemoryFile,
+                                     SeekTIFFMemoryFile,
+                                     CloseTIFFMemoryFile,
+                                     GetTIFFMemoryFileSize,
+                                     MapTIFFMemoryFile,
+                                     UnmapTIFFMemoryFile);
+  if (tiff == nullptr)
+  {
+    return;
+  }
+
+  // A single-tile image, with the same sample layout and compression as the image that is written.
+  if (TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, tileWidth) && TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, tileLength) &&
+      TIFFSetField(tiff, TIFFTAG_TILEWIDTH, tileWidth) && TIFFSetField(tiff, TIFFTAG_TILELENGTH, tileLength) &&
+      TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, bitsPerSample) && TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, 1) &&
+      TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, sampleFormat) &&
+      TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG) &&
+      TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK) &&
+      TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_LZW) &&
+      TIFFWriteTile(tiff, tile.data(), 0, 0, 0, 0) >= 0)
+  {
+    const auto offset = static_cast<std::size_t>(TIFFGetStrileOffset(tiff, 0));
+    const auto byteCount = static_cast<std::size_t>(TIFFGetStrileByteCount(tiff, 0));
+    if (byteCount > 0 && offset + byteCount <= file.data.size())
+    {
+      encodedTile.assign(file.data.cbegin() + offset, file.data.cbegin() + offset + byteCount);
+    }
+  }
+  TIFFClose(tiff);
+}
+
+} // namespace
+#endif
+
 namespace itk
 {
 
@@ -843,328 +983,138 @@ MevisDicomTiffImageIO::Read(void * buffer)
       itkExceptionMacro("mevisIO:read(): unsupported tiledepth (should be one)! ");
     }
 
-    // buffer pointer is scanline based (one dimensional array)
-    // tile is positioned on x,y,z; we read each tile, and fill
-    // the corresponding positions in the onedimensional array
-    auto * vol = reinterpret_cast<unsigned char *>(buffer);
-
-    const unsigned int tilesize = TIFFTileSize(m_TIFFImage);
-    const unsigned int tilerowbytes = TIFFTileRowSize(m_TIFFImage);
-    const unsigned int bytespersample = m_BitsPerSample / 8;
-
-    auto * tilebuf = static_cast<unsigned char *>(_TIFFmalloc(tilesize));
-
-    //
-    // special cases, if the tilexy is larger than or equal to the image
-    // size itself, treat as three separate cases, both are larger/equal,
-    // or only direction
-    //
-    bool tileoversized(false);
+    // The requested region, in tiff coordinates: x, y, and the tiff slice. In 4D, the slices of all time points are
+    // stacked along the z-direction of the tiff image. Dimensions that are missing in the region have size one.
+    const ImageIORegion & region = this->GetIORegion();
+    const auto            regionIndex = [&region](const unsigned int i) {
+      return i < region.GetImageDimension() ? static_cast<unsigned int>(region.GetIndex(i)) : 0U;
+    };
+    const auto regionSize = [&region](const unsigned int i) {
+      return i < region.GetImageDimension() ? static_cast<unsigned int>(region.GetSize(i)) : 1U;
+    };
+    const unsigned int regionX0 = regionIndex(0);
+    const unsigned int regionWidth = regionSize(0);
+    const unsigned int regionY0 = regionIndex(1);
+    const unsigned int regionLength = regionSize(1);
+    const unsigned int depth = (this->GetNumberOfDimensions() > 2) ? m_Dimensions[2] : 1;
+    const unsigned int numberOfTIFFSlices = (m_TIFFDimension == 3) ? m_Depth : 1;
+
+    std::vector<unsigned int> slices;
+    for (unsigned int t = regionIndex(3); t < regionIndex(3) + regionSize(3); ++t)
+    {
+      for (unsigned int z = regionIndex(2); z < regionIndex(2) + regionSize(2); ++z)
+      {
+        slices.push_back(t * depth + z);
+      }
+    }
 
-    if (m_TileLength >= m_Length || m_TileWidth >= m_Width)
+    if (regionX0 + regionWidth > m_Width || regionY0 + regionLength > m_Length ||
+        regionIndex(2) + regionSize(2) > depth || (!slices.empty() && slices.back() >= numberOfTIFFSlices))
     {
-      tileoversized = true;
+      itkExceptionMacro("mevisIO:read(): requested region is outside the image");
+    }
 
-      // case one both x,y is larger
-      if (m_TileLength >= m_Length && m_TileWidth >= m_Width)
+    // The tiles that overlap with the requested region, and the index of the region slice they belong to.
+    struct TileType
+    {
+      unsigned int x0;
+      unsigned int y0;
+      unsigned int z0;
+      unsigned int slice;
+    };
+    std::vector<TileType> tiles;
+    for (unsigned int slice = 0; slice < slices.size(); ++slice)
+    {
+      for (unsigned int y0 = regionY0 - regionY0 % m_TileLength; y0 < regionY0 + regionLength; y0 += m_TileLength)
       {
-        for (unsigned int z0 = 0; z0 < (m_TIFFDimension == 3 ? m_Depth : 1); ++z0)
+        for (unsigned int x0 = regionX0 - regionX0 % m_TileWidth; x0 < regionX0 + regionWidth; x0 += m_TileWidth)
         {
-          if (TIFFReadTile(m_TIFFImage, tilebuf, 0, 0, z0, 0) < 0)
-          {
-            _TIFFfree(tilebuf);
-            itkExceptionMacro("mevisIO:read(): error reading tile (topleft)");
-          }
-          else
-          {
-            // do row based copy of tile into volume
-            const unsigned     lenx = m_Width;
-            const unsigned     leny = m_Length;
-            const unsigned int tilexbytes = lenx * bytespersample;
-
-            unsigned char *    pv = vol;
-            const unsigned int p = z0 * m_Length * m_Width;
-            pv += p * bytespersample;
-
-            unsigned char * pb = tilebuf;
-            for (unsigned int r = 0; r < leny; ++r)
-            {
-              memcpy(pv, pb, tilexbytes);
-              pv += tilexbytes;
-              pb += tilerowbytes;
-            }
-          }
+          tiles.push_back({ x0, y0, slices[slice], slice });
         }
-      } // end case one
+      }
+    }
 
-      // case two, larger x, smaller y
-      if (m_TileWidth >= m_Width && m_TileLength < m_Length)
-      {
+    // buffer pointer is scanline based (one dimensional array), of the size of the requested region.
+    // each tile is positioned on x,y,z; we read each tile, and copy its intersection with the
+    // requested region to the corresponding positions in the onedimensional array
+    auto * const vol = static_cast<unsigned char *>(buffer);
 
-        const unsigned     lenx = m_Width;
-        const unsigned int tilexbytes = lenx * bytespersample;
+    const tmsize_t     tilesize = TIFFTileSize(m_TIFFImage);
+    const tmsize_t     tilerowbytes = TIFFTileRowSize(m_TIFFImage);
+    const unsigned int bytespersample = m_BitsPerSample / 8;
 
-        const bool my = (m_Length % m_TileLength == 0) ? true : false;
-        for (unsigned int z0 = 0; z0 < (m_TIFFDimension == 3 ? m_Depth : 1); ++z0)
-        {
-          for (unsigned int y0 = 0; y0 < (my ? m_Length : m_Length - m_TileLength); y0 += m_TileLength)
-          {
-            if (TIFFReadTile(m_TIFFImage, tilebuf, 0, y0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (top image)");
-            }
-            else
-            {
-
-              unsigned char *    pb = tilebuf;
-              unsigned char *    pv = vol;
-              const unsigned int p = z0 * m_Length * m_Width + y0 * m_Width;
-              pv += p * bytespersample;
-
-              for (unsigned int r = 0; r < m_TileLength; ++r)
-              {
-                memcpy(pv, pb, tilerowbytes);
-                pv += tilexbytes;
-                pb += tilerowbytes;
-              }
-            }
-          }
+    const auto copyTile = [&](const TileType & tile, const unsigned char * const tilebuf) {
+      const unsigned int xBegin = std::max(tile.x0, regionX0);
+      const unsigned int xEnd = std::min(tile.x0 + m_TileWidth, regionX0 + regionWidth);
+      const unsigned int yBegin = std::max(tile.y0, regionY0);
+      const unsigned int yEnd = std::min(tile.y0 + m_TileLength, regionY0 + regionLength);
 
-          if (!my)
-          {
-            const unsigned     leny = m_Length % m_TileLength;
-            const unsigned int y0 = m_Length - leny;
-
-            if (TIFFReadTile(m_TIFFImage, tilebuf, 0, y0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (strip bottom)");
-            }
-            else
-            {
-              unsigned char *    pb = tilebuf;
-              unsigned char *    pv = vol;
-              const unsigned int p = z0 * m_Length * m_Width + y0 * m_Width;
-              pv += p * bytespersample;
-
-              for (unsigned int r = 0; r < leny; ++r)
-              {
-                memcpy(pv, pb, tilexbytes);
-                pv += tilexbytes;
-                pb += tilerowbytes;
-              }
-            }
-          }
-        }
+      for (unsigned int y = yBegin; y < yEnd; ++y)
+      {
+        const std::size_t offset =
+          (static_cast<std::size_t>(tile.slice) * regionLength + (y - regionY0)) * regionWidth + (xBegin - regionX0);
+        memcpy(vol + offset * bytespersample,
+               tilebuf + (y - tile.y0) * tilerowbytes + (xBegin - tile.x0) * bytespersample,
+               (xEnd - xBegin) * bytespersample);
+      }
+    };
 
-      } // end case two
+    // A TIFF handle is not thread-safe, so each work unit except the first one opens the file once more, and reads
+    // a contiguous part of the tiles by its own handle.
+    const auto numberOfWorkUnits = static_cast<unsigned int>(
+      std::min<std::size_t>(MultiThreaderBase::GetGlobalDefaultNumberOfThreads(), tiles.size()));
+    std::vector<std::string> errors(numberOfWorkUnits);
 
-      // case three, smaller x, larger y
-      if (m_TileWidth < m_Width && m_TileLength >= m_Length)
+    const auto readTiles = [&](const SizeValueType workUnit) {
+      TIFF * const tiff = (workUnit == 0) ? m_TIFFImage : TIFFOpen(m_TiffFileName.c_str(), "rc");
+      if (tiff == nullptr)
       {
+        errors[workUnit] = "error opening tif file " + m_TiffFileName;
+        return;
+      }
+      auto * const tilebuf = static_cast<unsigned char *>(_TIFFmalloc(tilesize));
+      if (tilebuf == nullptr)
+      {
+        errors[workUnit] = "error allocating tile buffer";
+      }
+      else
+      {
+        const std::size_t first = tiles.size() * workUnit / numberOfWorkUnits;
+        const std::size_t last = tiles.size() * (workUnit + 1) / numberOfWorkUnits;
 
-        const unsigned leny = m_Length;
-        const bool     mx = (m_Width % m_TileWidth == 0) ? true : false;
-
-        for (unsigned int z0 = 0; z0 < (m_TIFFDimension == 3 ? m_Depth : 1); ++z0)
+        for (std::size_t i = first; i < last; ++i)
         {
-          for (unsigned int x0 = 0; x0 < (mx ? m_Width : m_Width - m_TileWidth); x0 += m_TileWidth)
-          {
-            // read tile
-            if (TIFFReadTile(m_TIFFImage, tilebuf, x0, 0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (top image)");
-            }
-            else
-            {
-              unsigned char *    pb = tilebuf;
-              unsigned char *    pv = vol;
-              const unsigned int p = z0 * m_Length * m_Width + x0;
-              pv += p * bytespersample;
-
-              for (unsigned int r = 0; r < leny; ++r)
-              {
-                memcpy(pv, pb, tilerowbytes);
-                pv += m_Width * bytespersample;
-                pb += tilerowbytes;
-              }
-            }
-          }
-          // fill strip right
-          if (!mx)
+          if (TIFFReadTile(tiff, tilebuf, tiles[i].x0, tiles[i].y0, tiles[i].z0, 0) < 0)
           {
-            const unsigned     lenx = m_Width % m_TileWidth;
-            const unsigned int x0 = m_Width - lenx;
-            const unsigned int tilexbytes = lenx * bytespersample;
-
-            if (TIFFReadTile(m_TIFFImage, tilebuf, x0, 0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (strip right)");
-            }
-            else
-            {
-              unsigned char *    pb = tilebuf;
-              unsigned char *    pv = vol;
-              const unsigned int p = z0 * m_Length * m_Width + x0;
-              pv += p * bytespersample;
-
-              for (unsigned int r = 0; r < leny; ++r)
-              {
-                memcpy(pv, pb, tilexbytes);
-                pv += m_Width * bytespersample;
-                pb += tilerowbytes;
-              }
-            }
+            errors[workUnit] = "error reading tile";
+            break;
           }
+          copyTile(tiles[i], tilebuf);
         }
+        _TIFFfree(tilebuf);
+      }
+      if (tiff != m_TIFFImage)
+      {
+        TIFFClose(tiff);
+      }
+    };
 
-      } // end case three
-
-    } // end oversized tile
-
-    //
-    // normal case, tile is smaller than image
-    //
-    if (!tileoversized)
+    if (numberOfWorkUnits == 1)
+    {
+      readTiles(0);
+    }
+    else if (numberOfWorkUnits > 1)
     {
-      // is volume direction a multiple of tiledirection?
-      const bool mx = (m_Width % m_TileWidth == 0) ? true : false;
-      const bool my = (m_Length % m_TileLength == 0) ? true : false;
+      MultiThreaderBase::New()->ParallelizeArray(0, numberOfWorkUnits, readTiles, nullptr);
+    }
 
-      // fill everything inside ie from topleft
-      for (unsigned int z0 = 0; z0 < (m_TIFFDimension == 3 ? m_Depth : 1); ++z0)
+    for (const auto & error : errors)
+    {
+      if (!error.empty())
       {
-        for (unsigned int y0 = 0; y0 < (my ? m_Length : m_Length - m_TileLength); y0 += m_TileLength)
-        {
-          for (unsigned int x0 = 0; x0 < (mx ? m_Width : m_Width - m_TileWidth); x0 += m_TileWidth)
-          {
-            // x0,y0,z0 is position of tile in volume, top left corner
-            // pointer to volume (at 0,0,0)
-            unsigned char * pv = vol;
-
-            // set pointer of volume to y0,x0,z0 position
-            const unsigned int p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-            pv += p * bytespersample;
-
-            // read tile
-            if (TIFFReadTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (topleft image)");
-            }
-            else
-            {
-              // do row based copy of tile into volume
-              unsigned char * pb = tilebuf;
-              for (unsigned int r = 0; r < m_TileLength; ++r)
-              {
-                memcpy(pv, pb, tilerowbytes);
-                // move pointers
-                // x remain same, y is one complete vol line
-                // (ie width of image)
-                pv += m_Width * bytespersample;
-                pb += tilerowbytes;
-              }
-            }
-          }
-        }
-        // fill boundaries
-        if (!mx)
-        {
-          // x is fixed
-          const unsigned     lenx = m_Width % m_TileWidth;
-          const unsigned int x0 = m_Width - lenx;
-          const unsigned int tilexbytes = lenx * bytespersample;
-
-          for (unsigned int y0 = 0; y0 < (my ? m_Length : m_Length - m_TileLength); y0 += m_TileLength)
-          {
-            unsigned char *    pv = vol;
-            const unsigned int p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-            pv += p * bytespersample;
-
-            if (TIFFReadTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (ydirection)");
-            }
-            else
-            {
-              unsigned char * pb = tilebuf;
-              for (unsigned int r = 0; r < m_TileLength; ++r)
-              {
-                memcpy(pv, pb, tilexbytes);
-                pv += m_Width * bytespersample;
-                pb += tilerowbytes;
-              }
-            }
-          }
-        }
-        if (!my)
-        {
-          // y is fixed
-          const unsigned     leny = m_Length % m_TileLength;
-          const unsigned int y0 = m_Length - leny;
-
-          for (unsigned int x0 = 0; x0 < (mx ? m_Width : m_Width - m_TileWidth); x0 += m_TileWidth)
-          {
-            unsigned char *    pv = vol;
-            const unsigned int p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-            pv += p * bytespersample;
-
-            if (TIFFReadTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-            {
-              _TIFFfree(tilebuf);
-              itkExceptionMacro("mevisIO:read(): error reading tile (x-direction)");
-            }
-            else
-            {
-              unsigned char * pb = tilebuf;
-              for (unsigned int r = 0; r < leny; ++r)
-              {
-                memcpy(pv, pb, tilerowbytes);
-                pv += m_Width * bytespersample;
-                pb += tilerowbytes;
-              }
-            }
-          }
-        }
-        // fill corner bottom
-        if (!mx && !my)
-        {
-          // x0,y0 is fixed
-          const unsigned     lenx = m_Width % m_TileWidth;
-          const unsigned int x0 = m_Width - lenx;
-          const unsigned int tilexbytes = lenx * bytespersample;
-          const unsigned     leny = m_Length % m_TileLength;
-          const unsigned int y0 = m_Length - leny;
-
-          unsigned char *    pv = vol;
-          const unsigned int p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-          pv += p * bytespersample;
-
-          if (TIFFReadTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-          {
-            _TIFFfree(tilebuf);
-            itkExceptionMacro("mevisIO:read(): error reading tile (corner bottom)");
-          }
-          else
-          {
-            unsigned char * pb = tilebuf;
-            for (unsigned int r = 0; r < leny; ++r)
-            {
-              memcpy(pv, pb, tilexbytes);
-              pv += m_Width * bytespersample;
-              pb += tilerowbytes;
-            }
-          }
-        }
+        itkExceptionMacro("mevisIO:read(): " << error);
       }
     }
-
-    _TIFFfree(tilebuf);
   }
   else
   {
@@ -1971,139 +1921,112 @@ MevisDicomTiffImageIO ::Write(const void * buffer)
   }
   else
   {
-    const unsigned int tilesize = TIFFTileSize(m_TIFFImage);
-    const unsigned int tilerowbytes = TIFFTileRowSize(m_TIFFImage);
+    const tmsize_t     tilesize = TIFFTileSize(m_TIFFImage);
+    const tmsize_t     tilerowbytes = TIFFTileRowSize(m_TIFFImage);
     const unsigned int bytespersample = m_BitsPerSample / 8;
 
-    const auto * vol = reinterpret_cast<const unsigned char *>(buffer);
-    auto *       tilebuf = static_cast<unsigned char *>(_TIFFmalloc(tilesize));
-
-    // is volume direction a multiple of tiledirection?
-    const bool mx = (m_Width % m_TileWidth == 0) ? true : false;
-    const bool my = (m_Length % m_TileLength == 0) ? true : false;
+    const auto * const vol = static_cast<const unsigned char *>(buffer);
 
+    // the origins of all tiles, in the order in which they are stored
+    struct TileType
+    {
+      unsigned int x0;
+      unsigned int y0;
+      unsigned int z0;
+    };
+    std::vector<TileType> tiles;
     for (unsigned int z0 = 0; z0 < (m_TIFFDimension == 3 ? m_Depth : 1); ++z0)
     {
-      for (unsigned int y0 = 0; y0 < (my ? m_Length : m_Length - m_TileLength); y0 += m_TileLength)
+      for (unsigned int y0 = 0; y0 < m_Length; y0 += m_TileLength)
       {
-        for (unsigned int x0 = 0; x0 < (mx ? m_Width : m_Width - m_TileWidth); x0 += m_TileWidth)
+        for (unsigned int x0 = 0; x0 < m_Width; x0 += m_TileWidth)
         {
-          // set bufferpointer to begin of tile
-          const unsigned char * pv = vol;
-          const unsigned int    p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-          pv += p * bytespersample;
-
-          // fill tile
-          unsigned char * pb = tilebuf;
-          for (unsigned int r = 0; r < m_TileLength; ++r)
-          {
-            memcpy(pb, pv, tilerowbytes);
-            pv += m_Width * bytespersample;
-            pb += tilerowbytes;
-          }
-          // write tile
-          if (TIFFWriteTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-          {
-
-            _TIFFfree(tilebuf);
-            TIFFClose(m_TIFFImage);
-            itkExceptionMacro("mevisIO:write(): error writing tile.");
-          }
+          tiles.push_back({ x0, y0, z0 });
         }
       }
-      // boundaries
-      if (!mx)
-      {
-        // x is fixed
-        const unsigned     lenx = m_Width % m_TileWidth;
-        const unsigned int x0 = m_Width - lenx;
-        const unsigned int tilexbytes = lenx * bytespersample;
-
-        for (unsigned int y0 = 0; y0 < (my ? m_Length : m_Length - m_TileLength); y0 += m_TileLength)
-        {
-          const unsigned char * pv = vol;
-          const unsigned int    p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-          pv += p * bytespersample;
-
-          unsigned char * pb = tilebuf;
-          memset(pb, 0, tilesize);
-
-          // fill tile
-          for (unsigned int r = 0; r < m_TileLength; ++r)
-          {
-            memcpy(pb, pv, tilexbytes);
-            pv += m_Width * bytespersample;
-            pb += tilerowbytes;
-          }
+    }
 
-          if (TIFFWriteTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-          {
-            _TIFFfree(tilebuf);
-            TIFFClose(m_TIFFImage);
-            itkExceptionMacro("mevisIO:write(): error writing tile (ydirection)");
-          }
-        }
+    // fills the tile with the part of the volume it covers; the parts of
+    // boundary tiles outside the volume are set to zero
+    const auto fillTile = [&](const TileType & tile, unsigned char * const tilebuf) {
+      const unsigned int lenx = std::min(m_TileWidth, m_Width - tile.x0);
+      const unsigned int leny = std::min(m_TileLength, m_Length - tile.y0);
+      if (lenx < m_TileWidth || leny < m_TileLength)
+      {
+        memset(tilebuf, 0, tilesize);
       }
-      if (!my)
+      for (unsigned int r = 0; r < leny; ++r)
       {
-        const unsigned     leny = m_Length % m_TileLength;
-        const unsigned int y0 = m_Length - leny;
+        const std::size_t offset =
+          (static_cast<std::size_t>(tile.z0) * m_Length + tile.y0 + r) * m_Width + tile.x0;
+        memcpy(tilebuf + r * tilerowbytes, vol + offset * bytespersample, lenx * bytespersample);
+      }
+    };
 
-        for (unsigned int x0 = 0; x0 < (mx ? m_Width : m_Width - m_TileWidth); x0 += m_TileWidth)
-        {
-          const unsigned char * pv = vol;
-          const unsigned int    p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-          pv += p * bytespersample;
+    const auto numberOfWorkUnits = static_cast<unsigned int>(
+      std::min<std::size_t>(MultiThreaderBase::GetGlobalDefaultNumberOfThreads(), tiles.size()));
 
-          unsigned char * pb = tilebuf;
-          memset(pb, 0, tilesize);
+#if TIFFLIB_VERSION >= 20191103
+    if (this->GetUseCompression() && numberOfWorkUnits > 1)
+    {
+      // A TIFF handle is not thread-safe, so the tiles are compressed in parallel, each into its own in-memory tiff
+      // file, and the compressed tiles are then written sequentially, in batches to limit the memory usage.
+      uint16_t sampleFormat = SAMPLEFORMAT_UINT;
+      TIFFGetFieldDefaulted(m_TIFFImage, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
 
-          for (unsigned int r = 0; r < leny; ++r)
-          {
-            memcpy(pb, pv, tilerowbytes);
-            pv += m_Width * bytespersample;
-            pb += tilerowbytes;
-          }
+      const auto        multiThreader = MultiThreaderBase::New();
+      const std::size_t batchSize = 16 * std::size_t{ numberOfWorkUnits };
 
-          if (TIFFWriteTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
+      std::vector<std::vector<unsigned char>> encodedTiles;
+
+      for (std::size_t batchBegin = 0; batchBegin < tiles.size(); batchBegin += batchSize)
+      {
+        const std::size_t batchEnd = std::min(batchBegin + batchSize, tiles.size());
+        encodedTiles.assign(batchEnd - batchBegin, {});
+
+        multiThreader->ParallelizeArray(
+          batchBegin,
+          batchEnd,
+          [&](const SizeValueType i) {
+            std::vector<unsigned char> tilebuf(tilesize);
+            fillTile(tiles[i], tilebuf.data());
+            EncodeTileLZW(
+              tilebuf, m_TileWidth, m_TileLength, m_BitsPerSample, sampleFormat, encodedTiles[i - batchBegin]);
+          },
+          nullptr);
+
+        for (std::size_t i = batchBegin; i < batchEnd; ++i)
+        {
+          auto &         encodedTile = encodedTiles[i - batchBegin];
+          const ttile_t  tileIndex = TIFFComputeTile(m_TIFFImage, tiles[i].x0, tiles[i].y0, tiles[i].z0, 0);
+          const tmsize_t encodedSize = static_cast<tmsize_t>(encodedTile.size());
+          if (encodedTile.empty() || TIFFWriteRawTile(m_TIFFImage, tileIndex, encodedTile.data(), encodedSize) < 0)
           {
-            _TIFFfree(tilebuf);
             TIFFClose(m_TIFFImage);
-            itkExceptionMacro("mevisIO:write(): error writing tile (x-direction)");
+            itkExceptionMacro("mevisIO:write(): error writing compressed tile.");
           }
         }
       }
-      if (!mx && !my)
-      {
-        // x0,y0 is fixed
-        const unsigned     lenx = m_Width % m_TileWidth;
-        const unsigned int x0 = m_Width - lenx;
-        const unsigned int tilexbytes = lenx * bytespersample;
-        const unsigned     leny = m_Length % m_TileLength;
-        const unsigned int y0 = m_Length - leny;
 
-        const unsigned char * pv = vol;
-        const unsigned int    p = z0 * m_Length * m_Width + y0 * m_Width + x0;
-        pv += p * bytespersample;
+      TIFFClose(m_TIFFImage);
+      return;
+    }
+#endif
 
-        unsigned char * pb = tilebuf;
-        memset(pb, 0, tilesize);
+    auto * tilebuf = static_cast<unsigned char *>(_TIFFmalloc(tilesize));
 
-        for (unsigned int r = 0; r < leny; ++r)
-        {
-          memcpy(pb, pv, tilexbytes);
-          pv += m_Width * bytespersample;
-          pb += tilerowbytes;
-        }
+    for (const auto & tile : tiles)
+    {
+      fillTile(tile, tilebuf);
 
-        if (TIFFWriteTile(m_TIFFImage, tilebuf, x0, y0, z0, 0) < 0)
-        {
-          _TIFFfree(tilebuf);
-          TIFFClose(m_TIFFImage);
-          itkExceptionMacro("mevisIO:write(): error writing tile (corner bottom)");
-        }
+      // write tile
+      if (TIFFWriteTile(m_TIFFImage, tilebuf, tile.x0, tile.y0, tile.z0, 0) < 0)
+      {
+        _TIFFfree(tilebuf);
+        TIFFClose(m_TIFFImage);
+        itkExceptionMacro("mevisIO:write(): error writing tile.");
       }
-    } // end z
+    }
     _TIFFfree(tilebuf);
   }
 
@@ -67,6 +67,10 @@ namespace itk
  *    (double is not accepted by MevisLab)
  *  - writing defaults is tiled tiff, tilesize is 128, 128,
  *    LZW compression and cm metric system
+ *  - the tiles are read in parallel, each thread by its own tiff handle,
+ *    and only the tiles that overlap with the requested region are read
+ *    (streaming). When writing with compression, the tiles are compressed
+ *    in parallel, and written sequentially.
  *  - default extension for tiff-image is ".tif" to comply with mevislab
  *    standards
  *  - gdcm header during reading is stored as (global) metadata
@@ -137,10 +141,11 @@ public:
   virtual void
   Write(const void * buffer);
 
+  /** Tiled images can be read per region: only the tiles that overlap with the requested region are decoded. */
   virtual bool
   CanStreamRead()
   {
-    return false;
+    return true;
   }
 
 
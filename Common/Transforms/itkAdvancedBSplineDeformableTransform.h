@@ -297,6 +297,12 @@ protected:
   ComputeNonZeroJacobianIndices(NonZeroJacobianIndicesType & nonZeroJacobianIndices,
                                 const RegionType &           supportRegion) const override;
 
+  /** Caches the support index and the interpolation weights at the points, for TransformPoint, GetJacobian and
+   * EvaluateJacobianWithImageGradientProduct.
+   */
+  SizeValueType
+  ComputeWeightCache(const std::vector<InputPointType> & points, const SizeValueType maximumSizeInBytes) override;
+
   using typename Superclass::JacobianImageType;
   using typename Superclass::JacobianPixelType;
 
@@ -308,6 +314,12 @@ protected:
   DerivativeWeightsFunctionPointer m_DerivativeWeightsFunctions[NDimensions]{};
 
 private:
+  /** Looks up the support index and the interpolation weights at a point in the weight cache, or computes them into
+   * the specified weights. Returns a pointer to the weights, or nullptr when the point is outside the valid region.
+   */
+  const double *
+  LookUpOrComputeWeights(const InputPointType & point, IndexType & supportIndex, WeightsType & weights) const;
+
   SODerivativeWeightsFunctionPointer m_SODerivativeWeightsFunctions[NDimensions][NDimensions]{};
 
   friend class MultiBSplineDeformableTransformWithNormal<ScalarType, Self::SpaceDimension, VSplineOrder>;
@@ -113,6 +113,7 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::SetG
     }
 
     this->UpdateGridOffsetTable();
+    this->ClearWeightCache();
 
     //
     // If we are using the default parameters, update their size and set to identity.
@@ -148,20 +149,18 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Tran
     return point;
   }
 
-  /***/
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+  // Look up or compute interpolation weights
+  IndexType            supportIndex;
+  WeightsType          computedWeights;
+  const double * const weights = this->LookUpOrComputeWeights(point, supportIndex, computedWeights);
 
   // NOTE: if the support region does not lie totally within the grid
   // we assume zero displacement and return the input point
-  if (!this->InsideValidRegion(cindex))
+  if (weights == nullptr)
   {
     return point;
   }
 
-  // Compute interpolation weights
-  const IndexType   supportIndex = WeightFunctionBaseType::ComputeStartIndex(cindex);
-  const WeightsType weights = m_WeightsFunction->Evaluate(cindex, supportIndex);
-
   // For each dimension, correlate coefficient with weights
   const RegionType supportRegion(supportIndex, WeightsFunctionType::SupportSize);
 
@@ -233,6 +232,64 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetN
 } // end GetNumberOfNonZeroJacobianIndices()
 
 
+/**
+ * ******************** ComputeWeightCache ***************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+SizeValueType
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::ComputeWeightCache(
+  const std::vector<InputPointType> & points,
+  const SizeValueType                 maximumSizeInBytes)
+{
+  return this->FillWeightCache(
+    points,
+    NumberOfWeights,
+    maximumSizeInBytes,
+    [this](const InputPointType & point, IndexType & supportIndex, double * const weights) {
+      const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+      if (!this->InsideValidRegion(cindex))
+      {
+        return false;
+      }
+      supportIndex = WeightFunctionBaseType::ComputeStartIndex(cindex);
+      const WeightsType computedWeights = m_WeightsFunction->Evaluate(cindex, supportIndex);
+      std::copy_n(computedWeights.cbegin(), NumberOfWeights, weights);
+      return true;
+    });
+
+} // end ComputeWeightCache()
+
+
+/**
+ * ********************* LookUpOrComputeWeights ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+const double *
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::LookUpOrComputeWeights(
+  const InputPointType & point,
+  IndexType &            supportIndex,
+  WeightsType &          weights) const
+{
+  if (const double * const cachedWeights = this->LookUpWeightCache(point, supportIndex))
+  {
+    return cachedWeights;
+  }
+
+  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+  if (!this->InsideValidRegion(cindex))
+  {
+    return nullptr;
+  }
+
+  supportIndex = WeightFunctionBaseType::ComputeStartIndex(cindex);
+  weights = m_WeightsFunction->Evaluate(cindex, supportIndex);
+  return weights.data();
+
+} // end LookUpOrComputeWeights()
+
+
 /**
  * ********************* GetJacobian ****************************
  */
@@ -252,11 +309,6 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJ
     itkExceptionMacro("Cannot compute Jacobian: parameters not set");
   }
 
-  /** Convert the physical point to a continuous index, which
-   * is needed for the 'Evaluate()' functions below.
-   */
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(inputPoint);
-
   /** Initialize. */
   const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
   if ((jacobian.cols() != nnzji) || (jacobian.rows() != SpaceDimension))
@@ -265,23 +317,21 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJ
     jacobian.fill(0.0);
   }
 
+  /** Look up or compute the weights. */
+  IndexType            supportIndex;
+  WeightsType          computedWeights;
+  const double * const weights = this->LookUpOrComputeWeights(inputPoint, supportIndex, computedWeights);
+
   /** NOTE: if the support region does not lie totally within the grid
    * we assume zero displacement and zero Jacobian.
    */
-  if (!this->InsideValidRegion(cindex))
+  if (weights == nullptr)
   {
     nonZeroJacobianIndices.resize(this->GetNumberOfNonZeroJacobianIndices());
     std::iota(nonZeroJacobianIndices.begin(), nonZeroJacobianIndices.end(), 0u);
     return;
   }
 
-  /** Compute the number of affected B-spline parameters.
-   */
-
-  /** Compute the weights. */
-  const IndexType   supportIndex = WeightFunctionBaseType::ComputeStartIndex(cindex);
-  const WeightsType weights = m_WeightsFunction->Evaluate(cindex, supportIndex);
-
   /** Setup support region */
   const RegionType supportRegion(supportIndex, WeightsFunctionType::SupportSize);
 
@@ -290,7 +340,7 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJ
   for (unsigned int d = 0; d < SpaceDimension; ++d)
   {
     unsigned long offset = d * SpaceDimension * NumberOfWeights + d * NumberOfWeights;
-    std::copy_n(weights.cbegin(), NumberOfWeights, jacobianPointer + offset);
+    std::copy_n(weights, NumberOfWeights, jacobianPointer + offset);
   }
 
   /** Compute the nonzero Jacobian indices.
@@ -313,19 +363,19 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Eval
   DerivativeType &                imageJacobian,
   NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const
 {
-  /** Convert the physical point to a continuous index, which
-   * is needed for the 'Evaluate()' functions below.
-   */
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(inputPoint);
-
   /** Get sizes. */
   const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
   const NumberOfParametersType nnzjiPerDimension = nnzji / SpaceDimension;
 
+  /** Look up or compute the B-spline weights. */
+  IndexType            supportIndex;
+  WeightsType          computedWeights;
+  const double * const weights = this->LookUpOrComputeWeights(inputPoint, supportIndex, computedWeights);
+
   /** NOTE: if the support region does not lie totally within the grid
    * we assume zero displacement and zero Jacobian.
    */
-  if (!this->InsideValidRegion(cindex))
+  if (weights == nullptr)
   {
     nonZeroJacobianIndices.resize(nnzji);
     std::iota(nonZeroJacobianIndices.begin(), nonZeroJacobianIndices.end(), 0u);
@@ -333,13 +383,6 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Eval
     return;
   }
 
-  /** Compute the number of affected B-spline parameters.
-   */
-
-  /** Compute the B-spline derivative weights. */
-  const IndexType   supportIndex = WeightFunctionBaseType::ComputeStartIndex(cindex);
-  const WeightsType weights = m_WeightsFunction->Evaluate(cindex, supportIndex);
-
   /** Compute the inner product. */
   NumberOfParametersType counter = 0;
   for (unsigned int d = 0; d < SpaceDimension; ++d)
@@ -22,6 +22,9 @@
 #include "itkImage.h"
 #include "itkImageRegion.h"
 
+#include <utility> // For pair.
+#include <vector>
+
 namespace itk
 {
 
@@ -327,6 +330,28 @@ public:
    */
   using ContinuousIndexType = ContinuousIndex<ScalarType, SpaceDimension>;
 
+  /** Precomputes the support index and the interpolation weights at the specified points, so that the point
+   * evaluation functions of the transform can look them up, instead of recomputing them. Meant for points that are
+   * evaluated in each iteration, like the samples of a grid or full sampler. The points are registered for the
+   * specified owner (typically a metric), replacing the points it registered before, and the cache is rebuilt for the
+   * union of the points of all owners, so that multiple metrics can share the transform. An empty vector of points
+   * unregisters the owner. The cache is only built when its size does not exceed the specified maximum, and it is
+   * cleared (including the registered points) when the grid changes. Returns the size that the cache requires (in
+   * bytes), or zero when the transform does not support caching its weights.
+   */
+  SizeValueType
+  BuildWeightCache(const Object * const                owner,
+                   const std::vector<InputPointType> & points,
+                   const SizeValueType                 maximumSizeInBytes);
+
+  /** Releases the weight cache, and the points registered by its owners. */
+  void
+  ClearWeightCache();
+
+  /** Returns the size of the weight cache in bytes, or zero when there is no weight cache. */
+  SizeValueType
+  GetWeightCacheSize() const;
+
 protected:
   /** Print contents of an AdvancedBSplineDeformableTransformBase. */
   void
@@ -355,9 +380,56 @@ protected:
   virtual bool
   InsideValidRegion(const ContinuousIndexType & index) const;
 
+  /** Caches the weights at the specified (unique) points, typically by calling FillWeightCache. The default
+   * implementation does not cache anything, and returns zero.
+   */
+  virtual SizeValueType
+  ComputeWeightCache(const std::vector<InputPointType> & itkNotUsed(points),
+                     const SizeValueType                 itkNotUsed(maximumSizeInBytes))
+  {
+    this->ReleaseWeightCacheEntries();
+    return 0;
+  }
+
+  /** Fills the weight cache with the support index and numberOfCachedWeights weights of each of the points, computed
+   * by computeWeights(point, supportIndex, weights), which returns false for a point outside the valid region. Points
+   * outside the valid region are not cached. Returns the size that the cache requires (in bytes).
+   */
+  template <typename TComputeWeightsFunction>
+  SizeValueType
+  FillWeightCache(const std::vector<InputPointType> & points,
+                  const unsigned int                  numberOfCachedWeights,
+                  const SizeValueType                 maximumSizeInBytes,
+                  TComputeWeightsFunction             computeWeights);
+
+  /** Looks up the support index and the weights of a point in the weight cache. Returns a pointer to the cached
+   * weights, or nullptr when the point is not cached.
+   */
+  const double *
+  LookUpWeightCache(const InputPointType & point, IndexType & supportIndex) const;
+
 private:
+  static SizeValueType
+  HashPoint(const InputPointType & point);
+
+  /** Releases the cached weights, but not the registered points. */
+  void
+  ReleaseWeightCacheEntries();
+
   const unsigned m_SplineOrder{};
 
+  /** The weight cache: the cached points, their support indices and weights, and an open addressing hash table, whose
+   * nonzero slots hold the entry index plus one.
+   */
+  std::vector<InputPointType> m_WeightCachePoints{};
+  std::vector<IndexType>      m_WeightCacheSupportIndices{};
+  std::vector<double>         m_WeightCacheWeights{};
+  std::vector<SizeValueType>  m_WeightCacheTable{};
+  unsigned int                m_NumberOfCachedWeights{ 0 };
+
+  /** The points registered by each owner of the weight cache. */
+  std::vector<std::pair<const Object *, std::vector<InputPointType>>> m_WeightCachePointSets{};
+
   // Private using-declarations, to avoid `-Woverloaded-virtual` warnings from GCC (GCC 11.4) or clang (macos-12).
   using Superclass::TransformVector;
   using Superclass::TransformCovariantVector;
@@ -21,8 +21,12 @@
 #include "itkAdvancedBSplineDeformableTransformBase.h"
 #include "itkContinuousIndex.h"
 #include "itkIdentityTransform.h"
+#include "itkMultiThreaderBase.h"
 #include <vnl/vnl_math.h>
 
+#include <algorithm>  // For copy_n, equal and find_if.
+#include <functional> // For hash.
+
 namespace itk
 {
 
@@ -162,6 +166,7 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::SetGridSpacing
     }
 
     this->UpdatePointIndexConversions();
+    this->ClearWeightCache();
 
     this->Modified();
   }
@@ -184,6 +189,7 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::SetGridDirecti
     }
 
     this->UpdatePointIndexConversions();
+    this->ClearWeightCache();
 
     this->Modified();
   }
@@ -205,6 +211,8 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::SetGridOrigin(
       m_WrappedImage[j]->SetOrigin(m_GridOrigin.GetDataPointer());
     }
 
+    this->ClearWeightCache();
+
     this->Modified();
   }
 }
@@ -549,6 +557,229 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::TransformPoint
 }
 
 
+// Register the points of an owner, and build the weight cache for the union of the points of all owners
+template <typename TScalarType, unsigned int NDimensions>
+SizeValueType
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::BuildWeightCache(
+  const Object * const                owner,
+  const std::vector<InputPointType> & points,
+  const SizeValueType                 maximumSizeInBytes)
+{
+  const auto found = std::find_if(m_WeightCachePointSets.begin(),
+                                  m_WeightCachePointSets.end(),
+                                  [owner](const auto & pointSet) { return pointSet.first == owner; });
+  if (found != m_WeightCachePointSets.end())
+  {
+    m_WeightCachePointSets.erase(found);
+  }
+  if (!points.empty())
+  {
+    m_WeightCachePointSets.emplace_back(owner, points);
+  }
+
+  /** Gather the union of the registered points, skipping the points that are already included, as multiple metrics
+   * commonly sample the same fixed image points. Uses an open addressing hash table, like LookUpWeightCache.
+   */
+  SizeValueType totalNumberOfPoints = 0;
+  for (const auto & pointSet : m_WeightCachePointSets)
+  {
+    totalNumberOfPoints += pointSet.second.size();
+  }
+  SizeValueType tableSize = 1;
+  while (tableSize < 2 * totalNumberOfPoints)
+  {
+    tableSize *= 2;
+  }
+  const SizeValueType         mask = tableSize - 1;
+  std::vector<SizeValueType>  table(tableSize);
+  std::vector<InputPointType> uniquePoints;
+  uniquePoints.reserve(totalNumberOfPoints);
+
+  for (const auto & pointSet : m_WeightCachePointSets)
+  {
+    for (const InputPointType & point : pointSet.second)
+    {
+      SizeValueType slot = HashPoint(point) & mask;
+      while (table[slot] != 0 && !std::equal(point.cbegin(), point.cend(), uniquePoints[table[slot] - 1].cbegin()))
+      {
+        slot = (slot + 1) & mask;
+      }
+      if (table[slot] == 0)
+      {
+        uniquePoints.push_back(point);
+        table[slot] = uniquePoints.size();
+      }
+    }
+  }
+  table = std::vector<SizeValueType>();
+
+  if (uniquePoints.empty())
+  {
+    this->ReleaseWeightCacheEntries();
+    return 0;
+  }
+  return this->ComputeWeightCache(uniquePoints, maximumSizeInBytes);
+}
+
+
+// Fill the weight cache
+template <typename TScalarType, unsigned int NDimensions>
+template <typename TComputeWeightsFunction>
+SizeValueType
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::FillWeightCache(
+  const std::vector<InputPointType> & points,
+  const unsigned int                  numberOfCachedWeights,
+  const SizeValueType                 maximumSizeInBytes,
+  TComputeWeightsFunction             computeWeights)
+{
+  this->ReleaseWeightCacheEntries();
+
+  /** The hash table has at least twice as many slots as there are points, which keeps the probe sequences short. */
+  const SizeValueType numberOfPoints = points.size();
+  SizeValueType       tableSize = 1;
+  while (tableSize < 2 * numberOfPoints)
+  {
+    tableSize *= 2;
+  }
+
+  const SizeValueType sizeInBytes =
+    numberOfPoints * (sizeof(InputPointType) + sizeof(IndexType) + numberOfCachedWeights * sizeof(double)) +
+    tableSize * sizeof(SizeValueType);
+  if (numberOfPoints == 0 || sizeInBytes > maximumSizeInBytes)
+  {
+    return sizeInBytes;
+  }
+
+  m_NumberOfCachedWeights = numberOfCachedWeights;
+  m_WeightCachePoints = points;
+  m_WeightCacheSupportIndices.resize(numberOfPoints);
+  m_WeightCacheWeights.resize(numberOfPoints * numberOfCachedWeights);
+
+  /** Compute the support index and the weights of the points concurrently. */
+  std::vector<unsigned char> isInsideValidRegion(numberOfPoints);
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    numberOfPoints,
+    [this, numberOfCachedWeights, &computeWeights, &isInsideValidRegion](const SizeValueType i) {
+      isInsideValidRegion[i] = computeWeights(m_WeightCachePoints[i],
+                                              m_WeightCacheSupportIndices[i],
+                                              m_WeightCacheWeights.data() + i * numberOfCachedWeights);
+    },
+    nullptr);
+
+  /** Only keep the points inside the valid region, for which the weights are actually used. */
+  SizeValueType numberOfEntries = 0;
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    if (isInsideValidRegion[i])
+    {
+      if (numberOfEntries != i)
+      {
+        m_WeightCachePoints[numberOfEntries] = m_WeightCachePoints[i];
+        m_WeightCacheSupportIndices[numberOfEntries] = m_WeightCacheSupportIndices[i];
+        std::copy_n(m_WeightCacheWeights.cbegin() + i * numberOfCachedWeights,
+                    numberOfCachedWeights,
+                    m_WeightCacheWeights.begin() + numberOfEntries * numberOfCachedWeights);
+      }
+      ++numberOfEntries;
+    }
+  }
+  m_WeightCachePoints.resize(numberOfEntries);
+  m_WeightCacheSupportIndices.resize(numberOfEntries);
+  m_WeightCacheWeights.resize(numberOfEntries * numberOfCachedWeights);
+
+  /** Insert the entries into the hash table, using linear probing. */
+  m_WeightCacheTable.assign(tableSize, 0);
+  const SizeValueType mask = tableSize - 1;
+  for (SizeValueType entry = 0; entry < numberOfEntries; ++entry)
+  {
+    SizeValueType slot = HashPoint(m_WeightCachePoints[entry]) & mask;
+    while (m_WeightCacheTable[slot] != 0)
+    {
+      slot = (slot + 1) & mask;
+    }
+    m_WeightCacheTable[slot] = entry + 1;
+  }
+
+  return sizeInBytes;
+}
+
+
+// Look up a point in the weight cache
+template <typename TScalarType, unsigned int NDimensions>
+auto
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::LookUpWeightCache(const InputPointType & point,
+                                                                                   IndexType & supportIndex) const
+  -> const double *
+{
+  if (m_WeightCacheTable.empty())
+  {
+    return nullptr;
+  }
+
+  /** Note that the coordinates are compared exactly, as the cached weights are only valid for the very same point. */
+  const SizeValueType mask = m_WeightCacheTable.size() - 1;
+  for (SizeValueType slot = HashPoint(point) & mask; m_WeightCacheTable[slot] != 0; slot = (slot + 1) & mask)
+  {
+    const SizeValueType entry = m_WeightCacheTable[slot] - 1;
+    if (std::equal(point.cbegin(), point.cend(), m_WeightCachePoints[entry].cbegin()))
+    {
+      supportIndex = m_WeightCacheSupportIndices[entry];
+      return m_WeightCacheWeights.data() + entry * m_NumberOfCachedWeights;
+    }
+  }
+  return nullptr;
+}
+
+
+// Release the weight cache and its registered points
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::ClearWeightCache()
+{
+  this->ReleaseWeightCacheEntries();
+  m_WeightCachePointSets = {};
+}
+
+
+// Release the cached weights
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::ReleaseWeightCacheEntries()
+{
+  m_WeightCachePoints = std::vector<InputPointType>();
+  m_WeightCacheSupportIndices = std::vector<IndexType>();
+  m_WeightCacheWeights = std::vector<double>();
+  m_WeightCacheTable = std::vector<SizeValueType>();
+  m_NumberOfCachedWeights = 0;
+}
+
+
+// Get the size of the weight cache
+template <typename TScalarType, unsigned int NDimensions>
+SizeValueType
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::GetWeightCacheSize() const
+{
+  return m_WeightCachePoints.capacity() * sizeof(InputPointType) +
+         m_WeightCacheSupportIndices.capacity() * sizeof(IndexType) +
+         m_WeightCacheWeights.capacity() * sizeof(double) + m_WeightCacheTable.capacity() * sizeof(SizeValueType);
+}
+
+
+// Hash the coordinates of a point
+template <typename TScalarType, unsigned int NDimensions>
+SizeValueType
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::HashPoint(const InputPointType & point)
+{
+  std::size_t hash = 0;
+  for (const ScalarType coordinate : point)
+  {
+    hash = (hash * 1099511628211u) ^ std::hash<ScalarType>{}(coordinate);
+  }
+  return static_cast<SizeValueType>(hash);
+}
+
+
 } // namespace itk
 
 #endif
@@ -59,6 +59,12 @@ namespace itk
  * computing the moments and doing so simplifies memory management for
  * the caller.
  *
+ * Compute() distributes the work over the threads of the multi-threader in blocks of a fixed size. Each block has its
+ * own partial sums, which are reduced in block order afterwards, so the results do not depend on the number of threads.
+ * When NumberOfSamplesForCenteredTransformInitialization is zero, or at least the number of pixels of the requested
+ * region, all pixels are visited directly, without building a sample container. Otherwise, the image is sampled by
+ * an ImageGridSampler. The mask and the optional lower threshold are applied on the fly.
+ *
  * \ingroup Operators
  *
  * \todo It's not yet clear how multi-echo images should be handled here.
@@ -106,6 +112,10 @@ public:
   using ImagePointer = typename ImageType::Pointer;
   using ImageConstPointer = typename ImageType::ConstPointer;
 
+  /** Index and point types of the image. */
+  using IndexType = typename ImageType::IndexType;
+  using PointType = typename ImageType::PointType;
+
   /** Affine transform for mapping to and from principal axis */
   using AffineTransformType = AffineTransform<double, Self::ImageDimension>;
   using AffineTransformPointer = typename AffineTransformType::Pointer;
@@ -245,7 +255,8 @@ public:
   using BinaryThresholdImageFilterType = itk::BinaryThresholdImageFilter<TImage, TImage>;
   using InputPixelType = typename TImage::PixelType;
 
-  /** Set some parameters. */
+  /** Set some parameters. A NumberOfSamplesForCenteredTransformInitialization of zero specifies that all pixels of the
+   * requested region are used. */
   itkSetMacro(NumberOfSamplesForCenteredTransformInitialization, SizeValueType);
   itkSetMacro(LowerThresholdForCenterGravity, InputPixelType);
   itkSetMacro(CenterOfGravityUsesLowerThreshold, bool);
@@ -271,7 +282,8 @@ protected:
   virtual void
   ThreadedCompute(ThreadIdType threadID);
 
-  /** Initialize some multi-threading related parameters. */
+  /** Initialize some multi-threading related parameters. Assumes that BeforeThreadedCompute() has determined the
+   * number of blocks. */
   virtual void
   InitializeThreadingParameters();
 
@@ -294,6 +306,18 @@ protected:
   itkPadStruct(ITK_CACHE_LINE_ALIGNMENT, ComputePerThreadStruct, PaddedComputePerThreadStruct);
   itkAlignedTypedef(ITK_CACHE_LINE_ALIGNMENT, PaddedComputePerThreadStruct, AlignedComputePerThreadStruct);
 
+  /** Returns partial sums that are all zero. */
+  static ComputePerThreadStruct
+  ZeroInitializedSums();
+
+  /** Adds the contribution of a single pixel to the specified sums, unless it is outside the mask. Applies the lower
+   * threshold, when CenterOfGravityUsesLowerThreshold is true. */
+  void
+  AccumulateMoments(const double             pixelValue,
+                    const IndexType &        index,
+                    const PointType &        physicalPoint,
+                    ComputePerThreadStruct & sums) const;
+
   /** The type of region used for multithreading */
   using ThreadRegionType = typename ImageType::RegionType;
 
@@ -311,9 +335,19 @@ private:
 
   mutable MultiThreaderParameterType m_ThreaderParameters{};
 
-  mutable std::vector<AlignedComputePerThreadStruct> m_ComputePerThreadVariables{};
+  /** The partial sums of each block, reduced in block order by AfterThreadedCompute(). */
+  mutable std::vector<AlignedComputePerThreadStruct> m_ComputePerBlockVariables{};
   bool                                               m_UseMultiThread{};
 
+  /** The (approximate) number of pixels or samples per block. */
+  static constexpr SizeValueType NumberOfPixelsPerBlock{ 4096 };
+
+  /** The block layout, determined by BeforeThreadedCompute(). In full image mode, a block consists of a number of
+   * consecutive slices along the last dimension of the requested region. */
+  bool          m_UseAllPixels{};
+  SizeValueType m_NumberOfBlocks{};
+  SizeValueType m_NumberOfSlicesPerBlock{};
+
   SizeValueType               m_NumberOfSamplesForCenteredTransformInitialization{};
   InputPixelType              m_LowerThresholdForCenterGravity{};
   bool                        m_CenterOfGravityUsesLowerThreshold{};
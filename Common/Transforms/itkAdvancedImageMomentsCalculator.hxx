@@ -23,6 +23,7 @@
 #include <vnl/algo/vnl_real_eigensystem.h>
 #include <vnl/algo/vnl_symmetric_eigensystem.h>
 #include "itkImageRegionConstIteratorWithIndex.h"
+#include <algorithm> // For min.
 #include <cassert>
 
 namespace itk
@@ -65,90 +66,110 @@ template <typename TImage>
 void
 AdvancedImageMomentsCalculator<TImage>::InitializeThreadingParameters()
 {
-  /** Resize and initialize the threading related parameters.
-   * The SetSize() functions do not resize the data when this is not
-   * needed, which saves valuable re-allocation time.
-   *
-   * This function is only to be called at the start of each resolution.
-   * Re-initialization of the potentially large vectors is performed after
-   * each iteration, in the accumulate functions, in a multi-threaded fashion.
-   * This has performance benefits for larger vector sizes.
-   */
-  const ThreadIdType numberOfThreads = this->m_Threader->GetNumberOfWorkUnits();
-
-  // For each thread, assign a struct of zero-initialized values.
-  m_ComputePerThreadVariables.assign(numberOfThreads, AlignedComputePerThreadStruct());
+  /** For each block, assign a struct of zero-initialized values. The number of blocks does not depend on the number
+   * of threads, which makes the reduction in AfterThreadedCompute() reproducible. */
+  m_ComputePerBlockVariables.assign(m_NumberOfBlocks, AlignedComputePerThreadStruct());
 
 } // end InitializeThreadingParameters()
 
-//----------------------------------------------------------------------
-// Compute moments for a new or modified image
+/**
+ * ************************* ZeroInitializedSums ************************
+ */
+
+template <typename TImage>
+auto
+AdvancedImageMomentsCalculator<TImage>::ZeroInitializedSums() -> ComputePerThreadStruct
+{
+  ComputePerThreadStruct sums;
+  sums.st_M0 = ScalarType{};
+  sums.st_M1.Fill(typename VectorType::ValueType{});
+  sums.st_M2.Fill(typename MatrixType::ValueType{});
+  sums.st_Cg.Fill(typename VectorType::ValueType{});
+  sums.st_Cm.Fill(typename MatrixType::ValueType{});
+  sums.st_NumberOfPixelsCounted = 0;
+  return sums;
+
+} // end ZeroInitializedSums()
+
+/**
+ * ************************* AccumulateMoments ************************
+ */
+
 template <typename TImage>
 void
-AdvancedImageMomentsCalculator<TImage>::ComputeSingleThreaded()
+AdvancedImageMomentsCalculator<TImage>::AccumulateMoments(const double             pixelValue,
+                                                          const IndexType &        index,
+                                                          const PointType &        physicalPoint,
+                                                          ComputePerThreadStruct & sums) const
 {
-  if (this->m_CenterOfGravityUsesLowerThreshold)
+  if (m_SpatialObjectMask.IsNotNull() && !m_SpatialObjectMask->IsInsideInWorldSpace(physicalPoint))
+  {
+    return;
+  }
+  ++sums.st_NumberOfPixelsCounted;
+
+  /** Equivalent to a BinaryThresholdImageFilter with inside value 1 and outside value 0. */
+  const double value =
+    m_CenterOfGravityUsesLowerThreshold
+      ? (pixelValue >= static_cast<double>(m_LowerThresholdForCenterGravity) ? 1.0 : 0.0)
+      : pixelValue;
+
+  if (value == 0.0)
+  {
+    return;
+  }
+
+  sums.st_M0 += value;
+
+  for (unsigned int i = 0; i < ImageDimension; ++i)
   {
-    auto thresholdFilter = BinaryThresholdImageFilterType::New();
-    thresholdFilter->SetInput(this->m_Image);
-    thresholdFilter->SetLowerThreshold(this->m_LowerThresholdForCenterGravity);
-    thresholdFilter->SetInsideValue(1);
-    thresholdFilter->SetOutsideValue(0);
-    thresholdFilter->Update();
-    this->SetImage(thresholdFilter->GetOutput());
+    const double indexValue = static_cast<double>(index[i]) * value;
+    const double pointValue = physicalPoint[i] * value;
+    sums.st_M1[i] += indexValue;
+    sums.st_Cg[i] += pointValue;
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      sums.st_M2[i][j] += indexValue * static_cast<double>(index[j]);
+      sums.st_Cm[i][j] += pointValue * physicalPoint[j];
+    }
   }
 
+} // end AccumulateMoments()
+
+//----------------------------------------------------------------------
+// Compute moments for a new or modified image
+template <typename TImage>
+void
+AdvancedImageMomentsCalculator<TImage>::ComputeSingleThreaded()
+{
   m_M0 = ScalarType{};
   m_M1.Fill(typename VectorType::ValueType{});
   m_M2.Fill(typename MatrixType::ValueType{});
   m_Cg.Fill(typename VectorType::ValueType{});
   m_Cm.Fill(typename MatrixType::ValueType{});
 
-  using IndexType = typename ImageType::IndexType;
-
   if (!m_Image)
   {
     return;
   }
 
-  ImageRegionConstIteratorWithIndex<ImageType> it(m_Image, m_Image->GetRequestedRegion());
+  ComputePerThreadStruct sums = ZeroInitializedSums();
 
-  while (!it.IsAtEnd())
+  for (ImageRegionConstIteratorWithIndex<ImageType> it(m_Image, m_Image->GetRequestedRegion()); !it.IsAtEnd(); ++it)
   {
-    double value = it.Value();
+    const IndexType indexPosition = it.GetIndex();
 
-    IndexType indexPosition = it.GetIndex();
-
-    Point<double, ImageDimension> physicalPosition;
+    PointType physicalPosition;
     m_Image->TransformIndexToPhysicalPoint(indexPosition, physicalPosition);
 
-    if (m_SpatialObjectMask.IsNull() || m_SpatialObjectMask->IsInsideInWorldSpace(physicalPosition))
-    {
-      m_M0 += value;
-
-      for (unsigned int i = 0; i < ImageDimension; ++i)
-      {
-        m_M1[i] += static_cast<double>(indexPosition[i]) * value;
-        for (unsigned int j = 0; j < ImageDimension; ++j)
-        {
-          double weight = value * static_cast<double>(indexPosition[i]) * static_cast<double>(indexPosition[j]);
-          m_M2[i][j] += weight;
-        }
-      }
-
-      for (unsigned int i = 0; i < ImageDimension; ++i)
-      {
-        m_Cg[i] += physicalPosition[i] * value;
-        for (unsigned int j = 0; j < ImageDimension; ++j)
-        {
-          double weight = value * physicalPosition[i] * physicalPosition[j];
-          m_Cm[i][j] += weight;
-        }
-      }
-    }
-
-    ++it;
+    this->AccumulateMoments(it.Value(), indexPosition, physicalPosition, sums);
   }
+
+  m_M0 = sums.st_M0;
+  m_M1 = sums.st_M1;
+  m_M2 = sums.st_M2;
+  m_Cg = sums.st_Cg;
+  m_Cm = sums.st_Cm;
   DoPostProcessing();
 }
 
@@ -164,16 +185,16 @@ AdvancedImageMomentsCalculator<TImage>::Compute()
     return this->ComputeSingleThreaded();
   }
 
+  /** Tackle stuff needed before multi-threading, including the block layout. */
+  this->BeforeThreadedCompute();
+
   /** Initialize multi-threading. */
   this->InitializeThreadingParameters();
 
-  /** Tackle stuff needed before multi-threading. */
-  this->BeforeThreadedCompute();
-
   /** Launch multi-threaded computation. */
   this->LaunchComputeThreaderCallback();
 
-  /** Gather the values from all threads. */
+  /** Gather the values from all blocks. */
   this->AfterThreadedCompute();
 
 } // end Compute()
@@ -191,23 +212,37 @@ AdvancedImageMomentsCalculator<TImage>::BeforeThreadedCompute()
   m_Cg.Fill(typename VectorType::ValueType{});
   m_Cm.Fill(typename MatrixType::ValueType{});
 
+  m_SampleContainer = nullptr;
+  m_NumberOfBlocks = 0;
+  m_NumberOfSlicesPerBlock = 0;
+
   if (!m_Image)
   {
     return;
   }
 
-  if (this->m_CenterOfGravityUsesLowerThreshold)
+  const auto          region = m_Image->GetRequestedRegion();
+  const SizeValueType numberOfPixels = region.GetNumberOfPixels();
+
+  m_UseAllPixels = m_NumberOfSamplesForCenteredTransformInitialization == 0 ||
+                   m_NumberOfSamplesForCenteredTransformInitialization >= numberOfPixels;
+
+  if (m_UseAllPixels)
   {
-    auto thresholdFilter = BinaryThresholdImageFilterType::New();
-    thresholdFilter->SetInput(this->m_Image);
-    thresholdFilter->SetLowerThreshold(this->m_LowerThresholdForCenterGravity);
-    thresholdFilter->SetInsideValue(1);
-    thresholdFilter->SetOutsideValue(0);
-    thresholdFilter->Update();
-    this->SetImage(thresholdFilter->GetOutput());
+    /** Visit all pixels directly, in blocks of whole slices along the last dimension. */
+    if (numberOfPixels > 0)
+    {
+      const SizeValueType numberOfSlices = region.GetSize(ImageDimension - 1);
+      const SizeValueType numberOfPixelsPerSlice = numberOfPixels / numberOfSlices;
+      m_NumberOfSlicesPerBlock = (NumberOfPixelsPerBlock + numberOfPixelsPerSlice - 1) / numberOfPixelsPerSlice;
+      m_NumberOfBlocks = (numberOfSlices + m_NumberOfSlicesPerBlock - 1) / m_NumberOfSlicesPerBlock;
+    }
+  }
+  else
+  {
+    this->SampleImage(this->m_SampleContainer);
+    m_NumberOfBlocks = (m_SampleContainer->size() + NumberOfPixelsPerBlock - 1) / NumberOfPixelsPerBlock;
   }
-
-  this->SampleImage(this->m_SampleContainer);
 } // end BeforeThreadedCompute()
 
 /**
@@ -258,62 +293,58 @@ AdvancedImageMomentsCalculator<TImage>::ThreadedCompute(ThreadIdType threadId)
     return;
   }
 
-  ScalarType M0 = 0;
-  VectorType M1, Cg;
-  M1.Fill(typename VectorType::ValueType{});
-  Cg.Fill(typename VectorType::ValueType{});
-  MatrixType M2, Cm;
-  M2.Fill(typename MatrixType::ValueType{});
-  Cm.Fill(typename MatrixType::ValueType{});
-  unsigned long numberOfPixelsCounted = 0;
-
-  /** Get sample container size, number of threads, and output space dimension. */
-  const size_t       sampleContainerSize{ this->m_SampleContainer->size() };
+  /** Each thread processes the blocks threadId, threadId + numberOfThreads, etc., accumulating into the partial sums
+   * of the block itself. */
   const ThreadIdType numberOfThreads = this->m_Threader->GetNumberOfWorkUnits();
 
-  /** Get the samples for this thread. */
-  const auto nrOfSamplesPerThreads = static_cast<unsigned long>(
-    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(numberOfThreads)));
-
-  const auto pos_begin = std::min<size_t>(nrOfSamplesPerThreads * threadId, sampleContainerSize);
-  const auto pos_end = std::min<size_t>(nrOfSamplesPerThreads * (threadId + 1), sampleContainerSize);
-
-  /** Create iterator over the sample container. */
-  const auto beginOfSampleContainer = this->m_SampleContainer->cbegin();
-  const auto threader_fbegin = beginOfSampleContainer + pos_begin;
-  const auto threader_fend = beginOfSampleContainer + pos_end;
-
-  for (auto threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
+  for (SizeValueType blockIndex = threadId; blockIndex < m_NumberOfBlocks; blockIndex += numberOfThreads)
   {
-    double value = threader_fiter->m_ImageValue;
-    // IndexType indexPosition = threader_fiter->GetIndex();
-    Point<double, ImageDimension> physicalPosition = threader_fiter->m_ImageCoordinates;
+    ComputePerThreadStruct sums = ZeroInitializedSums();
 
-    if (m_SpatialObjectMask.IsNull() || m_SpatialObjectMask->IsInsideInWorldSpace(physicalPosition))
+    if (m_UseAllPixels)
     {
-      M0 += value;
+      /** Restrict the requested region to the slices of this block. */
+      const auto          requestedRegion = m_Image->GetRequestedRegion();
+      const SizeValueType firstSlice = blockIndex * m_NumberOfSlicesPerBlock;
+      const SizeValueType numberOfSlices = requestedRegion.GetSize(ImageDimension - 1) - firstSlice;
+      auto                blockRegion = requestedRegion;
+      blockRegion.SetIndex(ImageDimension - 1,
+                           requestedRegion.GetIndex(ImageDimension - 1) + static_cast<IndexValueType>(firstSlice));
+      blockRegion.SetSize(ImageDimension - 1, std::min(m_NumberOfSlicesPerBlock, numberOfSlices));
+
+      for (ImageRegionConstIteratorWithIndex<ImageType> it(m_Image, blockRegion); !it.IsAtEnd(); ++it)
+      {
+        const IndexType indexPosition = it.GetIndex();
 
-      for (unsigned int i = 0; i < ImageDimension; ++i)
+        PointType physicalPosition;
+        m_Image->TransformIndexToPhysicalPoint(indexPosition, physicalPosition);
+
+        this->AccumulateMoments(it.Value(), indexPosition, physicalPosition, sums);
+      }
+    }
+    else
+    {
+      /** The grid samples are located at pixel positions, so their indices are recovered exactly. */
+      const size_t sampleContainerSize{ this->m_SampleContainer->size() };
+      const auto   beginOfSampleContainer = this->m_SampleContainer->cbegin();
+      const auto   pos_begin = blockIndex * NumberOfPixelsPerBlock;
+      const auto   pos_end = std::min<size_t>(pos_begin + NumberOfPixelsPerBlock, sampleContainerSize);
+
+      for (auto threader_fiter = beginOfSampleContainer + pos_begin;
+           threader_fiter != beginOfSampleContainer + pos_end;
+           ++threader_fiter)
       {
-        Cg[i] += physicalPosition[i] * value;
-        for (unsigned int j = 0; j < ImageDimension; ++j)
-        {
-          double weight = value * physicalPosition[i] * physicalPosition[j];
-          Cm[i][j] += weight;
-        }
+        const PointType & physicalPosition = threader_fiter->m_ImageCoordinates;
+        IndexType         indexPosition;
+        m_Image->TransformPhysicalPointToIndex(physicalPosition, indexPosition);
+
+        this->AccumulateMoments(threader_fiter->m_ImageValue, indexPosition, physicalPosition, sums);
       }
-      ++numberOfPixelsCounted;
     }
+
+    /** Update the block struct once. */
+    static_cast<ComputePerThreadStruct &>(m_ComputePerBlockVariables[blockIndex]) = sums;
   }
-  /** Update the thread struct once. */
-  AlignedComputePerThreadStruct computePerThreadStruct;
-  computePerThreadStruct.st_M0 = M0;
-  computePerThreadStruct.st_M1 = M1;
-  computePerThreadStruct.st_M2 = M2;
-  computePerThreadStruct.st_Cg = Cg;
-  computePerThreadStruct.st_Cm = Cm;
-  computePerThreadStruct.st_NumberOfPixelsCounted = numberOfPixelsCounted;
-  m_ComputePerThreadVariables[threadId] = computePerThreadStruct;
 
 } // end ThreadedCompute()
 
@@ -325,24 +356,19 @@ template <typename TImage>
 void
 AdvancedImageMomentsCalculator<TImage>::AfterThreadedCompute()
 {
-  /** Accumulate thread results. */
-  for (auto & computePerThreadStruct : m_ComputePerThreadVariables)
+  /** Accumulate block results, in block order. */
+  for (const auto & computePerBlockStruct : m_ComputePerBlockVariables)
   {
-    this->m_M0 += computePerThreadStruct.st_M0;
+    this->m_M0 += computePerBlockStruct.st_M0;
     for (unsigned int i = 0; i < ImageDimension; ++i)
     {
-      this->m_M1[i] += computePerThreadStruct.st_M1[i];
-      this->m_Cg[i] += computePerThreadStruct.st_Cg[i];
-      computePerThreadStruct.st_M1[i] = 0;
-      computePerThreadStruct.st_Cg[i] = 0;
+      this->m_M1[i] += computePerBlockStruct.st_M1[i];
+      this->m_Cg[i] += computePerBlockStruct.st_Cg[i];
       for (unsigned int j = 0; j < ImageDimension; ++j)
       {
-        this->m_M2[i][j] += computePerThreadStruct.st_M2[i][j];
-        this->m_Cm[i][j] += computePerThreadStruct.st_Cm[i][j];
-        computePerThreadStruct.st_M2[i][j] = 0;
-        computePerThreadStruct.st_Cm[i][j] = 0;
+        this->m_M2[i][j] += computePerBlockStruct.st_M2[i][j];
+        this->m_Cm[i][j] += computePerBlockStruct.st_Cm[i][j];
       }
-      computePerThreadStruct.st_M0 = 0;
     }
   }
   DoPostProcessing();
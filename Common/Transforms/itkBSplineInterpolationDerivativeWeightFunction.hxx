@@ -84,26 +84,18 @@ BSplineInterpolationDerivativeWeightFunction<TCoordinate, VSpaceDimension, VSpli
   const IndexType &           startIndex,
   OneDWeightsType &           weights1D) const
 {
-  /** Compute the 1D weights. */
+  /** Compute the 1D weights, at the entire support at once. */
   for (unsigned int i = 0; i < SpaceDimension; ++i)
   {
-    double x = cindex[i] - static_cast<double>(startIndex[i]);
+    const double x = cindex[i] - static_cast<double>(startIndex[i]);
 
     if (i != this->m_DerivativeDirection)
     {
-      for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
-      {
-        weights1D[i][k] = KernelType::FastEvaluate(x);
-        x -= 1.0;
-      }
+      KernelType::FastEvaluate(x, weights1D[i]);
     }
     else
     {
-      for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
-      {
-        weights1D[i][k] = DerivativeKernelType::FastEvaluate(x);
-        x -= 1.0;
-      }
+      Superclass::Evaluate1DDerivativeWeights(x, weights1D[i]);
     }
   }
 
@@ -99,36 +99,24 @@ BSplineInterpolationSecondOrderDerivativeWeightFunction<TCoordinate, VSpaceDimen
   const IndexType &           startIndex,
   OneDWeightsType &           weights1D) const
 {
-  /** Compute the 1D weights. */
+  /** Compute the 1D weights, at the entire support at once. */
   for (unsigned int i = 0; i < SpaceDimension; ++i)
   {
-    double x = index[i] - static_cast<double>(startIndex[i]);
+    const double x = index[i] - static_cast<double>(startIndex[i]);
 
     if (i != this->m_DerivativeDirections[0] && i != this->m_DerivativeDirections[1])
     {
-      for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
-      {
-        weights1D[i][k] = KernelType::FastEvaluate(x);
-        x -= 1.0;
-      }
+      KernelType::FastEvaluate(x, weights1D[i]);
     }
     else
     {
       if (this->m_EqualDerivativeDirections)
       {
-        for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
-        {
-          weights1D[i][k] = SecondOrderDerivativeKernelType::FastEvaluate(x);
-          x -= 1.0;
-        }
+        Superclass::Evaluate1DSecondOrderDerivativeWeights(x, weights1D[i]);
       }
       else
       {
-        for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
-        {
-          weights1D[i][k] = DerivativeKernelType::FastEvaluate(x);
-          x -= 1.0;
-        }
+        Superclass::Evaluate1DDerivativeWeights(x, weights1D[i]);
       }
     }
   }
@@ -37,17 +37,7 @@ BSplineInterpolationWeightFunction2<TCoordinate, VSpaceDimension, VSplineOrder>:
   /** Compute the 1D weights. */
   for (unsigned int i = 0; i < SpaceDimension; ++i)
   {
-    double x = index[i] - static_cast<double>(startIndex[i]);
-
-    // Compute weights
-    double weights[6]; // Sufficiently large: maximum implemented SplineOrder + 1
-    KernelType::FastEvaluate(x, weights);
-
-    // Copy
-    for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
-    {
-      weights1D[i][k] = weights[k];
-    }
+    KernelType::FastEvaluate(index[i] - static_cast<double>(startIndex[i]), weights1D[i]);
   }
 } // end Compute1DWeights()
 
@@ -20,7 +20,6 @@
 
 #include "itkFunctionBase.h"
 #include "itkContinuousIndex.h"
-#include "itkIndexRange.h"
 #include "itkMath.h"
 #include "itkMatrix.h"
 #include "itkBSplineKernelFunction2.h"
@@ -126,20 +125,107 @@ protected:
                    const IndexType &           startIndex,
                    OneDWeightsType &           weights1D) const = 0;
 
+  /** Evaluate the first order derivative of the kernel at the entire support of one dimension, where x is the distance
+   * between the continuous index and the start index, so in the range [(SplineOrder - 1) / 2, (SplineOrder + 1) / 2).
+   * Spline orders 1 to 3 are evaluated without branches. The results are equal to those of evaluating the
+   * DerivativeKernelType at each of the support points separately. */
+  static void
+  Evaluate1DDerivativeWeights(const double x, double * const weights)
+  {
+    Self::Evaluate1DDerivativeWeights(Dispatch<VSplineOrder>(), x, weights);
+  }
+
+  /** Evaluate the second order derivative of the kernel at the entire support of one dimension. Equivalent to
+   * Evaluate1DDerivativeWeights, but for the SecondOrderDerivativeKernelType. */
+  static void
+  Evaluate1DSecondOrderDerivativeWeights(const double x, double * const weights)
+  {
+    Self::Evaluate1DSecondOrderDerivativeWeights(Dispatch<VSplineOrder>(), x, weights);
+  }
+
   /** Print the member variables. */
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
-  /** Lookup table type. */
-  using TableType = FixedArray<IndexType, NumberOfWeights>;
-
-  /** Table mapping linear offset to indices. */
-  const TableType m_OffsetToIndexTable{ [] {
-    TableType     table;
-    std::copy_n(ZeroBasedIndexRange<SpaceDimension>(SupportSize).cbegin(), NumberOfWeights, table.begin());
-    return table;
-  }() };
+  /** Structures to control overloaded versions of the 1D weight evaluation. */
+  struct DispatchBase
+  {};
+  template <unsigned int>
+  struct ITK_TEMPLATE_EXPORT Dispatch : DispatchBase
+  {};
+
+  /** First order spline. At x == 0 the derivative kernel is discontinuous, and takes the mean of both sides. */
+  static void
+  Evaluate1DDerivativeWeights(const Dispatch<1> &, const double x, double * const weights)
+  {
+    const bool isAtKnot = (x == 0.0);
+    weights[0] = isAtKnot ? 0.0 : -1.0;
+    weights[1] = isAtKnot ? 0.5 : 1.0;
+  }
+
+  /** Second order spline. */
+  static void
+  Evaluate1DDerivativeWeights(const Dispatch<2> &, const double x, double * const weights)
+  {
+    weights[0] = x - 1.5;
+    weights[1] = 2.0 - 2.0 * x;
+    weights[2] = x - 0.5;
+  }
+
+  /** Third order spline. */
+  static void
+  Evaluate1DDerivativeWeights(const Dispatch<3> &, const double x, double * const weights)
+  {
+    const double sqrValue = x * x;
+    weights[0] = -0.5 * sqrValue + 2.0 * x - 2.0;
+    weights[1] = 1.5 * sqrValue - 5.0 * x + 3.5;
+    weights[2] = -1.5 * sqrValue + 4.0 * x - 2.0;
+    weights[3] = 0.5 * sqrValue - x + 0.5;
+  }
+
+  /** Other spline orders: evaluate the kernel at each support point. */
+  static void
+  Evaluate1DDerivativeWeights(const DispatchBase &, double x, double * const weights)
+  {
+    for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
+    {
+      weights[k] = DerivativeKernelType::FastEvaluate(x);
+      x -= 1.0;
+    }
+  }
+
+  /** Second order spline. At x == 0.5 the second order derivative kernel is discontinuous, and takes the mean of both
+   * sides. */
+  static void
+  Evaluate1DSecondOrderDerivativeWeights(const Dispatch<2> &, const double x, double * const weights)
+  {
+    const bool isAtKnot = (x == 0.5);
+    weights[0] = isAtKnot ? -0.5 : 1.0;
+    weights[1] = isAtKnot ? -0.5 : -2.0;
+    weights[2] = isAtKnot ? 0.5 : 1.0;
+  }
+
+  /** Third order spline. */
+  static void
+  Evaluate1DSecondOrderDerivativeWeights(const Dispatch<3> &, const double x, double * const weights)
+  {
+    weights[0] = 2.0 - x;
+    weights[1] = 3.0 * x - 5.0;
+    weights[2] = 4.0 - 3.0 * x;
+    weights[3] = x - 1.0;
+  }
+
+  /** Other spline orders: evaluate the kernel at each support point. */
+  static void
+  Evaluate1DSecondOrderDerivativeWeights(const DispatchBase &, double x, double * const weights)
+  {
+    for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
+    {
+      weights[k] = SecondOrderDerivativeKernelType::FastEvaluate(x);
+      x -= 1.0;
+    }
+  }
 };
 
 } // end namespace itk
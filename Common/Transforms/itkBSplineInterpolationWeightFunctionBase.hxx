@@ -19,6 +19,7 @@
 #define itkBSplineInterpolationWeightFunctionBase_hxx
 
 #include "itkBSplineInterpolationWeightFunctionBase.h"
+#include <algorithm> // For copy_n.
 
 namespace itk
 {
@@ -34,8 +35,6 @@ BSplineInterpolationWeightFunctionBase<TCoordinate, VSpaceDimension, VSplineOrde
 {
   Superclass::PrintSelf(os, indent);
 
-  os << indent << "OffsetToIndexTable: " << this->m_OffsetToIndexTable << std::endl;
-
 } // end PrintSelf()
 
 
@@ -98,16 +97,33 @@ BSplineInterpolationWeightFunctionBase<TCoordinate, VSpaceDimension, VSplineOrde
   OneDWeightsType weights1D;
   this->Compute1DWeights(cindex, startIndex, weights1D);
 
-  /** Compute the vector of weights. */
-  for (unsigned int k = 0; k < NumberOfWeights; ++k)
+  /** Compute the vector of weights as the outer product of the 1D weights, one dimension at a time. After handling
+   * dimension j, the first (SplineOrder + 1)^(j + 1) weights are filled in, with index[0] running fastest. Each block
+   * of the next dimension is a contiguous copy of the first block, multiplied by a single 1D weight, which allows the
+   * compiler to vectorize the inner loop. The first block is overwritten last, in place. The products are formed in
+   * the same order as a per-weight loop over the dimensions, so the results are exactly the same.
+   */
+  double * const weightsData = weights.data();
+  std::copy_n(weights1D[0], VSplineOrder + 1, weightsData);
+
+  unsigned int blockSize = VSplineOrder + 1;
+  for (unsigned int j = 1; j < SpaceDimension; ++j)
   {
-    double     tmp1 = 1.0;
-    const auto tmp2 = m_OffsetToIndexTable[k];
-    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    for (unsigned int k = VSplineOrder; k > 0; --k)
+    {
+      const double   weight1D = weights1D[j][k];
+      double * const block = weightsData + k * blockSize;
+      for (unsigned int n = 0; n < blockSize; ++n)
+      {
+        block[n] = weightsData[n] * weight1D;
+      }
+    }
+    const double weight1D = weights1D[j][0];
+    for (unsigned int n = 0; n < blockSize; ++n)
     {
-      tmp1 *= weights1D[j][tmp2[j]];
+      weightsData[n] *= weight1D;
     }
-    weights[k] = tmp1;
+    blockSize *= VSplineOrder + 1;
   }
 
   return weights;
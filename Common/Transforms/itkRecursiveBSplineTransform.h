@@ -186,6 +186,12 @@ protected:
   ComputeNonZeroJacobianIndices(NonZeroJacobianIndicesType & nonZeroJacobianIndices,
                                 const RegionType &           supportRegion) const override;
 
+  /** Caches the support index, the 1D interpolation weights and the 1D derivative weights at the points, for
+   * TransformPoint, GetJacobian, EvaluateJacobianWithImageGradientProduct and GetSpatialJacobian.
+   */
+  SizeValueType
+  ComputeWeightCache(const std::vector<InputPointType> & points, const SizeValueType maximumSizeInBytes) override;
+
 private:
   using ImplementationType =
     RecursiveBSplineTransformImplementation<NDimensions, NDimensions, VSplineOrder, TScalarType>;
@@ -193,6 +199,18 @@ private:
   using RecursiveBSplineWeightFunctionType =
     itk::RecursiveBSplineInterpolationWeightFunction<TScalarType, NDimensions, VSplineOrder>;
 
+  /** The number of 1D weights: SplineOrder + 1 for each dimension. */
+  static constexpr unsigned int NumberOfWeights1D = SpaceDimension * (VSplineOrder + 1);
+
+  /** Looks up the support index and the 1D weights at a point in the weight cache, or computes them. Also gets the 1D
+   * derivative weights, when derivativeWeights1D is not null. Returns false when the point is outside the valid region.
+   */
+  bool
+  LookUpOrComputeWeights1D(const InputPointType & point,
+                           IndexType &            supportIndex,
+                           WeightsType &          weights1D,
+                           WeightsType * const    derivativeWeights1D) const;
+
   elx::DefaultConstruct<RecursiveBSplineWeightFunctionType> m_RecursiveBSplineWeightFunction{};
 };
 
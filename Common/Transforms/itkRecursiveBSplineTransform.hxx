@@ -20,7 +20,8 @@
 
 #include "itkRecursiveBSplineTransform.h"
 
-#include <numeric> // For iota.
+#include <algorithm> // For copy_n.
+#include <numeric>   // For iota.
 
 namespace itk
 {
@@ -41,20 +42,17 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoint(co
     return point;
   }
 
-  /** Convert to continuous index. */
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+  // Look up or compute interpolation weights and store them in weights1D
+  IndexType   supportIndex;
+  WeightsType weights1D;
 
   // NOTE: if the support region does not lie totally within the grid
   // we assume zero displacement and return the input point
-  if (!this->InsideValidRegion(cindex))
+  if (!this->LookUpOrComputeWeights1D(point, supportIndex, weights1D, nullptr))
   {
     return point;
   }
 
-  // Compute interpolation weighs and store them in weights1D
-  IndexType         supportIndex;
-  const WeightsType weights1D = m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
-
   /** Initialize (helper) variables. */
   const OffsetValueType * bsplineOffsetTable = Superclass::m_CoefficientImages[0]->GetOffsetTable();
   OffsetValueType         totalOffsetToSupportIndex = 0;
@@ -85,6 +83,78 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoint(co
 } // end TransformPoint()
 
 
+/**
+ * ******************** ComputeWeightCache ***************************
+ */
+
+template <typename TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+SizeValueType
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::ComputeWeightCache(
+  const std::vector<InputPointType> & points,
+  const SizeValueType                 maximumSizeInBytes)
+{
+  /** Each entry holds the 1D weights, followed by the 1D derivative weights. */
+  return this->FillWeightCache(
+    points,
+    2 * NumberOfWeights1D,
+    maximumSizeInBytes,
+    [this](const InputPointType & point, IndexType & supportIndex, double * const weights) {
+      const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+      if (!this->InsideValidRegion(cindex))
+      {
+        return false;
+      }
+      const WeightsType weights1D = m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
+      const WeightsType derivativeWeights1D = m_RecursiveBSplineWeightFunction.EvaluateDerivative(cindex, supportIndex);
+      std::copy_n(weights1D.cbegin(), NumberOfWeights1D, weights);
+      std::copy_n(derivativeWeights1D.cbegin(), NumberOfWeights1D, weights + NumberOfWeights1D);
+      return true;
+    });
+
+} // end ComputeWeightCache()
+
+
+/**
+ * ********************* LookUpOrComputeWeights1D ****************************
+ */
+
+template <typename TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+bool
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::LookUpOrComputeWeights1D(
+  const InputPointType & point,
+  IndexType &            supportIndex,
+  WeightsType &          weights1D,
+  WeightsType * const    derivativeWeights1D) const
+{
+  if (const double * const cachedWeights = this->LookUpWeightCache(point, supportIndex))
+  {
+    std::copy_n(cachedWeights, NumberOfWeights1D, weights1D.begin());
+    if (derivativeWeights1D)
+    {
+      std::copy_n(cachedWeights + NumberOfWeights1D, NumberOfWeights1D, derivativeWeights1D->begin());
+    }
+    return true;
+  }
+
+  /** Convert the physical point to a continuous index, which
+   * is needed for the 'Evaluate()' functions below.
+   */
+  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+  if (!this->InsideValidRegion(cindex))
+  {
+    return false;
+  }
+
+  weights1D = m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
+  if (derivativeWeights1D)
+  {
+    *derivativeWeights1D = m_RecursiveBSplineWeightFunction.EvaluateDerivative(cindex, supportIndex);
+  }
+  return true;
+
+} // end LookUpOrComputeWeights1D()
+
+
 /**
  * ********************* GetJacobian ****************************
  */
@@ -96,11 +166,6 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobian(
   JacobianType &               jacobian,
   NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
 {
-  /** Convert the physical point to a continuous index, which
-   * is needed for the 'Evaluate()' functions below.
-   */
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(inputPoint);
-
   /** Initialize. */
   const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
   if ((jacobian.cols() != nnzji) || (jacobian.rows() != SpaceDimension))
@@ -109,23 +174,23 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobian(
     jacobian.fill(0.0);
   }
 
+  /** Look up or compute the interpolation weights.
+   * In contrast to the normal B-spline weights function, the recursive version
+   * returns the individual weights instead of the multiplied ones.
+   */
+  IndexType   supportIndex;
+  WeightsType weights1D;
+
   /** NOTE: if the support region does not lie totally within the grid
    * we assume zero displacement and zero Jacobian.
    */
-  if (!this->InsideValidRegion(cindex))
+  if (!this->LookUpOrComputeWeights1D(inputPoint, supportIndex, weights1D, nullptr))
   {
     nonZeroJacobianIndices.resize(this->GetNumberOfNonZeroJacobianIndices());
     std::iota(nonZeroJacobianIndices.begin(), nonZeroJacobianIndices.end(), 0u);
     return;
   }
 
-  /** Compute the interpolation weights.
-   * In contrast to the normal B-spline weights function, the recursive version
-   * returns the individual weights instead of the multiplied ones.
-   */
-  IndexType         supportIndex;
-  const WeightsType weights1D = m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
-
   /** Recursively compute the first numberOfIndices entries of the Jacobian.
    * They are directly written in the Jacobian matrix memory block.
    * The pointer has changed after this function call.
@@ -154,29 +219,24 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianW
   DerivativeType &                imageJacobian,
   NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const
 {
-  /** Convert the physical point to a continuous index, which
-   * is needed for the 'Evaluate()' functions below.
+  /** Look up or compute the interpolation weights.
+   * In contrast to the normal B-spline weights function, the recursive version
+   * returns the individual weights instead of the multiplied ones.
    */
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(inputPoint);
+  IndexType   supportIndex;
+  WeightsType weights1D;
 
   /** NOTE: if the support region does not lie totally within the grid
    * we assume zero displacement and zero Jacobian.
    */
   const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
-  if (!this->InsideValidRegion(cindex))
+  if (!this->LookUpOrComputeWeights1D(inputPoint, supportIndex, weights1D, nullptr))
   {
     nonZeroJacobianIndices.resize(nnzji);
     std::iota(nonZeroJacobianIndices.begin(), nonZeroJacobianIndices.end(), 0u);
     return;
   }
 
-  /** Compute the interpolation weights.
-   * In contrast to the normal B-spline weights function, the recursive version
-   * returns the individual weights instead of the multiplied ones.
-   */
-  IndexType         supportIndex;
-  const WeightsType weights1D = m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
-
   /** Recursively compute the inner product of the Jacobian and the moving image gradient.
    * The pointer has changed after this function call.
    */
@@ -209,27 +269,22 @@ void
 RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetSpatialJacobian(const InputPointType & inputPoint,
                                                                                   SpatialJacobianType &  sj) const
 {
-  /** Convert the physical point to a continuous index, which
-   * is needed for the 'Evaluate()' functions below.
+  /** Look up or compute the interpolation weights.
+   * In contrast to the normal B-spline weights function, the recursive version
+   * returns the individual weights instead of the multiplied ones.
    */
-  const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(inputPoint);
+  IndexType   supportIndex;
+  WeightsType weights1D;
+  WeightsType derivativeWeights1D;
 
   // NOTE: if the support region does not lie totally within the grid
   // we assume zero displacement and identity spatial Jacobian
-  if (!this->InsideValidRegion(cindex))
+  if (!this->LookUpOrComputeWeights1D(inputPoint, supportIndex, weights1D, &derivativeWeights1D))
   {
     sj.SetIdentity();
     return;
   }
 
-  /** Compute the interpolation weights.
-   * In contrast to the normal B-spline weights function, the recursive version
-   * returns the individual weights instead of the multiplied ones.
-   */
-  IndexType         supportIndex;
-  const WeightsType weights1D = m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
-  const WeightsType derivativeWeights1D = m_RecursiveBSplineWeightFunction.EvaluateDerivative(cindex, supportIndex);
-
   /** Compute the offset to the start index. */
   const OffsetValueType * bsplineOffsetTable = Superclass::m_CoefficientImages[0]->GetOffsetTable();
   OffsetValueType         totalOffsetToSupportIndex = 0;
@@ -0,0 +1,273 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "elxProfiler.h"
+
+#include <algorithm> // For find_if and max.
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility> // For pair.
+
+namespace elastix
+{
+
+namespace
+{
+std::uint64_t
+GetNewProfilerId()
+{
+  static std::atomic<std::uint64_t> numberOfProfilers{ 0 };
+  return numberOfProfilers++;
+}
+} // namespace
+
+
+/**
+ * ********************* Constructor *********************
+ */
+
+Profiler::Profiler()
+  : m_Id(GetNewProfilerId())
+{}
+
+
+/**
+ * ********************* Destructor *********************
+ */
+
+Profiler::~Profiler() = default;
+
+
+/**
+ * ********************* SetEnabled *********************
+ */
+
+void
+Profiler::SetEnabled(const bool enabled)
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (enabled)
+  {
+    // Clear the contents of the buffers, but keep the buffers themselves, as the threads still refer to them.
+    for (const auto & threadBuffer : m_ThreadBuffers)
+    {
+      const std::lock_guard<std::mutex> bufferLock(threadBuffer->mutex);
+      threadBuffer->events.clear();
+      threadBuffer->numberOfDiscardedEvents = 0;
+      threadBuffer->aggregatesPerResolution.clear();
+    }
+    m_StartTime = ClockType::now();
+  }
+  m_Enabled = enabled;
+}
+
+
+/**
+ * ********************* AddEvent *********************
+ */
+
+void
+Profiler::AddEvent(const char * const name, const ClockType::time_point start, const ClockType::time_point end)
+{
+  this->StoreEvent(name, false, start, std::chrono::duration<double, std::micro>(end - start).count());
+}
+
+
+/**
+ * ********************* AddCounterValue *********************
+ */
+
+void
+Profiler::AddCounterValue(const char * const name, const double value)
+{
+  if (this->IsEnabled())
+  {
+    this->StoreEvent(name, true, ClockType::now(), value);
+  }
+}
+
+
+/**
+ * ********************* GetThreadBuffer *********************
+ */
+
+Profiler::ThreadBuffer &
+Profiler::GetThreadBuffer()
+{
+  // Each thread caches a pointer to its buffer of the profiler that it used most recently, so that it only needs to
+  // lock the mutex of the profiler when it switches between profilers. The cache has a single entry, so it does not
+  // grow with the number of profilers, and the pointer is only used while the id matches, which is never reused.
+  thread_local std::pair<std::uint64_t, ThreadBuffer *> cachedThreadBuffer{ 0, nullptr };
+
+  if (cachedThreadBuffer.second != nullptr && cachedThreadBuffer.first == m_Id)
+  {
+    return *cachedThreadBuffer.second;
+  }
+
+  const std::thread::id             threadId = std::this_thread::get_id();
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+
+  const auto found = std::find_if(m_ThreadBuffers.cbegin(), m_ThreadBuffers.cend(), [threadId](const auto & buffer) {
+    return buffer->threadId == threadId;
+  });
+
+  ThreadBuffer * threadBuffer = (found == m_ThreadBuffers.cend()) ? nullptr : found->get();
+
+  if (threadBuffer == nullptr)
+  {
+    // Number the threads in the order in which they add their first event.
+    threadBuffer = m_ThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    threadBuffer->threadId = threadId;
+    threadBuffer->threadIndex = static_cast<unsigned int>(m_ThreadBuffers.size() - 1);
+  }
+  cachedThreadBuffer = { m_Id, threadBuffer };
+  return *threadBuffer;
+}
+
+
+/**
+ * ********************* StoreEvent *********************
+ */
+
+void
+Profiler::StoreEvent(const char * const          name,
+                     const bool                  isCounter,
+                     const ClockType::time_point start,
+                     const double                value)
+{
+  const unsigned int resolution = m_CurrentResolution.load(std::memory_order_relaxed);
+
+  auto & threadBuffer = this->GetThreadBuffer();
+
+  const std::lock_guard<std::mutex> lock(threadBuffer.mutex);
+
+  if (threadBuffer.aggregatesPerResolution.size() <= resolution)
+  {
+    threadBuffer.aggregatesPerResolution.resize(resolution + 1);
+  }
+  auto & aggregate = threadBuffer.aggregatesPerResolution[resolution][name];
+  aggregate.isCounter = isCounter;
+  aggregate.maximum = (aggregate.count == 0) ? value : std::max(aggregate.maximum, value);
+  aggregate.total += value;
+  ++aggregate.count;
+
+  if (threadBuffer.events.size() < MaximumNumberOfTraceEventsPerThread)
+  {
+    threadBuffer.events.push_back(Event{ name, isCounter, resolution, start, value });
+  }
+  else
+  {
+    ++threadBuffer.numberOfDiscardedEvents;
+  }
+}
+
+
+/**
+ * ********************* ToChromeTrace *********************
+ */
+
+std::string
+Profiler::ToChromeTrace() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+
+  std::ostringstream outputStream;
+  outputStream << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  const char * separator = "\n";
+  std::size_t  numberOfDiscardedEvents{};
+
+  for (const auto & threadBuffer : m_ThreadBuffers)
+  {
+    const std::lock_guard<std::mutex> bufferLock(threadBuffer->mutex);
+
+    for (const auto & event : threadBuffer->events)
+    {
+      const double timeStamp = std::chrono::duration<double, std::micro>(event.start - m_StartTime).count();
+
+      // The names are string literals from the elastix source code, so they do not need escaping.
+      outputStream << separator << "{\"name\":\"" << event.name << "\",\"cat\":\"elastix\",\"pid\":0,\"tid\":"
+                   << threadBuffer->threadIndex << ",\"ts\":" << timeStamp;
+      if (event.isCounter)
+      {
+        outputStream << ",\"ph\":\"C\",\"args\":{\"value\":" << event.durationOrValue << "}}";
+      }
+      else
+      {
+        outputStream << ",\"ph\":\"X\",\"dur\":" << event.durationOrValue << ",\"args\":{\"resolution\":"
+                     << event.resolution << "}}";
+      }
+      separator = ",\n";
+    }
+    numberOfDiscardedEvents += threadBuffer->numberOfDiscardedEvents;
+  }
+  outputStream << "\n],\"otherData\":{\"numberOfDiscardedEvents\":\"" << numberOfDiscardedEvents << "\"}}\n";
+  return outputStream.str();
+}
+
+
+/**
+ * ********************* GetSummary *********************
+ */
+
+std::string
+Profiler::GetSummary(const unsigned int resolution) const
+{
+  // Merge the aggregates of the threads, sorted by name.
+  std::map<std::string, Aggregate> aggregates;
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for (const auto & threadBuffer : m_ThreadBuffers)
+    {
+      const std::lock_guard<std::mutex> bufferLock(threadBuffer->mutex);
+
+      if (resolution < threadBuffer->aggregatesPerResolution.size())
+      {
+        for (const auto & [name, threadAggregate] : threadBuffer->aggregatesPerResolution[resolution])
+        {
+          auto & aggregate = aggregates[name];
+          aggregate.isCounter = threadAggregate.isCounter;
+          aggregate.maximum =
+            (aggregate.count == 0) ? threadAggregate.maximum : std::max(aggregate.maximum, threadAggregate.maximum);
+          aggregate.total += threadAggregate.total;
+          aggregate.count += threadAggregate.count;
+        }
+      }
+    }
+  }
+
+  std::ostringstream outputStream;
+  outputStream << std::fixed << std::setprecision(3) << std::left << std::setw(48) << "Phase or counter"
+               << std::right << std::setw(10) << "Count" << std::setw(16) << "Total" << std::setw(16) << "Mean"
+               << std::setw(16) << "Max" << '\n';
+  for (const auto & [name, aggregate] : aggregates)
+  {
+    // Report durations in milliseconds.
+    const double scale = aggregate.isCounter ? 1.0 : 0.001;
+    outputStream << std::left << std::setw(48) << (aggregate.isCounter ? name : (name + " [ms]")) << std::right
+                 << std::setw(10) << aggregate.count << std::setw(16) << aggregate.total * scale << std::setw(16)
+                 << aggregate.total * scale / static_cast<double>(aggregate.count) << std::setw(16)
+                 << aggregate.maximum * scale << '\n';
+  }
+  return outputStream.str();
+}
+
+} // namespace elastix
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef elxProfiler_h
+#define elxProfiler_h
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory> // For unique_ptr.
+#include <mutex>
+#include <string>
+#include <thread> // For thread::id.
+#include <unordered_map>
+#include <vector>
+
+namespace elastix
+{
+/// Collects the durations of the phases of a registration (like the image sampler update, the metric computation,
+/// the derivative reduction and the resampling), as well as the values of some counters, per resolution.
+///
+/// Each registration (ElastixTemplate) has its own profiler, which is disabled by default. When it is disabled, a
+/// `ProfilerScope` only checks a flag, so that the instrumentation has a negligible overhead. When it is enabled, each
+/// thread adds its events to its own buffer, which aggregates the count, total and maximum per phase and resolution,
+/// and keeps a bounded number of the events themselves, for the trace. The collected events can be exported in the
+/// Chrome trace event format, which can be viewed by chrome://tracing or https://ui.perfetto.dev
+class Profiler
+{
+public:
+  using ClockType = std::chrono::steady_clock;
+
+  /// The maximum number of events that each thread keeps for the trace. Further events are only aggregated.
+  static constexpr std::size_t MaximumNumberOfTraceEventsPerThread{ 100000 };
+
+  Profiler();
+  ~Profiler();
+
+  Profiler(const Profiler &) = delete;
+  Profiler &
+  operator=(const Profiler &) = delete;
+
+  /// Enables or disables the collection of events. Enabling clears the previously collected events.
+  void
+  SetEnabled(const bool enabled);
+
+  bool
+  IsEnabled() const
+  {
+    return m_Enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Sets the resolution that is associated with the events that are added from now on.
+  void
+  SetCurrentResolution(const unsigned int resolution)
+  {
+    m_CurrentResolution.store(resolution, std::memory_order_relaxed);
+  }
+
+  /// Adds a phase that started and ended at the specified time points. The name must be a string literal.
+  void
+  AddEvent(const char * const name, const ClockType::time_point start, const ClockType::time_point end);
+
+  /// Adds the value of a counter, when the profiler is enabled. The name must be a string literal.
+  void
+  AddCounterValue(const char * const name, const double value);
+
+  /// Returns the collected events in the Chrome trace event format (JSON).
+  std::string
+  ToChromeTrace() const;
+
+  /// Returns a table with the number of events, and the total, mean and maximum duration of each phase, or the total,
+  /// mean and maximum value of each counter, for the specified resolution. Merges the buffers of all threads.
+  std::string
+  GetSummary(const unsigned int resolution) const;
+
+private:
+  struct Event
+  {
+    const char *          name;
+    bool                  isCounter;
+    unsigned int          resolution;
+    ClockType::time_point start;
+    double                durationOrValue; // Duration in microseconds, or counter value.
+  };
+
+  struct Aggregate
+  {
+    bool        isCounter{};
+    std::size_t count{};
+    double      total{};
+    double      maximum{};
+  };
+
+  /// The events of a single thread. Its mutex is only contended while the profiler reads or clears the buffer.
+  struct ThreadBuffer
+  {
+    std::thread::id                                          threadId{};
+    unsigned int                                             threadIndex{};
+    std::mutex                                               mutex{};
+    std::vector<Event>                                       events{};
+    std::size_t                                              numberOfDiscardedEvents{};
+    std::vector<std::unordered_map<const char *, Aggregate>> aggregatesPerResolution{};
+  };
+
+  ThreadBuffer &
+  GetThreadBuffer();
+
+  void
+  StoreEvent(const char * const name, const bool isCounter, const ClockType::time_point start, const double value);
+
+  /// Identifies this profiler in the thread-local cache of a buffer. Unlike its address, it is never reused.
+  const std::uint64_t m_Id;
+
+  std::atomic<bool>         m_Enabled{ false };
+  std::atomic<unsigned int> m_CurrentResolution{ 0 };
+
+  mutable std::mutex                         m_Mutex{};
+  ClockType::time_point                      m_StartTime{ ClockType::now() };
+  std::vector<std::unique_ptr<ThreadBuffer>> m_ThreadBuffers{};
+};
+
+
+/// Measures the duration of its own lifetime, and adds it to the specified profiler as an event, when the profiler is
+/// enabled. The profiler may be null, in which case nothing is measured.
+class ProfilerScope
+{
+public:
+  /// The name must be a string literal.
+  ProfilerScope(Profiler * const profiler, const char * const name)
+    : m_Profiler((profiler != nullptr && profiler->IsEnabled()) ? profiler : nullptr)
+    , m_Name(name)
+  {
+    if (m_Profiler)
+    {
+      m_Start = Profiler::ClockType::now();
+    }
+  }
+
+  ~ProfilerScope()
+  {
+    if (m_Profiler)
+    {
+      m_Profiler->AddEvent(m_Name, m_Start, Profiler::ClockType::now());
+    }
+  }
+
+  ProfilerScope(const ProfilerScope &) = delete;
+  ProfilerScope &
+  operator=(const ProfilerScope &) = delete;
+
+private:
+  Profiler * const                m_Profiler;
+  const char * const              m_Name;
+  Profiler::ClockType::time_point m_Start{};
+};
+
+} // namespace elastix
+
+#endif
@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAdvancedBSplineInterpolateImageFunction_h
+#define itkAdvancedBSplineInterpolateImageFunction_h
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkMultiOrderBSplineDecompositionImageFilter.h"
+
+namespace itk
+{
+/** \class AdvancedBSplineInterpolateImageFunction
+ * \brief Evaluates an image at non-integer positions, using B-spline interpolation.
+ *
+ * This class is a BSplineInterpolateImageFunction of which the B-spline coefficients are computed by the
+ * MultiOrderBSplineDecompositionImageFilter, which distributes the lines of the image over its work units, rather
+ * than by the single-threaded BSplineDecompositionImageFilter. The coefficients are the same.
+ *
+ * Moreover, the coefficients that another interpolator of this type has computed may be shared with this
+ * interpolator (see ShareCoefficientsOf). SetInputImage then reuses those coefficients, instead of doing the
+ * decomposition once more, when its input image has the same geometry and the same pixel values as the image from
+ * which they were computed, and when the spline order is the same.
+ *
+ * \ingroup ImageFunctions ImageInterpolators
+ */
+template <typename TImageType, typename TCoordinate = double, typename TCoefficientType = double>
+class ITK_TEMPLATE_EXPORT AdvancedBSplineInterpolateImageFunction
+  : public BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AdvancedBSplineInterpolateImageFunction);
+
+  /** Standard class typedefs. */
+  using Self = AdvancedBSplineInterpolateImageFunction;
+  using Superclass = BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkOverrideGetNameOfClassMacro(AdvancedBSplineInterpolateImageFunction);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** InputImageType typedef support. */
+  using typename Superclass::InputImageType;
+
+  /** Internal Coefficient typedef support. */
+  using typename Superclass::CoefficientImageType;
+  using DecompositionFilterType = MultiOrderBSplineDecompositionImageFilter<TImageType, CoefficientImageType>;
+
+  /** Connects the input image, and computes its B-spline coefficients, unless they are still up-to-date, or unless
+   * the shared coefficients can be used. */
+  void
+  SetInputImage(const TImageType * inputData) override;
+
+  /** Returns the B-spline coefficients of the current input image. */
+  const CoefficientImageType *
+  GetCoefficients() const
+  {
+    return this->m_Coefficients;
+  }
+
+  /** Shares the current coefficients of the specified interpolator with this interpolator, to be used by the next
+   * call to SetInputImage, when possible. The coefficients are only kept when they are computed with the spline order
+   * of this interpolator. The coefficients are not copied, and they are released again by SetInputImage. Passing
+   * null releases the shared coefficients. */
+  void
+  ShareCoefficientsOf(const Self * other);
+
+protected:
+  AdvancedBSplineInterpolateImageFunction() = default;
+  ~AdvancedBSplineInterpolateImageFunction() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Returns whether the shared coefficients are computed from an image that has the same geometry and the same
+   * pixel values as the specified image, and with the current spline order. */
+  bool
+  CanUseSharedCoefficients(const InputImageType & inputImage) const;
+
+  /** The spline order of m_Coefficients. */
+  unsigned int m_CoefficientsSplineOrder{};
+
+  /** The shared coefficients, and the image and the spline order of the interpolator that computed them. */
+  typename CoefficientImageType::ConstPointer m_SharedCoefficients{};
+  typename InputImageType::ConstPointer       m_SharedCoefficientsImage{};
+  unsigned int                                m_SharedCoefficientsSplineOrder{};
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkAdvancedBSplineInterpolateImageFunction.hxx"
+#endif
+
+#endif
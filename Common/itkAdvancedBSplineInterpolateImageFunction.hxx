@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAdvancedBSplineInterpolateImageFunction_hxx
+#define itkAdvancedBSplineInterpolateImageFunction_hxx
+
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
+
+#include <algorithm> // For equal.
+
+namespace itk
+{
+
+/**
+ * ***************** SetInputImage ***********************
+ */
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+void
+AdvancedBSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::SetInputImage(
+  const TImageType * inputData)
+{
+  if (inputData == nullptr)
+  {
+    /** Releases the coefficients. */
+    this->ShareCoefficientsOf(nullptr);
+    Superclass::SetInputImage(nullptr);
+    return;
+  }
+
+  const unsigned int splineOrder = this->GetSplineOrder();
+
+  /** Like the pipeline of BSplineInterpolateImageFunction, the coefficients are only computed again when the image
+   * or the spline order has changed. */
+  if (this->m_Coefficients == nullptr || inputData != this->GetInputImage() ||
+      splineOrder != this->m_CoefficientsSplineOrder || inputData->GetMTime() > this->m_Coefficients->GetMTime())
+  {
+    if (this->CanUseSharedCoefficients(*inputData))
+    {
+      this->m_Coefficients = this->m_SharedCoefficients;
+    }
+    else
+    {
+      /** Release the old coefficients before allocating the new ones. A new filter is used for each image, so that
+       * coefficients that are shared with another interpolator are never overwritten. */
+      this->m_Coefficients = nullptr;
+      this->ShareCoefficientsOf(nullptr);
+
+      const auto decompositionFilter = DecompositionFilterType::New();
+      decompositionFilter->SetSplineOrder(splineOrder);
+      decompositionFilter->SetInput(inputData);
+      decompositionFilter->Update();
+      this->m_Coefficients = decompositionFilter->GetOutput();
+    }
+    this->m_CoefficientsSplineOrder = splineOrder;
+
+    /** The shared coefficients are not needed anymore. */
+    this->ShareCoefficientsOf(nullptr);
+  }
+
+  /** Skip the implementation of BSplineInterpolateImageFunction, which would compute the coefficients once more. */
+  Superclass::Superclass::SetInputImage(inputData);
+  this->m_DataLength = inputData->GetBufferedRegion().GetSize();
+
+} // end SetInputImage()
+
+
+/**
+ * ***************** ShareCoefficientsOf ***********************
+ */
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+void
+AdvancedBSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::ShareCoefficientsOf(
+  const Self * other)
+{
+  if (other != nullptr && other != this && other->m_Coefficients != nullptr &&
+      other->m_CoefficientsSplineOrder == this->GetSplineOrder())
+  {
+    this->m_SharedCoefficients = other->m_Coefficients;
+    this->m_SharedCoefficientsImage = other->GetInputImage();
+    this->m_SharedCoefficientsSplineOrder = other->m_CoefficientsSplineOrder;
+  }
+  else
+  {
+    this->m_SharedCoefficients = nullptr;
+    this->m_SharedCoefficientsImage = nullptr;
+    this->m_SharedCoefficientsSplineOrder = 0;
+  }
+
+} // end ShareCoefficientsOf()
+
+
+/**
+ * ***************** CanUseSharedCoefficients ***********************
+ */
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+bool
+AdvancedBSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::CanUseSharedCoefficients(
+  const InputImageType & inputImage) const
+{
+  const InputImageType * const sharedImage = this->m_SharedCoefficientsImage;
+
+  if (this->m_SharedCoefficients == nullptr || sharedImage == nullptr ||
+      this->m_SharedCoefficientsSplineOrder != this->GetSplineOrder())
+  {
+    return false;
+  }
+
+  const auto & bufferedRegion = inputImage.GetBufferedRegion();
+
+  if (sharedImage->GetBufferedRegion() != bufferedRegion ||
+      sharedImage->GetLargestPossibleRegion() != inputImage.GetLargestPossibleRegion() ||
+      sharedImage->GetSpacing() != inputImage.GetSpacing() || sharedImage->GetOrigin() != inputImage.GetOrigin() ||
+      sharedImage->GetDirection() != inputImage.GetDirection())
+  {
+    return false;
+  }
+
+  /** The pixel values are compared as well, as the images are typically different objects, for example the moving
+   * image and the output of the moving image pyramid at its last level. Comparing is much cheaper than the
+   * decomposition. */
+  const auto * const sharedBuffer = sharedImage->GetBufferPointer();
+  const auto * const buffer = inputImage.GetBufferPointer();
+
+  return sharedBuffer != nullptr && buffer != nullptr &&
+         std::equal(buffer, buffer + bufferedRegion.GetNumberOfPixels(), sharedBuffer);
+
+} // end CanUseSharedCoefficients()
+
+
+/**
+ * ***************** PrintSelf ***********************
+ */
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+void
+AdvancedBSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::PrintSelf(std::ostream & os,
+                                                                                          Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "CoefficientsSplineOrder: " << this->m_CoefficientsSplineOrder << std::endl;
+  os << indent << "SharedCoefficients: " << this->m_SharedCoefficients.GetPointer() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif
@@ -20,6 +20,8 @@
 
 #include "itkLinearInterpolateImageFunction.h"
 
+#include <vector>
+
 namespace itk
 {
 /** \class AdvancedLinearInterpolateImageFunction
@@ -50,6 +52,10 @@ namespace itk
  * We opt to subtract a small number from x, which is computationally efficient,
  * gives cleaner code, and almost exactly the same interpolated value.
  *
+ * Optionally (see SetUseBrickedLayout), the value and derivative are evaluated from
+ * an internal bricked copy of the input image, which is more cache friendly when
+ * the image is large and the positions are randomly scattered.
+ *
  * \sa VectorAdvancedLinearInterpolateImageFunction
  *
  * \ingroup ImageFunctions ImageInterpolators
@@ -104,6 +110,25 @@ public:
   /** Derivative typedef support */
   using CovariantVectorType = CovariantVector<OutputType, Self::ImageDimension>;
 
+  /** Connect the input image, and make a bricked copy of the image, when the bricked layout is used. */
+  void
+  SetInputImage(const InputImageType * ptr) override;
+
+  /** Set whether the value and derivative are evaluated from a bricked copy of the input image. The copy consists of
+   * bricks of BrickSize cells in each dimension, plus a one pixel overlap with the next brick, stored contiguously. All
+   * 2^ImageDimension neighbors of a position are then in the same brick, so that an evaluation touches fewer cache
+   * lines and memory pages than with the row-major layout of the image. The copy takes about (9/8)^ImageDimension
+   * times the memory of the image. It is made by SetInputImage, so the image should be up-to-date at that moment.
+   * Only supported for 2D and 3D images with a scalar pixel type; otherwise, the image is used directly. Default
+   * false. */
+  void
+  SetUseBrickedLayout(const bool arg);
+  itkGetConstMacro(UseBrickedLayout, bool);
+  itkBooleanMacro(UseBrickedLayout);
+
+  /** The number of cells of a brick in each dimension. */
+  static constexpr unsigned int BrickSize{ 8 };
+
   /** Method to compute the derivative. */
   CovariantVectorType
   EvaluateDerivativeAtContinuousIndex(const ContinuousIndexType & x) const;
@@ -123,6 +148,18 @@ protected:
   ~AdvancedLinearInterpolateImageFunction() override = default;
 
 private:
+  /** The number of pixels of a brick in each dimension, including the overlap with the next brick. */
+  static constexpr unsigned int BrickStride{ BrickSize + 1 };
+
+  /** Copies the input image into m_BrickedPixels, or clears m_BrickedPixels, when the bricked layout is not used. */
+  void
+  UpdateBrickedLayout();
+
+  /** Returns a pointer to the pixel at the specified index in the bricked copy, when the copy is available and
+   * all its neighbors at the next index in each dimension are in the image. Returns null otherwise. */
+  const InputPixelType *
+  GetBrickedPixel(const IndexType & baseIndex) const;
+
   /** Helper struct to select the correct dimension. */
   struct DispatchBase
   {};
@@ -162,6 +199,10 @@ private:
     itkExceptionMacro("ERROR: EvaluateValueAndDerivativeAtContinuousIndex() is not implemented for this dimension ("
                       << ImageDimension << ").");
   }
+
+  bool                        m_UseBrickedLayout{ false };
+  std::vector<InputPixelType> m_BrickedPixels{};
+  Size<Self::ImageDimension>  m_NumberOfBricks{};
 };
 
 } // end namespace itk
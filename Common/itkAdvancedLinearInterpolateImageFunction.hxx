@@ -20,11 +20,150 @@
 
 #include "itkAdvancedLinearInterpolateImageFunction.h"
 
+#include <itkIndexRange.h>
 #include <vnl/vnl_math.h>
 
+#include <algorithm>   // For max and min.
+#include <type_traits> // For is_arithmetic.
+
 namespace itk
 {
 
+/**
+ * ***************** SetInputImage ***********************
+ */
+
+template <typename TInputImage, typename TCoordinate>
+void
+AdvancedLinearInterpolateImageFunction<TInputImage, TCoordinate>::SetInputImage(const InputImageType * ptr)
+{
+  Superclass::SetInputImage(ptr);
+  this->UpdateBrickedLayout();
+
+} // end SetInputImage()
+
+
+/**
+ * ***************** SetUseBrickedLayout ***********************
+ */
+
+template <typename TInputImage, typename TCoordinate>
+void
+AdvancedLinearInterpolateImageFunction<TInputImage, TCoordinate>::SetUseBrickedLayout(const bool arg)
+{
+  if (m_UseBrickedLayout != arg)
+  {
+    m_UseBrickedLayout = arg;
+    this->UpdateBrickedLayout();
+    this->Modified();
+  }
+
+} // end SetUseBrickedLayout()
+
+
+/**
+ * ***************** UpdateBrickedLayout ***********************
+ */
+
+template <typename TInputImage, typename TCoordinate>
+void
+AdvancedLinearInterpolateImageFunction<TInputImage, TCoordinate>::UpdateBrickedLayout()
+{
+  m_BrickedPixels.clear();
+  m_BrickedPixels.shrink_to_fit();
+
+  if constexpr (std::is_arithmetic_v<InputPixelType> && (ImageDimension == 2 || ImageDimension == 3))
+  {
+    const InputImageType * const inputImage = this->GetInputImage();
+
+    if (!m_UseBrickedLayout || inputImage == nullptr || inputImage->GetBufferedRegion().GetNumberOfPixels() == 0)
+    {
+      return;
+    }
+
+    /** Each brick covers BrickSize cells, between BrickStride pixels, in each dimension. */
+    const auto imageSize = inputImage->GetBufferedRegion().GetSize();
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      m_NumberOfBricks[dim] = std::max<SizeValueType>((imageSize[dim] + BrickSize - 2) / BrickSize, 1);
+    }
+
+    const auto brickSize = Size<ImageDimension>::Filled(BrickStride);
+    m_BrickedPixels.reserve(m_NumberOfBricks.CalculateProductOfElements() * brickSize.CalculateProductOfElements());
+
+    /** The pixels are copied from the buffer line by line, one line of BrickStride pixels along the first dimension at
+     * a time. The pixels beyond the end of the image are only there to keep the bricks equally sized: they repeat the
+     * last pixel of the image along that dimension. */
+    const InputPixelType * const  buffer = inputImage->GetBufferPointer();
+    const OffsetValueType * const offsetTable = inputImage->GetOffsetTable();
+
+    auto linesPerBrick = brickSize;
+    linesPerBrick[0] = 1;
+
+    for (const auto & brickIndex : ZeroBasedIndexRange<ImageDimension>(m_NumberOfBricks))
+    {
+      const SizeValueType firstPixelOfLine = brickIndex[0] * SizeValueType{ BrickSize };
+      const SizeValueType numberOfPixelsInImage = std::min<SizeValueType>(BrickStride, imageSize[0] - firstPixelOfLine);
+
+      for (const auto & lineIndexInBrick : ZeroBasedIndexRange<ImageDimension>(linesPerBrick))
+      {
+        OffsetValueType lineOffset = firstPixelOfLine;
+        for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+        {
+          const SizeValueType indexInImage = std::min<SizeValueType>(
+            brickIndex[dim] * SizeValueType{ BrickSize } + lineIndexInBrick[dim], imageSize[dim] - 1);
+          lineOffset += static_cast<OffsetValueType>(indexInImage) * offsetTable[dim];
+        }
+        const InputPixelType * const line = buffer + lineOffset;
+
+        m_BrickedPixels.insert(m_BrickedPixels.end(), line, line + numberOfPixelsInImage);
+        m_BrickedPixels.insert(
+          m_BrickedPixels.end(), BrickStride - numberOfPixelsInImage, line[numberOfPixelsInImage - 1]);
+      }
+    }
+  }
+
+} // end UpdateBrickedLayout()
+
+
+/**
+ * ***************** GetBrickedPixel ***********************
+ */
+
+template <typename TInputImage, typename TCoordinate>
+auto
+AdvancedLinearInterpolateImageFunction<TInputImage, TCoordinate>::GetBrickedPixel(const IndexType & baseIndex) const
+  -> const InputPixelType *
+{
+  if (m_BrickedPixels.empty())
+  {
+    return nullptr;
+  }
+
+  std::size_t brickOffset{ 0 };
+  std::size_t pixelOffset{ 0 };
+  std::size_t numberOfBricks{ 1 };
+  std::size_t numberOfPixelsPerBrick{ 1 };
+
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    /** The neighbor at baseIndex[dim] + 1 must be inside the image as well. */
+    if (baseIndex[dim] < this->m_StartIndex[dim] || baseIndex[dim] >= this->m_EndIndex[dim])
+    {
+      return nullptr;
+    }
+    const auto indexInImage = static_cast<std::size_t>(baseIndex[dim] - this->m_StartIndex[dim]);
+
+    brickOffset += (indexInImage / BrickSize) * numberOfBricks;
+    pixelOffset += (indexInImage % BrickSize) * numberOfPixelsPerBrick;
+    numberOfBricks *= m_NumberOfBricks[dim];
+    numberOfPixelsPerBrick *= BrickStride;
+  }
+  return m_BrickedPixels.data() + brickOffset * numberOfPixelsPerBrick + pixelOffset;
+
+} // end GetBrickedPixel()
+
+
 /**
  * ***************** EvaluateDerivativeAtContinuousIndex ***********************
  */
@@ -118,15 +257,16 @@ AdvancedLinearInterpolateImageFunction<TInputImage, TCoordinate>::EvaluateValueA
     dinv[dim] = 1.0 - dist[dim];
   }
 
-  /** Get the 4 corner values. */
-  const RealType val00 = inputImage->GetPixel(baseIndex);
+  /** Get the 4 corner values, preferably from the bricked copy of the image. */
+  const InputPixelType * const brickedPixel = this->GetBrickedPixel(baseIndex);
+  const RealType               val00 = brickedPixel ? brickedPixel[0] : inputImage->GetPixel(baseIndex);
   ++baseIndex[0];
-  const RealType val10 = inputImage->GetPixel(baseIndex);
+  const RealType val10 = brickedPixel ? brickedPixel[1] : inputImage->GetPixel(baseIndex);
   --baseIndex[0];
   ++baseIndex[1];
-  const RealType val01 = inputImage->GetPixel(baseIndex);
+  const RealType val01 = brickedPixel ? brickedPixel[BrickStride] : inputImage->GetPixel(baseIndex);
   ++baseIndex[0];
-  const RealType val11 = inputImage->GetPixel(baseIndex);
+  const RealType val11 = brickedPixel ? brickedPixel[BrickStride + 1] : inputImage->GetPixel(baseIndex);
 
   /** Interpolate to get the value. */
   value = static_cast<OutputType>(val00 * dinv[0] * dinv[1] + val10 * dist[0] * dinv[1] + val01 * dinv[0] * dist[1] +
@@ -198,22 +338,25 @@ AdvancedLinearInterpolateImageFunction<TInputImage, TCoordinate>::EvaluateValueA
     dinv[dim] = 1.0 - dist[dim];
   }
 
-  /** Get the 8 corner values. */
-  const RealType val000 = inputImage->GetPixel(baseIndex);
+  /** Get the 8 corner values, preferably from the bricked copy of the image. */
+  constexpr unsigned int       strideY = BrickStride;
+  constexpr unsigned int       strideZ = BrickStride * BrickStride;
+  const InputPixelType * const brickedPixel = this->GetBrickedPixel(baseIndex);
+  const RealType               val000 = brickedPixel ? brickedPixel[0] : inputImage->GetPixel(baseIndex);
   ++baseIndex[0];
-  const RealType val100 = inputImage->GetPixel(baseIndex);
+  const RealType val100 = brickedPixel ? brickedPixel[1] : inputImage->GetPixel(baseIndex);
   ++baseIndex[1];
-  const RealType val110 = inputImage->GetPixel(baseIndex);
+  const RealType val110 = brickedPixel ? brickedPixel[1 + strideY] : inputImage->GetPixel(baseIndex);
   ++baseIndex[2];
-  const RealType val111 = inputImage->GetPixel(baseIndex);
+  const RealType val111 = brickedPixel ? brickedPixel[1 + strideY + strideZ] : inputImage->GetPixel(baseIndex);
   --baseIndex[1];
-  const RealType val101 = inputImage->GetPixel(baseIndex);
+  const RealType val101 = brickedPixel ? brickedPixel[1 + strideZ] : inputImage->GetPixel(baseIndex);
   --baseIndex[0];
-  const RealType val001 = inputImage->GetPixel(baseIndex);
+  const RealType val001 = brickedPixel ? brickedPixel[strideZ] : inputImage->GetPixel(baseIndex);
   ++baseIndex[1];
-  const RealType val011 = inputImage->GetPixel(baseIndex);
+  const RealType val011 = brickedPixel ? brickedPixel[strideY + strideZ] : inputImage->GetPixel(baseIndex);
   --baseIndex[2];
-  const RealType val010 = inputImage->GetPixel(baseIndex);
+  const RealType val010 = brickedPixel ? brickedPixel[strideY] : inputImage->GetPixel(baseIndex);
 
   /** Interpolate to get the value. */
   value = static_cast<OutputType>(val000 * dinv[0] * dinv[1] * dinv[2] + val100 * dist[0] * dinv[1] * dinv[2] +
@@ -38,6 +38,9 @@ PURPOSE.  See the above copyright notices for more information.
 #include "itkTransform.h"
 #include "itkVector.h"
 
+#include <memory> // For shared_ptr.
+#include <mutex>
+
 namespace itk
 {
 
@@ -48,6 +51,12 @@ namespace itk
  * image and uses bilinear interpolation to integrate each plane of
  * voxels traversed.
  *
+ * When the input image is set, the geometry of the volume is precomputed, as well as a map of
+ * bricks of voxels, with an upper bound of the intensities that can be interpolated within each
+ * brick. Ray points inside bricks whose upper bound does not exceed the threshold are skipped
+ * without reading the voxels, as they would not contribute to the integral anyway. This empty
+ * space skipping does not change the result.
+ *
  * \warning This interpolator works for 3-dimensional images only.
  *
  * \ingroup ImageFunctions
@@ -165,6 +174,18 @@ public:
   /** Get a pointer to the Transform.  */
   itkGetConstMacro(Threshold, double);
 
+  /** Set the input image, and precompute the volume geometry and (when empty space skipping is used) the empty space
+   * map. These are computed again by Evaluate() when the image has been modified afterwards (when its MTime has
+   * changed), or when empty space skipping is switched on afterwards. */
+  void
+  SetInputImage(const InputImageType * ptr) override;
+
+  /** Skip the ray points in bricks of voxels that are below the threshold. A ray that enters such a brick is advanced
+   * to the point where it exits the brick at once. Default: true. */
+  itkSetMacro(UseEmptySpaceSkipping, bool);
+  itkGetConstMacro(UseEmptySpaceSkipping, bool);
+  itkBooleanMacro(UseEmptySpaceSkipping);
+
   /** Check if a point is inside the image buffer.
    * \warning For efficiency, no validity checking of
    * the input image pointer is done. */
@@ -225,6 +246,29 @@ private:
   }
 
   class RayCastHelper;
+
+  /// The data that is precomputed for a specific state of the input image: a ray helper that is initialised for the
+  /// image, copied by each Evaluate() call, and the empty space map.
+  struct PrecomputedData;
+
+  /// Computes the data for the specified image, including the empty space map only when specified. Returns null when
+  /// the image is not three-dimensional.
+  static std::shared_ptr<const PrecomputedData>
+  ComputePrecomputedData(const InputImageType * const image, const bool computeEmptySpaceMap);
+
+  /// Returns the precomputed data for the current state of the input image, computing it again when the image has
+  /// been modified, or when the empty space map is needed but missing. Thread-safe, as it is called by Evaluate().
+  std::shared_ptr<const PrecomputedData>
+  GetPrecomputedData() const;
+
+  /// The size of the bricks of the empty space map, in voxels along each dimension.
+  static constexpr int BrickSize{ 8 };
+
+  bool m_UseEmptySpaceSkipping{ true };
+
+  /// Only accessed by std::atomic_load and std::atomic_store, as Evaluate() may replace it while other threads read it.
+  mutable std::shared_ptr<const PrecomputedData> m_PrecomputedData{};
+  mutable std::mutex                             m_PrecomputedDataMutex{};
 };
 
 } // namespace itk
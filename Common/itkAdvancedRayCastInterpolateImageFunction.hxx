@@ -38,6 +38,11 @@ PURPOSE.  See the above copyright notices for more information.
 
 #include <vnl/vnl_math.h>
 
+#include <algorithm> // For copy_n, max and min.
+#include <cmath>     // For abs and floor.
+#include <limits>
+#include <vector>
+
 namespace itk
 {
 
@@ -81,6 +86,28 @@ public:
   }
 
 
+  /**
+   * Get the image class
+   */
+  const InputImageType *
+  GetImage() const
+  {
+    return m_Image;
+  }
+
+
+  /**
+   * Set the empty space map: an upper bound of the interpolated intensities for each brick
+   * of voxels, or nullptr to disable empty space skipping.
+   */
+  void
+  SetBrickUpperBounds(const double * brickUpperBounds, const int numberOfBricks[3])
+  {
+    m_BrickUpperBounds = brickUpperBounds;
+    std::copy_n(numberOfBricks, 3, m_NumberOfBricks);
+  }
+
+
   /**
    *  Initialise the ray using the position and direction of a line.
    *
@@ -201,9 +228,27 @@ protected:
   void
   InitialiseVoxelPointers();
 
-  /// Increment the voxel pointers surrounding the current point on the ray.
+  /**
+   * Move the current point on the ray, and the voxel pointers surrounding it, to the ray point on the specified plane
+   * of voxels. The position is computed from the start of the ray, so that it does not depend on the ray points that
+   * have been skipped.
+   */
   void
-  IncrementVoxelPointers();
+  MoveVoxelPointers(const int rayPointIndex);
+
+  /// The position (in voxels) of the ray point on the specified plane of voxels.
+  double
+  GetRayPointPosition(const int rayPointIndex, const unsigned int i) const
+  {
+    return m_RayVoxelStartPosition[i] + rayPointIndex * m_VoxelIncrement[i];
+  }
+
+  /**
+   * The number of ray points, starting at the current one, that lie in the same brick of voxels as the current one,
+   * when the interpolated intensities in that brick are known not to exceed the threshold. Zero otherwise.
+   */
+  int
+  GetNumberOfRayPointsInEmptyBrick(const double threshold) const;
 
   /// Record volume dimensions and resolution
   void
@@ -343,6 +388,31 @@ protected:
 
   /// The direction of the ray
   double m_RayDirectionInMM[3];
+
+  /// The empty space map, or nullptr.
+  const double * m_BrickUpperBounds{ nullptr };
+
+  /// The number of bricks of the empty space map along each dimension.
+  int m_NumberOfBricks[3]{};
+};
+
+
+template <typename TInputImage, typename TCoordinate>
+struct AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::PrecomputedData
+{
+  /// The image and its MTime at the moment of the computation.
+  const InputImageType * image{};
+  ModifiedTimeType       imageMTime{};
+
+  RayCastHelper rayCastHelperPrototype{};
+
+  /// Whether the empty space map below is computed.
+  bool hasEmptySpaceMap{};
+
+  /// For each brick, an upper bound of the intensities interpolated between its voxels (including the first voxel
+  /// layer of the next brick), taking rounding errors into account.
+  std::vector<double> brickUpperBounds{};
+  int                 numberOfBricks[3]{};
 };
 
 /* -----------------------------------------------------------------------
@@ -1253,35 +1323,103 @@ AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::RayCastHelper
 
 
 /* -----------------------------------------------------------------------
-   IncrementVoxelPointers() - Increment the voxel pointers
+   MoveVoxelPointers() - Move the voxel pointers to a ray point
    ----------------------------------------------------------------------- */
 
 template <typename TInputImage, typename TCoordinate>
 void
-AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::RayCastHelper::IncrementVoxelPointers()
+AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::RayCastHelper::MoveVoxelPointers(
+  const int rayPointIndex)
 {
-  double xBefore = m_Position3Dvox[0];
-  double yBefore = m_Position3Dvox[1];
-  double zBefore = m_Position3Dvox[2];
+  int delta[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double position = this->GetRayPointPosition(rayPointIndex, i);
+
+    delta[i] = ((int)position) - ((int)m_Position3Dvox[i]);
+    m_Position3Dvox[i] = position;
+    m_RayIntersectionVoxelIndex[i] += delta[i];
+  }
+
+  const int offset = delta[0] + delta[1] * m_NumberOfVoxelsInX + delta[2] * m_NumberOfVoxelsInX * m_NumberOfVoxelsInY;
+
+  m_RayIntersectionVoxels[0] += offset;
+  m_RayIntersectionVoxels[1] += offset;
+  m_RayIntersectionVoxels[2] += offset;
+  m_RayIntersectionVoxels[3] += offset;
+}
 
-  m_Position3Dvox[0] += m_VoxelIncrement[0];
-  m_Position3Dvox[1] += m_VoxelIncrement[1];
-  m_Position3Dvox[2] += m_VoxelIncrement[2];
 
-  int dx = ((int)m_Position3Dvox[0]) - ((int)xBefore);
-  int dy = ((int)m_Position3Dvox[1]) - ((int)yBefore);
-  int dz = ((int)m_Position3Dvox[2]) - ((int)zBefore);
+/* -----------------------------------------------------------------------
+   GetNumberOfRayPointsInEmptyBrick() - Count the ray points in an empty brick
+   ----------------------------------------------------------------------- */
+
+template <typename TInputImage, typename TCoordinate>
+int
+AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::RayCastHelper::GetNumberOfRayPointsInEmptyBrick(
+  const double threshold) const
+{
+  if (m_BrickUpperBounds == nullptr)
+  {
+    return 0;
+  }
+
+  int brickIndex[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (m_RayIntersectionVoxelIndex[i] < 0)
+    {
+      return 0;
+    }
+    brickIndex[i] = m_RayIntersectionVoxelIndex[i] / BrickSize;
+    if (brickIndex[i] >= m_NumberOfBricks[i])
+    {
+      return 0;
+    }
+  }
+  const int brickOffset = brickIndex[0] + m_NumberOfBricks[0] * (brickIndex[1] + m_NumberOfBricks[1] * brickIndex[2]);
+  if (m_BrickUpperBounds[brickOffset] > threshold)
+  {
+    return 0;
+  }
 
-  m_RayIntersectionVoxelIndex[0] += dx;
-  m_RayIntersectionVoxelIndex[1] += dy;
-  m_RayIntersectionVoxelIndex[2] += dz;
+  const auto isInBrick = [this, &brickIndex](const int rayPointIndex) {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const int voxelIndex = (int)this->GetRayPointPosition(rayPointIndex, i);
+      if (voxelIndex < brickIndex[i] * BrickSize || voxelIndex >= (brickIndex[i] + 1) * BrickSize)
+      {
+        return false;
+      }
+    }
+    return true;
+  };
 
-  int totalRayVoxelPlanes = dx + dy * m_NumberOfVoxelsInX + dz * m_NumberOfVoxelsInX * m_NumberOfVoxelsInY;
+  /* Estimate the last ray point in the brick from the distance to the planes where the ray exits the brick. As the
+     positions are monotonic in the ray point index, the ray points in the brick are consecutive, so the estimate only
+     needs to be corrected for rounding errors. */
+  const int firstRayPoint = m_NumVoxelPlanesTraversed;
+  double    lastRayPoint = m_TotalRayVoxelPlanes - 1;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (m_VoxelIncrement[i] != 0.0)
+    {
+      const int exitPosition = (brickIndex[i] + ((m_VoxelIncrement[i] > 0.0) ? 1 : 0)) * BrickSize;
+      lastRayPoint =
+        std::min(lastRayPoint, std::floor((exitPosition - m_RayVoxelStartPosition[i]) / m_VoxelIncrement[i]));
+    }
+  }
 
-  m_RayIntersectionVoxels[0] += totalRayVoxelPlanes;
-  m_RayIntersectionVoxels[1] += totalRayVoxelPlanes;
-  m_RayIntersectionVoxels[2] += totalRayVoxelPlanes;
-  m_RayIntersectionVoxels[3] += totalRayVoxelPlanes;
+  int last = std::max(firstRayPoint, static_cast<int>(lastRayPoint));
+  while (last > firstRayPoint && !isInBrick(last))
+  {
+    --last;
+  }
+  while (last + 1 < m_TotalRayVoxelPlanes && isInBrick(last + 1))
+  {
+    ++last;
+  }
+  return last - firstRayPoint + 1;
 }
 
 
@@ -1387,15 +1525,69 @@ AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::RayCastHelper
   /* Step along the ray as quickly as possible
      integrating the interpolated intensities. */
 
-  for (m_NumVoxelPlanesTraversed = 0; m_NumVoxelPlanesTraversed < m_TotalRayVoxelPlanes; ++m_NumVoxelPlanesTraversed)
+  /* The components of the ray position within the planes of voxels, which determine the
+     bilinear interpolation weights. Selected once, instead of for each ray point. */
+
+  unsigned int inPlane0;
+  unsigned int inPlane1;
+  switch (m_TraversalDirection)
   {
-    intensity = this->GetCurrentIntensity();
+    case TRANSVERSE_IN_X:
+    {
+      inPlane0 = 1;
+      inPlane1 = 2;
+      break;
+    }
+    case TRANSVERSE_IN_Y:
+    {
+      inPlane0 = 0;
+      inPlane1 = 2;
+      break;
+    }
+    case TRANSVERSE_IN_Z:
+    {
+      inPlane0 = 0;
+      inPlane1 = 1;
+      break;
+    }
+    default:
+    {
+      itk::ExceptionObject err(__FILE__, __LINE__);
+      err.SetLocation(ITK_LOCATION);
+      err.SetDescription("The ray traversal direction is unset "
+                         "- IntegrateAboveThreshold().");
+      throw err;
+    }
+  }
 
-    if (intensity > threshold)
+  m_NumVoxelPlanesTraversed = 0;
+  while (m_NumVoxelPlanesTraversed < m_TotalRayVoxelPlanes)
+  {
+    // Points in empty bricks do not contribute, so the ray is advanced to the point where it exits the brick at once.
+    const int numberOfRayPointsInEmptyBrick = this->GetNumberOfRayPointsInEmptyBrick(threshold);
+    if (numberOfRayPointsInEmptyBrick > 0)
+    {
+      m_NumVoxelPlanesTraversed += numberOfRayPointsInEmptyBrick;
+    }
+    else
     {
-      integral += intensity - threshold;
+      // The same bilinear interpolation as GetCurrentIntensity().
+      const double a = (double)(*m_RayIntersectionVoxels[0]);
+      const double b = (double)(*m_RayIntersectionVoxels[1] - a);
+      const double c = (double)(*m_RayIntersectionVoxels[2] - a);
+      const double d = (double)(*m_RayIntersectionVoxels[3] - a - b - c);
+      const double y = m_Position3Dvox[inPlane0] - std::floor(m_Position3Dvox[inPlane0]);
+      const double z = m_Position3Dvox[inPlane1] - std::floor(m_Position3Dvox[inPlane1]);
+
+      intensity = a + b * y + c * z + d * y * z;
+
+      if (intensity > threshold)
+      {
+        integral += intensity - threshold;
+      }
+      ++m_NumVoxelPlanesTraversed;
     }
-    this->IncrementVoxelPointers();
+    this->MoveVoxelPointers(m_NumVoxelPlanesTraversed);
   }
 
   /* The ray passes through the volume one plane of voxels at a time,
@@ -1487,6 +1679,152 @@ AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::PrintSelf(std
   os << indent << "FocalPoint: " << m_FocalPoint << std::endl;
   os << indent << "Transform: " << m_Transform.GetPointer() << std::endl;
   os << indent << "Interpolator: " << m_Interpolator.GetPointer() << std::endl;
+  os << indent << "UseEmptySpaceSkipping: " << m_UseEmptySpaceSkipping << std::endl;
+}
+
+
+/* -----------------------------------------------------------------------
+   SetInputImage - Precompute the volume geometry and the empty space map
+   ----------------------------------------------------------------------- */
+
+template <typename TInputImage, typename TCoordinate>
+void
+AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::SetInputImage(const InputImageType * ptr)
+{
+  this->Superclass::SetInputImage(ptr);
+
+  const std::lock_guard<std::mutex> lock(m_PrecomputedDataMutex);
+  std::atomic_store(&m_PrecomputedData, ComputePrecomputedData(ptr, m_UseEmptySpaceSkipping));
+}
+
+
+/* -----------------------------------------------------------------------
+   ComputePrecomputedData - Compute the volume geometry and the empty space map
+   ----------------------------------------------------------------------- */
+
+template <typename TInputImage, typename TCoordinate>
+auto
+AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::ComputePrecomputedData(
+  const InputImageType * const image,
+  const bool                   computeEmptySpaceMap) -> std::shared_ptr<const PrecomputedData>
+{
+  if constexpr (InputImageDimension == 3)
+  {
+    if (image == nullptr)
+    {
+      return nullptr;
+    }
+
+    const auto data = std::make_shared<PrecomputedData>();
+    data->image = image;
+    data->imageMTime = image->GetMTime();
+    data->rayCastHelperPrototype.SetImage(image);
+    data->rayCastHelperPrototype.ZeroState();
+    data->rayCastHelperPrototype.Initialise();
+
+    if (!computeEmptySpaceMap)
+    {
+      return data;
+    }
+    data->hasEmptySpaceMap = true;
+
+    const SizeType size = image->GetLargestPossibleRegion().GetSize();
+    int            numberOfVoxels[3];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      numberOfVoxels[i] = static_cast<int>(size[i]);
+      data->numberOfBricks[i] = (numberOfVoxels[i] + BrickSize - 1) / BrickSize;
+    }
+    data->brickUpperBounds.resize(static_cast<std::size_t>(data->numberOfBricks[0]) * data->numberOfBricks[1] *
+                                  data->numberOfBricks[2]);
+
+    const PixelType * const buffer = image->GetBufferPointer();
+    const std::size_t       strideY = numberOfVoxels[0];
+    const std::size_t       strideZ = strideY * numberOfVoxels[1];
+
+    auto brickUpperBound = data->brickUpperBounds.begin();
+    for (int bz = 0; bz < data->numberOfBricks[2]; ++bz)
+    {
+      for (int by = 0; by < data->numberOfBricks[1]; ++by)
+      {
+        for (int bx = 0; bx < data->numberOfBricks[0]; ++bx)
+        {
+          // Include the first voxel layer of the next brick, as the four voxels that surround a ray point in a brick
+          // may extend into it.
+          double minimum = std::numeric_limits<double>::max();
+          double maximum = std::numeric_limits<double>::lowest();
+          for (int z = bz * BrickSize; z <= std::min((bz + 1) * BrickSize, numberOfVoxels[2] - 1); ++z)
+          {
+            for (int y = by * BrickSize; y <= std::min((by + 1) * BrickSize, numberOfVoxels[1] - 1); ++y)
+            {
+              const PixelType * const row = buffer + z * strideZ + y * strideY;
+              for (int x = bx * BrickSize; x <= std::min((bx + 1) * BrickSize, numberOfVoxels[0] - 1); ++x)
+              {
+                const auto value = static_cast<double>(row[x]);
+                minimum = std::min(minimum, value);
+                maximum = std::max(maximum, value);
+              }
+            }
+          }
+
+          // The bilinear interpolation is a convex combination of the voxel values, up to rounding errors, which are
+          // bounded by a few ulps of the largest magnitude involved.
+          const double magnitude = std::max(std::abs(minimum), std::abs(maximum)) + (maximum - minimum);
+          *brickUpperBound = maximum + 16.0 * std::numeric_limits<double>::epsilon() * magnitude;
+          ++brickUpperBound;
+        }
+      }
+    }
+
+    return data;
+  }
+  else
+  {
+    (void)image;
+    (void)computeEmptySpaceMap;
+    return nullptr;
+  }
+}
+
+
+/* -----------------------------------------------------------------------
+   GetPrecomputedData - Get the data for the current state of the image
+   ----------------------------------------------------------------------- */
+
+template <typename TInputImage, typename TCoordinate>
+auto
+AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::GetPrecomputedData() const
+  -> std::shared_ptr<const PrecomputedData>
+{
+  const InputImageType * const image = this->m_Image.GetPointer();
+
+  const bool useEmptySpaceSkipping = m_UseEmptySpaceSkipping;
+
+  const auto isUpToDate = [image, useEmptySpaceSkipping](const std::shared_ptr<const PrecomputedData> & data) {
+    return data != nullptr && data->image == image && data->imageMTime == image->GetMTime() &&
+           (data->hasEmptySpaceMap || !useEmptySpaceSkipping);
+  };
+
+  if (image == nullptr)
+  {
+    return nullptr;
+  }
+
+  auto data = std::atomic_load(&m_PrecomputedData);
+  if (isUpToDate(data))
+  {
+    return data;
+  }
+
+  // The image has been modified (or replaced) since the data was computed. Only one thread computes it again.
+  const std::lock_guard<std::mutex> lock(m_PrecomputedDataMutex);
+  data = std::atomic_load(&m_PrecomputedData);
+  if (!isUpToDate(data))
+  {
+    data = ComputePrecomputedData(image, useEmptySpaceSkipping);
+    std::atomic_store(&m_PrecomputedData, data);
+  }
+  return data;
 }
 
 
@@ -1504,10 +1842,26 @@ AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::Evaluate(cons
 
   DirectionType direction = transformedFocalPoint - point;
 
+  // Copy the ray helper that is initialised for the current state of the input image, when available. The local
+  // shared pointer keeps the empty space map alive during the integration.
+  const std::shared_ptr<const PrecomputedData> precomputedData = this->GetPrecomputedData();
+
   AdvancedRayCastInterpolateImageFunction<TInputImage, TCoordinate>::RayCastHelper ray;
-  ray.SetImage(this->m_Image);
-  ray.ZeroState();
-  ray.Initialise();
+  if (precomputedData)
+  {
+    ray = precomputedData->rayCastHelperPrototype;
+
+    if (m_UseEmptySpaceSkipping && precomputedData->hasEmptySpaceMap)
+    {
+      ray.SetBrickUpperBounds(precomputedData->brickUpperBounds.data(), precomputedData->numberOfBricks);
+    }
+  }
+  else
+  {
+    ray.SetImage(this->m_Image);
+    ray.ZeroState();
+    ray.Initialise();
+  }
 
   ray.SetRay(point, direction);
   ray.IntegrateAboveThreshold(integral, m_Threshold);
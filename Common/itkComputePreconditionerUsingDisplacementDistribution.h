@@ -92,10 +92,18 @@ public:
 
   /** The main function that performs the computation.
    * The aims to be a generic function, working for all transformations.
+   * The samples are processed in parallel, and the entries of the preconditioner
+   * are bucketed per block of parameters and accumulated in parallel, in the order
+   * of the samples, so that the result equals the result of ComputeSingleThreaded().
    */
   void
   Compute(const ParametersType & mu, double & maxJJ, ParametersType & preconditioner) const;
 
+  /** The single-threaded version of Compute(mu, maxJJ, preconditioner): the original sequential loop. */
+  using Superclass::ComputeSingleThreaded;
+  void
+  ComputeSingleThreaded(const ParametersType & mu, double & maxJJ, ParametersType & preconditioner) const;
+
   void
   ComputeJacobiTypePreconditioner(double & maxJJ, ParametersType & preconditioner);
 
@@ -119,6 +127,18 @@ protected:
   double m_MaximumStepLength{};
   double m_RegularizationKappa{};
   double m_ConditionNumber{};
+
+private:
+  /** Computes the Jacobian at the point, and for each of its nonzero Jacobian indices the
+   * displacement due to a change in that parameter. Returns JJ_j for the point.
+   */
+  double
+  ComputeSampleDisplacements(const FixedImagePointType &  point,
+                             const DerivativeType &       exactgradient,
+                             const bool                   transformIsBSpline,
+                             JacobianType &               jacj,
+                             NonZeroJacobianIndicesType & jacind,
+                             double * const               displacements) const;
 };
 
 } // end namespace itk
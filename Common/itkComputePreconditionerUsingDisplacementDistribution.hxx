@@ -31,6 +31,7 @@
 
 #include <algorithm> // For min and max.
 #include <cmath>     // For abs.
+#include <numeric>   // For partial_sum.
 
 
 namespace itk
@@ -74,6 +75,175 @@ ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::Com
   const ParametersType & mu,
   double &               maxJJ,
   ParametersType &       preconditioner) const
+{
+  const auto numberOfWorkUnits = static_cast<SizeValueType>(this->m_Threader->GetNumberOfWorkUnits());
+  if (numberOfWorkUnits <= 1)
+  {
+    return this->ComputeSingleThreaded(mu, maxJJ, preconditioner);
+  }
+
+  /** Initialize. */
+  maxJJ = 0.0;
+
+  /** Get the number of parameters. */
+  const auto numberOfParameters = static_cast<unsigned int>(this->m_Transform->GetNumberOfParameters());
+
+  // Replace by a general check later.
+  bool transformIsBSpline = false;
+  if (numberOfParameters > 13)
+    transformIsBSpline = true; // assume B-spline
+
+  /** Get the exact gradient. Uses a random coordinate sampler with
+   * NumberOfSamplesForPrecondition samples, which equals numberOfParameters.
+   */
+  DerivativeType exactgradient(numberOfParameters);
+  this->GetScaledDerivative(mu, exactgradient);
+
+  /** Get samples. Uses a grid sampler with m_NumberOfJacobianMeasurements samples. */
+  const std::vector<ImageSampleType> samples = this->SampleFixedImageForJacobianTerms();
+  const auto                         numberOfSamples = static_cast<SizeValueType>(samples.size());
+
+  static constexpr unsigned int outdim{ TTransform::OutputSpaceDimension };
+
+  const SizeValueType sizejacind = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
+  std::vector<double> localStepSizeSquared(numberOfParameters, 0.0);
+  ParametersType      binCount(numberOfParameters, 0.0);
+
+  /** The samples are processed in chunks, to bound the memory of the intermediate results. Per chunk, the
+   * displacements of the samples are first computed in parallel. The entries of the chunk are then bucketed by the
+   * work unit that owns their parameter, in a single pass that keeps the order of the samples. Finally, each work unit
+   * accumulates the entries of its own bucket, so each entry of the preconditioner receives exactly the same sequence
+   * of additions as in ComputeSingleThreaded().
+   */
+  constexpr SizeValueType    maximumChunkSize{ 4096 };
+  const SizeValueType        chunkSize = std::min(numberOfSamples, maximumChunkSize);
+  const SizeValueType        parametersPerWorkUnit = (numberOfParameters + numberOfWorkUnits - 1) / numberOfWorkUnits;
+  NonZeroJacobianIndicesType chunkIndices(chunkSize * sizejacind);
+  std::vector<double>        chunkDisplacements(chunkSize * sizejacind);
+  std::vector<double>        chunkJJ(chunkSize);
+  std::vector<SizeValueType> bucketedEntries(chunkSize * sizejacind);
+  std::vector<SizeValueType> bucketBegins(numberOfWorkUnits + 1);
+  std::vector<SizeValueType> bucketEnds(numberOfWorkUnits);
+
+  for (SizeValueType chunkBegin = 0; chunkBegin < numberOfSamples; chunkBegin += chunkSize)
+  {
+    const SizeValueType chunkEnd = std::min(chunkBegin + chunkSize, numberOfSamples);
+    const SizeValueType numberOfChunkSamples = chunkEnd - chunkBegin;
+    const SizeValueType numberOfChunkEntries = numberOfChunkSamples * sizejacind;
+
+    this->m_Threader->ParallelizeArray(
+      0,
+      numberOfWorkUnits,
+      [&](const SizeValueType workUnit) {
+        const SizeValueType first = chunkBegin + numberOfChunkSamples * workUnit / numberOfWorkUnits;
+        const SizeValueType last = chunkBegin + numberOfChunkSamples * (workUnit + 1) / numberOfWorkUnits;
+
+        JacobianType               jacj(outdim, sizejacind, 0.0);
+        NonZeroJacobianIndicesType jacind(sizejacind);
+
+        for (SizeValueType s = first; s < last; ++s)
+        {
+          const SizeValueType offset = (s - chunkBegin) * sizejacind;
+          chunkJJ[s - chunkBegin] = this->ComputeSampleDisplacements(samples[s].m_ImageCoordinates,
+                                                                     exactgradient,
+                                                                     transformIsBSpline,
+                                                                     jacj,
+                                                                     jacind,
+                                                                     chunkDisplacements.data() + offset);
+          std::copy(jacind.cbegin(), jacind.cend(), chunkIndices.begin() + offset);
+        }
+      },
+      nullptr);
+
+    /** Max_j [JJ_j]. */
+    maxJJ = std::max(maxJJ, *std::max_element(chunkJJ.cbegin(), chunkJJ.cbegin() + numberOfChunkSamples));
+
+    /** Bucket the entries by their work unit (a counting sort), keeping their order within each bucket. */
+    std::fill(bucketBegins.begin(), bucketBegins.end(), 0);
+    for (SizeValueType k = 0; k < numberOfChunkEntries; ++k)
+    {
+      ++bucketBegins[chunkIndices[k] / parametersPerWorkUnit + 1];
+    }
+    std::partial_sum(bucketBegins.cbegin(), bucketBegins.cend(), bucketBegins.begin());
+    std::copy_n(bucketBegins.cbegin(), numberOfWorkUnits, bucketEnds.begin());
+    for (SizeValueType k = 0; k < numberOfChunkEntries; ++k)
+    {
+      bucketedEntries[bucketEnds[chunkIndices[k] / parametersPerWorkUnit]++] = k;
+    }
+
+    /** Update all entries of the pre-conditioner, per bucket.
+     * localStepSize keeps track of the mean displacement.
+     * localStepSizeSquared keeps track of the standard deviation.
+     */
+    this->m_Threader->ParallelizeArray(
+      0,
+      numberOfWorkUnits,
+      [&](const SizeValueType workUnit) {
+        for (SizeValueType i = bucketBegins[workUnit]; i < bucketBegins[workUnit + 1]; ++i)
+        {
+          const SizeValueType k = bucketedEntries[i];
+          const SizeValueType pj = chunkIndices[k];
+          const double        displacement_j = chunkDisplacements[k];
+          preconditioner[pj] += displacement_j;
+          localStepSizeSquared[pj] += displacement_j * displacement_j;
+          binCount[pj] += 1.0;
+        }
+      },
+      nullptr);
+  }
+
+  /** Compute the mean local step sizes and apply the 2 sigma rule. */
+  double maxEigenvalue = -1e+9;
+  double minEigenvalue = 1e+9;
+  for (unsigned int i = 0; i < numberOfParameters; ++i)
+  {
+    /** Mean deformation magnitude. */
+    double nonZeroBin = binCount[i];
+
+    const double meanLocalStepSize = preconditioner[i] / (nonZeroBin + 1e-14);
+    double       sigma = localStepSizeSquared[i] / (nonZeroBin + 1e-14) - meanLocalStepSize * meanLocalStepSize;
+
+    /** Due to numerical issues, in case of very small squared sums and means,
+     * the standard deviation may become negative. This happens for example in
+     * case of an affine transformation for the translational parameters.
+     */
+    if (sigma < 1e-14)
+      sigma = 0;
+
+    /** Apply the 2 sigma rule. */
+    double localStep = meanLocalStepSize + 2.0 * std::sqrt(sigma) + 1e-14;
+
+    minEigenvalue = std::min(localStep, minEigenvalue);
+    maxEigenvalue = std::max(localStep, maxEigenvalue);
+    preconditioner[i] = this->m_MaximumStepLength / localStep;
+
+  } // end loop over step size vector
+
+  /** Constrained the condition number into a given range, here we first try kappa = 2. */
+  double conditionNumber = maxEigenvalue / minEigenvalue;
+
+  if (transformIsBSpline && conditionNumber > this->m_ConditionNumber)
+  {
+    minEigenvalue = maxEigenvalue / this->m_ConditionNumber;
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      preconditioner[i] = std::min(preconditioner[i], this->m_MaximumStepLength / minEigenvalue);
+    }
+  } // end condition number check.
+
+} // end Compute()
+
+
+/**
+ * ************************* ComputeSingleThreaded ************************
+ */
+
+template <typename TFixedImage, typename TTransform>
+void
+ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::ComputeSingleThreaded(
+  const ParametersType & mu,
+  double &               maxJJ,
+  ParametersType &       preconditioner) const
 {
   /** Initialize. */
   maxJJ = 0.0;
@@ -285,7 +455,155 @@ ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::Com
     }
   } // end condition number check.
 
-} // end Compute()
+} // end ComputeSingleThreaded()
+
+
+/**
+ * ************************* ComputeSampleDisplacements ************************
+ */
+
+template <typename TFixedImage, typename TTransform>
+double
+ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::ComputeSampleDisplacements(
+  const FixedImagePointType &  point,
+  const DerivativeType &       exactgradient,
+  const bool                   transformIsBSpline,
+  JacobianType &               jacj,
+  NonZeroJacobianIndicesType & jacind,
+  double * const               displacements) const
+{
+  static constexpr unsigned int outdim{ TTransform::OutputSpaceDimension };
+
+  const double sqrt2 = std::sqrt(static_cast<double>(2.0));
+
+  /** Get the Jacobian. */
+  this->m_Transform->GetJacobian(point, jacj, jacind);
+  const auto sizejacind = static_cast<unsigned int>(jacind.size());
+
+  /** Compute 1st part of JJ: ||J_j||_F^2. */
+  double JJ_j = vnl_math::sqr(jacj.frobenius_norm());
+
+  /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
+  JacobianType jacjjacj(outdim, outdim);
+  vnl_fastops::ABt(jacjjacj, jacj, jacj);
+  JJ_j += 2.0 * sqrt2 * jacjjacj.frobenius_norm();
+
+  double displacement2_j = 0.0;
+  if (transformIsBSpline)
+  {
+    DerivativeType jacj_g(outdim, 0.0);
+    for (unsigned int i = 0; i < outdim; ++i)
+    {
+      double temp = 0.0;
+      for (unsigned int j = 0; j < sizejacind; ++j)
+      {
+        int pj = jacind[j];
+        temp += jacj(i, j) * exactgradient(pj);
+      }
+
+      // Use the absolute value
+      jacj_g(i) = std::abs(temp);
+    }
+    displacement2_j = jacj_g.magnitude();
+  }
+
+  /** Compute the displacement due to a change in each of the parameters. */
+  for (unsigned int j = 0; j < sizejacind; ++j)
+  {
+    const unsigned int pj = jacind[j];
+    double             displacement_j = 0.0;
+    double             jacj_current = 0.0;
+    for (unsigned int i = 0; i < outdim; ++i)
+    {
+      jacj_current += std::abs(jacj(i, j));
+    }
+    displacement_j = std::abs(jacj_current * exactgradient(pj));
+
+    if (transformIsBSpline)
+    {
+      displacement_j =
+        displacement_j * this->m_RegularizationKappa + (1.0 - this->m_RegularizationKappa) * displacement2_j;
+    }
+    else
+    { // else for affine and rigid
+      double diff_jacobian = 0;
+      double weight = 0;
+      double sum_displacement = 0;
+      double sum_weight = 0;
+      double weight_sigma = 0.01;
+      double maxdiff = 0.0;
+      double mindiff = 0.0;
+      bool   mindiffCheck = true;
+
+      /** Obtain the maximum and minimum difference of absolute jacobian. */
+      for (unsigned int k = 0; k < sizejacind; ++k)
+      {
+        if (k != j)
+        {
+          double jacj_k = 0.0;
+          for (unsigned int i = 0; i < outdim; ++i)
+          {
+            jacj_k += std::abs(jacj(i, k));
+          }
+          diff_jacobian = std::abs(jacj_k - jacj_current);
+          if (diff_jacobian > 0 && mindiffCheck)
+          {
+            mindiff = diff_jacobian;
+            mindiffCheck = false;
+          }
+          if (diff_jacobian > 0 && !mindiffCheck)
+          {
+            mindiff = diff_jacobian < mindiff ? diff_jacobian : mindiff;
+          }
+          maxdiff = diff_jacobian > maxdiff ? diff_jacobian : maxdiff;
+        } // end if
+      } // end for
+
+      if (maxdiff > 0)
+      {
+        weight_sigma = mindiff / maxdiff;
+      }
+      else
+      {
+        weight_sigma = 1e-9;
+      }
+
+      /** To regularize the other entries using the neighborhood information. */
+      for (unsigned int k = 0; k < sizejacind; ++k)
+      {
+        const unsigned int pk = jacind[k];
+        if (k != j)
+        {
+          double jacj_k = 0.0;
+          for (unsigned int i = 0; i < outdim; ++i)
+          {
+            jacj_k += std::abs(jacj(i, k));
+          }
+
+          diff_jacobian = std::abs(jacj_k - jacj_current);
+          weight = std::exp(-(vnl_math::sqr(diff_jacobian / weight_sigma) / 2.0));
+
+          sum_displacement += std::abs(jacj_k * exactgradient(pk)) * weight;
+          sum_weight += weight;
+        } // end if
+      } // end for loop regularization
+
+      if (sum_weight > 0.0)
+      {
+        sum_displacement /= sum_weight;
+
+        /** regularize. */
+        displacement_j =
+          displacement_j * this->m_RegularizationKappa + (1.0 - this->m_RegularizationKappa) * sum_displacement;
+      }
+    } // end else for affine and rigid
+
+    displacements[j] = displacement_j;
+  }
+
+  return JJ_j;
+
+} // end ComputeSampleDisplacements()
 
 
 /**
@@ -65,6 +65,10 @@ namespace itk
  * To generate each output image, recursive Gaussian smoothing is performed
  * using a SmoothingRecursiveGaussianImageFilter.
  *
+ * For an integer output pixel type (for example a 16-bit internal image type),
+ * the levels that are smoothed or resampled are computed in floating point, and
+ * rounded to the nearest integer, rather than truncated.
+ *
  * The user can make alteration on smoothing schedule via SetSmoothingSchedule()
  * For example, for 4 levels smoothing schedule would be:
  * 3 4 5
@@ -98,6 +102,35 @@ namespace itk
  * compute only single level of the pyramid via SetCurrentLevel() and
  * SetComputeOnlyForCurrentLevel() methods.
  *
+ * The computation can be restricted to a region of interest, specified as an
+ * axis-aligned bounding box in physical space, via SetRegionOfInterest() and
+ * SetUseRegionOfInterest(). In that case each output level only covers the
+ * bounding box, extended by a small interpolation margin, and only the part of
+ * the input that is needed for the smoothing and resampling of that region
+ * (the bounding box, extended by four sigma) is processed. This is typically
+ * used to restrict the pyramid to the bounding box of a mask. Note that, when
+ * the region of interest is used, rescaling is always done by the
+ * ResampleImageFilter, because the ShrinkImageFilter can not produce a
+ * specified output region.
+ *
+ * When all levels are computed at once, the levels can be computed in a
+ * cascade, via SetUseCascadedSmoothing(): from fine to coarse, each level is
+ * derived from the (already smoothed and rescaled) next finer level, by
+ * smoothing it with the incremental sigma sqrt(sigma_k^2 - sigma_{k+1}^2),
+ * and resampling it to the grid of the level. The incremental sigma also
+ * accounts for the smoothing by the linear interpolation of the resampling.
+ * Only the finest level is then computed from the full resolution input, and
+ * the other levels are computed from smaller images, which is much faster for
+ * large images. The result is a close approximation of the result of the
+ * default mode. A level is computed directly from the input when its sigmas
+ * are smaller than those of the finer level, when its shrink factors are not
+ * multiples of those of the finer level, or when the finer level is too small
+ * for the recursive Gaussian filter. The cascade is not used in combination with
+ * SetComputeOnlyForCurrentLevel(), which already computes each level lazily,
+ * and releases it when the current level changes (the levels are requested
+ * from coarse to fine, so a finer level is never available to derive the
+ * current level from), nor in combination with SetUseRegionOfInterest().
+ *
  * \author Denis P. Shamonin and Marius Staring. Division of Image Processing,
  * Department of Radiology, Leiden, The Netherlands
  *
@@ -145,6 +178,9 @@ public:
   using typename Superclass::OutputImagePointer;
   using typename Superclass::InputImageConstPointer;
   using SpacingType = typename Superclass::InputImageType::SpacingType;
+  using PointType = typename InputImageType::PointType;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
   using PixelType = typename InputImageType::PixelType;
   using ScalarRealType = typename NumericTraits<PixelType>::ScalarRealType;
 
@@ -225,6 +261,26 @@ public:
   itkGetConstMacro(ComputeOnlyForCurrentLevel, bool);
   itkBooleanMacro(ComputeOnlyForCurrentLevel);
 
+  /** Set the region of interest as an axis-aligned bounding box in physical
+   * space, given by its minimum and maximum corner points.
+   */
+  virtual void
+  SetRegionOfInterest(const PointType & minimum, const PointType & maximum);
+
+  /** Get the minimum and maximum corner points of the region of interest. */
+  itkGetConstReferenceMacro(RegionOfInterestMinimum, PointType);
+  itkGetConstReferenceMacro(RegionOfInterestMaximum, PointType);
+
+  /** Set a control on whether the outputs are restricted to the region of interest. */
+  itkSetMacro(UseRegionOfInterest, bool);
+  itkGetConstMacro(UseRegionOfInterest, bool);
+  itkBooleanMacro(UseRegionOfInterest);
+
+  /** Set a control on whether the levels are computed in a cascade, each from the next finer level. */
+  itkSetMacro(UseCascadedSmoothing, bool);
+  itkGetConstMacro(UseCascadedSmoothing, bool);
+  itkBooleanMacro(UseCascadedSmoothing);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<ImageDimension, OutputImageDimension>));
@@ -274,6 +330,10 @@ protected:
   unsigned int          m_CurrentLevel{};
   bool                  m_ComputeOnlyForCurrentLevel{};
   bool                  m_SmoothingScheduleDefined{};
+  bool                  m_UseRegionOfInterest{ false };
+  PointType             m_RegionOfInterestMinimum{};
+  PointType             m_RegionOfInterestMaximum{};
+  bool                  m_UseCascadedSmoothing{ false };
 
 private:
   /** Typedef for smoother. Smooth always happens first, then only from
@@ -316,6 +376,41 @@ private:
                             typename ImageToImageFilterSameTypes::Pointer &      rescaleSameTypes,
                             typename ImageToImageFilterDifferentTypes::Pointer & rescaleDifferentTypes);
 
+  /** Returns true if the ShrinkImageFilter is used for rescaling. */
+  bool
+  UseShrinker() const
+  {
+    return this->GetUseShrinkImageFilter() && !this->m_UseRegionOfInterest;
+  }
+
+  /** Compute the output region of the level that covers the region of interest. */
+  OutputImageRegionType
+  ComputeOutputRegionOfInterest(const unsigned int level) const;
+
+  /** Compute the input region that is needed to compute the output region of
+   * the level, taking the size of the smoothing kernel into account.
+   */
+  InputImageRegionType
+  ComputeInputRegionOfInterest(const unsigned int level) const;
+
+  /** Computes the sigmas that smooth the next finer level into this level, when the level can be derived from the
+   * next finer level. Returns false otherwise.
+   */
+  bool
+  ComputeIncrementalSigmas(const unsigned int level, SigmaArrayType & incrementalSigmas) const;
+
+  /** Computes the variances of the smoothing by the linear interpolation of the image at the points of the grid.
+   * Returns false when the grid spacing is not a multiple of the image spacing.
+   */
+  static bool
+  ComputeInterpolationVariances(const ImageBase<ImageDimension> & image,
+                                const ImageBase<ImageDimension> & grid,
+                                SigmaArrayType &                  variances);
+
+  /** Computes the output of the level from the output of the next finer level. */
+  void
+  GenerateLevelFromFinerLevel(const unsigned int level, const SigmaArrayType & incrementalSigmas);
+
   /** Initialize m_SmoothingSchedule to default values for backward compatibility. */
   void
   SetSmoothingScheduleToDefault();
@@ -348,6 +443,15 @@ private:
   /** Returns true if rescale has been used in pipeline, otherwise return false. */
   bool
   IsRescaleUsed() const;
+
+  /** Computes the levels of an integer output type in floating point, one level at a time, and rounds them to the
+   * nearest integer. */
+  void
+  GenerateRoundedLevels();
+
+  /** Allows a pyramid with a floating point output type to copy the smoothing schedule of this pyramid. */
+  template <typename, typename, typename>
+  friend class GenericMultiResolutionPyramidImageFilter;
 };
 
 } // namespace itk
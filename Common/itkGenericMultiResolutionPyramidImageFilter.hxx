@@ -22,7 +22,15 @@
 
 #include "itkResampleImageFilter.h"
 #include "itkShrinkImageFilter.h"
+#include "itkExtractImageFilter.h"
 #include "itkImageAlgorithm.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMath.h"
+#include <itkDeref.h>
+
+#include <algorithm> // For clamp.
+#include <cmath>     // For abs, floor, round and sqrt.
 
 namespace itk
 {
@@ -110,6 +118,25 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
 } // end SetComputeOnlyForCurrentLevel()
 
 
+/**
+ * ******************* SetRegionOfInterest ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+void
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::SetRegionOfInterest(
+  const PointType & minimum,
+  const PointType & maximum)
+{
+  if (this->m_RegionOfInterestMinimum != minimum || this->m_RegionOfInterestMaximum != maximum)
+  {
+    this->m_RegionOfInterestMinimum = minimum;
+    this->m_RegionOfInterestMaximum = maximum;
+    this->Modified();
+  }
+} // end SetRegionOfInterest()
+
+
 /**
  * ******************* SetSchedule ***********************
  */
@@ -256,6 +283,10 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   //
   // Pipeline also takes care of memory allocation for N'th output if
   // SetComputeOnlyForCurrentLevel has been set to true.
+  //
+  // If m_UseRegionOfInterest is true, the input of the pipeline is the part of
+  // the input image that is needed to compute the output region of interest,
+  // extracted by an ExtractImageFilter (which keeps the image indices intact).
 
   // Get the input and output pointers
   InputImageConstPointer input = this->GetInput();
@@ -274,12 +305,12 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
       if (this->ComputeForCurrentLevel(level))
       {
         OutputImagePointer outputPtr = this->GetOutput(level);
-        outputPtr->SetBufferedRegion(input->GetLargestPossibleRegion());
+        outputPtr->SetBufferedRegion(outputPtr->GetLargestPossibleRegion());
         outputPtr->Allocate();
 
         ImageAlgorithm::Copy(input.GetPointer(),
                              outputPtr.GetPointer(),
-                             input->GetLargestPossibleRegion(),
+                             outputPtr->GetLargestPossibleRegion(),
                              outputPtr->GetLargestPossibleRegion());
       }
     }
@@ -292,15 +323,35 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
     this->SetSmoothingScheduleToDefault();
   }
 
+  // The smoother and the resampler would truncate the values of an integer output type
+  if constexpr (NumericTraits<typename OutputImageType::PixelType>::is_integer)
+  {
+    if (this->IsSmoothingUsed() || !this->UseShrinker())
+    {
+      this->GenerateRoundedLevels();
+      return;
+    }
+  }
+
   typename SmootherType::Pointer                     smoother;
   typename ImageToImageFilterSameTypes::Pointer      rescaleSameTypes;
   typename ImageToImageFilterDifferentTypes::Pointer rescaleDifferentTypes;
 
-  for (unsigned int level = 0; level < this->m_NumberOfLevels; ++level)
+  using ExtractorType = ExtractImageFilter<InputImageType, InputImageType>;
+  typename ExtractorType::Pointer extractor;
+
+  // In the cascaded mode, the levels are computed from fine to coarse, so that
+  // each level can be derived from the next finer one.
+  const bool useCascade =
+    this->m_UseCascadedSmoothing && !this->m_ComputeOnlyForCurrentLevel && !this->m_UseRegionOfInterest;
+
+  for (unsigned int i = 0; i < this->m_NumberOfLevels; ++i)
   {
+    const unsigned int level = useCascade ? this->m_NumberOfLevels - 1 - i : i;
+
     if (!this->m_ComputeOnlyForCurrentLevel)
     {
-      this->UpdateProgress(static_cast<float>(level) / static_cast<float>(this->m_NumberOfLevels));
+      this->UpdateProgress(static_cast<float>(i) / static_cast<float>(this->m_NumberOfLevels));
     }
 
     if (this->ComputeForCurrentLevel(level))
@@ -310,12 +361,35 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
       outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
       outputPtr->Allocate();
 
+      // Derive the level from the next finer level, if possible
+      SigmaArrayType incrementalSigmas;
+      if (useCascade && this->ComputeIncrementalSigmas(level, incrementalSigmas))
+      {
+        this->GenerateLevelFromFinerLevel(level, incrementalSigmas);
+        continue;
+      }
+
+      // Restrict the input to the part that is needed for the region of interest
+      InputImageConstPointer levelInput = input;
+      if (this->m_UseRegionOfInterest)
+      {
+        if (extractor.IsNull())
+        {
+          extractor = ExtractorType::New();
+          extractor->SetDirectionCollapseToSubmatrix();
+        }
+        extractor->SetInput(input);
+        extractor->SetExtractionRegion(this->ComputeInputRegionOfInterest(level));
+        extractor->UpdateLargestPossibleRegion();
+        levelInput = extractor->GetOutput();
+      }
+
       // Setup the smoother
-      const bool smootherIsUsed = this->SetupSmoother(level, smoother, input);
+      const bool smootherIsUsed = this->SetupSmoother(level, smoother, levelInput);
 
       // Setup the shrinker or resampler
       const int shrinkerOrResamplerIsUsed = this->SetupShrinkerOrResampler(
-        level, smoother, smootherIsUsed, input, outputPtr, rescaleSameTypes, rescaleDifferentTypes);
+        level, smoother, smootherIsUsed, levelInput, outputPtr, rescaleSameTypes, rescaleDifferentTypes);
 
       const auto updateAndGraft = [this, level, outputPtr](auto & filter) {
         filter.GraftOutput(outputPtr);
@@ -327,15 +401,27 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
       };
 
       // Update the pipeline and graft or copy results to this filters output
-      if (shrinkerOrResamplerIsUsed == 0 && smootherIsUsed)
+      if (shrinkerOrResamplerIsUsed == 0 && smootherIsUsed && this->m_UseRegionOfInterest)
+      {
+        // The smoother output covers the extracted input region, which is larger
+        // than the output region of interest, so copy the part that is needed.
+        smoother->Modified();
+        smoother->UpdateLargestPossibleRegion();
+        ImageAlgorithm::Copy(smoother->GetOutput(),
+                             outputPtr.GetPointer(),
+                             outputPtr->GetLargestPossibleRegion(),
+                             outputPtr->GetLargestPossibleRegion());
+        smoother->GetOutput()->ReleaseData();
+      }
+      else if (shrinkerOrResamplerIsUsed == 0 && smootherIsUsed)
       {
         updateAndGraft(*smoother);
       }
       else if (shrinkerOrResamplerIsUsed == 0)
       {
-        ImageAlgorithm::Copy(input.GetPointer(),
+        ImageAlgorithm::Copy(levelInput.GetPointer(),
                              outputPtr.GetPointer(),
-                             input->GetLargestPossibleRegion(),
+                             outputPtr->GetLargestPossibleRegion(),
                              outputPtr->GetLargestPossibleRegion());
       }
       else if (shrinkerOrResamplerIsUsed == 1)
@@ -347,11 +433,236 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
         updateAndGraft(*rescaleDifferentTypes);
       }
       // no else needed
+
+      // The extracted input is not needed anymore for this level
+      if (extractor.IsNotNull())
+      {
+        extractor->GetOutput()->ReleaseData();
+      }
     }
   } // end for ilevel
 } // end GenerateData()
 
 
+/**
+ * ******************* GenerateRoundedLevels ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+void
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::GenerateRoundedLevels()
+{
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using RealImageType = Image<typename NumericTraits<OutputPixelType>::FloatType, OutputImageDimension>;
+  using RealPyramidType = GenericMultiResolutionPyramidImageFilter<InputImageType, RealImageType, TPrecisionType>;
+
+  // The floating point pyramid computes only one level at a time, to limit its memory usage
+  const auto realPyramid = RealPyramidType::New();
+  realPyramid->SetInput(this->GetInput());
+  realPyramid->SetNumberOfLevels(this->m_NumberOfLevels);
+  realPyramid->SetRescaleSchedule(this->m_Schedule);
+  realPyramid->m_SmoothingSchedule = this->m_SmoothingSchedule;
+  realPyramid->m_SmoothingScheduleDefined = true;
+  realPyramid->SetUseShrinkImageFilter(this->GetUseShrinkImageFilter());
+  realPyramid->SetRegionOfInterest(this->m_RegionOfInterestMinimum, this->m_RegionOfInterestMaximum);
+  realPyramid->SetUseRegionOfInterest(this->m_UseRegionOfInterest);
+  realPyramid->SetComputeOnlyForCurrentLevel(true);
+  realPyramid->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  const auto minimum = static_cast<double>(NumericTraits<OutputPixelType>::NonpositiveMin());
+  const auto maximum = static_cast<double>(NumericTraits<OutputPixelType>::max());
+
+  for (unsigned int level = 0; level < this->m_NumberOfLevels; ++level)
+  {
+    if (!this->m_ComputeOnlyForCurrentLevel)
+    {
+      this->UpdateProgress(static_cast<float>(level) / static_cast<float>(this->m_NumberOfLevels));
+    }
+
+    if (this->ComputeForCurrentLevel(level))
+    {
+      realPyramid->SetCurrentLevel(level);
+      realPyramid->UpdateLargestPossibleRegion();
+
+      const OutputImagePointer outputPtr = this->GetOutput(level);
+      outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+      outputPtr->Allocate();
+
+      const auto &                            region = outputPtr->GetBufferedRegion();
+      ImageRegionConstIterator<RealImageType> realIt(realPyramid->GetOutput(level), region);
+      for (ImageRegionIterator<OutputImageType> it(outputPtr, region); !it.IsAtEnd(); ++it, ++realIt)
+      {
+        it.Set(Math::Round<OutputPixelType>(std::clamp(static_cast<double>(realIt.Get()), minimum, maximum)));
+      }
+      Deref(realPyramid->GetOutput(level)).ReleaseData();
+    }
+  }
+
+} // end GenerateRoundedLevels()
+
+
+/**
+ * ******************* ComputeIncrementalSigmas ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+bool
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::ComputeIncrementalSigmas(
+  const unsigned int level,
+  SigmaArrayType &   incrementalSigmas) const
+{
+  if (level + 1 >= this->m_NumberOfLevels)
+  {
+    return false;
+  }
+
+  /** The recursive Gaussian filter requires at least four pixels along each dimension. */
+  const OutputImageType & finerLevel = Deref(this->GetOutput(level + 1));
+  const auto &            finerSize = finerLevel.GetLargestPossibleRegion().GetSize();
+
+  /** The rescaling adds smoothing as well: the variance of the linear interpolation of the finer level, and of the
+   * input, at the grid of each level. The shrinker does not interpolate.
+   */
+  const InputImageType & input = Deref(this->GetInput());
+  const bool             useInterpolationOfInput = this->IsRescaleUsed() && !this->UseShrinker();
+
+  SigmaArrayType cascadeVariances;
+  auto           inputVariances = SigmaArrayType::Filled(0.0);
+  auto           finerInputVariances = SigmaArrayType::Filled(0.0);
+  if (!ComputeInterpolationVariances(finerLevel, Deref(this->GetOutput(level)), cascadeVariances) ||
+      (useInterpolationOfInput &&
+       !(ComputeInterpolationVariances(input, Deref(this->GetOutput(level)), inputVariances) &&
+         ComputeInterpolationVariances(input, finerLevel, finerInputVariances))))
+  {
+    return false;
+  }
+
+  const SigmaArrayType sigmas = this->GetSigmas(level);
+  const SigmaArrayType finerSigmas = this->GetSigmas(level + 1);
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    /** Gaussian smoothing is a cascade: the variances of the successive smoothing steps add up. */
+    const double incrementalVariance = sigmas[dim] * sigmas[dim] + inputVariances[dim] -
+                                       finerSigmas[dim] * finerSigmas[dim] - finerInputVariances[dim] -
+                                       cascadeVariances[dim];
+    if (incrementalVariance < 0.0 || finerSize[dim] < 4)
+    {
+      return false;
+    }
+    incrementalSigmas[dim] = std::sqrt(incrementalVariance);
+  }
+  return true;
+
+} // end ComputeIncrementalSigmas()
+
+
+/**
+ * ******************* ComputeInterpolationVariances ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+bool
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::ComputeInterpolationVariances(
+  const ImageBase<ImageDimension> & image,
+  const ImageBase<ImageDimension> & grid,
+  SigmaArrayType &                  variances)
+{
+  /** Linear interpolation at a fraction t between two pixels is a weighted average with weights 1 - t and t, which
+   * has a variance of t (1 - t) spacing^2. The fraction is only the same for all points of the grid when the grid
+   * spacing is a multiple of the pixel spacing.
+   */
+  const auto   continuousIndex = image.template TransformPhysicalPointToContinuousIndex<double>(grid.GetOrigin());
+  const auto & spacing = image.GetSpacing();
+
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    const double step = grid.GetSpacing()[dim] / spacing[dim];
+    if (std::abs(step - std::round(step)) > 1e-6)
+    {
+      return false;
+    }
+    const double fraction = continuousIndex[dim] - std::floor(continuousIndex[dim]);
+    variances[dim] = fraction * (1.0 - fraction) * spacing[dim] * spacing[dim];
+  }
+  return true;
+
+} // end ComputeInterpolationVariances()
+
+
+/**
+ * ******************* GenerateLevelFromFinerLevel ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+void
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::GenerateLevelFromFinerLevel(
+  const unsigned int     level,
+  const SigmaArrayType & incrementalSigmas)
+{
+  using CascadeSmootherType = SmoothingRecursiveGaussianImageFilter<OutputImageType, OutputImageType>;
+  using CascadeResamplerType = ResampleImageFilter<OutputImageType, OutputImageType, TPrecisionType>;
+  using InterpolatorType = LinearInterpolateImageFunction<OutputImageType, TPrecisionType>;
+  using TransformType = IdentityTransform<TPrecisionType, OutputImageType::ImageDimension>;
+
+  const OutputImagePointer outputPtr = this->GetOutput(level);
+
+  /** Graft the finer level onto a separate image, to disconnect it from this
+   * filter: otherwise updating the filters below would update this filter.
+   */
+  const auto finerLevel = OutputImageType::New();
+  finerLevel->Graft(this->GetOutput(level + 1));
+
+  typename OutputImageType::ConstPointer source = finerLevel;
+
+  typename CascadeSmootherType::Pointer smoother;
+  if (incrementalSigmas != SigmaArrayType{})
+  {
+    smoother = CascadeSmootherType::New();
+    smoother->SetInput(finerLevel);
+    smoother->SetSigmaArray(incrementalSigmas);
+    source = smoother->GetOutput();
+  }
+
+  if (this->GetShrinkFactors(level) == this->GetShrinkFactors(level + 1))
+  {
+    /** The finer level has the same grid as this level. */
+    if (smoother.IsNotNull())
+    {
+      smoother->GraftOutput(outputPtr);
+      smoother->UpdateLargestPossibleRegion();
+      this->GraftNthOutput(level, smoother->GetOutput());
+    }
+    else
+    {
+      ImageAlgorithm::Copy(finerLevel.GetPointer(),
+                           outputPtr.GetPointer(),
+                           outputPtr->GetLargestPossibleRegion(),
+                           outputPtr->GetLargestPossibleRegion());
+    }
+    return;
+  }
+
+  /** Resample the (smoothed) finer level to the grid of this level. The
+   * smoothed finer level is released as soon as it has been consumed.
+   */
+  const auto resampler = CascadeResamplerType::New();
+  resampler->SetInput(source);
+  resampler->SetOutputParametersFromImage(outputPtr);
+  resampler->SetDefaultPixelValue(0);
+  resampler->SetInterpolator(InterpolatorType::New());
+  resampler->SetTransform(TransformType::New());
+  resampler->GraftOutput(outputPtr);
+  resampler->UpdateLargestPossibleRegion();
+  this->GraftNthOutput(level, resampler->GetOutput());
+
+  if (smoother.IsNotNull())
+  {
+    smoother->GetOutput()->ReleaseData();
+  }
+
+} // end GenerateLevelFromFinerLevel()
+
+
 /**
  * ******************* SetupSmoother ***********************
  */
@@ -453,7 +764,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
     // A pipeline version that newly constructs the required filters:
     if (rescaleSameTypes.IsNull())
     {
-      if (this->GetUseShrinkImageFilter())
+      if (this->UseShrinker())
       {
         // Define and setup shrinker
         auto shrinker = ShrinkerSameType::New();
@@ -484,7 +795,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
     // A pipeline version that re-uses previously constructed filters:
     else
     {
-      if (this->GetUseShrinkImageFilter())
+      if (this->UseShrinker())
       {
         // Setup shrinker
         typename ShrinkerSameType::Pointer shrinker = dynamic_cast<ShrinkerSameType *>(rescaleSameTypes.GetPointer());
@@ -509,7 +820,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   // A pipeline version that newly constructs the required filters:
   if (rescaleDifferentTypes.IsNull())
   {
-    if (this->GetUseShrinkImageFilter())
+    if (this->UseShrinker())
     {
       // Define and setup shrinker
       auto shrinker = ShrinkerDifferentType::New();
@@ -540,7 +851,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   // A pipeline version that re-uses previously constructed filters:
   else
   {
-    if (this->GetUseShrinkImageFilter())
+    if (this->UseShrinker())
     {
       typename ShrinkerDifferentType::Pointer shrinker =
         dynamic_cast<ShrinkerDifferentType *>(rescaleDifferentTypes.GetPointer());
@@ -574,6 +885,15 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
     // call the SuperSuperclass implementation of this method
     SuperSuperclass::GenerateOutputInformation();
   }
+
+  // Restrict the outputs to the region of interest
+  if (this->m_UseRegionOfInterest)
+  {
+    for (unsigned int level = 0; level < this->m_NumberOfLevels; ++level)
+    {
+      this->GetOutput(level)->SetLargestPossibleRegion(this->ComputeOutputRegionOfInterest(level));
+    }
+  }
 } // end GenerateOutputInformation()
 
 
@@ -644,6 +964,126 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
 } // end GenerateInputRequestedRegion()
 
 
+/**
+ * ******************* ComputeOutputRegionOfInterest ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+auto
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::ComputeOutputRegionOfInterest(
+  const unsigned int level) const -> OutputImageRegionType
+{
+  const OutputImageType *       output = this->GetOutput(level);
+  const OutputImageRegionType & largestRegion = output->GetLargestPossibleRegion();
+
+  /** Map all corners of the bounding box to the grid of this level,
+   * to support images with a non-identity direction cosine matrix.
+   */
+  ContinuousIndex<double, ImageDimension> minimumIndex;
+  ContinuousIndex<double, ImageDimension> maximumIndex;
+  minimumIndex.Fill(NumericTraits<double>::max());
+  maximumIndex.Fill(NumericTraits<double>::NonpositiveMin());
+  for (unsigned int corner = 0; corner < (1u << ImageDimension); ++corner)
+  {
+    PointType point;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      point[dim] = ((corner >> dim) & 1) ? this->m_RegionOfInterestMaximum[dim] : this->m_RegionOfInterestMinimum[dim];
+    }
+    const auto cindex = output->template TransformPhysicalPointToContinuousIndex<double>(point);
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      minimumIndex[dim] = std::min(minimumIndex[dim], cindex[dim]);
+      maximumIndex[dim] = std::max(maximumIndex[dim], cindex[dim]);
+    }
+  }
+
+  /** Add a margin of two voxels, which is enough for linear and cubic B-spline
+   * interpolation at the border of the region of interest.
+   */
+  constexpr IndexValueType margin = 2;
+
+  typename OutputImageRegionType::IndexType start;
+  typename OutputImageRegionType::SizeType  size;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    start[dim] = Math::Floor<IndexValueType>(minimumIndex[dim]) - margin;
+    const IndexValueType end = Math::Ceil<IndexValueType>(maximumIndex[dim]) + margin;
+    size[dim] = static_cast<SizeValueType>(end - start[dim] + 1);
+  }
+
+  OutputImageRegionType region(start, size);
+
+  /** If the region of interest does not overlap with the image, then fall back to the whole image. */
+  if (!region.Crop(largestRegion))
+  {
+    return largestRegion;
+  }
+  return region;
+
+} // end ComputeOutputRegionOfInterest()
+
+
+/**
+ * ******************* ComputeInputRegionOfInterest ***********************
+ */
+
+template <typename TInputImage, typename TOutputImage, typename TPrecisionType>
+auto
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::ComputeInputRegionOfInterest(
+  const unsigned int level) const -> InputImageRegionType
+{
+  const InputImageType *        input = this->GetInput();
+  const OutputImageType *       output = this->GetOutput(level);
+  const OutputImageRegionType & outputRegion = output->GetLargestPossibleRegion();
+
+  /** Map all corners of the output region to the input grid. */
+  ContinuousIndex<double, ImageDimension> minimumIndex;
+  ContinuousIndex<double, ImageDimension> maximumIndex;
+  minimumIndex.Fill(NumericTraits<double>::max());
+  maximumIndex.Fill(NumericTraits<double>::NonpositiveMin());
+  for (unsigned int corner = 0; corner < (1u << ImageDimension); ++corner)
+  {
+    ContinuousIndex<double, ImageDimension> outputIndex;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      outputIndex[dim] = ((corner >> dim) & 1)
+                           ? static_cast<double>(outputRegion.GetUpperIndex()[dim]) + 0.5
+                           : static_cast<double>(outputRegion.GetIndex()[dim]) - 0.5;
+    }
+    const auto point = output->template TransformContinuousIndexToPhysicalPoint<double>(outputIndex);
+    const auto cindex = input->template TransformPhysicalPointToContinuousIndex<double>(point);
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      minimumIndex[dim] = std::min(minimumIndex[dim], cindex[dim]);
+      maximumIndex[dim] = std::max(maximumIndex[dim], cindex[dim]);
+    }
+  }
+
+  /** Extend the region by four sigma (in voxels) for the Gaussian smoothing. */
+  const SigmaArrayType sigmas = this->GetSigmas(level);
+  const SpacingType &  spacing = input->GetSpacing();
+
+  typename InputImageRegionType::IndexType start;
+  typename InputImageRegionType::SizeType  size;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    const auto margin = Math::Ceil<IndexValueType>(4.0 * sigmas[dim] / spacing[dim]) + 1;
+    start[dim] = Math::Floor<IndexValueType>(minimumIndex[dim]) - margin;
+    const IndexValueType end = Math::Ceil<IndexValueType>(maximumIndex[dim]) + margin;
+    size[dim] = static_cast<SizeValueType>(end - start[dim] + 1);
+  }
+
+  InputImageRegionType region(start, size);
+  if (!region.Crop(input->GetLargestPossibleRegion()))
+  {
+    return input->GetLargestPossibleRegion();
+  }
+  return region;
+
+} // end ComputeInputRegionOfInterest()
+
+
 /**
  * ******************* ReleaseOutputs ***********************
  */
@@ -832,6 +1272,10 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   os << indent << "ComputeOnlyForCurrentLevel: " << (this->m_ComputeOnlyForCurrentLevel ? "true" : "false")
      << std::endl;
   os << indent << "SmoothingScheduleDefined: " << (this->m_SmoothingScheduleDefined ? "true" : "false") << std::endl;
+  os << indent << "UseRegionOfInterest: " << (this->m_UseRegionOfInterest ? "true" : "false") << std::endl;
+  os << indent << "RegionOfInterestMinimum: " << this->m_RegionOfInterestMinimum << std::endl;
+  os << indent << "RegionOfInterestMaximum: " << this->m_RegionOfInterestMaximum << std::endl;
+  os << indent << "UseCascadedSmoothing: " << (this->m_UseCascadedSmoothing ? "true" : "false") << std::endl;
   os << indent << "Smoothing Schedule: ";
   if (this->m_SmoothingSchedule.empty())
   {
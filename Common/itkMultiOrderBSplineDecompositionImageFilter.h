@@ -70,11 +70,14 @@ namespace itk
  *               Uses mirror boundary conditions.
  *               Can only process LargestPossibleRegion
  *
+ * The directions are processed one after the other, but the lines along a direction are independent, so they are
+ * distributed over the work units of the filter. The output pixel type may be float, in which case the recursive
+ * filtering is also done in float, like BSplineDecompositionImageFilter does.
+ *
  * \sa itkBSplineInterpolateImageFunction
  *
  *  ***TODO: Is this an ImageFilter?  or does it belong to another group?
  * \ingroup ImageFilters
- * \ingroup SingleThreaded
  * \ingroup CannotBeStreamed
  */
 template <typename TInputImage, typename TOutputImage>
@@ -119,8 +122,8 @@ public:
   void
   SetSplineOrder(unsigned int dimension, unsigned int order);
 
-  void
-  GetSplineOrder(unsigned int dimension)
+  unsigned int
+  GetSplineOrder(unsigned int dimension) const
   {
     return m_SplineOrder[dimension];
   }
@@ -153,7 +156,6 @@ protected:
   EnlargeOutputRequestedRegion(DataObject * output) override;
 
   /** These are needed by the smoothing spline routine. */
-  std::vector<CoeffType>         m_Scratch{};    // temp storage for processing of Coefficients
   typename TInputImage::SizeType m_DataLength{}; // Image size
 
   unsigned int
@@ -161,16 +163,16 @@ protected:
   double m_SplinePoles[3]{};              // Poles calculated for a given spline order
   int    m_NumberOfPoles{};               // number of poles
   double m_Tolerance{};                   // Tolerance used for determining initial causal coefficient
-  unsigned int m_IteratorDirection{};     // Direction for iterator incrementing
 
 private:
   /** Determines the poles for dimension given the Spline Order. */
   virtual void
   SetPoles(unsigned int dimension);
 
-  /** Converts a vector of data to a vector of Spline coefficients. */
-  virtual bool
-  DataToCoefficients1D();
+  /** Converts a line of data, stored in the specified scratch buffer, to a line of Spline coefficients, in place.
+   * Uses the poles of the current direction. */
+  bool
+  DataToCoefficients1D(CoeffType * scratch, SizeValueType dataLength) const;
 
   /** Converts an N-dimension image of data to an equivalent sized image
    *    of spline coefficients. */
@@ -178,24 +180,16 @@ private:
   DataToCoefficientsND();
 
   /** Determines the first coefficient for the causal filtering of the data. */
-  virtual void
-  SetInitialCausalCoefficient(double z);
+  void
+  SetInitialCausalCoefficient(double z, CoeffType * scratch, SizeValueType dataLength) const;
 
   /** Determines the first coefficient for the anti-causal filtering of the data. */
-  virtual void
-  SetInitialAntiCausalCoefficient(double z);
+  void
+  SetInitialAntiCausalCoefficient(double z, CoeffType * scratch, SizeValueType dataLength) const;
 
   /** Used to initialize the Coefficients image before calculation. */
   void
   CopyImageToImage();
-
-  /** Copies a vector of data from the Coefficients image to the m_Scratch vector. */
-  void
-  CopyCoefficientsToScratch(OutputLinearIterator &);
-
-  /** Copies a vector of data from m_Scratch to the Coefficients image. */
-  void
-  CopyScratchToCoefficients(OutputLinearIterator &);
 };
 
 } // namespace itk
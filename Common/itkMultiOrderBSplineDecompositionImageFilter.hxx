@@ -39,9 +39,11 @@
 #include "itkMultiOrderBSplineDecompositionImageFilter.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
-#include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkVector.h"
 
+#include <algorithm> // For min.
+
 namespace itk
 {
 
@@ -53,7 +55,6 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::MultiOrder
 {
   int splineOrder = 3;
   m_Tolerance = 1e-10; // Need some guidance on this one...what is reasonable?
-  m_IteratorDirection = 0;
   this->SetSplineOrder(splineOrder);
 }
 
@@ -81,7 +82,9 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::PrintSelf(
 
 template <typename TInputImage, typename TOutputImage>
 bool
-MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficients1D()
+MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficients1D(
+  CoeffType * const   scratch,
+  const SizeValueType dataLength) const
 {
 
   // See Unser, 1993, Part II, Equation 2.5,
@@ -89,7 +92,7 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoef
 
   double c0 = 1.0;
 
-  if (m_DataLength[m_IteratorDirection] == 1) // Required by mirror boundaries
+  if (dataLength == 1) // Required by mirror boundaries
   {
     return false;
   }
@@ -102,28 +105,28 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoef
   }
 
   // apply the gain
-  for (SizeValueType n = 0; n < m_DataLength[m_IteratorDirection]; ++n)
+  for (SizeValueType n = 0; n < dataLength; ++n)
   {
-    m_Scratch[n] *= c0;
+    scratch[n] *= c0;
   }
 
   // loop over all poles
   for (int k = 0; k < m_NumberOfPoles; ++k)
   {
     // causal initialization
-    this->SetInitialCausalCoefficient(m_SplinePoles[k]);
+    this->SetInitialCausalCoefficient(m_SplinePoles[k], scratch, dataLength);
     // causal recursion
-    for (SizeValueType n = 1; n < m_DataLength[m_IteratorDirection]; ++n)
+    for (SizeValueType n = 1; n < dataLength; ++n)
     {
-      m_Scratch[n] += m_SplinePoles[k] * m_Scratch[n - 1];
+      scratch[n] += m_SplinePoles[k] * scratch[n - 1];
     }
 
     // anticausal initialization
-    this->SetInitialAntiCausalCoefficient(m_SplinePoles[k]);
+    this->SetInitialAntiCausalCoefficient(m_SplinePoles[k], scratch, dataLength);
     // anticausal recursion
-    for (int n = m_DataLength[m_IteratorDirection] - 2; 0 <= n; n--)
+    for (SizeValueType n = dataLength - 1; n > 0; --n)
     {
-      m_Scratch[n] = m_SplinePoles[k] * (m_Scratch[n + 1] - m_Scratch[n]);
+      scratch[n - 1] = m_SplinePoles[k] * (scratch[n] - scratch[n - 1]);
     }
   }
   return true;
@@ -213,7 +216,10 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetPoles(u
 
 template <typename TInputImage, typename TOutputImage>
 void
-MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialCausalCoefficient(double z)
+MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialCausalCoefficient(
+  double              z,
+  CoeffType * const   scratch,
+  const SizeValueType dataLength) const
 {
   // See Unser, 1999, Box 2 for explanation
 
@@ -222,16 +228,16 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitial
   if (m_Tolerance > 0.0)
   {
     if (const auto horizon = static_cast<SizeValueType>(std::ceil(std::log(m_Tolerance) / std::log(std::abs(z))));
-        horizon < m_DataLength[m_IteratorDirection])
+        horizon < dataLength)
     {
       // Accelerated loop
-      CoeffType sum = m_Scratch[0]; // verify this
+      CoeffType sum = scratch[0]; // verify this
       for (SizeValueType n = 1; n < horizon; ++n)
       {
-        sum += zn * m_Scratch[n];
+        sum += zn * scratch[n];
         zn *= z;
       }
-      m_Scratch[0] = sum;
+      scratch[0] = sum;
 
       // Return early.
       return;
@@ -240,29 +246,30 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitial
 
   // Full loop
   const double iz = 1.0 / z;
-  double       z2n = std::pow(z, static_cast<double>(m_DataLength[m_IteratorDirection] - 1));
-  CoeffType    sum = m_Scratch[0] + z2n * m_Scratch[m_DataLength[m_IteratorDirection] - 1];
+  double       z2n = std::pow(z, static_cast<double>(dataLength - 1));
+  CoeffType    sum = scratch[0] + z2n * scratch[dataLength - 1];
   z2n *= z2n * iz;
-  for (SizeValueType n = 1; n <= (m_DataLength[m_IteratorDirection] - 2); ++n)
+  for (SizeValueType n = 1; n <= (dataLength - 2); ++n)
   {
-    sum += (zn + z2n) * m_Scratch[n];
+    sum += (zn + z2n) * scratch[n];
     zn *= z;
     z2n *= iz;
   }
-  m_Scratch[0] = sum / (1.0 - zn * zn);
+  scratch[0] = sum / (1.0 - zn * zn);
 }
 
 
 template <typename TInputImage, typename TOutputImage>
 void
-MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialAntiCausalCoefficient(double z)
+MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialAntiCausalCoefficient(
+  double              z,
+  CoeffType * const   scratch,
+  const SizeValueType dataLength) const
 {
   // this initialization corresponds to mirror boundaries
   /* See Unser, 1999, Box 2 for explaination */
   //  Also see erratum at http://bigwww.epfl.ch/publications/unser9902.html
-  m_Scratch[m_DataLength[m_IteratorDirection] - 1] =
-    (z / (z * z - 1.0)) *
-    (z * m_Scratch[m_DataLength[m_IteratorDirection] - 2] + m_Scratch[m_DataLength[m_IteratorDirection] - 1]);
+  scratch[dataLength - 1] = (z / (z * z - 1.0)) * (z * scratch[dataLength - 2] + scratch[dataLength - 1]);
 }
 
 
@@ -270,44 +277,94 @@ template <typename TInputImage, typename TOutputImage>
 void
 MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficientsND()
 {
+  using OutputPixelType = typename TOutputImage::PixelType;
+
   OutputImagePointer output = this->GetOutput();
 
-  Size<ImageDimension> size = output->GetBufferedRegion().GetSize();
+  const SizeValueType           numberOfPixels = output->GetBufferedRegion().GetNumberOfPixels();
+  const OffsetValueType * const offsetTable = output->GetOffsetTable();
+  OutputPixelType * const       buffer = output->GetBufferPointer();
 
-  unsigned int count = output->GetBufferedRegion().GetNumberOfPixels() / size[0] * ImageDimension;
+  SizeValueType count = 0;
+  for (unsigned int n = 0; n < ImageDimension; ++n)
+  {
+    count += numberOfPixels / m_DataLength[n];
+  }
 
-  ProgressReporter progress(this, 0, count, 10);
+  // The progress is reported per dimension, by the thread that runs this function, rather than by the work units.
+  TotalProgressReporter progress(this, count);
 
   // Initialize coeffient array
   this->CopyImageToImage(); // Coefficients are initialized to the input data
 
+  MultiThreaderBase * const multiThreader = this->GetMultiThreader();
+
   for (unsigned int n = 0; n < ImageDimension; ++n)
   {
-    m_IteratorDirection = n;
     // Loop through each dimension
 
     // Compute poles for this dimension
     this->SetPoles(n);
 
-    // Initialize iterators
-    OutputLinearIterator CIterator(output, output->GetBufferedRegion());
-    CIterator.SetDirection(m_IteratorDirection);
-    // For each data vector
-    while (!CIterator.IsAtEnd())
+    const SizeValueType   dataLength = m_DataLength[n];
+    const SizeValueType   numberOfLines = numberOfPixels / dataLength;
+    const OffsetValueType stride = offsetTable[n];
+
+    if (m_NumberOfPoles == 0)
     {
-      // Copy coefficients to scratch
-      this->CopyCoefficientsToScratch(CIterator);
-
-      // Perform 1D BSpline calculations
-      this->DataToCoefficients1D();
-
-      // Copy scratch back to coefficients.
-      // Brings us back to the end of the line we were working on.
-      CIterator.GoToBeginOfLine();
-      this->CopyScratchToCoefficients(CIterator); // m_Scratch = m_Image;
-      CIterator.NextLine();
-      progress.CompletedPixel();
+      // The coefficients are equal to the data along this dimension.
+      progress.Completed(numberOfLines);
+      continue;
     }
+
+    // The lines along this dimension are distributed over the work units, in contiguous chunks. Each chunk has its
+    // own scratch buffer.
+    const SizeValueType numberOfChunks =
+      std::min(static_cast<SizeValueType>(this->GetNumberOfWorkUnits()), numberOfLines);
+
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [this, n, buffer, offsetTable, dataLength, numberOfLines, numberOfChunks, stride](const SizeValueType chunk) {
+        const SizeValueType firstLine = numberOfLines * chunk / numberOfChunks;
+        const SizeValueType endLine = numberOfLines * (chunk + 1) / numberOfChunks;
+
+        std::vector<CoeffType> scratch(dataLength);
+
+        for (SizeValueType line = firstLine; line < endLine; ++line)
+        {
+          // The offset of the first pixel of the line, from its index along the other dimensions.
+          OffsetValueType lineOffset = 0;
+          SizeValueType   remainder = line;
+          for (unsigned int d = 0; d < ImageDimension; ++d)
+          {
+            if (d != n)
+            {
+              lineOffset += static_cast<OffsetValueType>(remainder % m_DataLength[d]) * offsetTable[d];
+              remainder /= m_DataLength[d];
+            }
+          }
+          OutputPixelType * const lineBegin = buffer + lineOffset;
+
+          // Copy coefficients to scratch
+          for (SizeValueType j = 0; j < dataLength; ++j)
+          {
+            scratch[j] = static_cast<CoeffType>(lineBegin[j * stride]);
+          }
+
+          // Perform 1D BSpline calculations
+          this->DataToCoefficients1D(scratch.data(), dataLength);
+
+          // Copy scratch back to coefficients.
+          for (SizeValueType j = 0; j < dataLength; ++j)
+          {
+            lineBegin[j * stride] = static_cast<OutputPixelType>(scratch[j]);
+          }
+        }
+      },
+      nullptr);
+
+    progress.Completed(numberOfLines);
   }
 }
 
@@ -335,43 +392,6 @@ MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::CopyImageT
 }
 
 
-/**
- * Copy the scratch to one line of the output image
- */
-template <typename TInputImage, typename TOutputImage>
-void
-MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::CopyScratchToCoefficients(
-  OutputLinearIterator & Iter)
-{
-  using OutputPixelType = typename TOutputImage::PixelType;
-  unsigned long j = 0;
-  while (!Iter.IsAtEndOfLine())
-  {
-    Iter.Set(static_cast<OutputPixelType>(m_Scratch[j]));
-    ++Iter;
-    ++j;
-  }
-}
-
-
-/**
- * Copy one line of the output image to the scratch
- */
-template <typename TInputImage, typename TOutputImage>
-void
-MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::CopyCoefficientsToScratch(
-  OutputLinearIterator & Iter)
-{
-  unsigned long j = 0;
-  while (!Iter.IsAtEndOfLine())
-  {
-    m_Scratch[j] = static_cast<CoeffType>(Iter.Get());
-    ++Iter;
-    ++j;
-  }
-}
-
-
 /**
  * GenerateInputRequestedRegion method.
  */
@@ -415,30 +435,16 @@ void
 MultiOrderBSplineDecompositionImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
 
-  // Allocate scratch memory
   InputImageConstPointer inputPtr = this->GetInput();
   m_DataLength = inputPtr->GetBufferedRegion().GetSize();
 
-  unsigned long maxLength = 0;
-  for (unsigned int n = 0; n < ImageDimension; ++n)
-  {
-    if (m_DataLength[n] > maxLength)
-    {
-      maxLength = m_DataLength[n];
-    }
-  }
-  m_Scratch.resize(maxLength);
-
   // Allocate memory for output image
   OutputImagePointer outputPtr = this->GetOutput();
   outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
   outputPtr->Allocate();
 
-  // Calculate actual output
+  // Calculate actual output. The scratch memory is allocated per chunk of lines.
   this->DataToCoefficientsND();
-
-  // Clean up
-  m_Scratch.clear();
 }
 
 
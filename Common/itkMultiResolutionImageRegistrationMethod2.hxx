@@ -250,6 +250,14 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::PreparePyram
 
     m_FixedImageRegionPyramid[level].SetSize(size);
     m_FixedImageRegionPyramid[level].SetIndex(start);
+
+    /** The pyramid may restrict its output to a region of interest, in which case the region
+     * of the fixed image at this level is cropped accordingly. */
+    FixedImageRegionType croppedRegion = m_FixedImageRegionPyramid[level];
+    if (croppedRegion.Crop(fixedImageAtLevel->GetLargestPossibleRegion()))
+    {
+      m_FixedImageRegionPyramid[level] = croppedRegion;
+    }
   }
 
 } // end PreparePyramids()
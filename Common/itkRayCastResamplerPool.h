@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRayCastResamplerPool_h
+#define itkRayCastResamplerPool_h
+
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include <itkMultiThreaderBase.h>
+#include <itkResampleImageFilter.h>
+
+#include <vector>
+
+namespace itk
+{
+/** \class RayCastResamplerPool
+ * \brief A number of independent copies of a ray cast resampling pipeline, which project the moving image for
+ * different transform parameters concurrently.
+ *
+ * Each copy has its own transform, ray cast interpolator and resample filter, so that the copies can be updated
+ * concurrently, for example to compute the perturbed values of a finite difference derivative. The filters of a copy
+ * use a single work unit, as the parallelism is over the copies. The copies are kept between the updates, so that
+ * their output buffers are reused, rather than reallocated.
+ *
+ * The transform of the ray cast interpolator is copied by copying the current transform of each (nested)
+ * AdvancedCombinationTransform, while sharing its initial transform, which is not changed by setting the parameters.
+ *
+ * \ingroup ImageFunctions
+ */
+
+template <typename TMovingImage, typename TOutputImage, typename TCoordinate = double>
+class RayCastResamplerPool
+{
+public:
+  using RayCastInterpolatorType = AdvancedRayCastInterpolateImageFunction<TMovingImage, TCoordinate>;
+  using TransformType = typename RayCastInterpolatorType::TransformType;
+  using TransformPointer = typename TransformType::Pointer;
+  using ParametersType = typename TransformType::ParametersType;
+  using ResamplerType = ResampleImageFilter<TMovingImage, TOutputImage, TCoordinate>;
+  using OutputImageBaseType = ImageBase<TOutputImage::ImageDimension>;
+
+  /** Creates the specified number of copies of the pipeline that resamples the moving image by the specified ray cast
+   * interpolator onto the grid of the specified output image. Returns false, leaving the pool empty, when the
+   * transform of the interpolator cannot be copied.
+   */
+  bool
+  Initialize(RayCastInterpolatorType &   rayCaster,
+             const TMovingImage &        movingImage,
+             const OutputImageBaseType & outputGrid,
+             const unsigned int          numberOfCopies)
+  {
+    this->Clear();
+
+    TransformType * const transform = rayCaster.GetModifiableTransform();
+    if (transform == nullptr)
+    {
+      return false;
+    }
+
+    // The copies are not moved after this, because some transforms keep a pointer to their parameters.
+    m_Copies.resize(numberOfCopies);
+
+    for (Copy & copy : m_Copies)
+    {
+      try
+      {
+        copy.transform = CopyTransform(*transform);
+      }
+      catch (const ExceptionObject &)
+      {
+        copy.transform = nullptr;
+      }
+
+      if (copy.transform == nullptr)
+      {
+        this->Clear();
+        return false;
+      }
+      copy.parameters = transform->GetParameters();
+      copy.transform->SetParameters(copy.parameters);
+
+      // Check that the copy maps the focal point like the original transform.
+      if (copy.transform->TransformPoint(rayCaster.GetFocalPoint()) !=
+          transform->TransformPoint(rayCaster.GetFocalPoint()))
+      {
+        this->Clear();
+        return false;
+      }
+
+      copy.rayCaster = RayCastInterpolatorType::New();
+      copy.rayCaster->SetTransform(copy.transform);
+      copy.rayCaster->SetInterpolator(rayCaster.GetModifiableInterpolator());
+      copy.rayCaster->SetFocalPoint(rayCaster.GetFocalPoint());
+      copy.rayCaster->SetThreshold(rayCaster.GetThreshold());
+      copy.rayCaster->SetUseEmptySpaceSkipping(rayCaster.GetUseEmptySpaceSkipping());
+      copy.rayCaster->SetInputImage(&movingImage);
+
+      copy.resampler = ResamplerType::New();
+      copy.resampler->SetTransform(copy.transform);
+      copy.resampler->SetInterpolator(copy.rayCaster);
+      copy.resampler->SetInput(&movingImage);
+      copy.resampler->SetDefaultPixelValue(0);
+      copy.resampler->SetSize(outputGrid.GetLargestPossibleRegion().GetSize());
+      copy.resampler->SetOutputStartIndex(outputGrid.GetLargestPossibleRegion().GetIndex());
+      copy.resampler->SetOutputOrigin(outputGrid.GetOrigin());
+      copy.resampler->SetOutputSpacing(outputGrid.GetSpacing());
+      copy.resampler->SetOutputDirection(outputGrid.GetDirection());
+      copy.resampler->SetNumberOfWorkUnits(1);
+    }
+    return true;
+  }
+
+
+  /** Removes all copies. */
+  void
+  Clear()
+  {
+    m_Copies.clear();
+  }
+
+
+  unsigned int
+  GetNumberOfCopies() const
+  {
+    return static_cast<unsigned int>(m_Copies.size());
+  }
+
+
+  /** The output of the specified copy, to be connected to the filters that process the projection. */
+  TOutputImage *
+  GetOutput(const unsigned int copyIndex) const
+  {
+    return m_Copies[copyIndex].resampler->GetOutput();
+  }
+
+
+  /** Sets the transform parameters of the specified copy. Its output is updated by the next update of its output or
+   * of a downstream filter. Different copies may be used concurrently.
+   */
+  void
+  SetParameters(const unsigned int copyIndex, const ParametersType & parameters)
+  {
+    Copy & copy = m_Copies[copyIndex];
+
+    copy.parameters = parameters;
+    copy.transform->SetParameters(copy.parameters);
+    copy.resampler->Modified();
+  }
+
+
+  /** Calls evaluate(copyIndex, evaluationIndex) for each evaluation index in [0, numberOfEvaluations). The
+   * evaluations are distributed over the copies, which run concurrently, each one evaluating its share in order.
+   */
+  template <typename TEvaluate>
+  void
+  EvaluateConcurrently(MultiThreaderBase & threader, const SizeValueType numberOfEvaluations, TEvaluate && evaluate)
+  {
+    const SizeValueType numberOfCopies = m_Copies.size();
+
+    threader.ParallelizeArray(
+      0,
+      numberOfCopies,
+      [numberOfCopies, numberOfEvaluations, &evaluate](const SizeValueType copyIndex) {
+        for (SizeValueType evaluationIndex = copyIndex; evaluationIndex < numberOfEvaluations;
+             evaluationIndex += numberOfCopies)
+        {
+          evaluate(static_cast<unsigned int>(copyIndex), evaluationIndex);
+        }
+      },
+      nullptr);
+  }
+
+private:
+  struct Copy
+  {
+    ParametersType                            parameters{};
+    TransformPointer                          transform{};
+    typename RayCastInterpolatorType::Pointer rayCaster{};
+    typename ResamplerType::Pointer           resampler{};
+  };
+
+  /** Returns a copy of the transform whose parameters can be set independently, or null when it cannot be copied. */
+  template <typename TTransform>
+  static typename TTransform::Pointer
+  CopyTransform(TTransform & transform)
+  {
+    using CombinationTransformType = AdvancedCombinationTransform<TCoordinate, TMovingImage::ImageDimension>;
+    using CurrentTransformType = typename CombinationTransformType::CurrentTransformType;
+
+    if (auto * const combination = dynamic_cast<CombinationTransformType *>(&transform))
+    {
+      CurrentTransformType * const currentTransform = combination->GetModifiableCurrentTransform();
+      if (currentTransform == nullptr)
+      {
+        return nullptr;
+      }
+      const auto currentTransformCopy = CopyTransform(*currentTransform);
+      if (currentTransformCopy == nullptr)
+      {
+        return nullptr;
+      }
+
+      const auto combinationCopy = CombinationTransformType::New();
+      combinationCopy->SetUseAddition(combination->GetUseAddition());
+      combinationCopy->SetUseComposition(combination->GetUseComposition());
+      combinationCopy->SetInitialTransform(combination->GetModifiableInitialTransform());
+      combinationCopy->SetCurrentTransform(currentTransformCopy);
+      return combinationCopy.GetPointer();
+    }
+
+    // Other transforms are cloned, which copies their fixed parameters and their parameters.
+    const auto clone = transform.Clone();
+    return dynamic_cast<TTransform *>(clone.GetPointer());
+  }
+
+  std::vector<Copy> m_Copies{};
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkRayCastResamplerPool_h
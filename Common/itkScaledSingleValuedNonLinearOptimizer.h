@@ -118,6 +118,13 @@ public:
   const ParametersType &
   GetCurrentPosition() const override;
 
+  /** Set the profiler that measures the evaluations of the scaled cost function. */
+  void
+  SetProfiler(elastix::Profiler * const profiler)
+  {
+    m_ScaledCostFunction->SetProfiler(profiler);
+  }
+
   /** Get a pointer to the scaled cost function. */
   itkGetConstObjectMacro(ScaledCostFunction, ScaledCostFunctionType);
 
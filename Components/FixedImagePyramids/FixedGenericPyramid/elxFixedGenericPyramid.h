@@ -56,6 +56,17 @@ namespace elastix
  *    at once, or per resolution. Latter saves memory.\n
  *    example: <tt>(ComputePyramidImagesPerResolution "true")</tt>\n
  *    Default false.
+ * \parameter ComputePyramidImagesInMaskBoundingBox: Flag to specify if the pyramid images are only
+ *    computed within the bounding box of the fixed mask. Latter saves time and memory when the
+ *    mask only covers a small part of the image. Requires exactly one fixed mask.\n
+ *    example: <tt>(ComputePyramidImagesInMaskBoundingBox "true")</tt>\n
+ *    Default false.
+ * \parameter ComputePyramidImagesCascaded: Flag to specify if the pyramid images are computed in
+ *    a cascade, from fine to coarse, each level from the next finer level. Latter saves time for
+ *    large images, and closely approximates the default result. Only used when all resolution
+ *    levels are computed at once.\n
+ *    example: <tt>(ComputePyramidImagesCascaded "true")</tt>\n
+ *    Default false.
  * \parameter ImagePyramidUseShrinkImageFilter: Flag to specify if the ShrinkingImageFilter is used
  *    for rescaling the image, or the ResampleImageFilter. Skrinker is faster.\n
  *    example: <tt>(ImagePyramidUseShrinkImageFilter "true")</tt>\n
@@ -106,6 +117,7 @@ public:
   using typename Superclass1::ScheduleType;
   using typename Superclass1::RescaleScheduleType;
   using typename Superclass1::SmoothingScheduleType;
+  using typename Superclass1::PointType;
 
   /** Typedefs inherited from Elastix. */
   using typename Superclass2::ElastixType;
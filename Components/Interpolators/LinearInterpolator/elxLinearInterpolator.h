@@ -36,6 +36,11 @@ namespace elastix
  * The parameters used in this class are:
  * \parameter Interpolator: Select this interpolator as follows:\n
  *    <tt>(Interpolator "LinearInterpolator")</tt>
+ * \parameter UseBrickedLayout: Whether to interpolate from a bricked copy of the
+ *    moving image, which is more cache friendly for large (3D) images, at the cost
+ *    of about 1.4 times the memory of the moving image. \n
+ *    example: <tt>(UseBrickedLayout "true" "false" "false")</tt> \n
+ *    The default is "false" for each resolution.
  *
  * \ingroup Interpolators
  */
@@ -84,6 +89,12 @@ public:
   using typename Superclass2::RegistrationType;
   using ITKBaseType = typename Superclass2::ITKBaseType;
 
+  /** Execute stuff before each new pyramid resolution:
+   * \li Set whether to use a bricked copy of the moving image.
+   */
+  void
+  BeforeEachResolution() override;
+
 protected:
   /** The constructor. */
   LinearInterpolator() = default;
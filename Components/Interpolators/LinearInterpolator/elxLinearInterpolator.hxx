@@ -24,7 +24,24 @@
 namespace elastix
 {
 
-/** Nothing */
+/**
+ * ***************** BeforeEachResolution ***********************
+ */
+
+template <typename TElastix>
+void
+LinearInterpolator<TElastix>::BeforeEachResolution()
+{
+  /** Get the current resolution level. */
+  const unsigned int level = (this->m_Registration->GetAsITKBaseType())->GetCurrentLevel();
+
+  /** Read from the parameter file whether to use the bricked layout. */
+  bool useBrickedLayout = false;
+  this->GetConfiguration()->ReadParameter(
+    useBrickedLayout, "UseBrickedLayout", this->GetComponentLabel(), level, 0, false);
+  this->SetUseBrickedLayout(useBrickedLayout);
+
+} // end BeforeEachResolution()
 
 } // end namespace elastix
 
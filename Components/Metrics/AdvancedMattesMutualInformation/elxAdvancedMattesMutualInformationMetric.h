@@ -79,6 +79,13 @@ namespace elastix
  *    The default value is 0.01. Can be given for each resolution, or for
  *    all resolutions at once.
  * \parameter FiniteDifferenceDerivative: Experimental feature, do not use.
+ * \parameter FiniteDifferenceDerivativeMaximumMemory: The maximum amount of memory, in megabytes,
+ *    used by the finite difference derivative. The transform parameters are then processed in
+ *    blocks that fit within this budget, which requires an additional pass over the samples per
+ *    block. Only used when FiniteDifferenceDerivative is "true".\n
+ *    example: <tt>(FiniteDifferenceDerivativeMaximumMemory 512)</tt> \n
+ *    The default value is 0, meaning no limit. Can be given for each resolution, or for all
+ *    resolutions at once.
  * \parameter UseFastAndLowMemoryVersion: Switch between a version of
  *    mutual information that explicitely computes the derivatives of the
  *    joint histogram to each transformation parameter (false) and a
@@ -127,6 +127,12 @@ AdvancedMattesMutualInformationMetric<TElastix>::BeforeEachResolution()
   configuration.ReadParameter(useFiniteDifferenceDerivative, "FiniteDifferenceDerivative", componentLabel, level, 0);
   this->SetUseFiniteDifferenceDerivative(useFiniteDifferenceDerivative);
 
+  /** Set the memory budget of the finite difference derivative. */
+  itk::SizeValueType finiteDifferenceDerivativeMaximumMemory = 0;
+  configuration.ReadParameter(
+    finiteDifferenceDerivativeMaximumMemory, "FiniteDifferenceDerivativeMaximumMemory", componentLabel, level, 0);
+  this->SetFiniteDifferenceDerivativeMaximumMemory(finiteDifferenceDerivativeMaximumMemory);
+
   /** Prepare for computing the perturbation gain c_k. */
   this->SetCurrentIteration(0);
   if (useFiniteDifferenceDerivative)
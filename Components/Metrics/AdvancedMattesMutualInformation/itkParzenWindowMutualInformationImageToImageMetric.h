@@ -137,6 +137,12 @@ public:
   /** The moving image dimension. */
   itkStaticConstMacro(MovingImageDimension, unsigned int, MovingImageType::ImageDimension);
 
+  /** Initialize the Metric. Enables the sparse accumulation of the per-thread derivatives for the low memory
+   * variant without Jacobian preconditioning, and calls the superclass' implementation.
+   */
+  void
+  Initialize() override;
+
   /**  Get the value. */
   MeasureType
   GetValue(const ParametersType & parameters) const override;
@@ -178,6 +184,7 @@ protected:
   using typename Superclass::ParzenValueContainerType;
   using typename Superclass::KernelFunctionType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::FiniteDifferenceParameterBlockType;
 
   /**  Get the value and analytic derivative.
    * Called by GetValueAndDerivative if UseFiniteDifferenceDerivative == false.
@@ -215,6 +222,11 @@ protected:
                                         MeasureType &          value,
                                         DerivativeType &       derivative) const override;
 
+  /** Compute the finite difference derivative entries of one parameter block. */
+  void
+  UpdateFiniteDifferenceDerivative(const FiniteDifferenceParameterBlockType & block,
+                                   DerivativeType &                           derivative) const override;
+
   /** Compute terms to implement preconditioning as proposed by Tustison et al. */
   virtual void
   ComputeJacobianPreconditioner(const TransformJacobianType &      jac,
@@ -265,13 +277,10 @@ private:
   void
   ComputeDerivativeLowMemory(DerivativeType & derivative) const;
 
-  /** Helper function to update the derivative for the low memory variant. */
-  void
-  UpdateDerivativeLowMemory(const RealType                     fixedImageValue,
-                            const RealType                     movingImageValue,
-                            const DerivativeType &             imageJacobian,
-                            const NonZeroJacobianIndicesType & nzji,
-                            DerivativeType &                   derivative) const;
+  /** Helper function for the low memory variant, that computes the factor by which the image Jacobian of a sample
+   * contributes to the derivative. */
+  PDFValueType
+  ComputeDerivativeLowMemoryFactor(const RealType fixedImageValue, const RealType movingImageValue) const;
 
   /** Helper function to compute m_PRatioArray in case of low memory consumption. */
   void
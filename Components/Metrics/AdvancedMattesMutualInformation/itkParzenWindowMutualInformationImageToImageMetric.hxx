@@ -45,6 +45,27 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage,
 } // end constructor
 
 
+/**
+ * ********************* Initialize ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
+{
+  /** The low memory variant adds a scaled image Jacobian per sample to the derivative of each thread, which may be
+   * accumulated sparsely. Jacobian preconditioning rescales the whole derivative of each thread afterwards, so it
+   * needs the dense per-thread derivatives. This must be known before the threading parameters are initialized.
+   */
+  this->m_SupportsSparseDerivativeAccumulation =
+    !this->GetUseExplicitPDFDerivatives() && !this->m_UseJacobianPreconditioning;
+
+  /** Call the superclass implementation. */
+  this->Superclass::Initialize();
+
+} // end Initialize()
+
+
 /**
  * ********************* InitializeHistograms ******************************
  */
@@ -353,8 +374,9 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Comp
         }
       }
 
-      /** Compute this sample's contribution to the joint distributions. */
-      this->UpdateDerivativeLowMemory(fixedImageValue, movingImageValue, imageJacobian, nzji, derivative);
+      /** Compute this sample's contribution to the derivative. */
+      Superclass::AccumulateDerivativeTerms(
+        this->ComputeDerivativeLowMemoryFactor(fixedImageValue, movingImageValue), imageJacobian, nzji, derivative);
 
     } // end sampleOk
   } // end loop over sample container
@@ -422,6 +444,8 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
    * The initialization is performed at the beginning of each resolution in
    * InitializeThreadingParameters(), and at the end of each iteration in
    * AfterThreadedGetValueAndDerivative() and the accumulate functions.
+   * It is only used directly for Jacobian preconditioning, which disables
+   * sparse derivative accumulation.
    */
   DerivativeType & derivative = Superclass::m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
 
@@ -514,8 +538,9 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
         }
       }
 
-      /** Compute this sample's contribution to the joint distributions. */
-      this->UpdateDerivativeLowMemory(fixedImageValue, movingImageValue, imageJacobian, nzji, derivative);
+      /** Compute this sample's contribution to the derivative of this thread. */
+      this->UpdateThreadDerivative(
+        threadId, this->ComputeDerivativeLowMemoryFactor(fixedImageValue, movingImageValue), imageJacobian, nzji);
 
     } // end sampleOk
   } // end loop over sample container
@@ -595,6 +620,12 @@ void
 ParzenWindowMutualInformationImageToImageMetric<TFixedImage,
                                                 TMovingImage>::LaunchComputeDerivativeLowMemoryThreaderCallback() const
 {
+  /** Make the derivative blocks of the previous iteration available again. */
+  if (this->GetUseSparseDerivativeAccumulationInternally())
+  {
+    this->RecycleDerivativeBlocks();
+  }
+
   /** Setup threader and launch. */
   this->m_Threader->SetSingleMethodAndExecute(
     this->ComputeDerivativeLowMemoryThreaderCallback,
@@ -679,17 +710,14 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Comp
 
 
 /**
- * ******************* UpdateDerivativeLowMemory *******************
+ * ******************* ComputeDerivativeLowMemoryFactor *******************
  */
 
 template <typename TFixedImage, typename TMovingImage>
-void
-ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::UpdateDerivativeLowMemory(
-  const RealType                     fixedImageValue,
-  const RealType                     movingImageValue,
-  const DerivativeType &             imageJacobian,
-  const NonZeroJacobianIndicesType & nzji,
-  DerivativeType &                   derivative) const
+auto
+ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::ComputeDerivativeLowMemoryFactor(
+  const RealType fixedImageValue,
+  const RealType movingImageValue) const -> PDFValueType
 {
   /** In this function we need to do (see eq. 24 of Thevenaz [3]):
    *      derivative -= constant * imageJacobian *
@@ -700,7 +728,8 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Upda
    *
    * Note (1) that we only have to loop over i,k within the support
    * of the B-spline Parzen-window.
-   * Note (2) that imageJacobian may be sparse.
+   * Note (2) that this function only computes the sum: the caller adds
+   * the (possibly sparse) imageJacobian times this sum to the derivative.
    */
 
   /** Determine the affected region. */
@@ -751,28 +780,9 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Upda
     }
   }
 
-  const auto numberOfParameters = this->GetNumberOfParameters();
+  return sum;
 
-  /** Now compute derivative -= sum * imageJacobian. */
-  if (nzji.size() == numberOfParameters)
-  {
-    /** Loop over all Jacobians. */
-    for (unsigned int mu = 0; mu < numberOfParameters; ++mu)
-    {
-      derivative[mu] += static_cast<DerivativeValueType>(imageJacobian[mu] * sum);
-    }
-  }
-  else
-  {
-    /** Loop only over the non-zero Jacobians. */
-    for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
-    {
-      const unsigned int mu = nzji[i];
-      derivative[mu] += static_cast<DerivativeValueType>(imageJacobian[i] * sum);
-    }
-  }
-
-} // end UpdateDerivativeLowMemory()
+} // end ComputeDerivativeLowMemoryFactor()
 
 
 /**
@@ -791,23 +801,73 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
   derivative.set_size(this->GetNumberOfParameters());
   derivative.Fill(0.0);
 
-  /** Construct the JointPDF, JointPDFDerivatives, Alpha and its derivatives. */
-  this->ComputePDFsAndIncrementalPDFs(parameters);
+  /** Construct the JointPDF and Alpha. */
+  this->ComputePDFs(parameters);
 
   /** Compute the fixed and moving marginal pdf by summing over the histogram. */
   this->ComputeMarginalPDF(this->m_JointPDF, this->m_FixedImageMarginalPDF, 0);
   this->ComputeMarginalPDF(this->m_JointPDF, this->m_MovingImageMarginalPDF, 1);
 
-  /** Compute the fixed and moving incremental marginal pdfs by summing over the
-   * incremental histogram. Do it for Right and Left.
-   */
-  this->ComputeIncrementalMarginalPDFs(this->m_IncrementalJointPDFRight,
-                                       this->m_FixedIncrementalMarginalPDFRight,
-                                       this->m_MovingIncrementalMarginalPDFRight);
-  this->ComputeIncrementalMarginalPDFs(
-    this->m_IncrementalJointPDFLeft, this->m_FixedIncrementalMarginalPDFLeft, this->m_MovingIncrementalMarginalPDFLeft);
+  /** Compute the metric by double summation over histogram. */
 
-  /** Compute the metric and derivatives by double summation over histogram. */
+  /** Setup iterators */
+  using JointPDFIteratorType = ImageLinearConstIteratorWithIndex<JointPDFType>;
+  using MarginalPDFIteratorType = typename MarginalPDFType::const_iterator;
+
+  JointPDFIteratorType jointPDFit(this->m_JointPDF, this->m_JointPDF->GetLargestPossibleRegion());
+
+  MarginalPDFIteratorType       fixedPDFit = this->m_FixedImageMarginalPDF.begin();
+  const MarginalPDFIteratorType fixedPDFend = this->m_FixedImageMarginalPDF.end();
+  MarginalPDFIteratorType       movingPDFit = this->m_MovingImageMarginalPDF.begin();
+  const MarginalPDFIteratorType movingPDFend = this->m_MovingImageMarginalPDF.end();
+
+  double MI = 0.0;
+  while (fixedPDFit != fixedPDFend)
+  {
+    const double fixedPDFValue = *fixedPDFit;
+
+    while (movingPDFit != movingPDFend)
+    {
+      const double movingPDFValue = *movingPDFit;
+      const double jointPDFValue = jointPDFit.Get();
+      const double fixPDFmovPDFAlpha = fixedPDFValue * movingPDFValue * this->m_Alpha;
+
+      /** Check for non-zero bin contribution and update the mutual information value. */
+      if (jointPDFValue > 1e-16 && fixPDFmovPDFAlpha > 1e-16)
+      {
+        MI += this->m_Alpha * jointPDFValue * std::log(jointPDFValue / fixPDFmovPDFAlpha);
+      }
+
+      ++jointPDFit;  // next moving bin
+      ++movingPDFit; // next moving bin
+
+    } // end while-loop over moving index
+
+    jointPDFit.NextLine();                                // next fixed bin
+    ++fixedPDFit;                                         // next fixed bin
+    movingPDFit = this->m_MovingImageMarginalPDF.begin(); // first moving bin
+
+  } // end while-loop over fixed index
+
+  value = static_cast<MeasureType>(-1.0 * MI);
+
+  /** Compute the derivative, per block of parameters. */
+  this->ComputeFiniteDifferenceDerivative(derivative);
+
+} // end GetValueAndFiniteDifferenceDerivative
+
+
+/**
+ * ******************** UpdateFiniteDifferenceDerivative *******************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::UpdateFiniteDifferenceDerivative(
+  const FiniteDifferenceParameterBlockType & block,
+  DerivativeType &                           derivative) const
+{
+  /** Compute the derivatives by double summation over histogram. */
 
   /** Setup iterators */
   using JointPDFIteratorType = ImageLinearConstIteratorWithIndex<JointPDFType>;
@@ -819,10 +879,10 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
 
   JointPDFIteratorType jointPDFit(this->m_JointPDF, this->m_JointPDF->GetLargestPossibleRegion());
 
-  IncrementalJointPDFIteratorType jointIncPDFRightit(this->m_IncrementalJointPDFRight,
-                                                     this->m_IncrementalJointPDFRight->GetLargestPossibleRegion());
-  IncrementalJointPDFIteratorType jointIncPDFLeftit(this->m_IncrementalJointPDFLeft,
-                                                    this->m_IncrementalJointPDFLeft->GetLargestPossibleRegion());
+  IncrementalJointPDFIteratorType jointIncPDFRightit(block.st_IncrementalJointPDFRight,
+                                                     block.st_IncrementalJointPDFRight->GetLargestPossibleRegion());
+  IncrementalJointPDFIteratorType jointIncPDFLeftit(block.st_IncrementalJointPDFLeft,
+                                                    block.st_IncrementalJointPDFLeft->GetLargestPossibleRegion());
 
   MarginalPDFIteratorType       fixedPDFit = this->m_FixedImageMarginalPDF.begin();
   const MarginalPDFIteratorType fixedPDFend = this->m_FixedImageMarginalPDF.end();
@@ -830,24 +890,26 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
   const MarginalPDFIteratorType movingPDFend = this->m_MovingImageMarginalPDF.end();
 
   IncrementalMarginalPDFIteratorType fixedIncPDFRightit(
-    this->m_FixedIncrementalMarginalPDFRight, this->m_FixedIncrementalMarginalPDFRight->GetLargestPossibleRegion());
+    block.st_FixedIncrementalMarginalPDFRight, block.st_FixedIncrementalMarginalPDFRight->GetLargestPossibleRegion());
   IncrementalMarginalPDFIteratorType movingIncPDFRightit(
-    this->m_MovingIncrementalMarginalPDFRight, this->m_MovingIncrementalMarginalPDFRight->GetLargestPossibleRegion());
+    block.st_MovingIncrementalMarginalPDFRight, block.st_MovingIncrementalMarginalPDFRight->GetLargestPossibleRegion());
   IncrementalMarginalPDFIteratorType fixedIncPDFLeftit(
-    this->m_FixedIncrementalMarginalPDFLeft, this->m_FixedIncrementalMarginalPDFLeft->GetLargestPossibleRegion());
+    block.st_FixedIncrementalMarginalPDFLeft, block.st_FixedIncrementalMarginalPDFLeft->GetLargestPossibleRegion());
   IncrementalMarginalPDFIteratorType movingIncPDFLeftit(
-    this->m_MovingIncrementalMarginalPDFLeft, this->m_MovingIncrementalMarginalPDFLeft->GetLargestPossibleRegion());
+    block.st_MovingIncrementalMarginalPDFLeft, block.st_MovingIncrementalMarginalPDFLeft->GetLargestPossibleRegion());
 
-  DerivativeIteratorType       derivit = derivative.begin();
-  const DerivativeIteratorType derivbegin = derivative.begin();
-  const DerivativeIteratorType derivend = derivative.end();
+  /** The derivative entries of this block. The buffers may be larger than the
+   * block (the last one), but the rest of each line is skipped by NextLine().
+   */
+  const DerivativeIteratorType derivbegin = derivative.begin() + block.st_FirstParameter;
+  const DerivativeIteratorType derivend = derivbegin + block.st_NumberOfParameters;
+  DerivativeIteratorType       derivit = derivbegin;
 
-  DerivativeConstIteratorType       perturbedAlphaRightit = this->m_PerturbedAlphaRight.begin();
-  const DerivativeConstIteratorType perturbedAlphaRightbegin = this->m_PerturbedAlphaRight.begin();
-  DerivativeConstIteratorType       perturbedAlphaLeftit = this->m_PerturbedAlphaLeft.begin();
-  const DerivativeConstIteratorType perturbedAlphaLeftbegin = this->m_PerturbedAlphaLeft.begin();
+  DerivativeConstIteratorType       perturbedAlphaRightit = block.st_PerturbedAlphaRight.begin();
+  const DerivativeConstIteratorType perturbedAlphaRightbegin = block.st_PerturbedAlphaRight.begin();
+  DerivativeConstIteratorType       perturbedAlphaLeftit = block.st_PerturbedAlphaLeft.begin();
+  const DerivativeConstIteratorType perturbedAlphaLeftbegin = block.st_PerturbedAlphaLeft.begin();
 
-  double MI = 0.0;
   while (fixedPDFit != fixedPDFend)
   {
     const double fixedPDFValue = *fixedPDFit;
@@ -856,13 +918,6 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
     {
       const double movingPDFValue = *movingPDFit;
       const double jointPDFValue = jointPDFit.Get();
-      const double fixPDFmovPDFAlpha = fixedPDFValue * movingPDFValue * this->m_Alpha;
-
-      /** Check for non-zero bin contribution and update the mutual information value. */
-      if (jointPDFValue > 1e-16 && fixPDFmovPDFAlpha > 1e-16)
-      {
-        MI += this->m_Alpha * jointPDFValue * std::log(jointPDFValue / fixPDFmovPDFAlpha);
-      }
 
       /** Update the derivative. */
       derivit = derivbegin;
@@ -949,18 +1004,14 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
 
   } // end while-loop over fixed index
 
-  value = static_cast<MeasureType>(-1.0 * MI);
-
   /** Divide the derivative by -delta*2. */
   const double delta2 = -1.0 / (this->GetFiniteDifferencePerturbation() * 2.0);
-  derivit = derivative.begin();
-  while (derivit != derivend)
+  for (derivit = derivbegin; derivit != derivend; ++derivit)
   {
     *derivit *= delta2;
-    ++derivit;
   }
 
-} // end GetValueAndFiniteDifferenceDerivative
+} // end UpdateFiniteDifferenceDerivative()
 
 
 /**
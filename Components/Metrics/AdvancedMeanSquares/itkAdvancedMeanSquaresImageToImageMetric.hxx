@@ -20,7 +20,6 @@
 
 #include "itkAdvancedMeanSquaresImageToImageMetric.h"
 #include <vnl/algo/vnl_matrix_update.h>
-#include "itkComputeImageExtremaFilter.h"
 
 namespace itk
 {
@@ -33,6 +32,7 @@ template <typename TFixedImage, typename TMovingImage>
 AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::AdvancedMeanSquaresImageToImageMetric()
 {
   this->Superclass::SetUseImageSampler(true);
+  Superclass::m_SupportsSparseDerivativeAccumulation = true;
 }
 
 /**
@@ -49,13 +49,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
   if (this->GetUseNormalization())
   {
     /** Try to guess a normalization factor. */
-    const auto computeFixedImageExtrema = ComputeImageExtremaFilter<FixedImageType>::New();
-    computeFixedImageExtrema->SetInput(this->GetFixedImage());
-    computeFixedImageExtrema->SetImageSpatialMask(this->GetFixedImageMask());
-    computeFixedImageExtrema->Update();
-
-    Superclass::m_FixedImageTrueMax = computeFixedImageExtrema->GetMaximum();
-    Superclass::m_FixedImageTrueMin = computeFixedImageExtrema->GetMinimum();
+    this->ComputeFixedImageExtrema();
 
     Superclass::m_FixedImageMinLimit = static_cast<FixedImageLimiterOutputType>(
       Superclass::m_FixedImageTrueMin -
@@ -64,13 +58,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
       Superclass::m_FixedImageTrueMax +
       Superclass::m_FixedLimitRangeRatio * (Superclass::m_FixedImageTrueMax - Superclass::m_FixedImageTrueMin));
 
-    const auto computeMovingImageExtrema = ComputeImageExtremaFilter<MovingImageType>::New();
-    computeMovingImageExtrema->SetInput(this->GetMovingImage());
-    computeMovingImageExtrema->SetImageSpatialMask(this->GetMovingImageMask());
-    computeMovingImageExtrema->Update();
-
-    Superclass::m_MovingImageTrueMax = computeMovingImageExtrema->GetMaximum();
-    Superclass::m_MovingImageTrueMin = computeMovingImageExtrema->GetMinimum();
+    this->ComputeMovingImageExtrema();
 
     Superclass::m_MovingImageMinLimit = static_cast<MovingImageLimiterOutputType>(
       Superclass::m_MovingImageTrueMin -
@@ -540,13 +528,6 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
   NonZeroJacobianIndicesType   nzji(nnzji);
   DerivativeType               imageJacobian(nnzji);
 
-  /** Get a handle to the pre-allocated derivative for the current thread.
-   * The initialization is performed at the beginning of each resolution in
-   * InitializeThreadingParameters(), and at the end of each iteration in
-   * AfterThreadedGetValueAndDerivative() and the accumulate functions.
-   */
-  DerivativeType & derivative = Superclass::m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
-
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
   const size_t                sampleContainerSize{ sampleContainer->size() };
@@ -610,8 +591,12 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
         fixedPoint, movingImageDerivative, imageJacobian, nzji);
 #endif
 
-      /** Compute this pixel's contribution to the measure and derivatives. */
-      this->UpdateValueAndDerivativeTerms(fixedImageValue, movingImageValue, imageJacobian, nzji, measure, derivative);
+      /** Compute this pixel's contribution to the measure and derivatives. The derivative of this thread is
+       * pre-allocated by InitializeThreadingParameters(), and reset by the accumulate functions.
+       */
+      const RealType diff = movingImageValue - fixedImageValue;
+      measure += diff * diff;
+      this->UpdateThreadDerivative(threadId, diff * 2.0, imageJacobian, nzji);
 
     } // end if sampleOk
 
@@ -694,31 +679,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::UpdateValueAnd
   measure += diff * diff;
 
   /** Calculate the contributions to the derivatives with respect to each parameter. */
-  const RealType diff_2 = diff * 2.0;
-
-  const auto numberOfParameters = this->GetNumberOfParameters();
-
-  if (nzji.size() == numberOfParameters)
-  {
-    /** Loop over all Jacobians. */
-    typename DerivativeType::const_iterator imjacit = imageJacobian.begin();
-    typename DerivativeType::iterator       derivit = deriv.begin();
-    for (unsigned int mu = 0; mu < numberOfParameters; ++mu)
-    {
-      *derivit += diff_2 * *imjacit;
-      ++imjacit;
-      ++derivit;
-    }
-  }
-  else
-  {
-    /** Only pick the nonzero Jacobians. */
-    for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
-    {
-      const unsigned int index = nzji[i];
-      deriv[index] += diff_2 * imageJacobian[i];
-    }
-  }
+  Superclass::AccumulateDerivativeTerms(diff * 2.0, imageJacobian, nzji, deriv);
 } // end UpdateValueAndDerivativeTerms()
 
 
@@ -31,6 +31,12 @@ namespace elastix
  * The parameters used in this class are:
  * \parameter Metric: Select this metric as follows:\n
  *    <tt>(Metric "AdvancedNormalizedCorrelation")</tt>
+ * \parameter UseTwoPassDerivative: Whether to compute the correlation statistics and the derivative in
+ *    two separate passes over the samples. This requires only one derivative array per thread, instead of
+ *    three, which saves memory and time for transforms with many parameters (for example fine B-spline
+ *    grids), at the cost of evaluating the moving image twice. Only used when multi-threading is enabled.\n
+ *    example: <tt>(UseTwoPassDerivative "true")</tt>\n
+ *    The default is "false". Can be given for each resolution, or for all resolutions at once.
  *
  * \note The parameter "SubtractMean" is obsolete, and will be ignored. The current elastix version just has the default
  * behavior of elastix <= version 5.1.0: For this parameter, the default value was true. This means that the sample mean
@@ -34,11 +34,17 @@ AdvancedNormalizedCorrelationMetric<TElastix>::BeforeEachResolution()
 {
   const Configuration & configuration = itk::Deref(Superclass2::GetConfiguration());
 
+  /** Get the current resolution level. */
+  const unsigned int level = (this->m_Registration->GetAsITKBaseType())->GetCurrentLevel();
+
+  /** Get and set UseTwoPassDerivative. Default false. */
+  bool useTwoPassDerivative = false;
+  configuration.ReadParameter(
+    useTwoPassDerivative, "UseTwoPassDerivative", BaseComponent::GetComponentLabel(), level, 0);
+  this->SetUseTwoPassDerivative(useTwoPassDerivative);
+
   if (configuration.HasParameter("SubtractMean"))
   {
-    /** Get the current resolution level. */
-    unsigned int level = (this->m_Registration->GetAsITKBaseType())->GetCurrentLevel();
-
     /** Get and set SubtractMean. Default true. */
     bool subtractMean = true;
     configuration.ReadParameter(subtractMean, "SubtractMean", BaseComponent::GetComponentLabel(), level, 0);
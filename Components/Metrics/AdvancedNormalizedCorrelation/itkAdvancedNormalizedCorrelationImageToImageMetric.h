@@ -82,6 +82,21 @@ namespace itk
  *
  * where Af and Am are the average of f and m, respectively.
  *
+ * The derivative can be written as a single sum over the samples:
+ *
+ * \f[
+ *   \frac{\partial \mathrm{NC}}{\partial p}
+ *     = \frac{\sum_x[ ( f(x) - \mathtt{Af} - ( \mathtt{sfm} / \mathtt{smm} ) * ( m(x+u(x,p)) - \mathtt{Am} ) )
+ *     * \mathtt{differential} ]}{\sqrt{\mathtt{sff} * \mathtt{smm}}},
+ * \f]
+ *
+ * with sff, smm and sfm after subtraction of the means. When UseTwoPassDerivative is true, the
+ * multi-threaded GetValueAndDerivative first computes these statistics in a pass over the samples,
+ * and then computes the derivative in a second pass, scattering each sample's contribution
+ * into a single derivative array per thread, instead of three. This reduces memory use and
+ * memory traffic for transforms with many parameters, at the cost of evaluating the moving image
+ * twice per sample.
+ *
  *
  * \ingroup RegistrationMetrics
  * \ingroup Metrics
@@ -172,6 +187,13 @@ public:
                         MeasureType &          value,
                         DerivativeType &       derivative) const override;
 
+  /** Set/get whether the multi-threaded GetValueAndDerivative computes the statistics and the
+   * derivative in two separate passes over the samples. Default: false.
+   * This option should be set before calling Initialize().
+   */
+  itkSetMacro(UseTwoPassDerivative, bool);
+  itkGetConstMacro(UseTwoPassDerivative, bool);
+
 protected:
   AdvancedNormalizedCorrelationImageToImageMetric();
   ~AdvancedNormalizedCorrelationImageToImageMetric() override = default;
@@ -222,6 +244,27 @@ protected:
   static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
   AccumulateDerivativesThreaderCallback(void * arg);
 
+  /** Get value and derivatives, using two passes over the samples;
+   * Called by GetValueAndDerivative() if UseTwoPassDerivative is true.
+   */
+  void
+  GetValueAndDerivativeTwoPass(MeasureType & value, DerivativeType & derivative) const;
+
+  /** Compute the statistics sff, smm, sfm, sf and sm for each thread (first pass). */
+  void
+  ThreadedComputeStatistics(ThreadIdType threadId) const;
+
+  /** Compute the derivative for each thread (second pass). */
+  void
+  ThreadedComputeDerivative(ThreadIdType threadId) const;
+
+  /** ComputeStatistics and ComputeDerivative threader callback functions */
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  ComputeStatisticsThreaderCallback(void * arg);
+
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  ComputeDerivativeThreaderCallback(void * arg);
+
 private:
   using AccumulateType = typename NumericTraits<MeasureType>::AccumulateType;
 
@@ -259,6 +302,11 @@ private:
                     AlignedCorrelationGetValueAndDerivativePerThreadStruct);
   mutable std::vector<AlignedCorrelationGetValueAndDerivativePerThreadStruct>
     m_CorrelationGetValueAndDerivativePerThreadVariables;
+
+  /** The coefficients of the second pass, computed from the statistics of the first pass. */
+  mutable MultiThreaderAccumulateDerivativeType m_TwoPassCoefficients{};
+
+  bool m_UseTwoPassDerivative{ false };
 };
 
 } // end namespace itk
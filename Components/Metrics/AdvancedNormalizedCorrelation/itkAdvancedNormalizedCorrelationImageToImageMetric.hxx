@@ -61,8 +61,9 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Init
   /** Only resize the array of structs when needed. */
   m_CorrelationGetValueAndDerivativePerThreadVariables.resize(numberOfThreads);
 
-  /** Some initialization. */
+  /** Some initialization. The two-pass derivative only uses st_DerivativeF. */
   const auto numberOfParameters = this->GetNumberOfParameters();
+  const auto numberOfOtherParameters = this->m_UseTwoPassDerivative ? 0 : numberOfParameters;
   for (auto & perThreadVariable : m_CorrelationGetValueAndDerivativePerThreadVariables)
   {
     perThreadVariable.st_NumberOfPixelsCounted = SizeValueType{};
@@ -72,8 +73,8 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Init
     perThreadVariable.st_Sf = 0.0;
     perThreadVariable.st_Sm = 0.0;
     perThreadVariable.st_DerivativeF.SetSize(numberOfParameters);
-    perThreadVariable.st_DerivativeM.SetSize(numberOfParameters);
-    perThreadVariable.st_Differential.SetSize(this->GetNumberOfParameters());
+    perThreadVariable.st_DerivativeM.SetSize(numberOfOtherParameters);
+    perThreadVariable.st_Differential.SetSize(numberOfOtherParameters);
     perThreadVariable.st_DerivativeF.Fill(0.0);
     perThreadVariable.st_DerivativeM.Fill(0.0);
     perThreadVariable.st_Differential.Fill(0.0);
@@ -442,6 +443,11 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::GetV
    */
   this->BeforeThreadedGetValueAndDerivative(parameters);
 
+  if (this->m_UseTwoPassDerivative)
+  {
+    return this->GetValueAndDerivativeTwoPass(value, derivative);
+  }
+
   /** launch multithreading metric */
   this->LaunchGetValueAndDerivativeThreaderCallback();
 
@@ -682,6 +688,24 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Accu
   const unsigned int jmin = threadId * subSize;
   const unsigned int jmax = std::min((threadId + 1) * subSize, numPar);
 
+  if (metric.m_UseTwoPassDerivative)
+  {
+    /** The per-thread derivatives are already complete, they only need to be summed. */
+    for (unsigned int j = jmin; j < jmax; ++j)
+    {
+      DerivativeValueType derivative{};
+      for (ThreadIdType i = 0; i < nrOfThreads; ++i)
+      {
+        derivative += metric.m_CorrelationGetValueAndDerivativePerThreadVariables[i].st_DerivativeF[j];
+
+        /** Reset this variable for the next iteration. */
+        metric.m_CorrelationGetValueAndDerivativePerThreadVariables[i].st_DerivativeF[j] = 0.0;
+      }
+      userData.st_DerivativePointer[j] = derivative;
+    }
+    return ITK_THREAD_RETURN_DEFAULT_VALUE;
+  }
+
   for (unsigned int j = jmin; j < jmax; ++j)
   {
     DerivativeValueType derivativeF{};
@@ -711,6 +735,296 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Accu
 } // end AccumulateDerivativesThreaderCallback()
 
 
+/**
+ * ******************* GetValueAndDerivativeTwoPass *******************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDerivativeTwoPass(
+  MeasureType &    value,
+  DerivativeType & derivative) const
+{
+  MultiThreaderAccumulateDerivativeType & userData = this->m_TwoPassCoefficients;
+  userData.st_Metric = const_cast<Self *>(this);
+
+  /** First pass: compute the statistics. */
+  this->m_Threader->SetSingleMethodAndExecute(ComputeStatisticsThreaderCallback, &userData);
+
+  const ThreadIdType numberOfThreads = Self::GetNumberOfWorkUnits();
+
+  /** Accumulate the number of pixels and the statistics. */
+  Superclass::m_NumberOfPixelsCounted = 0;
+  AccumulateType sff{};
+  AccumulateType smm{};
+  AccumulateType sfm{};
+  AccumulateType sf{};
+  AccumulateType sm{};
+  for (ThreadIdType i = 0; i < numberOfThreads; ++i)
+  {
+    const auto & perThreadVariable = this->m_CorrelationGetValueAndDerivativePerThreadVariables[i];
+    Superclass::m_NumberOfPixelsCounted += perThreadVariable.st_NumberOfPixelsCounted;
+    sff += perThreadVariable.st_Sff;
+    smm += perThreadVariable.st_Smm;
+    sfm += perThreadVariable.st_Sfm;
+    sf += perThreadVariable.st_Sf;
+    sm += perThreadVariable.st_Sm;
+  }
+
+  /** Check if enough samples were valid. */
+  this->CheckNumberOfSamples();
+
+  /** Subtract things from sff, smm and sfm. */
+  const auto N = static_cast<RealType>(Superclass::m_NumberOfPixelsCounted);
+  sff -= (sf * sf / N);
+  smm -= (sm * sm / N);
+  sfm -= (sf * sm / N);
+
+  /** The denominator of the value and the derivative. */
+  const RealType denom = -1.0 * std::sqrt(sff * smm);
+
+  /** Check for sufficiently large denominator. */
+  if (denom > -1e-14)
+  {
+    value = MeasureType{};
+    derivative.Fill(0.0);
+    return;
+  }
+
+  /** Calculate the metric value. */
+  value = sfm / denom;
+
+  /** Second pass: compute the derivative per thread, and sum the threads' derivatives. */
+  userData.st_sf_N = sf / N;
+  userData.st_sm_N = sm / N;
+  userData.st_sfm_smm = sfm / smm;
+  userData.st_InvertedDenominator = 1.0 / denom;
+  userData.st_DerivativePointer = derivative.begin();
+
+  this->m_Threader->SetSingleMethodAndExecute(ComputeDerivativeThreaderCallback, &userData);
+  this->m_Threader->SetSingleMethodAndExecute(AccumulateDerivativesThreaderCallback, &userData);
+
+} // end GetValueAndDerivativeTwoPass()
+
+
+/**
+ * ******************* ThreadedComputeStatistics *******************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComputeStatistics(
+  ThreadIdType threadId) const
+{
+  /** Get a handle to the sample container. */
+  ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
+  const size_t                sampleContainerSize{ sampleContainer->size() };
+
+  /** Get the samples for this thread. */
+  const auto nrOfSamplesPerThreads = static_cast<unsigned long>(
+    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
+
+  const auto pos_begin = std::min<size_t>(nrOfSamplesPerThreads * threadId, sampleContainerSize);
+  const auto pos_end = std::min<size_t>(nrOfSamplesPerThreads * (threadId + 1), sampleContainerSize);
+
+  /** Create iterator over the sample container. */
+  const auto beginOfSampleContainer = sampleContainer->cbegin();
+  const auto threader_fbegin = beginOfSampleContainer + pos_begin;
+  const auto threader_fend = beginOfSampleContainer + pos_end;
+
+  /** Create variables to store intermediate results. */
+  AccumulateType sff{};
+  AccumulateType smm{};
+  AccumulateType sfm{};
+  AccumulateType sf{};
+  AccumulateType sm{};
+  unsigned long  numberOfPixelsCounted = 0;
+
+  /** Loop over the fixed image samples; the moving image derivative is not needed yet. */
+  for (auto threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
+  {
+    /** Read fixed coordinates and initialize some variables. */
+    const FixedImagePointType & fixedPoint = threader_fiter->m_ImageCoordinates;
+    RealType                    movingImageValue;
+
+    /** Transform point. */
+    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+
+    /** Check if the point is inside the moving mask. */
+    bool sampleOk = this->IsInsideMovingMask(mappedPoint);
+
+    /** Compute the moving image value M(T(x)) and check if the point is inside the moving image buffer. */
+    if (sampleOk)
+    {
+      sampleOk = this->FastEvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, nullptr, threadId);
+    }
+
+    if (sampleOk)
+    {
+      ++numberOfPixelsCounted;
+
+      /** Get the fixed image value. */
+      const auto fixedImageValue = static_cast<RealType>(threader_fiter->m_ImageValue);
+
+      /** Update some sums needed to calculate the value of NC. */
+      sff += fixedImageValue * fixedImageValue;
+      smm += movingImageValue * movingImageValue;
+      sfm += fixedImageValue * movingImageValue;
+      sf += fixedImageValue;
+      sm += movingImageValue;
+
+    } // end if sampleOk
+
+  } // end for loop over the image sample container
+
+  /** Only update these variables at the end to prevent unnecessary "false sharing". */
+  auto & perThreadVariable = this->m_CorrelationGetValueAndDerivativePerThreadVariables[threadId];
+  perThreadVariable.st_NumberOfPixelsCounted = numberOfPixelsCounted;
+  perThreadVariable.st_Sff = sff;
+  perThreadVariable.st_Smm = smm;
+  perThreadVariable.st_Sfm = sfm;
+  perThreadVariable.st_Sf = sf;
+  perThreadVariable.st_Sm = sm;
+
+} // end ThreadedComputeStatistics()
+
+
+/**
+ * ******************* ThreadedComputeDerivative *******************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComputeDerivative(
+  ThreadIdType threadId) const
+{
+  /** Initialize array that stores dM(x)/dmu, and the sparse Jacobian + indices. */
+  const NumberOfParametersType nnzji = Superclass::m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
+  NonZeroJacobianIndicesType   nzji(nnzji);
+  DerivativeType               imageJacobian(nzji.size());
+
+  /** Get a handle to the pre-allocated derivative for the current thread. It is
+   * reset to zero by AccumulateDerivativesThreaderCallback().
+   */
+  DerivativeType & derivative = this->m_CorrelationGetValueAndDerivativePerThreadVariables[threadId].st_DerivativeF;
+
+  /** The coefficients computed from the first pass. */
+  const RealType sf_N = this->m_TwoPassCoefficients.st_sf_N;
+  const RealType sm_N = this->m_TwoPassCoefficients.st_sm_N;
+  const RealType sfm_smm = this->m_TwoPassCoefficients.st_sfm_smm;
+  const RealType invertedDenominator = this->m_TwoPassCoefficients.st_InvertedDenominator;
+
+  /** Get a handle to the sample container. */
+  ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
+  const size_t                sampleContainerSize{ sampleContainer->size() };
+
+  /** Get the samples for this thread. */
+  const auto nrOfSamplesPerThreads = static_cast<unsigned long>(
+    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
+
+  const auto pos_begin = std::min<size_t>(nrOfSamplesPerThreads * threadId, sampleContainerSize);
+  const auto pos_end = std::min<size_t>(nrOfSamplesPerThreads * (threadId + 1), sampleContainerSize);
+
+  /** Create iterator over the sample container. */
+  const auto beginOfSampleContainer = sampleContainer->cbegin();
+  const auto threader_fbegin = beginOfSampleContainer + pos_begin;
+  const auto threader_fend = beginOfSampleContainer + pos_end;
+
+  /** Loop over the fixed image samples, and scatter their contributions into the derivative. */
+  for (auto threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
+  {
+    /** Read fixed coordinates and initialize some variables. */
+    const FixedImagePointType & fixedPoint = threader_fiter->m_ImageCoordinates;
+    RealType                    movingImageValue;
+    MovingImageDerivativeType   movingImageDerivative;
+
+    /** Transform point. */
+    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+
+    /** Check if the point is inside the moving mask. */
+    bool sampleOk = this->IsInsideMovingMask(mappedPoint);
+
+    /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
+     * the point is inside the moving image buffer.
+     */
+    if (sampleOk)
+    {
+      sampleOk = this->FastEvaluateMovingImageValueAndDerivative(
+        mappedPoint, movingImageValue, &movingImageDerivative, threadId);
+    }
+
+    if (sampleOk)
+    {
+      /** Get the fixed image value. */
+      const auto fixedImageValue = static_cast<RealType>(threader_fiter->m_ImageValue);
+
+      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+      Superclass::m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
+        fixedPoint, movingImageDerivative, imageJacobian, nzji);
+
+      /** The weight of this sample's differential in the derivative. */
+      const RealType weight =
+        ((fixedImageValue - sf_N) - sfm_smm * (movingImageValue - sm_N)) * invertedDenominator;
+
+      /** Only update the nonzero Jacobians. */
+      for (unsigned int i = 0; i < nzji.size(); ++i)
+      {
+        derivative[nzji[i]] += weight * imageJacobian[i];
+      }
+
+    } // end if sampleOk
+
+  } // end for loop over the image sample container
+
+} // end ThreadedComputeDerivative()
+
+
+/**
+ *********** ComputeStatisticsThreaderCallback *************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::ComputeStatisticsThreaderCallback(
+  void * arg)
+{
+  assert(arg);
+  const auto & infoStruct = *static_cast<ThreadInfoType *>(arg);
+
+  assert(infoStruct.UserData);
+  const auto & userData = *static_cast<MultiThreaderAccumulateDerivativeType *>(infoStruct.UserData);
+
+  assert(userData.st_Metric);
+  userData.st_Metric->ThreadedComputeStatistics(infoStruct.WorkUnitID);
+
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end ComputeStatisticsThreaderCallback()
+
+
+/**
+ *********** ComputeDerivativeThreaderCallback *************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::ComputeDerivativeThreaderCallback(
+  void * arg)
+{
+  assert(arg);
+  const auto & infoStruct = *static_cast<ThreadInfoType *>(arg);
+
+  assert(infoStruct.UserData);
+  const auto & userData = *static_cast<MultiThreaderAccumulateDerivativeType *>(infoStruct.UserData);
+
+  assert(userData.st_Metric);
+  userData.st_Metric->ThreadedComputeDerivative(infoStruct.WorkUnitID);
+
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end ComputeDerivativeThreaderCallback()
+
+
 } // end namespace itk
 
 #endif // end #ifndef _itkAdvancedNormalizedCorrelationImageToImageMetric_hxx
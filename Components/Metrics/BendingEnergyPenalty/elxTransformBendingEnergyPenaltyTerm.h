@@ -39,6 +39,13 @@ namespace elastix
  * The parameters used in this class are:
  * \parameter Metric: Select this metric as follows:\n
  *    <tt>(Metric "TransformBendingEnergyPenalty")</tt>
+ * \parameter UseGridBasedEvaluation: Bool to evaluate the bending energy of a
+ *    B-spline transform exactly on its grid, instead of estimating it from the
+ *    image samples. The bending energy is then averaged over the valid region of
+ *    the B-spline grid, and its computation time does not depend on the number of
+ *    samples. Can be given for each resolution.\n
+ *    <tt>(UseGridBasedEvaluation "true")</tt>\n
+ *    The default value is false.
  *
  * \ingroup Metrics
  *
@@ -125,6 +132,13 @@ public:
   void
   Initialize() override;
 
+  /**
+   * Do some things before each resolution:
+   * \li Set UseGridBasedEvaluation setting
+   */
+  void
+  BeforeEachResolution() override;
+
 protected:
   /** The constructor. */
   TransformBendingEnergyPenalty() = default;
@@ -20,6 +20,7 @@
 
 #include "elxTransformBendingEnergyPenaltyTerm.h"
 #include "itkTimeProbe.h"
+#include <itkDeref.h>
 
 namespace elastix
 {
@@ -41,6 +42,28 @@ TransformBendingEnergyPenalty<TElastix>::Initialize()
 
 } // end Initialize()
 
+
+/**
+ * ***************** BeforeEachResolution ***********************
+ */
+
+template <typename TElastix>
+void
+TransformBendingEnergyPenalty<TElastix>::BeforeEachResolution()
+{
+  const Configuration & configuration = itk::Deref(Superclass2::GetConfiguration());
+
+  /** Get the current resolution level. */
+  unsigned int level = (this->m_Registration->GetAsITKBaseType())->GetCurrentLevel();
+
+  /** Get and set the grid-based evaluation. */
+  bool useGridBasedEvaluation = false;
+  configuration.ReadParameter(
+    useGridBasedEvaluation, "UseGridBasedEvaluation", BaseComponent::GetComponentLabel(), level, 0);
+  this->SetUseGridBasedEvaluation(useGridBasedEvaluation);
+
+} // end BeforeEachResolution()
+
 } // end namespace elastix
 
 #endif // end #ifndef elxTransformBendingEnergyPenaltyTerm_hxx
@@ -21,6 +21,9 @@
 #include "itkTransformPenaltyTerm.h"
 #include "itkImageGridSampler.h"
 
+#include <array>
+#include <vector>
+
 namespace itk
 {
 
@@ -39,6 +42,10 @@ namespace itk
  *      M. O. Leach, and D. J. Hawkes, "Nonrigid registration
  *      using free-form deformations: Application to breast MR
  *      images", IEEE Trans. Med. Imaging 18, 712-721, 1999.\n
+ * For a B-spline transform, the bending energy may optionally be
+ * evaluated exactly on the B-spline grid, instead of being estimated
+ * from the samples of the image sampler, see SetUseGridBasedEvaluation().
+ *
  * [2]: M. Staring and S. Klein,
  *      "Itk::Transforms supporting spatial derivatives"",
  *      Insight Journal, http://hdl.handle.net/10380/3215.
@@ -119,6 +126,21 @@ public:
   /** Define the dimension. */
   itkStaticConstMacro(FixedImageDimension, unsigned int, FixedImageType::ImageDimension);
 
+  /** Use an exact evaluation of the bending energy of a B-spline transform, instead of an estimate from the samples of
+   * the image sampler. The bending energy is then averaged over the valid region of the B-spline grid. As it is a
+   * quadratic form in the B-spline coefficients, it is computed by separable banded matrix products on the coefficient
+   * grid, so that its cost does not depend on the number of samples. The B-spline transform may be the current
+   * transform of a combination transform, in which case the initial transform is ignored. Cyclic B-spline transforms
+   * and grids with a non-orthogonal direction are not supported. Default: false.
+   */
+  itkSetMacro(UseGridBasedEvaluation, bool);
+  itkGetConstMacro(UseGridBasedEvaluation, bool);
+  itkBooleanMacro(UseGridBasedEvaluation);
+
+  /** Initialize the penalty term. For the grid-based evaluation, it computes the matrices of the B-spline grid. */
+  void
+  Initialize() override;
+
   /** Get the penalty term value. */
   MeasureType
   GetValue(const ParametersType & parameters) const override;
@@ -155,12 +177,66 @@ protected:
   using typename Superclass::MovingImagePointType;
   using typename Superclass::MovingImageContinuousIndexType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::CachedSampleDerivativeType;
 
   /** The constructor. */
   TransformBendingEnergyPenaltyTerm();
 
   /** The destructor. */
   ~TransformBendingEnergyPenaltyTerm() override = default;
+
+  /** The sample derivative cache holds the Jacobian of the spatial Hessian, unless the grid-based evaluation is used.
+   */
+  int
+  GetSampleDerivativeOrder() const override
+  {
+    return m_UseGridBasedEvaluation ? -1 : 2;
+  }
+
+private:
+  /** The banded Gram matrices of the 1D B-spline basis functions, and of their first and second order derivatives,
+   * integrated over the valid region of the grid. Each band has a width of 2 * SplineOrder + 1 per row.
+   */
+  using GramMatrixBandsType = std::array<std::vector<double>, 3>;
+
+  /** Compute the banded Gram matrices for a grid of the specified size, along one dimension. */
+  template <unsigned int VSplineOrder>
+  static GramMatrixBandsType
+  ComputeGramMatrixBands(const SizeValueType gridSize);
+
+  /** Multiply the coefficient grid by the Gram matrix of the specified derivative order, along one dimension. */
+  void
+  MultiplyByGramMatrix(const unsigned int dimension,
+                       const unsigned int derivativeOrder,
+                       const double *     input,
+                       double *           output) const;
+
+  /** Compute the bending energy, and optionally its derivative, exactly on the B-spline grid. */
+  void
+  GetValueAndDerivativeOnBSplineGrid(const ParametersType & parameters,
+                                     MeasureType &          value,
+                                     DerivativeType * const derivative) const;
+
+  /** Accumulate the bending energy, and optionally its derivative, over the samples in the range
+   * [beginIndex, endIndex), using the sample derivative cache. Returns the number of samples that are counted.
+   */
+  SizeValueType
+  AccumulateUsingSampleDerivativeCache(const ImageSampleContainerType & samples,
+                                       const SizeValueType              beginIndex,
+                                       const SizeValueType              endIndex,
+                                       const ParametersType &           parameters,
+                                       RealType &                       measure,
+                                       DerivativeType * const           derivative) const;
+
+  bool m_UseGridBasedEvaluation{ false };
+
+  /** Properties of the B-spline grid, set by Initialize() for the grid-based evaluation. A spline order of zero
+   * indicates that the grid-based evaluation is not used.
+   */
+  unsigned int                                         m_GridSplineOrder{ 0 };
+  Size<FixedImageDimension>                            m_GridSize{};
+  Vector<double, FixedImageDimension>                  m_GridSpacing{};
+  std::array<GramMatrixBandsType, FixedImageDimension> m_GramMatrixBands{};
 };
 
 } // end namespace itk
@@ -19,6 +19,13 @@
 #define itkTransformBendingEnergyPenaltyTerm_hxx
 
 #include "itkTransformBendingEnergyPenaltyTerm.h"
+#include "itkBSplineKernelFunction2.h"
+#include "itkBSplineDerivativeKernelFunction.h"
+#include "itkBSplineSecondOrderDerivativeKernelFunction2.h"
+#include "itkCyclicBSplineDeformableTransform.h"
+
+#include <algorithm> // For min.
+#include <numeric>   // For inner_product.
 
 namespace itk
 {
@@ -38,6 +45,357 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::TransformBendingEne
 } // end Constructor
 
 
+/**
+ * ****************** Initialize *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+void
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::Initialize()
+{
+  /** Call the superclass' implementation. */
+  this->Superclass::Initialize();
+
+  m_GridSplineOrder = 0;
+  m_GramMatrixBands = {};
+
+  if (!m_UseGridBasedEvaluation)
+  {
+    return;
+  }
+
+  /** Find the B-spline transform, possibly as the current transform of a combination transform. */
+  using BSplineScalarType = typename TransformType::ScalarType;
+  using BSplineTransformBaseType = AdvancedBSplineDeformableTransformBase<BSplineScalarType, FixedImageDimension>;
+  auto * bsplineTransform = dynamic_cast<BSplineTransformBaseType *>(Superclass::m_AdvancedTransform.GetPointer());
+  if (auto * const combinationTransform =
+        dynamic_cast<CombinationTransformType *>(Superclass::m_AdvancedTransform.GetPointer()))
+  {
+    bsplineTransform = dynamic_cast<BSplineTransformBaseType *>(combinationTransform->GetModifiableCurrentTransform());
+  }
+  if (bsplineTransform == nullptr)
+  {
+    itkExceptionMacro("The grid-based evaluation of the bending energy requires a B-spline transform.");
+  }
+  if (dynamic_cast<CyclicBSplineDeformableTransform<BSplineScalarType, FixedImageDimension, 1> *>(bsplineTransform) ||
+      dynamic_cast<CyclicBSplineDeformableTransform<BSplineScalarType, FixedImageDimension, 2> *>(bsplineTransform) ||
+      dynamic_cast<CyclicBSplineDeformableTransform<BSplineScalarType, FixedImageDimension, 3> *>(bsplineTransform))
+  {
+    itkExceptionMacro("The grid-based evaluation of the bending energy does not support a cyclic B-spline transform.");
+  }
+
+  /** The spatial Hessian only reduces to a scaling of the Hessian on the grid for an orthogonal grid direction. */
+  const auto directionMatrix = bsplineTransform->GetGridDirection().GetVnlMatrix();
+  if (!(directionMatrix.transpose() * directionMatrix).is_identity(1e-6))
+  {
+    itkExceptionMacro("The grid-based evaluation of the bending energy requires an orthogonal grid direction.");
+  }
+
+  const unsigned int splineOrder = bsplineTransform->GetSplineOrder();
+  const auto         gridSize = bsplineTransform->GetGridRegion().GetSize();
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    if (gridSize[i] <= splineOrder)
+    {
+      itkExceptionMacro("The B-spline grid has no valid region: its size is " << gridSize << '.');
+    }
+
+    switch (splineOrder)
+    {
+      case 1:
+        m_GramMatrixBands[i] = ComputeGramMatrixBands<1>(gridSize[i]);
+        break;
+      case 2:
+        m_GramMatrixBands[i] = ComputeGramMatrixBands<2>(gridSize[i]);
+        break;
+      case 3:
+        m_GramMatrixBands[i] = ComputeGramMatrixBands<3>(gridSize[i]);
+        break;
+      default:
+        itkExceptionMacro("The grid-based evaluation of the bending energy does not support spline order "
+                          << splineOrder << '.');
+    }
+  }
+
+  m_GridSplineOrder = splineOrder;
+  m_GridSize = gridSize;
+  m_GridSpacing = bsplineTransform->GetGridSpacing();
+
+} // end Initialize()
+
+
+/**
+ * ****************** ComputeGramMatrixBands *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+template <unsigned int VSplineOrder>
+auto
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::ComputeGramMatrixBands(const SizeValueType gridSize)
+  -> GramMatrixBandsType
+{
+  using KernelType = BSplineKernelFunction2<VSplineOrder>;
+  using DerivativeKernelType = BSplineDerivativeKernelFunction<VSplineOrder>;
+  using SecondOrderDerivativeKernelType = BSplineSecondOrderDerivativeKernelFunction2<VSplineOrder>;
+
+  constexpr unsigned int supportSize = VSplineOrder + 1;
+  constexpr unsigned int bandWidth = 2 * VSplineOrder + 1;
+
+  /** The 4-point Gauss-Legendre quadrature on a grid cell, which is exact for the products of the basis functions,
+   * as they are polynomials of a degree of at most 2 * VSplineOrder within a cell.
+   */
+  constexpr double nodes[] = { 0.5 - 0.5 * 0.8611363115940526,
+                               0.5 - 0.5 * 0.3399810435848563,
+                               0.5 + 0.5 * 0.3399810435848563,
+                               0.5 + 0.5 * 0.8611363115940526 };
+  constexpr double weights[] = {
+    0.5 * 0.3478548451374538, 0.5 * 0.6521451548625461, 0.5 * 0.6521451548625461, 0.5 * 0.3478548451374538
+  };
+
+  /** Integrate the products of the basis functions that overlap a grid cell of the valid region. Within the cell, the
+   * distance to the first of these basis functions is x, just like in the B-spline weight functions.
+   */
+  double cellMatrices[3][supportSize][supportSize]{};
+  for (unsigned int g = 0; g < 4; ++g)
+  {
+    const double x = nodes[g] + (VSplineOrder - 1.0) / 2.0;
+
+    double values[3][supportSize];
+    for (unsigned int p = 0; p < supportSize; ++p)
+    {
+      values[0][p] = KernelType::FastEvaluate(x - p);
+      values[1][p] = DerivativeKernelType::FastEvaluate(x - p);
+
+      // The second order derivative of a first order B-spline vanishes within a grid cell.
+      values[2][p] = (VSplineOrder > 1) ? SecondOrderDerivativeKernelType::FastEvaluate(x - p) : 0.0;
+    }
+
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      for (unsigned int p = 0; p < supportSize; ++p)
+      {
+        for (unsigned int q = 0; q < supportSize; ++q)
+        {
+          cellMatrices[a][p][q] += weights[g] * values[a][p] * values[a][q];
+        }
+      }
+    }
+  }
+
+  /** Sum the cell matrices over the cells of the valid region, of which there are gridSize - VSplineOrder. */
+  GramMatrixBandsType bands;
+  for (auto & band : bands)
+  {
+    band.assign(gridSize * bandWidth, 0.0);
+  }
+  for (SizeValueType cell = 0; cell + VSplineOrder < gridSize; ++cell)
+  {
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      for (unsigned int p = 0; p < supportSize; ++p)
+      {
+        for (unsigned int q = 0; q < supportSize; ++q)
+        {
+          bands[a][(cell + p) * bandWidth + VSplineOrder + q - p] += cellMatrices[a][p][q];
+        }
+      }
+    }
+  }
+  return bands;
+
+} // end ComputeGramMatrixBands()
+
+
+/**
+ * ****************** MultiplyByGramMatrix *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+void
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::MultiplyByGramMatrix(const unsigned int dimension,
+                                                                                  const unsigned int derivativeOrder,
+                                                                                  const double *     input,
+                                                                                  double *           output) const
+{
+  const SizeValueType halfBandWidth = m_GridSplineOrder;
+  const SizeValueType bandWidth = 2 * halfBandWidth + 1;
+  const SizeValueType length = m_GridSize[dimension];
+  const double *      band = m_GramMatrixBands[dimension][derivativeOrder].data();
+
+  SizeValueType stride = 1;
+  for (unsigned int i = 0; i < dimension; ++i)
+  {
+    stride *= m_GridSize[i];
+  }
+  const SizeValueType numberOfLines = m_GridSize.CalculateProductOfElements() / length;
+
+  /** Each line of coefficients along the dimension is multiplied independently. */
+  Superclass::m_Threader->ParallelizeArray(
+    0,
+    numberOfLines,
+    [=](const SizeValueType line) {
+      const SizeValueType first = (line / stride) * stride * length + line % stride;
+      for (SizeValueType i = 0; i < length; ++i)
+      {
+        /** The elements of row i of the Gram matrix are at bandRow[j], for |i - j| <= halfBandWidth. */
+        const double *      bandRow = band + i * (bandWidth - 1) + halfBandWidth;
+        const SizeValueType end = std::min(i + halfBandWidth + 1, length);
+
+        double sum = 0.0;
+        for (SizeValueType j = (i > halfBandWidth) ? (i - halfBandWidth) : 0; j < end; ++j)
+        {
+          sum += bandRow[j] * input[first + j * stride];
+        }
+        output[first + i * stride] = sum;
+      }
+    },
+    nullptr);
+
+} // end MultiplyByGramMatrix()
+
+
+/**
+ * ****************** GetValueAndDerivativeOnBSplineGrid *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+void
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivativeOnBSplineGrid(
+  const ParametersType & parameters,
+  MeasureType &          value,
+  DerivativeType * const derivative) const
+{
+  const SizeValueType numberOfCoefficients = m_GridSize.CalculateProductOfElements();
+  if (parameters.size() != FixedImageDimension * numberOfCoefficients)
+  {
+    itkExceptionMacro("The number of parameters (" << parameters.size()
+                                                   << ") does not match the B-spline grid of the last Initialize().");
+  }
+
+  /** Like BeforeThreadedGetValueAndDerivative(), but without the image sampler, which is not needed here. */
+  if (Superclass::m_UseMetricSingleThreaded)
+  {
+    this->SetTransformParameters(parameters);
+  }
+
+  /** The mean is taken over the valid region, which consists of gridSize - SplineOrder cells per dimension. */
+  double numberOfValidCells = 1.0;
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    numberOfValidCells *= static_cast<double>(m_GridSize[i] - m_GridSplineOrder);
+  }
+
+  if (derivative != nullptr)
+  {
+    derivative->set_size(parameters.size());
+    derivative->Fill(0.0);
+  }
+
+  std::vector<double> buffers[2] = { std::vector<double>(numberOfCoefficients),
+                                     std::vector<double>(numberOfCoefficients) };
+  RealType            measure{};
+
+  /** The squared Frobenius norm of the spatial Hessian of displacement component k is the sum over all pairs (i, j)
+   * of the squared second order derivatives with respect to x_i and x_j, of which the mixed ones occur twice. On the
+   * grid, each of these derivatives is a separable product of 1D derivatives, divided by the grid spacings. The
+   * integral of its square is therefore a quadratic form in the coefficients, of which the matrix is the Kronecker
+   * product of the 1D Gram matrices. The integration over the cells of the grid, instead of over physical space,
+   * cancels against the division by the volume of the valid region.
+   */
+  for (unsigned int k = 0; k < FixedImageDimension; ++k)
+  {
+    const double * const coefficients = parameters.data_block() + k * numberOfCoefficients;
+
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      for (unsigned int j = i; j < FixedImageDimension; ++j)
+      {
+        unsigned int derivativeOrders[FixedImageDimension]{};
+        ++derivativeOrders[i];
+        ++derivativeOrders[j];
+
+        const double factor = ((i == j) ? 1.0 : 2.0) /
+                              (vnl_math::sqr(m_GridSpacing[i] * m_GridSpacing[j]) * numberOfValidCells);
+
+        /** Multiply the coefficients by the Kronecker product of the Gram matrices, one dimension at a time. */
+        const double * input = coefficients;
+        for (unsigned int d = 0; d < FixedImageDimension; ++d)
+        {
+          double * const output = buffers[d % 2].data();
+          this->MultiplyByGramMatrix(d, derivativeOrders[d], input, output);
+          input = output;
+        }
+
+        measure += factor * std::inner_product(coefficients, coefficients + numberOfCoefficients, input, 0.0);
+
+        if (derivative != nullptr)
+        {
+          double * const derivativeOfComponent = derivative->data_block() + k * numberOfCoefficients;
+          for (SizeValueType n = 0; n < numberOfCoefficients; ++n)
+          {
+            derivativeOfComponent[n] += 2.0 * factor * input[n];
+          }
+        }
+      }
+    }
+  }
+
+  value = static_cast<MeasureType>(measure);
+
+} // end GetValueAndDerivativeOnBSplineGrid()
+
+
+/**
+ * ****************** AccumulateUsingSampleDerivativeCache *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+SizeValueType
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::AccumulateUsingSampleDerivativeCache(
+  const ImageSampleContainerType & samples,
+  const SizeValueType              beginIndex,
+  const SizeValueType              endIndex,
+  const ParametersType &           parameters,
+  RealType &                       measure,
+  DerivativeType * const           derivative) const
+{
+  SizeValueType              numberOfPixelsCounted = 0;
+  CachedSampleDerivativeType spatialHessians;
+
+  for (SizeValueType sampleIndex = beginIndex; sampleIndex < endIndex; ++sampleIndex)
+  {
+    /** The mapped point is only needed to check if it is inside the moving mask. */
+    if (this->GetMovingImageMask() != nullptr &&
+        !this->IsInsideMovingMask(this->TransformPoint(samples[sampleIndex].m_ImageCoordinates)))
+    {
+      continue;
+    }
+    ++numberOfPixelsCounted;
+
+    /** Compute the spatial Hessians of all transform components, and the contribution of this point. */
+    this->ComputeCachedSampleDerivative(sampleIndex, parameters, spatialHessians.data());
+    for (const double element : spatialHessians)
+    {
+      measure += element * element;
+    }
+
+    /** The derivative of the sum of the squared elements with respect to the spatial Hessians is twice the spatial
+     * Hessians themselves.
+     */
+    if (derivative != nullptr)
+    {
+      for (double & element : spatialHessians)
+      {
+        element *= 2.0;
+      }
+      this->AddCachedSampleDerivativeProduct(sampleIndex, spatialHessians.data(), *derivative);
+    }
+  }
+  return numberOfPixelsCounted;
+
+} // end AccumulateUsingSampleDerivativeCache()
+
+
 /**
  * ****************** GetValue *******************************
  */
@@ -47,6 +405,14 @@ auto
 TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValue(const ParametersType & parameters) const
   -> MeasureType
 {
+  /** Evaluate exactly on the B-spline grid, if requested. */
+  if (m_GridSplineOrder > 0)
+  {
+    MeasureType value{};
+    this->GetValueAndDerivativeOnBSplineGrid(parameters, value, nullptr);
+    return value;
+  }
+
   /** Initialize some variables. */
   Superclass::m_NumberOfPixelsCounted = 0;
   RealType           measure{};
@@ -76,6 +442,15 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValue(const Para
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
 
+  /** Use the cached Jacobians of the spatial Hessian at the samples, if available. */
+  if (this->SampleDerivativeCacheIsUsable(*sampleContainer))
+  {
+    Superclass::m_NumberOfPixelsCounted = this->AccumulateUsingSampleDerivativeCache(
+      *sampleContainer, 0, sampleContainer->size(), parameters, measure, nullptr);
+    this->CheckNumberOfSamples();
+    return static_cast<MeasureType>(measure / static_cast<RealType>(Superclass::m_NumberOfPixelsCounted));
+  }
+
   /** Loop over the fixed image samples to calculate the penalty term. */
   for (const auto & fixedImageSample : *sampleContainer)
   {
@@ -146,6 +521,12 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivati
   MeasureType &          value,
   DerivativeType &       derivative) const
 {
+  /** Evaluate exactly on the B-spline grid, if requested. */
+  if (m_GridSplineOrder > 0)
+  {
+    return this->GetValueAndDerivativeOnBSplineGrid(parameters, value, &derivative);
+  }
+
   /** Create and initialize some variables. */
   Superclass::m_NumberOfPixelsCounted = 0;
   RealType measure{};
@@ -191,6 +572,17 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivati
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
 
+  /** Use the cached Jacobians of the spatial Hessian at the samples, if available. */
+  if (this->SampleDerivativeCacheIsUsable(*sampleContainer))
+  {
+    Superclass::m_NumberOfPixelsCounted = this->AccumulateUsingSampleDerivativeCache(
+      *sampleContainer, 0, sampleContainer->size(), parameters, measure, &derivative);
+    this->CheckNumberOfSamples();
+    derivative /= static_cast<RealType>(Superclass::m_NumberOfPixelsCounted);
+    value = static_cast<MeasureType>(measure / static_cast<RealType>(Superclass::m_NumberOfPixelsCounted));
+    return;
+  }
+
   /** Loop over the fixed image to calculate the penalty term and its derivative. */
   for (const auto & fixedImageSample : *sampleContainer)
   {
@@ -331,6 +723,12 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivati
                                                                                    MeasureType &          value,
                                                                                    DerivativeType & derivative) const
 {
+  /** Evaluate exactly on the B-spline grid, if requested. */
+  if (m_GridSplineOrder > 0)
+  {
+    return this->GetValueAndDerivativeOnBSplineGrid(parameters, value, &derivative);
+  }
+
   /** Option for now to still use the single threaded code. */
   if (!Superclass::m_UseMultiThread)
   {
@@ -413,6 +811,18 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::ThreadedGetValueAnd
   const auto fbegin = beginOfSampleContainer + pos_begin;
   const auto fend = beginOfSampleContainer + pos_end;
 
+  /** Use the cached Jacobians of the spatial Hessian at the samples, if available. */
+  if (this->SampleDerivativeCacheIsUsable(*sampleContainer))
+  {
+    const ParametersType & parameters = Superclass::m_AdvancedTransform->GetParameters();
+    RealType               cachedMeasure{};
+    Superclass::m_GetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted =
+      this->AccumulateUsingSampleDerivativeCache(
+        *sampleContainer, pos_begin, pos_end, parameters, cachedMeasure, &derivative);
+    Superclass::m_GetValueAndDerivativePerThreadVariables[threadId].st_Value = static_cast<MeasureType>(cachedMeasure);
+    return;
+  }
+
   /** Create variables to store intermediate results. circumvent false sharing */
   unsigned long numberOfPixelsCounted = 0;
   MeasureType   measure{};
@@ -59,6 +59,7 @@ public:
   using typename Superclass::TransformJacobianType;
   using typename Superclass::MeasureType;
   using typename Superclass::DerivativeType;
+  using typename Superclass::DerivativeValueType;
   using typename Superclass::FixedPointSetType;
   using typename Superclass::MovingPointSetType;
   using typename Superclass::InputPointType;
@@ -82,6 +83,8 @@ public:
 protected:
   CorrespondingPointsEuclideanDistancePointMetric() = default;
   ~CorrespondingPointsEuclideanDistancePointMetric() override = default;
+
+  using typename Superclass::PointContributionsType;
 };
 
 } // end namespace itk
@@ -35,38 +35,30 @@ CorrespondingPointsEuclideanDistancePointMetric<TFixedPointSet, TMovingPointSet>
   const auto & fixedPoints = this->Superclass::GetFixedPoints();
   const auto & movingPoints = this->Superclass::GetMovingPoints();
 
-  /** Initialize some variables. */
-  Superclass::m_NumberOfPointsCounted = 0;
-  MeasureType measure{};
-
   /** Make sure the transform parameters are up to date. */
   this->SetTransformParameters(parameters);
 
-  /** Create iterator. */
-  auto pointItMoving = movingPoints.cbegin();
-
   /** Loop over the corresponding points. */
-  for (const OutputPointType & fixedPoint : fixedPoints)
-  {
-    /** Get the current corresponding moving point. */
-    const InputPointType & movingPoint = *pointItMoving;
-
-    /** Transform point and check if it is inside the B-spline support region. */
-    // bool sampleOk = this->TransformPoint( fixedPoint, mappedPoint );
-    const OutputPointType mappedPoint = Superclass::m_Transform->TransformPoint(fixedPoint);
-
-    /** Check if the point is inside the moving mask. */
-    if ((Superclass::m_MovingImageMask == nullptr) || Superclass::m_MovingImageMask->IsInsideInWorldSpace(mappedPoint))
-    {
-      Superclass::m_NumberOfPointsCounted++;
-      const auto diffVector = movingPoint - mappedPoint;
-      measure += diffVector.GetNorm();
-
-    } // end if sampleOk
-
-    ++pointItMoving;
+  const MeasureType measure = this->AccumulatePointContributions(
+    fixedPoints.size(),
+    nullptr,
+    [this, &fixedPoints, &movingPoints](
+      const SizeValueType beginIndex, const SizeValueType endIndex, PointContributionsType & contributions) {
+      for (SizeValueType pointIndex = beginIndex; pointIndex < endIndex; ++pointIndex)
+      {
+        /** Transform point and check if it is inside the B-spline support region. */
+        const OutputPointType mappedPoint = Superclass::m_Transform->TransformPoint(fixedPoints[pointIndex]);
 
-  } // end loop over all corresponding points
+        /** Check if the point is inside the moving mask. */
+        if ((Superclass::m_MovingImageMask == nullptr) ||
+            Superclass::m_MovingImageMask->IsInsideInWorldSpace(mappedPoint))
+        {
+          ++contributions.numberOfPointsCounted;
+          const auto diffVector = movingPoints[pointIndex] - mappedPoint;
+          contributions.measure += diffVector.GetNorm();
+        }
+      }
+    });
 
   return measure / Superclass::m_NumberOfPointsCounted;
 
@@ -105,18 +97,12 @@ CorrespondingPointsEuclideanDistancePointMetric<TFixedPointSet, TMovingPointSet>
   MeasureType &          value,
   DerivativeType &       derivative) const
 {
-  using VnlVectorType = vnl_vector<typename OutputPointType::CoordinateType>;
-
   const auto & fixedPoints = this->Superclass::GetFixedPoints();
   const auto & movingPoints = this->Superclass::GetMovingPoints();
 
   /** Initialize some variables */
-  Superclass::m_NumberOfPointsCounted = 0;
-  MeasureType measure{};
   derivative.set_size(this->GetNumberOfParameters());
   derivative.Fill(0.0);
-  NonZeroJacobianIndicesType nzji(Superclass::m_Transform->GetNumberOfNonZeroJacobianIndices());
-  TransformJacobianType      jacobian;
 
   /** Call non-thread-safe stuff, such as:
    *   this->SetTransformParameters( parameters );
@@ -133,58 +119,54 @@ CorrespondingPointsEuclideanDistancePointMetric<TFixedPointSet, TMovingPointSet>
    */
   this->BeforeThreadedGetValueAndDerivative(parameters);
 
-  /** Create iterator. */
-  auto pointItMoving = movingPoints.cbegin();
+  /** Loop over the corresponding points. Each chunk of points accumulates its own (sparse) derivative. */
+  const MeasureType measure = this->AccumulatePointContributions(
+    fixedPoints.size(),
+    &derivative,
+    [this, &fixedPoints, &movingPoints](
+      const SizeValueType beginIndex, const SizeValueType endIndex, PointContributionsType & contributions) {
+      NonZeroJacobianIndicesType nzji(Superclass::m_Transform->GetNumberOfNonZeroJacobianIndices());
+      TransformJacobianType      jacobian;
 
-  /** Loop over the corresponding points. */
-  for (const OutputPointType & fixedPoint : fixedPoints)
-  {
-    /** Get the current corresponding moving point. */
-    const InputPointType & movingPoint = *pointItMoving;
-
-    /** Transform point and check if it is inside the B-spline support region. */
-    // bool sampleOk = this->TransformPoint( fixedPoint, mappedPoint );
-    const OutputPointType mappedPoint = Superclass::m_Transform->TransformPoint(fixedPoint);
-
-    /** Check if the point is inside the moving mask. */
-    if ((Superclass::m_MovingImageMask == nullptr) || Superclass::m_MovingImageMask->IsInsideInWorldSpace(mappedPoint))
-    {
-      Superclass::m_NumberOfPointsCounted++;
-
-      /** Get the TransformJacobian dT/dmu. */
-      // this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
-      Superclass::m_Transform->GetJacobian(fixedPoint, jacobian, nzji);
+      for (SizeValueType pointIndex = beginIndex; pointIndex < endIndex; ++pointIndex)
+      {
+        const OutputPointType & fixedPoint = fixedPoints[pointIndex];
 
-      const auto  diffVector = movingPoint - mappedPoint;
-      MeasureType distance = diffVector.GetNorm();
-      measure += distance;
+        /** Transform point and check if it is inside the B-spline support region. */
+        const OutputPointType mappedPoint = Superclass::m_Transform->TransformPoint(fixedPoint);
 
-      /** Calculate the contributions to the derivatives with respect to each parameter. */
-      if (distance > std::numeric_limits<MeasureType>::epsilon())
-      {
-        VnlVectorType diff_2 = (diffVector / distance).GetVnlVector();
-        if (nzji.size() == this->GetNumberOfParameters())
+        /** Check if the point is inside the moving mask. */
+        if ((Superclass::m_MovingImageMask == nullptr) ||
+            Superclass::m_MovingImageMask->IsInsideInWorldSpace(mappedPoint))
         {
-          /** Loop over all Jacobians. */
-          derivative -= diff_2 * jacobian;
-        }
-        else
-        {
-          /** Only pick the nonzero Jacobians. */
-          for (unsigned int i = 0; i < nzji.size(); ++i)
-          {
-            const unsigned int index = nzji[i];
-            VnlVectorType      column = jacobian.get_column(i);
-            derivative[index] -= dot_product(diff_2, column);
-          }
-        }
-      } // end if distance != 0
+          ++contributions.numberOfPointsCounted;
 
-    } // end if sampleOk
+          /** Get the TransformJacobian dT/dmu. */
+          Superclass::m_Transform->GetJacobian(fixedPoint, jacobian, nzji);
 
-    ++pointItMoving;
+          const auto        diffVector = movingPoints[pointIndex] - mappedPoint;
+          const MeasureType distance = diffVector.GetNorm();
+          contributions.measure += distance;
 
-  } // end loop over all corresponding points
+          /** Calculate the contributions to the derivatives with respect to the nonzero Jacobians. */
+          if (distance > std::numeric_limits<MeasureType>::epsilon())
+          {
+            const auto diff_2 = diffVector / distance;
+            for (unsigned int i = 0; i < nzji.size(); ++i)
+            {
+              DerivativeValueType sum{};
+              for (unsigned int d = 0; d < Self::MovingPointSetDimension; ++d)
+              {
+                sum += diff_2[d] * jacobian(d, i);
+              }
+              contributions.AddToDerivative(nzji[i], -sum);
+            }
+          } // end if distance != 0
+
+        } // end if sampleOk
+
+      } // end loop over the points of the chunk
+    });
 
   /** Check if enough samples were valid. */
   //   this->CheckNumberOfSamples(
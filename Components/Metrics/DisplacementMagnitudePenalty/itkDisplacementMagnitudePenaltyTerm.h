@@ -121,6 +121,7 @@ protected:
   using typename Superclass::MovingImagePointType;
   using typename Superclass::MovingImageContinuousIndexType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::CachedSampleDerivativeType;
 
   /** The constructor. */
   DisplacementMagnitudePenaltyTerm();
@@ -128,8 +129,25 @@ protected:
   /** The destructor. */
   ~DisplacementMagnitudePenaltyTerm() override = default;
 
+  /** The sample derivative cache holds the Jacobian of the transform, which yields the displacement. */
+  int
+  GetSampleDerivativeOrder() const override
+  {
+    return 0;
+  }
+
   /** PrintSelf. *
   void PrintSelf( std::ostream& os, Indent indent ) const;*/
+
+private:
+  /** Accumulate the penalty term, and optionally its derivative (without the factor 2), over all samples, using the
+   * sample derivative cache. Returns the number of samples that are counted.
+   */
+  SizeValueType
+  AccumulateUsingSampleDerivativeCache(const ImageSampleContainerType & samples,
+                                       const ParametersType &           parameters,
+                                       RealType &                       measure,
+                                       DerivativeType * const           derivative) const;
 };
 
 } // end namespace itk
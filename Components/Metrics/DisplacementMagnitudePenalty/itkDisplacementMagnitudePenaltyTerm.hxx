@@ -56,6 +56,56 @@ DisplacementMagnitudePenaltyTerm< TFixedImage, TScalarType >
 } // end PrintSelf()
 */
 
+/**
+ * ****************** AccumulateUsingSampleDerivativeCache *******************************
+ */
+
+template <typename TFixedImage, typename TScalarType>
+SizeValueType
+DisplacementMagnitudePenaltyTerm<TFixedImage, TScalarType>::AccumulateUsingSampleDerivativeCache(
+  const ImageSampleContainerType & samples,
+  const ParametersType &           parameters,
+  RealType &                       measure,
+  DerivativeType * const           derivative) const
+{
+  SizeValueType              numberOfPixelsCounted = 0;
+  CachedSampleDerivativeType displacement;
+
+  for (SizeValueType sampleIndex = 0; sampleIndex < samples.size(); ++sampleIndex)
+  {
+    /** Compute the displacement T(x)-x from the cached B-spline weights. */
+    this->ComputeCachedSampleDerivative(sampleIndex, parameters, displacement.data());
+
+    /** Check if the mapped point is inside the moving mask. */
+    if (this->GetMovingImageMask() != nullptr)
+    {
+      MovingImagePointType mappedPoint = samples[sampleIndex].m_ImageCoordinates;
+      for (unsigned int d = 0; d < FixedImageDimension; ++d)
+      {
+        mappedPoint[d] += displacement[d];
+      }
+      if (!this->IsInsideMovingMask(mappedPoint))
+      {
+        continue;
+      }
+    }
+    ++numberOfPixelsCounted;
+
+    /** Compute the contribution of this point: ||T(x)-x||^2, and (T(x)-x)' dT/dmu. */
+    for (unsigned int d = 0; d < FixedImageDimension; ++d)
+    {
+      measure += vnl_math::sqr(displacement[d]);
+    }
+    if (derivative != nullptr)
+    {
+      this->AddCachedSampleDerivativeProduct(sampleIndex, displacement.data(), *derivative);
+    }
+  }
+  return numberOfPixelsCounted;
+
+} // end AccumulateUsingSampleDerivativeCache()
+
+
 /**
  * ****************** GetValue *******************************
  */
@@ -76,6 +126,16 @@ DisplacementMagnitudePenaltyTerm<TFixedImage, TScalarType>::GetValue(const Param
   this->GetImageSampler()->Update();
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
 
+  /** Use the cached B-spline weights at the samples, if available. */
+  if (this->SampleDerivativeCacheIsUsable(*sampleContainer))
+  {
+    Superclass::m_NumberOfPixelsCounted =
+      this->AccumulateUsingSampleDerivativeCache(*sampleContainer, parameters, measure, nullptr);
+    this->CheckNumberOfSamples();
+    measure /= std::max(NumericTraits<RealType>::One, static_cast<RealType>(Superclass::m_NumberOfPixelsCounted));
+    return static_cast<MeasureType>(measure);
+  }
+
   /** Loop over the fixed image samples to calculate the penalty term. */
   for (const auto & fixedImageSample : *sampleContainer)
   {
@@ -172,6 +232,19 @@ DisplacementMagnitudePenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivativ
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
 
+  /** Use the cached B-spline weights at the samples, if available. */
+  if (this->SampleDerivativeCacheIsUsable(*sampleContainer))
+  {
+    Superclass::m_NumberOfPixelsCounted =
+      this->AccumulateUsingSampleDerivativeCache(*sampleContainer, parameters, measure, &derivative);
+    this->CheckNumberOfSamples();
+    const RealType normalizationConstant =
+      std::max(NumericTraits<RealType>::One, static_cast<RealType>(Superclass::m_NumberOfPixelsCounted));
+    derivative /= (normalizationConstant / 2.0);
+    value = static_cast<MeasureType>(measure / normalizationConstant);
+    return;
+  }
+
   /** Loop over the fixed image to calculate the penalty term and its derivative. */
   for (const auto & fixedImageSample : *sampleContainer)
   {
@@ -43,6 +43,9 @@
 #include "itkOptimizer.h"
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkRayCastResamplerPool.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -63,6 +66,9 @@ namespace itk
  * on it. Values at these non-grid position of the Fixed image are
  * interpolated using a user-selected Interpolator.
  *
+ * The derivative is computed by central finite differences. When multi-threading is used, the values at the
+ * perturbed parameters are computed concurrently, each by its own copy of the resampling and Sobel filter pipeline.
+ *
  * Implementation of this class is based on:
  * Hipwell, J. H., et. al. (2003), "Intensity-Based 2-D-3D Registration of
  * Cerebral Angiograms,", IEEE Transactions on Medical Imaging,
@@ -174,6 +180,12 @@ protected:
   void
   ComputeMovedGradientRange() const;
 
+  /** Compute the range of the specified moved image gradients. */
+  void
+  ComputeMovedGradientRange(const MovedGradientImageType * const movedGradients[],
+                            MovedGradientPixelType               minMovedGradient[],
+                            MovedGradientPixelType               maxMovedGradient[]) const;
+
   /** Compute the variance and range of the moving image gradients. */
   void
   ComputeVariance() const;
@@ -182,11 +194,26 @@ protected:
   MeasureType
   ComputeMeasure(const ParametersType & parameters, const double * subtractionFactor) const;
 
+  /** Compute the similarity measure of the specified moved image gradients, using a specified subtraction factor. */
+  MeasureType
+  ComputeMeasureOfMovedGradients(const MovedGradientImageType * const movedGradients[],
+                                 const double *                       subtractionFactor) const;
+
   using FixedSobelFilter = NeighborhoodOperatorImageFilter<FixedGradientImageType, FixedGradientImageType>;
 
   using MovedSobelFilter = NeighborhoodOperatorImageFilter<MovedGradientImageType, MovedGradientImageType>;
 
 private:
+  using ResamplerPoolType = RayCastResamplerPool<MovingImageType, TransformedMovingImageType, ScalarType>;
+
+  /** Set up the copies of the pipeline that are used to compute the derivative concurrently. */
+  void
+  InitializeConcurrentPipelines(RayCastInterpolatorType & rayCaster);
+
+  /** Compute the value for the specified parameters, by the specified copy of the pipeline. */
+  MeasureType
+  ComputeValueUsingPipelineCopy(const unsigned int copyIndex, const ParametersType & parameters) const;
+
   /** The variance of the moving image gradients. */
   mutable MovedGradientPixelType m_Variance[FixedImageDimension]{};
 
@@ -220,6 +247,11 @@ private:
 
   typename MovedSobelFilter::Pointer m_MovedSobelFilters[Self::MovedImageDimension]{};
 
+  /** The copies of the pipeline that compute the derivative concurrently, and their Sobel filters. */
+  mutable ResamplerPoolType                       m_ResamplerPool{};
+  std::vector<CastMovedImageFilterPointer>        m_ConcurrentCastMovedImageFilters{};
+  std::vector<typename MovedSobelFilter::Pointer> m_ConcurrentMovedSobelFilters{};
+
   ScalesType                  m_Scales{};
   double                      m_DerivativeDelta{ 0.001 };
   double                      m_Rescalingfactor{ 1.0 };
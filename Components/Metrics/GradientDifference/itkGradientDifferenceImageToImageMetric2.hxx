@@ -39,6 +39,7 @@
 #include "itkRescaleIntensityImageFilter.h"
 #include "itkImageFileWriter.h"
 
+#include <algorithm> // For min.
 #include <iostream>
 #include <iomanip>
 #include <stdio.h>
@@ -113,6 +114,8 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
   /** Compute the variance */
   ComputeVariance();
 
+  this->InitializeConcurrentPipelines(*rayCaster);
+
   /* Rescale the similarity measure between 0-1; */
   MeasureType tmpmeasure = this->GetValue(this->m_Transform->GetParameters());
 
@@ -124,6 +127,55 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
 } // end Initialize()
 
 
+/**
+ * ********************* InitializeConcurrentPipelines ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::InitializeConcurrentPipelines(
+  RayCastInterpolatorType & rayCaster)
+{
+  this->m_ResamplerPool.Clear();
+  this->m_ConcurrentCastMovedImageFilters.clear();
+  this->m_ConcurrentMovedSobelFilters.clear();
+
+  if (!this->m_UseMultiThread)
+  {
+    return;
+  }
+
+  /** One copy per work unit, but not more than the number of values per derivative. */
+  const unsigned int numberOfCopies =
+    std::min(this->m_Threader->GetNumberOfWorkUnits(), 2 * this->GetNumberOfParameters());
+
+  if (numberOfCopies < 2 ||
+      !this->m_ResamplerPool.Initialize(rayCaster, *this->m_MovingImage, *this->m_FixedImage, numberOfCopies))
+  {
+    return;
+  }
+
+  for (unsigned int copyIndex = 0; copyIndex < numberOfCopies; ++copyIndex)
+  {
+    const auto castMovedImageFilter = CastMovedImageFilterType::New();
+    castMovedImageFilter->SetInput(this->m_ResamplerPool.GetOutput(copyIndex));
+    castMovedImageFilter->SetNumberOfWorkUnits(1);
+    this->m_ConcurrentCastMovedImageFilters.push_back(castMovedImageFilter);
+
+    for (unsigned int iFilter = 0; iFilter < MovedImageDimension; ++iFilter)
+    {
+      const auto movedSobelFilter = MovedSobelFilter::New();
+      movedSobelFilter->OverrideBoundaryCondition(&this->m_MovedBoundCond);
+      movedSobelFilter->SetOperator(this->m_MovedSobelOperators[iFilter]);
+      movedSobelFilter->SetInput(castMovedImageFilter->GetOutput());
+      movedSobelFilter->SetNumberOfWorkUnits(1);
+      this->m_ConcurrentMovedSobelFilters.push_back(movedSobelFilter);
+    }
+  }
+
+} // end InitializeConcurrentPipelines()
+
+
 /**
  * ********************* PrintSelf ******************************
  */
@@ -144,32 +196,54 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::
 template <typename TFixedImage, typename TMovingImage>
 void
 GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovedGradientRange() const
+{
+  const MovedGradientImageType * movedGradients[MovedImageDimension];
+
+  for (unsigned int iDimension = 0; iDimension < MovedImageDimension; ++iDimension)
+  {
+    movedGradients[iDimension] = this->m_MovedSobelFilters[iDimension]->GetOutput();
+  }
+
+  this->ComputeMovedGradientRange(movedGradients, this->m_MinMovedGradient, this->m_MaxMovedGradient);
+}
+
+
+/**
+ * ******************** ComputeMovedGradientRange ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovedGradientRange(
+  const MovedGradientImageType * const movedGradients[],
+  MovedGradientPixelType               minMovedGradient[],
+  MovedGradientPixelType               maxMovedGradient[]) const
 {
   unsigned int           iDimension;
   MovedGradientPixelType gradient;
 
   for (iDimension = 0; iDimension < FixedImageDimension; ++iDimension)
   {
-    ImageRegionConstIteratorWithIndex<MovedGradientImageType> iterate(m_MovedSobelFilters[iDimension]->GetOutput(),
+    ImageRegionConstIteratorWithIndex<MovedGradientImageType> iterate(movedGradients[iDimension],
                                                                       this->GetFixedImageRegion());
 
     gradient = iterate.Get();
 
-    m_MinMovedGradient[iDimension] = gradient;
-    m_MaxMovedGradient[iDimension] = gradient;
+    minMovedGradient[iDimension] = gradient;
+    maxMovedGradient[iDimension] = gradient;
 
     while (!iterate.IsAtEnd())
     {
       gradient = iterate.Get();
 
-      if (gradient > m_MaxMovedGradient[iDimension])
+      if (gradient > maxMovedGradient[iDimension])
       {
-        m_MaxMovedGradient[iDimension] = gradient;
+        maxMovedGradient[iDimension] = gradient;
       }
 
-      if (gradient < m_MinMovedGradient[iDimension])
+      if (gradient < minMovedGradient[iDimension])
       {
-        m_MinMovedGradient[iDimension] = gradient;
+        minMovedGradient[iDimension] = gradient;
       }
 
       ++iterate;
@@ -323,10 +397,39 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
   this->BeforeThreadedGetValueAndDerivative(parameters);
   // this->SetTransformParameters( parameters );
 
-  unsigned int iDimension;
   this->m_TransformMovingImageFilter->Modified();
   this->m_TransformMovingImageFilter->UpdateLargestPossibleRegion();
-  MeasureType measure{};
+
+  for (unsigned int iDimension = 0; iDimension < FixedImageDimension; ++iDimension)
+  {
+    this->m_FixedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
+  }
+
+  const MovedGradientImageType * movedGradients[MovedImageDimension];
+
+  for (unsigned int iDimension = 0; iDimension < MovedImageDimension; ++iDimension)
+  {
+    this->m_MovedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
+    movedGradients[iDimension] = this->m_MovedSobelFilters[iDimension]->GetOutput();
+  }
+
+  return this->ComputeMeasureOfMovedGradients(movedGradients, subtractionFactor);
+
+} // end ComputeMeasure()
+
+
+/**
+ * ******************** ComputeMeasureOfMovedGradients ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasureOfMovedGradients(
+  const MovedGradientImageType * const movedGradients[],
+  const double *                       subtractionFactor) const -> MeasureType
+{
+  unsigned int iDimension;
+  MeasureType  measure{};
 
   typename FixedImageType::IndexType currentIndex;
   typename FixedImageType::PointType point;
@@ -353,10 +456,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
 
     using MovedIteratorType = itk::ImageRegionConstIteratorWithIndex<MovedGradientImageType>;
 
-    MovedIteratorType movedIterator(this->m_MovedSobelFilters[iDimension]->GetOutput(), this->GetFixedImageRegion());
-
-    this->m_FixedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
-    this->m_MovedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
+    MovedIteratorType movedIterator(movedGradients[iDimension], this->GetFixedImageRegion());
 
     bool sampleOK = false;
 
@@ -402,7 +502,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
 
   return measure /= -this->m_Rescalingfactor; // negative for minimization
 
-} // end ComputeMeasure()
+} // end ComputeMeasureOfMovedGradients()
 
 
 /**
@@ -444,6 +544,46 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetValue(const
 } // end GetValue()
 
 
+/**
+ * ******************** ComputeValueUsingPipelineCopy ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeValueUsingPipelineCopy(
+  const unsigned int     copyIndex,
+  const ParametersType & parameters) const -> MeasureType
+{
+  /** Like GetValue(), but by the specified copy of the resampling and Sobel filters, so that it does not change the
+   * transform of this metric, and can be called concurrently for different copies.
+   */
+  this->m_ResamplerPool.SetParameters(copyIndex, parameters);
+
+  const MovedGradientImageType * movedGradients[MovedImageDimension];
+
+  for (unsigned int iDimension = 0; iDimension < MovedImageDimension; ++iDimension)
+  {
+    const auto & movedSobelFilter = this->m_ConcurrentMovedSobelFilters[copyIndex * MovedImageDimension + iDimension];
+    movedSobelFilter->UpdateLargestPossibleRegion();
+    movedGradients[iDimension] = movedSobelFilter->GetOutput();
+  }
+
+  MovedGradientPixelType minMovedGradient[MovedImageDimension];
+  MovedGradientPixelType maxMovedGradient[MovedImageDimension];
+  this->ComputeMovedGradientRange(movedGradients, minMovedGradient, maxMovedGradient);
+
+  MovedGradientPixelType subtractionFactor[FixedImageDimension];
+
+  for (unsigned int iDimension = 0; iDimension < FixedImageDimension; ++iDimension)
+  {
+    subtractionFactor[iDimension] = this->m_MaxFixedGradient[iDimension] / maxMovedGradient[iDimension];
+  }
+
+  return this->ComputeMeasureOfMovedGradients(movedGradients, subtractionFactor);
+
+} // end ComputeValueUsingPipelineCopy()
+
+
 /**
  * ******************** GetDerivative ******************************
  */
@@ -457,6 +597,35 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(c
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   derivative.set_size(numberOfParameters);
 
+  if (this->m_ResamplerPool.GetNumberOfCopies() > 0)
+  {
+    /** Compute the values at the perturbed parameters concurrently, the one at parameters[i] - delta at index 2 * i,
+     * and the one at parameters[i] + delta at index 2 * i + 1. The perturbed parameters are computed like below.
+     */
+    std::vector<MeasureType> values(2 * numberOfParameters);
+
+    this->m_ResamplerPool.EvaluateConcurrently(
+      *this->m_Threader,
+      values.size(),
+      [this, &parameters, &values](const unsigned int copyIndex, const SizeValueType k) {
+        const unsigned int i = k / 2;
+        ParametersType     perturbedPoint = parameters;
+        perturbedPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+        if (k % 2 == 1)
+        {
+          perturbedPoint[i] += 2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+        }
+        values[k] = this->ComputeValueUsingPipelineCopy(copyIndex, perturbedPoint);
+      });
+
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      derivative[i] =
+        (values[2 * i + 1] - values[2 * i]) / (2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]));
+    }
+    return;
+  }
+
   for (unsigned int i = 0; i < numberOfParameters; ++i)
   {
     testPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
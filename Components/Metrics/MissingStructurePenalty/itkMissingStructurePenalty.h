@@ -159,6 +159,8 @@ protected:
   MissingVolumeMeshPenalty();
   ~MissingVolumeMeshPenalty() override = default;
 
+  using typename Superclass::PointContributionsType;
+
   /** PrintSelf. */
   // void PrintSelf(std::ostream& os, Indent indent) const;
 
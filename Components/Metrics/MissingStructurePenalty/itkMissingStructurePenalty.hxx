@@ -163,9 +163,6 @@ MissingVolumeMeshPenalty<TFixedPointSet, TMovingPointSet>::GetValueAndDerivative
   derivative.set_size(this->GetNumberOfParameters());
   derivative.Fill(0.0);
 
-  NonZeroJacobianIndicesType nzji(this->m_Transform->GetNumberOfNonZeroJacobianIndices());
-  TransformJacobianType      jacobian;
-
   const FixedMeshContainerElementIdentifier numberOfMeshes = this->m_FixedMeshContainer->Size();
 
   typename MeshPointsContainerType::Pointer pointCentroids = FixedMeshType::PointsContainer::New();
@@ -187,15 +184,17 @@ MissingVolumeMeshPenalty<TFixedPointSet, TMovingPointSet>::GetValueAndDerivative
 
     derivPoints->resize(numberOfPoints);
 
-    MeshPointsContainerConstIteratorType fixedPointIt = fixedPoints->Begin();
-    MeshPointsContainerIteratorType      mappedPointIt = mappedPoints->Begin();
-    MeshPointsContainerConstIteratorType fixedPointEnd = fixedPoints->End();
+    /** Transform the points, distributed over the work units. */
+    this->ParallelizeOverIndices(numberOfPoints, [this, &fixedPoints, &mappedPoints](const SizeValueType pointIndex) {
+      mappedPoints->ElementAt(pointIndex) = this->m_Transform->TransformPoint(fixedPoints->ElementAt(pointIndex));
+    });
+
+    MeshPointsContainerIteratorType mappedPointIt = mappedPoints->Begin();
+    MeshPointsContainerIteratorType mappedPointEnd = mappedPoints->End();
 
-    for (; fixedPointIt != fixedPointEnd; ++fixedPointIt, ++mappedPointIt)
+    for (; mappedPointIt != mappedPointEnd; ++mappedPointIt)
     {
-      const OutputPointType mappedPoint = this->m_Transform->TransformPoint(fixedPointIt->Value());
-      mappedPointIt.Value() = mappedPoint;
-      pointCentroid.GetVnlVector() += mappedPoint.GetVnlVector();
+      pointCentroid.GetVnlVector() += mappedPointIt.Value().GetVnlVector();
     }
     pointCentroid.GetVnlVector() /= numberOfPoints;
 
@@ -287,31 +286,33 @@ MissingVolumeMeshPenalty<TFixedPointSet, TMovingPointSet>::GetValueAndDerivative
       sumAbsVolume += std::abs(signedVolume);
     }
 
-    /** Create iterators. */
-    fixedPointIt = fixedPoints->Begin();
-    unsigned int pointIndex;
-    /** Loop over points. */
-    for (pointIndex = 0; fixedPointIt != fixedPointEnd; ++fixedPointIt, ++pointIndex)
-    {
-      /** Get the TransformJacobian dT/dmu. */
-      this->m_Transform->GetJacobian(fixedPointIt.Value(), jacobian, nzji);
-      if (nzji.size() == this->GetNumberOfParameters())
-      {
-        /** Loop over all Jacobians. */
-        derivative += derivPoints->at(pointIndex).GetVnlVector() * jacobian; //* sumAbsVolumeEps;
-      }
-      else
-      {
-        /** Only pick the nonzero Jacobians. */
-        for (unsigned int i = 0; i < nzji.size(); ++i)
+    /** Loop over points. Each chunk of points accumulates its own (sparse) derivative. */
+    this->AccumulatePointContributions(
+      numberOfPoints,
+      &derivative,
+      [this, &fixedPoints, &derivPoints](
+        const SizeValueType beginIndex, const SizeValueType endIndex, PointContributionsType & contributions) {
+        NonZeroJacobianIndicesType nzji(this->m_Transform->GetNumberOfNonZeroJacobianIndices());
+        TransformJacobianType      jacobian;
+
+        for (SizeValueType pointIndex = beginIndex; pointIndex < endIndex; ++pointIndex)
         {
-          const unsigned int index = nzji[i];
-          VnlVectorType      column = jacobian.get_column(i);
-          derivative[index] += dot_product(derivPoints->at(pointIndex).GetVnlVector(), column); // *sumAbsVolumeEps;
-        }
-      }
+          /** Get the TransformJacobian dT/dmu. */
+          this->m_Transform->GetJacobian(fixedPoints->ElementAt(pointIndex), jacobian, nzji);
 
-    } // end loop over all corresponding points
+          /** Only pick the nonzero Jacobians. */
+          const MeshPointType & derivPoint = derivPoints->at(pointIndex);
+          for (unsigned int i = 0; i < nzji.size(); ++i)
+          {
+            DerivativeValueType sum{};
+            for (unsigned int d = 0; d < Self::FixedPointSetDimension; ++d)
+            {
+              sum += derivPoint[d] * jacobian(d, i);
+            }
+            contributions.AddToDerivative(nzji[i], sum); // *sumAbsVolumeEps;
+          }
+        }
+      }); // end loop over all corresponding points
 
     /** Check if enough samples were valid. */
 
@@ -29,6 +29,9 @@
 #include "itkRescaleIntensityImageFilter.h"
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkRayCastResamplerPool.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -36,7 +39,9 @@ namespace itk
 /** \class PatternIntensityImageToImageMetric
  * \brief Computes similarity between two objects to be registered
  *
- *
+ * The derivative is computed by central finite differences. When multi-threading is used, the values at the
+ * perturbed parameters are computed concurrently, each by its own copy of the resampling and difference filter
+ * pipeline.
  *
  * \ingroup RegistrationMetrics
  */
@@ -173,7 +178,28 @@ protected:
   MeasureType
   ComputePIDiff(const ParametersType & parameters, float scalingfactor) const;
 
+  /** Compute the pattern intensity of the specified difference image. */
+  MeasureType
+  ComputePIOfDifferenceImage(const TransformedMovingImageType & differenceImage) const;
+
 private:
+  using ResamplerPoolType = RayCastResamplerPool<MovingImageType, TransformedMovingImageType, ScalarType>;
+
+  /** Compute the value from the pattern intensity of the difference image, computed by the specified function for a
+   * given scaling factor of the moved image.
+   */
+  template <typename TComputePIDiff>
+  MeasureType
+  ComputeValueFromPIDiff(const TComputePIDiff & computePIDiff) const;
+
+  /** Set up the copies of the pipeline that are used to compute the derivative concurrently. */
+  void
+  InitializeConcurrentPipelines(RayCastInterpolatorType & rayCaster);
+
+  /** Compute the value for the specified parameters, by the specified copy of the pipeline. */
+  MeasureType
+  ComputeValueUsingPipelineCopy(const unsigned int copyIndex, const ParametersType & parameters) const;
+
   TransformMovingImageFilterPointer  m_TransformMovingImageFilter{ TransformMovingImageFilterType::New() };
   DifferenceImageFilterPointer       m_DifferenceImageFilter{ DifferenceImageFilterType::New() };
   RescaleIntensityImageFilterPointer m_RescaleImageFilter{ RescaleIntensityImageFilterType::New() };
@@ -187,6 +213,11 @@ private:
   ScalesType                         m_Scales{};
   MeasureType                        m_FixedMeasure{ 0 };
   CombinationTransformPointer        m_CombinationTransform{ CombinationTransformType::New() };
+
+  /** The copies of the pipeline that compute the derivative concurrently, and their difference filters. */
+  mutable ResamplerPoolType                 m_ResamplerPool{};
+  std::vector<MultiplyImageFilterPointer>   m_ConcurrentMultiplyImageFilters{};
+  std::vector<DifferenceImageFilterPointer> m_ConcurrentDifferenceImageFilters{};
 };
 
 } // end namespace itk
@@ -22,6 +22,7 @@
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkNumericTraits.h"
 
+#include <algorithm> // For min.
 #include <cmath>
 #include <iostream>
 #include <iomanip>
@@ -73,6 +74,8 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
   this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
   this->m_FixedMeasure = this->ComputePIFixed();
 
+  this->InitializeConcurrentPipelines(*rayCaster);
+
   /* to rescale the similarity measure between 0-1;*/
   MeasureType tmpmeasure = this->GetValue(this->m_Transform->GetParameters());
 
@@ -84,6 +87,53 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
 } // end Initialize()
 
 
+/**
+ * ********************* InitializeConcurrentPipelines ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+void
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::InitializeConcurrentPipelines(
+  RayCastInterpolatorType & rayCaster)
+{
+  this->m_ResamplerPool.Clear();
+  this->m_ConcurrentMultiplyImageFilters.clear();
+  this->m_ConcurrentDifferenceImageFilters.clear();
+
+  if (!this->m_UseMultiThread)
+  {
+    return;
+  }
+
+  /** One copy per work unit, but not more than the number of values per derivative. */
+  const unsigned int numberOfCopies =
+    std::min(this->m_Threader->GetNumberOfWorkUnits(), 2 * this->GetNumberOfParameters());
+
+  if (numberOfCopies < 2 ||
+      !this->m_ResamplerPool.Initialize(rayCaster, *this->m_MovingImage, *this->m_FixedImage, numberOfCopies))
+  {
+    return;
+  }
+
+  for (unsigned int copyIndex = 0; copyIndex < numberOfCopies; ++copyIndex)
+  {
+    const auto multiplyImageFilter = MultiplyImageFilterType::New();
+    multiplyImageFilter->SetInput(this->m_ResamplerPool.GetOutput(copyIndex));
+    multiplyImageFilter->SetConstant(this->m_NormalizationFactor);
+    multiplyImageFilter->SetNumberOfWorkUnits(1);
+
+    const auto differenceImageFilter = DifferenceImageFilterType::New();
+    differenceImageFilter->SetInput1(this->m_FixedImage);
+    differenceImageFilter->SetInput2(multiplyImageFilter->GetOutput());
+    differenceImageFilter->SetNumberOfWorkUnits(1);
+
+    this->m_ConcurrentMultiplyImageFilters.push_back(multiplyImageFilter);
+    this->m_ConcurrentDifferenceImageFilters.push_back(differenceImageFilter);
+  }
+
+} // end InitializeConcurrentPipelines()
+
+
 /**
  * ********************* PrintSelf ******************************
  */
@@ -217,6 +267,21 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
   this->m_TransformMovingImageFilter->Modified();
   this->m_MultiplyImageFilter->SetConstant(scalingfactor);
   this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
+
+  return this->ComputePIOfDifferenceImage(*this->m_DifferenceImageFilter->GetOutput());
+
+} // end ComputePIDiff()
+
+
+/**
+ * ********************* ComputePIOfDifferenceImage ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIOfDifferenceImage(
+  const TransformedMovingImageType & differenceImage) const -> MeasureType
+{
   MeasureType measure{};
   MeasureType diff{};
 
@@ -240,7 +305,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
   iterationRegion.SetSize(iterationSize);
 
   using DifferenceImageIteratorType = itk::ImageRegionConstIteratorWithIndex<TransformedMovingImageType>;
-  DifferenceImageIteratorType differenceImageIt(this->m_DifferenceImageFilter->GetOutput(), iterationRegion);
+  DifferenceImageIteratorType differenceImageIt(&differenceImage, iterationRegion);
 
   neighboriterationRegion.SetSize(neighborIterationSize);
 
@@ -279,7 +344,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
       }
 
       neighboriterationRegion.SetIndex(neighborIndex);
-      DifferenceImageIteratorType neighborIt(this->m_DifferenceImageFilter->GetOutput(), neighboriterationRegion);
+      DifferenceImageIteratorType neighborIt(&differenceImage, neighboriterationRegion);
 
       while (!neighborIt.IsAtEnd())
       {
@@ -295,7 +360,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
 
   return measure;
 
-} // end ComputePIDiff()
+} // end ComputePIOfDifferenceImage()
 
 
 /**
@@ -325,6 +390,23 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetValue(const Pa
 
   this->m_TransformMovingImageFilter->Modified();
   this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
+
+  return this->ComputeValueFromPIDiff(
+    [this, &parameters](const float scalingfactor) { return this->ComputePIDiff(parameters, scalingfactor); });
+
+} // end GetValue()
+
+
+/**
+ * ********************* ComputeValueFromPIDiff ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+template <typename TComputePIDiff>
+auto
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputeValueFromPIDiff(
+  const TComputePIDiff & computePIDiff) const -> MeasureType
+{
   MeasureType measure = 1e10;
   MeasureType currentMeasure = 1e10;
 
@@ -337,7 +419,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetValue(const Pa
 
     while (tmpfactor <= this->m_NormalizationFactor * 1.0)
     {
-      measure = this->ComputePIDiff(parameters, tmpfactor);
+      measure = computePIDiff(tmpfactor);
       tmpMeasure = (measure - this->m_FixedMeasure) / -this->m_Rescalingfactor;
 
       if (tmpMeasure < currentMeasure)
@@ -351,13 +433,40 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetValue(const Pa
   }
   else
   {
-    measure = this->ComputePIDiff(parameters, this->m_NormalizationFactor);
+    measure = computePIDiff(this->m_NormalizationFactor);
     currentMeasure = -(measure - this->m_FixedMeasure) / this->m_Rescalingfactor;
   }
 
   return currentMeasure;
 
-} // end GetValue()
+} // end ComputeValueFromPIDiff()
+
+
+/**
+ * ********************* ComputeValueUsingPipelineCopy ******************************
+ */
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputeValueUsingPipelineCopy(
+  const unsigned int     copyIndex,
+  const ParametersType & parameters) const -> MeasureType
+{
+  /** Like GetValue(), but by the specified copy of the resampling and difference filters, so that it does not change
+   * the transform of this metric, and can be called concurrently for different copies.
+   */
+  this->m_ResamplerPool.SetParameters(copyIndex, parameters);
+
+  const auto & multiplyImageFilter = this->m_ConcurrentMultiplyImageFilters[copyIndex];
+  const auto & differenceImageFilter = this->m_ConcurrentDifferenceImageFilters[copyIndex];
+
+  return this->ComputeValueFromPIDiff([this, &multiplyImageFilter, &differenceImageFilter](const float scalingfactor) {
+    multiplyImageFilter->SetConstant(scalingfactor);
+    differenceImageFilter->UpdateLargestPossibleRegion();
+    return this->ComputePIOfDifferenceImage(*differenceImageFilter->GetOutput());
+  });
+
+} // end ComputeValueUsingPipelineCopy()
 
 
 /**
@@ -373,6 +482,35 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(con
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   derivative.set_size(numberOfParameters);
 
+  if (this->m_ResamplerPool.GetNumberOfCopies() > 0)
+  {
+    /** Compute the values at the perturbed parameters concurrently, the one at parameters[i] - delta at index 2 * i,
+     * and the one at parameters[i] + delta at index 2 * i + 1. The perturbed parameters are computed like below.
+     */
+    std::vector<MeasureType> values(2 * numberOfParameters);
+
+    this->m_ResamplerPool.EvaluateConcurrently(
+      *this->m_Threader,
+      values.size(),
+      [this, &parameters, &values](const unsigned int copyIndex, const SizeValueType k) {
+        const unsigned int i = k / 2;
+        ParametersType     perturbedPoint = parameters;
+        perturbedPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+        if (k % 2 == 1)
+        {
+          perturbedPoint[i] += 2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+        }
+        values[k] = this->ComputeValueUsingPipelineCopy(copyIndex, perturbedPoint);
+      });
+
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      derivative[i] =
+        (values[2 * i + 1] - values[2 * i]) / (2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]));
+    }
+    return;
+  }
+
   for (unsigned int i = 0; i < numberOfParameters; ++i)
   {
     testPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
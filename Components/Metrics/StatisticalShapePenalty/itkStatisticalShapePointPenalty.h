@@ -94,9 +94,6 @@ public:
   using CoordinateType = typename OutputPointType::CoordinateType;
   using VnlVectorType = vnl_vector<CoordinateType>;
   using VnlMatrixType = vnl_matrix<CoordinateType>;
-  // typedef itk::Array<VnlVectorType *> ProposalDerivativeType;
-  using ProposalDerivativeType = typename std::vector<VnlVectorType *>;
-  // typedef typename vnl_vector<VnlVectorType *> ProposalDerivativeType; //Cannot be linked
   using PCACovarianceType = vnl_svd_economy<CoordinateType>;
 
   /** Initialization. */
@@ -176,28 +173,25 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  using typename Superclass::PointContributionsType;
+
 private:
+  /** Fills the proposal vector with the transformed points, aligned and normalized for a normalized shape model. */
   void
-  FillProposalVector(const OutputPointType & fixedPoint, const unsigned int vertexindex) const;
+  ComputeProposalVector(const unsigned int shapeLength) const;
 
   void
-  FillProposalDerivative(const OutputPointType & fixedPoint, const unsigned int vertexindex) const;
+  FillProposalVector(const OutputPointType & fixedPoint, const unsigned int vertexindex) const;
 
   void
   UpdateCentroidAndAlignProposalVector(const unsigned int shapeLength) const;
 
-  void
-  UpdateCentroidAndAlignProposalDerivative(const unsigned int shapeLength) const;
-
   void
   UpdateL2(const unsigned int shapeLength) const;
 
   void
   NormalizeProposalVector(const unsigned int shapeLength) const;
 
-  void
-  UpdateL2AndNormalizeProposalDerivative(const unsigned int shapeLength) const;
-
   void
   CalculateValue(MeasureType &   value,
                  VnlVectorType & differenceVector,
@@ -211,6 +205,10 @@ private:
                       const VnlVectorType & eigrot,
                       const unsigned int    shapeLength) const;
 
+  /** Returns vector^T * V, for the eigenvectors V of the shape model. */
+  VnlVectorType
+  ProjectOnEigenVectors(const VnlVectorType & vector) const;
+
   void
   CalculateCutOffValue(MeasureType & value) const;
 
@@ -239,15 +237,17 @@ private:
 
   VnlVectorType * m_EigenValuesRegularized{};
 
-  mutable ProposalDerivativeType * m_ProposalDerivative{};
-  unsigned int                     m_ProposalLength{};
-  bool                             m_NormalizedShapeModel{};
-  int                              m_ShapeModelCalculation{};
-  double                           m_ShrinkageIntensity{};
-  double                           m_BaseVariance{};
-  double                           m_BaseStd{};
-  mutable VnlVectorType            m_ProposalVector{};
-  mutable VnlVectorType            m_MeanValues{};
+  /** The standard deviations by which the elements of the proposal vector are scaled (ShapeModelCalculation 2). */
+  VnlVectorType m_ProposalStandardDeviations{};
+
+  unsigned int          m_ProposalLength{};
+  bool                  m_NormalizedShapeModel{};
+  int                   m_ShapeModelCalculation{};
+  double                m_ShrinkageIntensity{};
+  double                m_BaseVariance{};
+  double                m_BaseStd{};
+  mutable VnlVectorType m_ProposalVector{};
+  mutable VnlVectorType m_MeanValues{};
 
   double m_CutOffValue{};
   double m_CutOffSharpness{};
@@ -34,7 +34,6 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::StatisticalShapeP
   this->m_EigenVectors = nullptr;
   this->m_EigenValues = nullptr;
   this->m_EigenValuesRegularized = nullptr;
-  this->m_ProposalDerivative = nullptr;
   this->m_InverseCovarianceMatrix = nullptr;
 
   this->m_ShrinkageIntensityNeedsUpdate = true;
@@ -76,11 +75,6 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::~StatisticalShape
     delete this->m_EigenValuesRegularized;
     this->m_EigenValuesRegularized = nullptr;
   }
-  if (this->m_ProposalDerivative != nullptr)
-  {
-    delete this->m_ProposalDerivative;
-    this->m_ProposalDerivative = nullptr;
-  }
   if (this->m_InverseCovarianceMatrix != nullptr)
   {
     delete this->m_InverseCovarianceMatrix;
@@ -323,6 +317,17 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::Initialize()
           this->m_EigenValuesRegularized = new VnlVectorType(*this->m_EigenValues);
         }
       }
+      /** Cache the standard deviations by which the elements of the proposal vector are scaled. */
+      this->m_ProposalStandardDeviations.set_size(this->m_ProposalLength);
+      this->m_ProposalStandardDeviations.fill(this->m_BaseStd);
+      const double tailStandardDeviations[] = {
+        this->m_CentroidXStd, this->m_CentroidYStd, this->m_CentroidZStd, this->m_SizeStd
+      };
+      for (unsigned int i = 0; i < 4 && shapeLength + i < this->m_ProposalLength; ++i)
+      {
+        this->m_ProposalStandardDeviations[shapeLength + i] = tailStandardDeviations[i];
+      }
+
       this->m_ShrinkageIntensityNeedsUpdate = false;
       this->m_BaseVarianceNeedsUpdate = false;
       this->m_VariancesNeedsUpdate = false;
@@ -346,49 +351,15 @@ auto
 StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::GetValue(const ParametersType & parameters) const
   -> MeasureType
 {
-  const auto & fixedPoints = this->Superclass::GetFixedPoints();
+  const unsigned int shapeLength = Self::FixedPointSetDimension * this->Superclass::GetFixedPoints().size();
 
   /** Initialize some variables */
-  // this->m_NumberOfPointsCounted = 0;
   MeasureType value{};
 
   /** Make sure the transform parameters are up to date. */
   this->SetTransformParameters(parameters);
 
-  const unsigned int shapeLength = Self::FixedPointSetDimension * fixedPoints.size();
-  this->m_ProposalVector.set_size(this->m_ProposalLength);
-
-  /** Part 1:
-   * - Copy point positions in proposal vector
-   */
-
-  unsigned int vertexindex = 0;
-  /** Loop over the points. */
-  for (const OutputPointType & fixedPoint : fixedPoints)
-  {
-    this->FillProposalVector(fixedPoint, vertexindex);
-
-    this->m_NumberOfPointsCounted++;
-    vertexindex += Self::FixedPointSetDimension;
-  }
-
-  if (this->m_NormalizedShapeModel)
-  {
-    /** Part 2:
-     * - Calculate shape centroid
-     * - put centroid values in proposal
-     * - update proposal vector with aligned shape
-     */
-    this->UpdateCentroidAndAlignProposalVector(shapeLength);
-
-    /** Part 3:
-     * - Calculate l2-norm from aligned shapes
-     * - put l2-norm value in proposal vector
-     * - update proposal vector with size normalized shape
-     */
-    this->UpdateL2(shapeLength);
-    this->NormalizeProposalVector(shapeLength);
-  }
+  this->ComputeProposalVector(shapeLength);
 
   VnlVectorType differenceVector;
   VnlVectorType centerrotated;
@@ -431,10 +402,9 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::GetValueAndDeriva
                                                                                      MeasureType &          value,
                                                                                      DerivativeType & derivative) const
 {
-  const auto & fixedPoints = this->Superclass::GetFixedPoints();
+  const unsigned int shapeLength = Self::FixedPointSetDimension * this->Superclass::GetFixedPoints().size();
 
   /** Initialize some variables */
-  // this->m_NumberOfPointsCounted = 0;
   value = MeasureType{};
   derivative.set_size(this->GetNumberOfParameters());
   derivative.Fill(0.0);
@@ -442,26 +412,47 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::GetValueAndDeriva
   /** Make sure the transform parameters are up to date. */
   this->SetTransformParameters(parameters);
 
-  const unsigned int shapeLength = Self::FixedPointSetDimension * fixedPoints.size();
+  this->ComputeProposalVector(shapeLength);
+
+  // TODO this declaration instantiates a zero sized vector, but it will be reassigned anyways.
+  VnlVectorType differenceVector;
+  VnlVectorType centerrotated;
+  VnlVectorType eigrot;
+
+  this->CalculateValue(value, differenceVector, centerrotated, eigrot);
+
+  if (value != 0.0)
+  {
+    this->CalculateDerivative(derivative, value, differenceVector, eigrot, shapeLength);
+  }
+
+  this->CalculateCutOffValue(value);
+
+} // end GetValueAndDerivative()
+
+
+/**
+ * ******************* ComputeProposalVector *******************
+ */
+
+template <typename TFixedPointSet, typename TMovingPointSet>
+void
+StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::ComputeProposalVector(
+  const unsigned int shapeLength) const
+{
+  const auto & fixedPoints = this->Superclass::GetFixedPoints();
 
   this->m_ProposalVector.set_size(this->m_ProposalLength);
-  this->m_ProposalDerivative = new ProposalDerivativeType(this->GetNumberOfParameters(), nullptr);
 
   /** Part 1:
    * - Copy point positions in proposal vector
-   * - Copy point derivatives in proposal derivative vector
    */
 
-  unsigned int vertexindex = 0;
-  /** Loop over the points. */
-  for (const OutputPointType & fixedPoint : fixedPoints)
-  {
-    this->FillProposalVector(fixedPoint, vertexindex);
-    this->FillProposalDerivative(fixedPoint, vertexindex);
-
-    this->m_NumberOfPointsCounted++;
-    vertexindex += Self::FixedPointSetDimension;
-  }
+  /** Loop over the points, distributed over the work units. */
+  this->ParallelizeOverIndices(fixedPoints.size(), [this, &fixedPoints](const SizeValueType pointIndex) {
+    this->FillProposalVector(fixedPoints[pointIndex], pointIndex * Self::FixedPointSetDimension);
+  });
+  this->m_NumberOfPointsCounted = fixedPoints.size();
 
   if (this->m_NormalizedShapeModel)
   {
@@ -469,56 +460,19 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::GetValueAndDeriva
      * - Calculate shape centroid
      * - put centroid values in proposal
      * - update proposal vector with aligned shape
-     * - Calculate centroid derivatives and update proposal derivative vectors
-     * - put centroid derivatives values in proposal derivatives
-     * - update proposal derivatives
      */
     this->UpdateCentroidAndAlignProposalVector(shapeLength);
-    this->UpdateCentroidAndAlignProposalDerivative(shapeLength);
 
     /** Part 3:
      * - Calculate l2-norm from aligned shapes
      * - put l2-norm value in proposal vector
      * - update proposal vector with size normalized shape
-     * - Calculate l2-norm derivatice from updated proposal vector
-     * - put l2-norm derivative value in proposal derivative vectors
-     * - update proposal derivatives
      */
     this->UpdateL2(shapeLength);
-    this->UpdateL2AndNormalizeProposalDerivative(shapeLength);
     this->NormalizeProposalVector(shapeLength);
-
-  } // end if(m_NormalizedShapeModel)
-
-  // TODO this declaration instantiates a zero sized vector, but it will be reassigned anyways.
-  VnlVectorType differenceVector;
-  VnlVectorType centerrotated;
-  VnlVectorType eigrot;
-
-  this->CalculateValue(value, differenceVector, centerrotated, eigrot);
-
-  if (value != 0.0)
-  {
-    this->CalculateDerivative(derivative, value, differenceVector, eigrot, shapeLength);
-  }
-  else
-  {
-    auto proposalDerivativeIt = this->m_ProposalDerivative->begin();
-    auto proposalDerivativeEnd = this->m_ProposalDerivative->end();
-    for (; proposalDerivativeIt != proposalDerivativeEnd; ++proposalDerivativeIt)
-    {
-      if (*proposalDerivativeIt != nullptr)
-      {
-        delete *proposalDerivativeIt;
-      }
-    }
   }
-  delete this->m_ProposalDerivative;
-  this->m_ProposalDerivative = nullptr;
-
-  this->CalculateCutOffValue(value);
 
-} // end GetValueAndDerivative()
+} // end ComputeProposalVector()
 
 
 /**
@@ -542,55 +496,6 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::FillProposalVecto
 } // end FillProposalVector()
 
 
-/**
- * ******************* FillProposalDerivative *******************
- */
-
-template <typename TFixedPointSet, typename TMovingPointSet>
-void
-StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::FillProposalDerivative(
-  const OutputPointType & fixedPoint,
-  const unsigned int      vertexindex) const
-{
-  /**
-   * A (column) vector is constructed for each mu, only if that mu affects the shape penalty.
-   * I.e. if there is at least one point of the mesh with non-zero derivatives,
-   * a full column vector is instantiated (which can contain zeros for many other points)
-   *
-   * m_ProposalDerivative is a container with either full shape-vector-sized derivative vectors or NULL-s. Example:
-   *
-   * mu1: [ [ dx1/dmu1 , dy1/dmu1 , dz1/dmu1 ] , [ 0 , 0 , 0 ] , [ dx3/dmu1 , dy3/dmu1 , dz3/dmu1 ] , [...] ]^T
-   * mu2: Null
-   * mu3: [ [ 0 , 0 , 0 ] , [ dx2/dmu3 , dy2/dmu3 , dz2/dmu3 ] , [ dx3/dmu3 , dy3/dmu3 , dz3/dmu3 ] , [...] ]^T
-   *
-   */
-
-  NonZeroJacobianIndicesType nzji(this->m_Transform->GetNumberOfNonZeroJacobianIndices());
-
-  /** Get the TransformJacobian dT/dmu. */
-  TransformJacobianType jacobian;
-  this->m_Transform->GetJacobian(fixedPoint, jacobian, nzji);
-
-  for (unsigned int i = 0; i < nzji.size(); ++i)
-  {
-    const unsigned int mu = nzji[i];
-    if ((*this->m_ProposalDerivative)[mu] == nullptr)
-    {
-      /** Create the big column vector if it does not yet exist for this mu*/
-      (*this->m_ProposalDerivative)[mu] = new VnlVectorType(this->m_ProposalLength, 0.0);
-      // memory will be freed in CalculateDerivative()
-    }
-
-    /** The column vector exists for this mu, so copy the jacobians for this point into the big vector. */
-    for (unsigned int d = 0; d < Self::FixedPointSetDimension; ++d)
-    {
-      (*(*this->m_ProposalDerivative)[mu])[vertexindex + d] = jacobian.get_column(i)[d];
-    }
-  }
-
-} // end FillProposalVector()
-
-
 /**
  * ******************* UpdateCentroidAndAlignProposalVector *******************
  */
@@ -627,44 +532,6 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::UpdateCentroidAnd
 } // end UpdateCentroidAndAlignProposalVector()
 
 
-/**
- * ******************* UpdateCentroidAndAlignProposalDerivative *******************
- */
-
-template <typename TFixedPointSet, typename TMovingPointSet>
-void
-StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::UpdateCentroidAndAlignProposalDerivative(
-  const unsigned int shapeLength) const
-{
-  auto proposalDerivativeIt = m_ProposalDerivative->begin();
-  auto proposalDerivativeEnd = m_ProposalDerivative->end();
-  while (proposalDerivativeIt != proposalDerivativeEnd)
-  {
-    if (*proposalDerivativeIt != nullptr)
-    {
-      for (unsigned int d = 0; d < Self::FixedPointSetDimension; ++d)
-      {
-        double & centroid_dDerivative = (**proposalDerivativeIt)[shapeLength + d];
-        centroid_dDerivative = 0; // initialize accumulators to zero
-
-        for (unsigned int index = 0; index < shapeLength; index += Self::FixedPointSetDimension)
-        {
-          centroid_dDerivative += (**proposalDerivativeIt)[index + d]; // sum all x derivatives
-        }
-
-        centroid_dDerivative /= this->GetFixedPointSet()->GetNumberOfPoints(); // divide sum to get average
-
-        for (unsigned int index = 0; index < shapeLength; index += Self::FixedPointSetDimension)
-        {
-          (**proposalDerivativeIt)[index + d] -= centroid_dDerivative; // subtract average
-        }
-      }
-    }
-    ++proposalDerivativeIt;
-  }
-} // end UpdateCentroidAndAlignProposalDerivative()
-
-
 /**
  * ******************* UpdateL2 *******************
  */
@@ -708,47 +575,6 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::NormalizeProposal
 } // end NormalizeProposalVector()
 
 
-/**
- * ******************* UpdateL2AndNormalizeProposalDerivative *******************
- */
-
-template <typename TFixedPointSet, typename TMovingPointSet>
-void
-StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::UpdateL2AndNormalizeProposalDerivative(
-  const unsigned int shapeLength) const
-{
-  double & l2norm = this->m_ProposalVector[shapeLength + Self::FixedPointSetDimension];
-
-  auto proposalDerivativeIt = this->m_ProposalDerivative->begin();
-  auto proposalDerivativeEnd = this->m_ProposalDerivative->end();
-
-  while (proposalDerivativeIt != proposalDerivativeEnd)
-  {
-    if (*proposalDerivativeIt != nullptr)
-    {
-      double & l2normDerivative = (**proposalDerivativeIt)[shapeLength + Self::FixedPointSetDimension];
-      l2normDerivative = 0; // initialize to zero
-      // loop over all shape coordinates of the aligned shape
-      for (unsigned int index = 0; index < shapeLength; ++index)
-      {
-        l2normDerivative += this->m_ProposalVector[index] * (**proposalDerivativeIt)[index];
-      }
-      l2normDerivative /= (l2norm * sqrt((double)(this->GetFixedPointSet()->GetNumberOfPoints())));
-
-      // loop over all shape coordinates of the aligned shape
-      for (unsigned int index = 0; index < shapeLength; ++index)
-      {
-        // update normalized shape derivatives
-        (**proposalDerivativeIt)[index] = (**proposalDerivativeIt)[index] / l2norm -
-                                          this->m_ProposalVector[index] * l2normDerivative / (l2norm * l2norm);
-      }
-    }
-    ++proposalDerivativeIt;
-  }
-
-} // end UpdateL2AndNormalizeProposalDerivative()
-
-
 /**
  * ******************* CalculateValue *******************
  */
@@ -771,7 +597,7 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::CalculateValue(Me
     }
     case 1: // decomposed covariance (uniform regularization)
     {
-      centerrotated = differenceVector * *m_EigenVectors;                  /** diff^T * V */
+      centerrotated = this->ProjectOnEigenVectors(differenceVector);       /** diff^T * V */
       eigrot = element_quotient(centerrotated, *m_EigenValuesRegularized); /** diff^T * V * Lambda^-1 */
       if (this->m_ShrinkageIntensity != 0)
       {
@@ -788,18 +614,10 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::CalculateValue(Me
     }
     case 2: // decomposed scaled covariance (element specific regularization)
     {
-      const unsigned int               shapeLength = this->m_ProposalLength - Self::FixedPointSetDimension - 1;
-      typename VnlVectorType::iterator diffElementIt = differenceVector.begin();
-      for (unsigned int diffElementIndex = 0; diffElementIndex < shapeLength; ++diffElementIndex, ++diffElementIt)
-      {
-        *diffElementIt /= this->m_BaseStd;
-      }
-      differenceVector[shapeLength] /= this->m_CentroidXStd;
-      differenceVector[shapeLength + 1] /= this->m_CentroidYStd;
-      differenceVector[shapeLength + 2] /= this->m_CentroidZStd;
-      differenceVector[shapeLength + 3] /= this->m_SizeStd;
+      /** Scale the elements by their (cached) standard deviations. */
+      differenceVector = element_quotient(differenceVector, this->m_ProposalStandardDeviations);
 
-      centerrotated = differenceVector * (*this->m_EigenVectors);                /** diff^T * V */
+      centerrotated = this->ProjectOnEigenVectors(differenceVector);             /** diff^T * V */
       eigrot = element_quotient(centerrotated, *this->m_EigenValuesRegularized); /** diff^T * V * Lambda^-1 */
       if (this->m_ShrinkageIntensity != 0)
       {
@@ -835,90 +653,157 @@ StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::CalculateDerivati
   const VnlVectorType & eigrot,
   const unsigned int    shapeLength) const
 {
-  auto proposalDerivativeIt = this->m_ProposalDerivative->begin();
-  auto proposalDerivativeEnd = this->m_ProposalDerivative->end();
+  /** The derivative of value^2 / 2 with respect to the proposal vector is computed once, by a single back-projection
+   * onto the shape space, rather than projecting the derivative of the proposal vector for each parameter.
+   */
+  VnlVectorType proposalGradient;
+  switch (this->m_ShapeModelCalculation)
+  {
+    case 0: // full covariance
+    {
+      /** Sigma^-1 * diff */
+      proposalGradient = differenceVector * (*this->m_InverseCovarianceMatrix);
+      break;
+    }
+    case 1: // decomposed covariance (uniform regularization)
+    {
+      /** V * Lambda^-1 * V^T * diff + 1/(Beta*sigma_0^2) * diff */
+      proposalGradient = (*this->m_EigenVectors) * eigrot;
+      if (this->m_ShrinkageIntensity != 0)
+      {
+        proposalGradient += differenceVector / (this->m_ShrinkageIntensity * this->m_BaseVariance);
+      }
+      break;
+    }
+    case 2: // decomposed scaled covariance (element specific regularization)
+    {
+      /** V * Lambda^-1 * V^T * diff + 1/Beta * diff, of the scaled difference vector */
+      proposalGradient = (*this->m_EigenVectors) * eigrot;
+      if (this->m_ShrinkageIntensity != 0)
+      {
+        proposalGradient += differenceVector / this->m_ShrinkageIntensity;
+      }
+      /** The chain rule for the scaling by the standard deviations. */
+      proposalGradient = element_quotient(proposalGradient, this->m_ProposalStandardDeviations);
+      break;
+    }
+    default:
+      return;
+  }
 
-  typename DerivativeType::iterator derivativeIt = derivative.begin();
+  /** The chain rule through the alignment of the centroid and the normalization of the size turns the gradient
+   * into a weight vector for each point, such that the derivative with respect to a parameter mu is the sum over the
+   * points of weight^T * dT/dmu. This way, only the Jacobians of the points in the support of mu are visited.
+   */
+  const auto &        fixedPoints = this->Superclass::GetFixedPoints();
+  const SizeValueType numberOfPoints = fixedPoints.size();
+  VnlVectorType       pointWeights = proposalGradient.extract(shapeLength);
 
-  for (; proposalDerivativeIt != proposalDerivativeEnd; ++proposalDerivativeIt, ++derivativeIt)
+  if (this->m_NormalizedShapeModel)
   {
-    if (*proposalDerivativeIt != nullptr)
+    constexpr unsigned int dimension = Self::FixedPointSetDimension;
+    const double           l2norm = this->m_ProposalVector[shapeLength + dimension];
+
+    /** The sums over the points, per dimension, of the gradient and of the normalized shape. */
+    double gradientSums[dimension]{};
+    double shapeSums[dimension]{};
+    double gradientDotShape{};
+    for (unsigned int index = 0; index < shapeLength; ++index)
+    {
+      gradientSums[index % dimension] += proposalGradient[index];
+      shapeSums[index % dimension] += this->m_ProposalVector[index];
+      gradientDotShape += proposalGradient[index] * this->m_ProposalVector[index];
+    }
+
+    /** The weight of the derivative of the l2-norm, as computed by the proposal vector. */
+    const double sizeWeight =
+      (proposalGradient[shapeLength + dimension] - gradientDotShape / l2norm) / (l2norm * std::sqrt(numberOfPoints));
+
+    double centroidWeights[dimension];
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      centroidWeights[d] = (proposalGradient[shapeLength + d] - gradientSums[d] / l2norm -
+                            sizeWeight * l2norm * shapeSums[d]) /
+                           numberOfPoints;
+    }
+
+    for (unsigned int index = 0; index < shapeLength; ++index)
     {
-      switch (this->m_ShapeModelCalculation)
+      pointWeights[index] = proposalGradient[index] / l2norm + sizeWeight * l2norm * this->m_ProposalVector[index] +
+                            centroidWeights[index % dimension];
+    }
+  }
+
+  /** Loop over the points. Each chunk of points accumulates its own (sparse) derivative. */
+  this->AccumulatePointContributions(
+    numberOfPoints,
+    &derivative,
+    [this, &fixedPoints, &pointWeights](
+      const SizeValueType beginIndex, const SizeValueType endIndex, PointContributionsType & contributions) {
+      NonZeroJacobianIndicesType nzji(this->m_Transform->GetNumberOfNonZeroJacobianIndices());
+      TransformJacobianType      jacobian;
+
+      for (SizeValueType pointIndex = beginIndex; pointIndex < endIndex; ++pointIndex)
       {
-        case 0: // full covariance
-        {
-          /**innerproduct diff^T * Sigma^-1 * d/dmu (diff), where iterated over mu-s*/
-          *derivativeIt = bracket(differenceVector, *m_InverseCovarianceMatrix, (**proposalDerivativeIt)) / value;
-          this->CalculateCutOffDerivative(*derivativeIt, value);
-          break;
-        }
-        case 1: // decomposed covariance (uniform regularization)
-        {
-          if (this->m_ShrinkageIntensity != 0)
-          {
-            /** Innerproduct diff^T * V * Lambda^-1 * V^T * d/dmu(diff)
-             * + 1/(Beta*sigma_0^2)*diff^T* d/dmu(diff), where iterated over mu-s
-             */
-            *derivativeIt = (dot_product(eigrot, this->m_EigenVectors->transpose() * (**proposalDerivativeIt)) +
-                             dot_product(differenceVector, **proposalDerivativeIt) /
-                               (this->m_ShrinkageIntensity * this->m_BaseVariance)) /
-                            value;
-            this->CalculateCutOffDerivative(*derivativeIt, value);
-          }
-          else // m_ShrinkageIntensity==0
-          {
-            /**innerproduct diff^T * V * Lambda^-1 * V^T * d/dmu (diff), where iterated over mu-s*/
-            *derivativeIt = (dot_product(eigrot, this->m_EigenVectors->transpose() * (**proposalDerivativeIt))) / value;
-            this->CalculateCutOffDerivative(*derivativeIt, value);
-          }
-          break;
-        }
-        case 2: // decomposed scaled covariance (element specific regularization)
+        ++contributions.numberOfPointsCounted;
+
+        /** Get the TransformJacobian dT/dmu. */
+        this->m_Transform->GetJacobian(fixedPoints[pointIndex], jacobian, nzji);
+
+        const double * const pointWeight = pointWeights.data_block() + pointIndex * Self::FixedPointSetDimension;
+        for (unsigned int i = 0; i < nzji.size(); ++i)
         {
-          // first scale proposalDerivatives with their sigma's in order to evaluate
-          // with the EigenValues and EigenVectors of the scaled CovarianceMatrix
-          typename VnlVectorType::iterator propDerivElementIt = (*proposalDerivativeIt)->begin();
-          for (unsigned int propDerivElementIndex = 0; propDerivElementIndex < shapeLength;
-               ++propDerivElementIndex, ++propDerivElementIt)
-          {
-            *propDerivElementIt /= this->m_BaseStd;
-          }
-          (**proposalDerivativeIt)[shapeLength] /= this->m_CentroidXStd;
-          (**proposalDerivativeIt)[shapeLength + 1] /= this->m_CentroidYStd;
-          (**proposalDerivativeIt)[shapeLength + 2] /= this->m_CentroidZStd;
-          (**proposalDerivativeIt)[shapeLength + 3] /= this->m_SizeStd;
-          if (this->m_ShrinkageIntensity != 0)
+          DerivativeValueType sum{};
+          for (unsigned int d = 0; d < Self::FixedPointSetDimension; ++d)
           {
-            /** innerproduct diff^T * V * Lambda^-1 * V^T * d/dmu(diff)
-             * + 1/(Beta*sigma_0^2)*diff^T* d/dmu(diff), where iterated over mu-s
-             */
-            *derivativeIt = (dot_product(eigrot, this->m_EigenVectors->transpose() * (**proposalDerivativeIt)) +
-                             dot_product(differenceVector, **proposalDerivativeIt) / this->m_ShrinkageIntensity) /
-                            value;
-            this->CalculateCutOffDerivative(*derivativeIt, value);
+            sum += pointWeight[d] * jacobian(d, i);
           }
-          else // m_ShrinkageIntensity==0
-          {
-            /**innerproduct diff^T * V * Lambda^-1 * V^T * d/dmu (diff), where iterated over mu-s*/
-            *derivativeIt = (dot_product(eigrot, this->m_EigenVectors->transpose() * (**proposalDerivativeIt))) / value;
-            this->CalculateCutOffDerivative(*derivativeIt, value);
-          }
-          break;
-        }
-        default:
-        {
+          contributions.AddToDerivative(nzji[i], sum);
         }
-
-          delete *proposalDerivativeIt;
-          // nzjacs++;
       }
-    }
+    });
+
+  for (auto & derivativeElement : derivative)
+  {
+    derivativeElement /= value;
+    this->CalculateCutOffDerivative(derivativeElement, value);
   }
 
 } // end CalculateDerivative()
 
 
+/**
+ * ******************* ProjectOnEigenVectors *******************
+ */
+
+template <typename TFixedPointSet, typename TMovingPointSet>
+auto
+StatisticalShapePointPenalty<TFixedPointSet, TMovingPointSet>::ProjectOnEigenVectors(const VnlVectorType & vector) const
+  -> VnlVectorType
+{
+  /** Computes vector^T * V row by row, so that the (row-major) eigenvector matrix is traversed contiguously, one
+   * block of rows per point, and the inner loop over the modes can be vectorized.
+   */
+  const VnlMatrixType & eigenVectors = *this->m_EigenVectors;
+  const unsigned int    numberOfModes = eigenVectors.cols();
+
+  VnlVectorType  projection(numberOfModes, 0.0);
+  double * const projectionData = projection.data_block();
+
+  for (unsigned int row = 0; row < eigenVectors.rows(); ++row)
+  {
+    const double         element = vector[row];
+    const double * const eigenVectorRow = eigenVectors[row];
+    for (unsigned int mode = 0; mode < numberOfModes; ++mode)
+    {
+      projectionData[mode] += element * eigenVectorRow[mode];
+    }
+  }
+  return projection;
+
+} // end ProjectOnEigenVectors()
+
+
 /**
  * ******************* CalculateCutOffValue *******************
  */
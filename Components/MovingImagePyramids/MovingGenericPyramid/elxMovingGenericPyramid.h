@@ -60,6 +60,17 @@ namespace elastix
  * ImagePyramidUseShrinkImageFilter: Flag to specify if the ShrinkingImageFilter is used for rescaling the image, or the
  * ResampleImageFilter. Shrinker is faster.\n example: <tt>(ImagePyramidUseShrinkImageFilter "true")</tt>\n Default
  * false, so by default the resampler is used.
+ * \parameter ComputePyramidImagesInMaskBoundingBox: Flag to specify if the pyramid images are only
+ *    computed within the bounding box of the moving mask. Latter saves time and memory when the
+ *    mask only covers a small part of the image. Requires exactly one moving mask.\n
+ *    example: <tt>(ComputePyramidImagesInMaskBoundingBox "true")</tt>\n
+ *    Default false.
+ * \parameter ComputePyramidImagesCascaded: Flag to specify if the pyramid images are computed in
+ *    a cascade, from fine to coarse, each level from the next finer level. Latter saves time for
+ *    large images, and closely approximates the default result. Only used when all resolution
+ *    levels are computed at once.\n
+ *    example: <tt>(ComputePyramidImagesCascaded "true")</tt>\n
+ *    Default false.
  *
  * \ingroup ImagePyramids
  */
@@ -106,6 +117,7 @@ public:
   using typename Superclass1::ScheduleType;
   using typename Superclass1::RescaleScheduleType;
   using typename Superclass1::SmoothingScheduleType;
+  using typename Superclass1::PointType;
 
   /** Typedefs inherited from Elastix. */
   using typename Superclass2::ElastixType;
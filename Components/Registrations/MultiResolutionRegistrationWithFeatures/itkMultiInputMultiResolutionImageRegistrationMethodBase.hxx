@@ -414,6 +414,13 @@ MultiInputMultiResolutionImageRegistrationMethodBase<TFixedImage, TMovingImage>:
         this->m_FixedImageRegionPyramids[i][level].SetSize(size);
         this->m_FixedImageRegionPyramids[i][level].SetIndex(start);
 
+        /** The pyramid may restrict its output to a region of interest. */
+        FixedImageRegionType croppedRegion = this->m_FixedImageRegionPyramids[i][level];
+        if (croppedRegion.Crop(fixedImageAtLevel->GetLargestPossibleRegion()))
+        {
+          this->m_FixedImageRegionPyramids[i][level] = croppedRegion;
+        }
+
       } // end for loop over res levels
 
     } // end if fixpyr!=0
@@ -19,7 +19,7 @@
 #define elxBSplineResampleInterpolatorFloat_h
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
-#include "itkBSplineInterpolateImageFunction.h"
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
 
 namespace elastix
 {
@@ -52,9 +52,9 @@ namespace elastix
 
 template <typename TElastix>
 class ITK_TEMPLATE_EXPORT BSplineResampleInterpolatorFloat
-  : public itk::BSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
-                                                typename ResampleInterpolatorBase<TElastix>::CoordinateType,
-                                                float>
+  : public itk::AdvancedBSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
+                                                        typename ResampleInterpolatorBase<TElastix>::CoordinateType,
+                                                        float>
   , // CoefficientType
     public ResampleInterpolatorBase<TElastix>
 {
@@ -63,9 +63,10 @@ public:
 
   /** Standard ITK-stuff. */
   using Self = BSplineResampleInterpolatorFloat;
-  using Superclass1 = itk::BSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
-                                                           typename ResampleInterpolatorBase<TElastix>::CoordinateType,
-                                                           float>;
+  using Superclass1 =
+    itk::AdvancedBSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
+                                                 typename ResampleInterpolatorBase<TElastix>::CoordinateType,
+                                                 float>;
   using Superclass2 = ResampleInterpolatorBase<TElastix>;
   using Pointer = itk::SmartPointer<Self>;
   using ConstPointer = itk::SmartPointer<const Self>;
@@ -110,6 +111,15 @@ public:
   void
   BeforeRegistration() override;
 
+  /** Execute stuff after each resolution:
+   * \li At the last resolution, share the B-spline coefficients that the interpolator of the registration has
+   * computed from the moving image, so that the final resampling can reuse them, instead of computing them once more.
+   * They are only reused when the image at the last resolution is equal to the moving image, and when the
+   * BSplineInterpolationOrder of the last resolution is equal to the FinalBSplineInterpolationOrder.
+   */
+  void
+  AfterEachResolution() override;
+
   /** Function to read transform-parameters from a file. */
   void
   ReadFromFile() override;
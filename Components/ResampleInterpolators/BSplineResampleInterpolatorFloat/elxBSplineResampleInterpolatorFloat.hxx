@@ -46,6 +46,27 @@ BSplineResampleInterpolatorFloat<TElastix>::BeforeRegistration()
 } // end BeforeRegistration()
 
 
+/*
+ * ******************* AfterEachResolution ***********************
+ */
+
+template <typename TElastix>
+void
+BSplineResampleInterpolatorFloat<TElastix>::AfterEachResolution()
+{
+  const auto * const registration = this->m_Registration->GetAsITKBaseType();
+
+  if (registration->GetCurrentLevel() + 1 == registration->GetNumberOfLevels())
+  {
+    /** Nothing is shared when the interpolator of the registration is of another type, for example when it has
+     * another coefficient type. */
+    this->ShareCoefficientsOf(
+      dynamic_cast<const Superclass1 *>(this->GetElastix()->GetElxInterpolatorBase()->GetAsITKBaseType()));
+  }
+
+} // end AfterEachResolution()
+
+
 /*
  * ******************* ReadFromFile  ****************************
  */
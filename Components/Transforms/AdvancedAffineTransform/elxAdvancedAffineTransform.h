@@ -62,6 +62,11 @@ namespace elastix
  *    transform. Should be one of {GeometricalCenter, CenterOfGravity, Origins, GeometryTop}.\n
  *    example: <tt>(AutomaticTransformInitializationMethod "CenterOfGravity")</tt> \n
  *    By default "GeometricalCenter" is assumed.\n
+ * \parameter NumberOfSamplesForCenteredTransformInitialization: the number of grid samples
+ *    used to compute the centers of gravity, for the "CenterOfGravity" method. The value 0
+ *    specifies that all pixels are used. \n
+ *    example: <tt>(NumberOfSamplesForCenteredTransformInitialization 0)</tt> \n
+ *    By default 10000 is assumed.\n
  *
  * The transform parameters necessary for transformix, additionally defined by this class, are:
  * \transformparameter CenterOfRotationPoint: stores the center of rotation, expressed in world coordinates. \n
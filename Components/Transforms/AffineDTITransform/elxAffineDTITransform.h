@@ -21,7 +21,7 @@
 #include "elxIncludes.h" // include first to avoid MSVS warning
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAffineDTITransform.h"
-#include "itkCenteredTransformInitializer.h"
+#include "itkCenteredTransformInitializer2.h"
 
 namespace elastix
 {
@@ -148,7 +148,7 @@ public:
   using DirectionType = typename FixedImageType::DirectionType;
 
   using TransformInitializerType =
-    itk::CenteredTransformInitializer<AffineDTITransformType, FixedImageType, MovingImageType>;
+    itk::CenteredTransformInitializer2<AffineDTITransformType, FixedImageType, MovingImageType>;
   using TransformInitializerPointer = typename TransformInitializerType::Pointer;
 
   /** For scales setting in the optimizer */
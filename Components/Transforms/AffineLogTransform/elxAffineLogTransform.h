@@ -20,7 +20,7 @@
 
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAffineLogTransform.h"
-#include "itkCenteredTransformInitializer.h"
+#include "itkCenteredTransformInitializer2.h"
 #include "elxIncludes.h"
 
 namespace elastix
@@ -114,7 +114,7 @@ public:
   using DirectionType = typename FixedImageType::DirectionType;
 
   using TransformInitializerType =
-    itk::CenteredTransformInitializer<AffineLogTransformType, FixedImageType, MovingImageType>;
+    itk::CenteredTransformInitializer2<AffineLogTransformType, FixedImageType, MovingImageType>;
   using TransformInitializerPointer = typename TransformInitializerType::Pointer;
 
   /** For scales setting in the optimizer */
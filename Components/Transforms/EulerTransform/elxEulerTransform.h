@@ -21,7 +21,7 @@
 #include "elxIncludes.h" // include first to avoid MSVS warning
 #include "itkAdvancedCombinationTransform.h"
 #include "itkEulerTransform.h"
-#include "itkCenteredTransformInitializer.h"
+#include "itkCenteredTransformInitializer2.h"
 
 namespace elastix
 {
@@ -59,6 +59,11 @@ namespace elastix
  *    transform. Should be one of {GeometricalCenter, CenterOfGravity}.\n
  *    example: <tt>(AutomaticTransformInitializationMethod "CenterOfGravity")</tt> \n
  *    By default "GeometricalCenter" is assumed.\n
+ * \parameter NumberOfSamplesForCenteredTransformInitialization: the number of grid samples
+ *    used to compute the centers of gravity, for the "CenterOfGravity" method. The value 0
+ *    specifies that all pixels are used. \n
+ *    example: <tt>(NumberOfSamplesForCenteredTransformInitialization 10000)</tt> \n
+ *    By default 0 is assumed.\n
  * \parameter ComputeZYX: whether the order of rotations is ZYX. Default: "false". When false, the order is ZXY.\n
  *    This parameter is only relevant for 3D transformation, otherwise it is ignored.\n
  *
@@ -150,7 +155,7 @@ public:
   using DirectionType = typename FixedImageType::DirectionType;
 
   using TransformInitializerType =
-    itk::CenteredTransformInitializer<EulerTransformType, FixedImageType, MovingImageType>;
+    itk::CenteredTransformInitializer2<EulerTransformType, FixedImageType, MovingImageType>;
   using TransformInitializerPointer = typename TransformInitializerType::Pointer;
 
   /** For scales setting in the optimizer */
@@ -222,6 +222,11 @@ EulerTransformElastix<TElastix>::InitializeTransform()
     configuration.ReadParameter(method, "AutomaticTransformInitializationMethod", 0);
     if (method == "CenterOfGravity")
     {
+      /** By default, the centers of gravity are computed from all pixels. */
+      double nrofsamples = 0;
+      configuration.ReadParameter(nrofsamples, "NumberOfSamplesForCenteredTransformInitialization", 0);
+      transformInitializer->SetNumberOfSamplesForCenteredTransformInitialization(nrofsamples);
+
       transformInitializer->MomentsOn();
     }
 
@@ -20,7 +20,7 @@
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
 #include "itkSimilarityTransform.h"
-#include "itkCenteredTransformInitializer.h"
+#include "itkCenteredTransformInitializer2.h"
 
 namespace elastix
 {
@@ -64,6 +64,11 @@ namespace elastix
  *    transform. Should be one of {GeometricalCenter, CenterOfGravity}.\n
  *    example: <tt>(AutomaticTransformInitializationMethod "CenterOfGravity")</tt> \n
  *    By default "GeometricalCenter" is assumed.\n
+ * \parameter NumberOfSamplesForCenteredTransformInitialization: the number of grid samples
+ *    used to compute the centers of gravity, for the "CenterOfGravity" method. The value 0
+ *    specifies that all pixels are used. \n
+ *    example: <tt>(NumberOfSamplesForCenteredTransformInitialization 10000)</tt> \n
+ *    By default 0 is assumed.\n
  *
  * The transform parameters necessary for transformix, additionally defined by this class, are:
  * \transformparameter CenterOfRotationPoint: stores the center of rotation, expressed in world coordinates. \n
@@ -150,7 +155,7 @@ public:
   using DirectionType = typename FixedImageType::DirectionType;
 
   using TransformInitializerType =
-    itk::CenteredTransformInitializer<SimilarityTransformType, FixedImageType, MovingImageType>;
+    itk::CenteredTransformInitializer2<SimilarityTransformType, FixedImageType, MovingImageType>;
   using TransformInitializerPointer = typename TransformInitializerType::Pointer;
 
   /** For scales setting in the optimizer */
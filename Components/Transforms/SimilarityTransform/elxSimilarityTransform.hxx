@@ -197,6 +197,11 @@ SimilarityTransformElastix<TElastix>::InitializeTransform()
     configuration.ReadParameter(method, "AutomaticTransformInitializationMethod", 0);
     if (method == "CenterOfGravity")
     {
+      /** By default, the centers of gravity are computed from all pixels. */
+      double nrofsamples = 0;
+      configuration.ReadParameter(nrofsamples, "NumberOfSamplesForCenteredTransformInitialization", 0);
+      transformInitializer->SetNumberOfSamplesForCenteredTransformInitialization(nrofsamples);
+
       transformInitializer->MomentsOn();
     }
 
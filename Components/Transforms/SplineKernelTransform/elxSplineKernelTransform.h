@@ -70,6 +70,12 @@ namespace elastix
  * Default: 0.3. You cannot specify this parameter for each resolution differently.\n
  * Valid values are withing -1.0 and 0.5. 0.5 means incompressible.
  * Negative values are a bit odd, but possible. See Wikipedia on PoissonRatio.
+ * \parameter TPSMatrixInversionMethod: The decomposition that is used to solve
+ * the linear system of the spline, which must be one of { SVD, QR, LDLT }. LDLT is a
+ * symmetric indefinite decomposition, which is much faster than QR and SVD for
+ * large numbers of landmarks.\n
+ *   example: <tt>(TPSMatrixInversionMethod "LDLT")</tt>\n
+ * Default: SVD.
  *
  * \commandlinearg -fp: a file specifying a set of points that will serve
  * as fixed image landmarks.\n
@@ -107,6 +113,21 @@ namespace elastix
  * \transformparameter FixedImageLandmarks: The landmark positions in the
  * fixed image, in world coordinates. Positions written as x1 y1 [z1] x2 y2 [z2] etc.\n
  *   example: <tt>(FixedImageLandmarks 10.0 11.0 12.0 4.0 4.0 4.0 6.0 6.0 6.0 )</tt>
+ * \transformparameter TPSMatrixInversionMethod: The decomposition that is used to
+ * solve the linear system of the spline, one of { SVD, QR, LDLT }.\n
+ *   example: <tt>(TPSMatrixInversionMethod "LDLT")</tt>\n
+ * Default: SVD.
+ * \transformparameter SplineKernelApproximationTolerance: When positive, transformix
+ * approximates the deformation by interpolation on a grid that covers the output image,
+ * instead of summing over all landmarks for each voxel. The grid is refined until the
+ * estimated error (in mm) is below this tolerance. Points outside the grid are still
+ * evaluated exactly.\n
+ *   example: <tt>(SplineKernelApproximationTolerance 0.01 )</tt>\n
+ * Default: 0.0, which means no approximation.
+ * \transformparameter SplineKernelApproximationGridSpacing: The initial spacing (in mm)
+ * of the approximation grid.\n
+ *   example: <tt>(SplineKernelApproximationGridSpacing 8.0 )</tt>\n
+ * Default: four times the largest output image spacing.
  *
  * \ingroup Transforms
  */
@@ -229,6 +250,11 @@ protected:
   virtual bool
   DetermineTargetLandmarks();
 
+  /** Approximate the deformation on a grid that covers the output image, as specified by the Size, Index, Spacing,
+   * Origin and Direction parameters. */
+  void
+  UpdateDeformationApproximation(const double tolerance);
+
   /** General function to read all landmarks. */
   void
   ReadLandmarkFile(const std::string & filename, PointSetPointer & landmarkPointSet, const bool landmarksInFixedImage);
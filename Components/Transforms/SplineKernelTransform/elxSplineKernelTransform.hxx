@@ -23,7 +23,8 @@
 #include <vnl/vnl_math.h>
 #include "itkDeref.h"
 #include "itkTimeProbe.h"
-#include <cstdint> // For int64_t.
+#include <algorithm> // For max_element, min and max.
+#include <cstdint>   // For int64_t.
 
 namespace elastix
 {
@@ -413,6 +414,11 @@ SplineKernelTransform<TElastix>::ReadFromFile()
   configuration.ReadParameter(poissonRatio, "SplinePoissonRatio", this->GetComponentLabel(), 0, -1);
   this->m_KernelTransform->SetPoissonRatio(poissonRatio);
 
+  /** Set the matrix inversion method (one of {SVD, QR, LDLT}). */
+  std::string matrixInversionMethod = "SVD";
+  configuration.ReadParameter(matrixInversionMethod, "TPSMatrixInversionMethod", 0, false);
+  this->m_KernelTransform->SetMatrixInversionMethod(matrixInversionMethod);
+
   /** Read number of parameters. */
   unsigned int numberOfParameters = 0;
   configuration.ReadParameter(numberOfParameters, "NumberOfParameters", 0);
@@ -442,9 +448,110 @@ SplineKernelTransform<TElastix>::ReadFromFile()
    */
   this->Superclass2::ReadFromFile();
 
+  /** Optionally approximate the deformation, to speed up the resampling. */
+  double approximationTolerance = 0.0;
+  configuration.ReadParameter(approximationTolerance, "SplineKernelApproximationTolerance", 0, false);
+  if (approximationTolerance > 0.0)
+  {
+    this->UpdateDeformationApproximation(approximationTolerance);
+  }
+
 } // ReadFromFile()
 
 
+/**
+ * ************************* UpdateDeformationApproximation ************************
+ */
+
+template <typename TElastix>
+void
+SplineKernelTransform<TElastix>::UpdateDeformationApproximation(const double tolerance)
+{
+  const Configuration & configuration = itk::Deref(Superclass2::GetConfiguration());
+
+  /** Read the output image domain, like the resampler does. */
+  typename FixedImageType::SizeType      size{};
+  typename FixedImageType::IndexType     index{};
+  typename FixedImageType::SpacingType   spacing(1.0);
+  typename FixedImageType::PointType     origin{};
+  typename FixedImageType::DirectionType direction = FixedImageType::DirectionType::GetIdentity();
+  for (unsigned int i = 0; i < SpaceDimension; ++i)
+  {
+    configuration.ReadParameter(size[i], "Size", i);
+    configuration.ReadParameter(index[i], "Index", i);
+    configuration.ReadParameter(spacing[i], "Spacing", i);
+    configuration.ReadParameter(origin[i], "Origin", i);
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      configuration.ReadParameter(direction(j, i), "Direction", i * SpaceDimension + j);
+    }
+  }
+
+  const auto domain = FixedImageType::New();
+  domain->SetRegions(typename FixedImageType::RegionType(index, size));
+  domain->SetSpacing(spacing);
+  domain->SetOrigin(origin);
+  domain->SetDirection(direction);
+
+  /** The bounding box of the corners of the output image, mapped by the initial transform when it is composed with
+   * this transform. Points outside the box are evaluated exactly, so the box does not need to be conservative.
+   */
+  const auto *   initialTransform = this->GetUseComposition() ? this->Superclass1::GetInitialTransform() : nullptr;
+  InputPointType minimum;
+  InputPointType maximum;
+  minimum.Fill(itk::NumericTraits<CoordinateType>::max());
+  maximum.Fill(itk::NumericTraits<CoordinateType>::NonpositiveMin());
+  for (unsigned int corner = 0; corner < (1u << SpaceDimension); ++corner)
+  {
+    typename FixedImageType::IndexType cornerIndex = index;
+    for (unsigned int i = 0; i < SpaceDimension; ++i)
+    {
+      if ((corner >> i) & 1u)
+      {
+        cornerIndex[i] += static_cast<itk::IndexValueType>(size[i]) - 1;
+      }
+    }
+    InputPointType cornerPoint = domain->template TransformIndexToPhysicalPoint<CoordinateType>(cornerIndex);
+    if (initialTransform != nullptr)
+    {
+      cornerPoint = initialTransform->TransformPoint(cornerPoint);
+    }
+    for (unsigned int i = 0; i < SpaceDimension; ++i)
+    {
+      minimum[i] = std::min(minimum[i], cornerPoint[i]);
+      maximum[i] = std::max(maximum[i], cornerPoint[i]);
+    }
+  }
+
+  double gridSpacing = 4.0 * *std::max_element(spacing.Begin(), spacing.End());
+  configuration.ReadParameter(gridSpacing, "SplineKernelApproximationGridSpacing", 0, false);
+
+  /** The approximation only pays off when the grid is much smaller than the output image. */
+  const itk::SizeValueType maximumNumberOfGridPoints =
+    std::max<itk::SizeValueType>(domain->GetLargestPossibleRegion().GetNumberOfPixels() / 8, 1u << SpaceDimension);
+
+  log::info("Approximating the deformation of the spline kernel transform ...");
+  itk::TimeProbe timer;
+  timer.Start();
+  const bool approximated = this->m_KernelTransform->UpdateDeformationApproximation(
+    minimum, maximum, gridSpacing, tolerance, maximumNumberOfGridPoints);
+  timer.Stop();
+
+  if (approximated)
+  {
+    log::info(std::ostringstream{} << "  Approximating the deformation took: "
+                                   << Conversion::SecondsToDHMS(timer.GetMean(), 6));
+  }
+  else
+  {
+    log::warn(std::ostringstream{} << "WARNING: The deformation could not be approximated within a tolerance of "
+                                   << tolerance << " by a grid smaller than the output image. "
+                                   << "The exact spline kernel transform is used instead.");
+  }
+
+} // end UpdateDeformationApproximation()
+
+
 /**
  * ************************* CustomizeTransformParameterMap ************************
  */
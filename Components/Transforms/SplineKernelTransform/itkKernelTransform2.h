@@ -39,6 +39,8 @@ PURPOSE.  See the above copyright notices for more information.
 #include "itkVector.h"
 #include "itkMatrix.h"
 #include "itkPointSet.h"
+#include "itkSize.h"
+#include "itkSymmetricLDLTDecomposition.h"
 #include <deque>
 #include <math.h>
 #include <vnl/vnl_matrix_fixed.h>
@@ -48,6 +50,7 @@ PURPOSE.  See the above copyright notices for more information.
 #include <vnl/vnl_sample.h>
 #include <vnl/algo/vnl_svd.h>
 #include <vnl/algo/vnl_qr.h>
+#include <vector>
 
 namespace itk
 {
@@ -85,6 +88,10 @@ namespace itk
  * - make it threadsafe, like was done in the itk as well.
  * - Support for matrix inversion by QR decomposition, instead of SVD.
  *   QR is much faster. Used in SetParameters() and SetFixedParameters().
+ * - Support for matrix inversion by a symmetric (Bunch-Kaufman) LDL^T
+ *   decomposition, which is again much faster than QR.
+ * - Optional approximation of the deformation by interpolation on a
+ *   precomputed grid, to speed up TransformPoint() for many landmarks.
  * - Much faster Jacobian computation for some of the derived kernel transforms.
  *
  * \ingroup Transforms
@@ -297,10 +304,40 @@ public:
   }
 
 
-  /** Matrix inversion by SVD or QR decomposition. */
+  /** Matrix inversion by SVD, QR, or symmetric LDLT decomposition. */
   itkSetMacro(MatrixInversionMethod, std::string);
   itkGetConstReferenceMacro(MatrixInversionMethod, std::string);
 
+  /** Approximate the deformation (non-affine) part of the transform by multilinear interpolation of its values on a
+   * regular grid that covers the axis-aligned box [minimum, maximum]. The grid spacing starts at initialSpacing and is
+   * halved until the approximation error, estimated at the centres of the grid cells, is at most the tolerance. Points
+   * outside the box are still evaluated exactly, by summing over all landmarks. The approximation is discarded when
+   * the landmarks change. Returns false (without approximation) when the tolerance cannot be met by a grid of at
+   * most maximumNumberOfGridPoints points.
+   */
+  bool
+  UpdateDeformationApproximation(const InputPointType & minimum,
+                                 const InputPointType & maximum,
+                                 const double           initialSpacing,
+                                 const double           tolerance,
+                                 const SizeValueType    maximumNumberOfGridPoints);
+
+  /** Discard the approximation, so that TransformPoint() sums over all landmarks again. */
+  void
+  ClearDeformationApproximation()
+  {
+    this->m_DeformationApproximationGrid.clear();
+  }
+
+
+  /** Returns whether TransformPoint() uses the approximation grid. */
+  bool
+  HasDeformationApproximation() const
+  {
+    return !this->m_DeformationApproximationGrid.empty();
+  }
+
+
   /** Must be provided. */
   void
   GetSpatialJacobian(const InputPointType &, SpatialJacobianType &) const override
@@ -427,6 +464,12 @@ protected:
   virtual void
   ComputeDeformationContribution(const InputPointType & inputPoint, OutputPointType & result) const;
 
+  /** Add the interpolated deformation contribution from the approximation grid to the result. Returns false, without
+   * modifying the result, when there is no approximation grid, or when the point is outside of it.
+   */
+  bool
+  ApproximateDeformationContribution(const InputPointType & inputPoint, OutputPointType & result) const;
+
   /** Compute K matrix. */
   void
   ComputeK();
@@ -517,9 +560,11 @@ protected:
    */
   using SVDDecompositionType = vnl_svd<ScalarType>;
   using QRDecompositionType = vnl_qr<ScalarType>;
+  using LDLTDecompositionType = SymmetricLDLTDecomposition<ScalarType>;
 
-  SVDDecompositionType * m_LMatrixDecompositionSVD{};
-  QRDecompositionType *  m_LMatrixDecompositionQR{};
+  SVDDecompositionType *  m_LMatrixDecompositionSVD{};
+  QRDecompositionType *   m_LMatrixDecompositionQR{};
+  LDLTDecompositionType * m_LMatrixDecompositionLDLT{};
 
   /** Identity matrix. */
   IMatrixType m_I{};
@@ -539,8 +584,15 @@ private:
 
   TScalarType m_PoissonRatio{};
 
-  /** Using SVD or QR decomposition. */
+  /** Using SVD, QR or LDLT decomposition. */
   std::string m_MatrixInversionMethod{};
+
+  /** The approximation grid of the deformation contribution, with NDimensions values per grid point, and the first
+   * dimension running fastest. Empty when there is no approximation. */
+  std::vector<TScalarType> m_DeformationApproximationGrid{};
+  InputPointType           m_DeformationApproximationOrigin{};
+  InputVectorType          m_DeformationApproximationSpacing{};
+  Size<NDimensions>        m_DeformationApproximationSize{};
 };
 
 } // end namespace itk
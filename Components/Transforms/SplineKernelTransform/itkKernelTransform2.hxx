@@ -35,8 +35,11 @@ PURPOSE.  See the above copyright notices for more information.
 #define _itkKernelTransform2_hxx
 
 #include "itkKernelTransform2.h"
+#include "itkMultiThreaderBase.h"
 
-#include <numeric> // For iota.
+#include <algorithm> // For copy_n and max_element.
+#include <cmath>     // For ceil and floor.
+#include <numeric>   // For iota.
 
 namespace itk
 {
@@ -66,6 +69,7 @@ KernelTransform2<TScalarType, NDimensions>::KernelTransform2()
 
   this->m_LMatrixDecompositionSVD = nullptr;
   this->m_LMatrixDecompositionQR = nullptr;
+  this->m_LMatrixDecompositionLDLT = nullptr;
 
   this->m_Stiffness = 0.0;
   this->m_PoissonRatio = 0.3;
@@ -88,6 +92,7 @@ KernelTransform2<TScalarType, NDimensions>::~KernelTransform2()
 {
   delete m_LMatrixDecompositionSVD;
   delete m_LMatrixDecompositionQR;
+  delete m_LMatrixDecompositionLDLT;
 
 } // end destructor
 
@@ -207,6 +212,183 @@ KernelTransform2<TScalarType, NDimensions>::ComputeDeformationContribution(const
 } // end ComputeDeformationContribution()
 
 
+/**
+ * ******************* ApproximateDeformationContribution *******************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+bool
+KernelTransform2<TScalarType, NDimensions>::ApproximateDeformationContribution(const InputPointType & thisPoint,
+                                                                               OutputPointType &      opp) const
+{
+  if (this->m_DeformationApproximationGrid.empty())
+  {
+    return false;
+  }
+
+  /** Compute the grid cell that contains the point, and the position within that cell. */
+  SizeValueType baseIndex[NDimensions];
+  TScalarType   fraction[NDimensions];
+  SizeValueType stride[NDimensions];
+  SizeValueType currentStride = 1;
+  for (unsigned int dim = 0; dim < NDimensions; ++dim)
+  {
+    const SizeValueType gridSize = this->m_DeformationApproximationSize[dim];
+    const TScalarType   continuousIndex =
+      (thisPoint[dim] - this->m_DeformationApproximationOrigin[dim]) / this->m_DeformationApproximationSpacing[dim];
+
+    if (!(continuousIndex >= 0.0 && continuousIndex <= static_cast<TScalarType>(gridSize - 1)))
+    {
+      return false;
+    }
+    baseIndex[dim] = std::min(static_cast<SizeValueType>(std::floor(continuousIndex)), gridSize - 2);
+    fraction[dim] = continuousIndex - static_cast<TScalarType>(baseIndex[dim]);
+    stride[dim] = currentStride;
+    currentStride *= gridSize;
+  }
+
+  /** Multilinear interpolation between the 2^NDimensions corners of the cell. */
+  for (unsigned int corner = 0; corner < (1u << NDimensions); ++corner)
+  {
+    TScalarType   weight = 1.0;
+    SizeValueType gridPointIndex = 0;
+    for (unsigned int dim = 0; dim < NDimensions; ++dim)
+    {
+      const bool upper = (corner >> dim) & 1u;
+      weight *= upper ? fraction[dim] : (1.0 - fraction[dim]);
+      gridPointIndex += (baseIndex[dim] + (upper ? 1 : 0)) * stride[dim];
+    }
+
+    const TScalarType * const values = &this->m_DeformationApproximationGrid[gridPointIndex * NDimensions];
+    for (unsigned int dim = 0; dim < NDimensions; ++dim)
+    {
+      opp[dim] += weight * values[dim];
+    }
+  }
+  return true;
+
+} // end ApproximateDeformationContribution()
+
+
+/**
+ * ******************* UpdateDeformationApproximation *******************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+bool
+KernelTransform2<TScalarType, NDimensions>::UpdateDeformationApproximation(
+  const InputPointType & minimum,
+  const InputPointType & maximum,
+  const double           initialSpacing,
+  const double           tolerance,
+  const SizeValueType    maximumNumberOfGridPoints)
+{
+  this->m_DeformationApproximationGrid.clear();
+
+  if (!this->m_WMatrixComputed)
+  {
+    itkExceptionMacro("The landmarks must be set before the deformation can be approximated.");
+  }
+  if (!(initialSpacing > 0.0))
+  {
+    itkExceptionMacro("The initial spacing of the approximation grid must be positive, not " << initialSpacing);
+  }
+
+  const auto multiThreader = MultiThreaderBase::New();
+
+  /** Refine the grid until the estimated error is small enough. */
+  for (double spacing = initialSpacing;; spacing /= 2.0)
+  {
+    Size<NDimensions> gridSize;
+    InputVectorType   gridSpacing;
+    SizeValueType     numberOfGridPoints = 1;
+    SizeValueType     numberOfCells = 1;
+    for (unsigned int dim = 0; dim < NDimensions; ++dim)
+    {
+      const double extent = maximum[dim] - minimum[dim];
+      gridSize[dim] = extent > 0.0 ? static_cast<SizeValueType>(std::ceil(extent / spacing)) + 1 : 2;
+      gridSpacing[dim] = extent > 0.0 ? extent / static_cast<double>(gridSize[dim] - 1) : 1.0;
+      numberOfGridPoints *= gridSize[dim];
+      numberOfCells *= gridSize[dim] - 1;
+    }
+
+    if (numberOfGridPoints > maximumNumberOfGridPoints)
+    {
+      this->m_DeformationApproximationGrid.clear();
+      return false;
+    }
+
+    /** Returns the physical point at the specified (continuous) grid index. */
+    const auto getGridPoint = [minimum, gridSpacing](const SizeValueType (&gridIndex)[NDimensions],
+                                                     const double offset) {
+      InputPointType point = minimum;
+      for (unsigned int dim = 0; dim < NDimensions; ++dim)
+      {
+        point[dim] += (static_cast<double>(gridIndex[dim]) + offset) * gridSpacing[dim];
+      }
+      return point;
+    };
+
+    /** Converts a linear index into a grid index, for a grid of the specified size. */
+    const auto toGridIndex = [](SizeValueType linearIndex, const Size<NDimensions> & size,
+                                SizeValueType(&gridIndex)[NDimensions]) {
+      for (unsigned int dim = 0; dim < NDimensions; ++dim)
+      {
+        gridIndex[dim] = linearIndex % size[dim];
+        linearIndex /= size[dim];
+      }
+    };
+
+    /** Evaluate the exact deformation contribution at the grid points. */
+    std::vector<TScalarType> grid(numberOfGridPoints * NDimensions);
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfGridPoints,
+      [this, &grid, &getGridPoint, &toGridIndex, gridSize](const SizeValueType gridPointIndex) {
+        SizeValueType gridIndex[NDimensions];
+        toGridIndex(gridPointIndex, gridSize, gridIndex);
+        OutputPointType contribution{};
+        this->ComputeDeformationContribution(getGridPoint(gridIndex, 0.0), contribution);
+        std::copy_n(contribution.begin(), NDimensions, grid.begin() + gridPointIndex * NDimensions);
+      },
+      nullptr);
+
+    this->m_DeformationApproximationGrid = std::move(grid);
+    this->m_DeformationApproximationOrigin = minimum;
+    this->m_DeformationApproximationSpacing = gridSpacing;
+    this->m_DeformationApproximationSize = gridSize;
+
+    /** Estimate the error at the cell centres, where the multilinear interpolation is least accurate. */
+    Size<NDimensions> cellGridSize;
+    for (unsigned int dim = 0; dim < NDimensions; ++dim)
+    {
+      cellGridSize[dim] = gridSize[dim] - 1;
+    }
+    std::vector<TScalarType> cellErrors(numberOfCells);
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfCells,
+      [this, &cellErrors, &getGridPoint, &toGridIndex, cellGridSize](const SizeValueType cellIndex) {
+        SizeValueType gridIndex[NDimensions];
+        toGridIndex(cellIndex, cellGridSize, gridIndex);
+        const InputPointType cellCentre = getGridPoint(gridIndex, 0.5);
+        OutputPointType      exact{};
+        OutputPointType      approximation{};
+        this->ComputeDeformationContribution(cellCentre, exact);
+        this->ApproximateDeformationContribution(cellCentre, approximation);
+        cellErrors[cellIndex] = exact.EuclideanDistanceTo(approximation);
+      },
+      nullptr);
+
+    if (*std::max_element(cellErrors.cbegin(), cellErrors.cend()) <= tolerance)
+    {
+      return true;
+    }
+  }
+
+} // end UpdateDeformationApproximation()
+
+
 /**
  * ******************* ComputeD *******************
  */
@@ -242,6 +424,9 @@ template <typename TScalarType, unsigned int NDimensions>
 void
 KernelTransform2<TScalarType, NDimensions>::ComputeWMatrix()
 {
+  /** The approximation of the deformation is no longer valid. */
+  this->m_DeformationApproximationGrid.clear();
+
   /** Compute L and Y. */
   if (!this->m_LMatrixComputed)
   {
@@ -280,6 +465,16 @@ KernelTransform2<TScalarType, NDimensions>::ComputeWMatrix()
     //     vnl_qr<TScalarType> qr( this->m_LMatrix );
     //     this->m_WMatrix = qr.solve( this->m_YMatrix );
   }
+  else if (this->m_MatrixInversionMethod == "LDLT")
+  {
+    if (!this->m_LMatrixDecompositionComputed)
+    {
+      delete this->m_LMatrixDecompositionLDLT;
+      this->m_LMatrixDecompositionLDLT = new LDLTDecompositionType(this->m_LMatrix);
+      this->m_LMatrixDecompositionComputed = true;
+    }
+    this->m_WMatrix = this->m_LMatrixDecompositionLDLT->Solve(this->m_YMatrix);
+  }
   else
   {
     itkExceptionMacro("ERROR: invalid matrix inversion method (" << this->m_MatrixInversionMethod << ")");
@@ -316,6 +511,15 @@ KernelTransform2<TScalarType, NDimensions>::ComputeLInverse()
     this->m_LMatrixInverse = vnl_qr<TScalarType>(this->m_LMatrix).inverse();
     this->m_LInverseComputed = true;
   }
+  else if (this->m_MatrixInversionMethod == "LDLT")
+  {
+    // The decomposition is kept, so that ComputeWMatrix() can reuse it.
+    delete this->m_LMatrixDecompositionLDLT;
+    this->m_LMatrixDecompositionLDLT = new LDLTDecompositionType(this->m_LMatrix);
+    this->m_LMatrixDecompositionComputed = true;
+    this->m_LMatrixInverse = this->m_LMatrixDecompositionLDLT->GetInverse();
+    this->m_LInverseComputed = true;
+  }
   else
   {
     itkExceptionMacro("ERROR: invalid matrix inversion method (" << this->m_MatrixInversionMethod << ")");
@@ -347,6 +551,7 @@ KernelTransform2<TScalarType, NDimensions>::ComputeL()
   this->m_LMatrix.update(O2, this->m_KMatrix.rows(), this->m_KMatrix.columns());
   this->m_LMatrixComputed = true;
   this->m_LMatrixDecompositionComputed = false;
+  this->m_DeformationApproximationGrid.clear();
 
 } // end ComputeL()
 
@@ -522,7 +727,10 @@ auto
 KernelTransform2<TScalarType, NDimensions>::TransformPoint(const InputPointType & thisPoint) const -> OutputPointType
 {
   OutputPointType opp{};
-  this->ComputeDeformationContribution(thisPoint, opp);
+  if (!this->ApproximateDeformationContribution(thisPoint, opp))
+  {
+    this->ComputeDeformationContribution(thisPoint, opp);
+  }
 
   // Add the rotational part of the Affine component
   for (unsigned int j = 0; j < NDimensions; ++j)
@@ -894,6 +1102,8 @@ KernelTransform2<TScalarType, NDimensions>::PrintSelf(std::ostream & os, Indent
   os << indent << "FastComputationPossible: " << this->m_FastComputationPossible << std::endl;
   os << indent << "PoissonRatio: " << this->m_PoissonRatio << std::endl;
   os << indent << "MatrixInversionMethod: " << this->m_MatrixInversionMethod << std::endl;
+  os << indent << "DeformationApproximationSize: " << this->m_DeformationApproximationSize << std::endl;
+  os << indent << "DeformationApproximationSpacing: " << this->m_DeformationApproximationSpacing << std::endl;
 
   /** Just print the sizes of these matrices, not their contents. */
   os << indent << "LMatrix: " << this->m_LMatrix.rows() << " x " << this->m_LMatrix.cols() << std::endl;
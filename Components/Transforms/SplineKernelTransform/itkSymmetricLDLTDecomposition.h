@@ -0,0 +1,308 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSymmetricLDLTDecomposition_h
+#define itkSymmetricLDLTDecomposition_h
+
+#include <itkMacro.h>
+#include <vnl/vnl_matrix.h>
+
+#include <algorithm> // For swap.
+#include <cmath>     // For abs and sqrt.
+#include <numeric>   // For iota.
+#include <vector>
+
+namespace itk
+{
+/** \class SymmetricLDLTDecomposition
+ * \brief Solves a symmetric, possibly indefinite, linear system by an LDL^T decomposition.
+ *
+ * The matrix is decomposed as P A P^T = L D L^T, with P a permutation, L unit lower triangular and D block diagonal
+ * with 1x1 and 2x2 blocks, using the diagonal pivoting method of Bunch and Kaufman (as in LAPACK's xSYTF2). Only the
+ * lower triangle of the matrix is accessed. This takes about a quarter of the floating point operations of a QR
+ * decomposition, and a small fraction of those of an SVD, while still being stable for the saddle point systems of
+ * the kernel transforms, whose L matrix has a zero block on its diagonal.
+ *
+ * \ingroup Transforms
+ */
+
+template <typename TScalarType>
+class SymmetricLDLTDecomposition
+{
+public:
+  using MatrixType = vnl_matrix<TScalarType>;
+
+  /** Decomposes the specified square symmetric matrix. Throws an exception when it is (numerically) singular. */
+  explicit SymmetricLDLTDecomposition(const MatrixType & matrix)
+    : m_Factors(matrix)
+    , m_Permutation(matrix.rows())
+  {
+    if (matrix.rows() != matrix.cols())
+    {
+      itkGenericExceptionMacro("SymmetricLDLTDecomposition: the matrix is not square");
+    }
+    std::iota(m_Permutation.begin(), m_Permutation.end(), 0u);
+    this->Decompose();
+  }
+
+  /** Returns the solution X of A X = B, for each column of B. */
+  MatrixType
+  Solve(const MatrixType & rhs) const
+  {
+    const unsigned int n = m_Factors.rows();
+    if (rhs.rows() != n)
+    {
+      itkGenericExceptionMacro("SymmetricLDLTDecomposition: the right-hand side has the wrong number of rows");
+    }
+
+    MatrixType               result(n, rhs.cols());
+    std::vector<TScalarType> y(n);
+
+    for (unsigned int column = 0; column < rhs.cols(); ++column)
+    {
+      for (unsigned int i = 0; i < n; ++i)
+      {
+        y[i] = rhs(m_Permutation[i], column);
+      }
+      this->SolveInPlace(y);
+      for (unsigned int i = 0; i < n; ++i)
+      {
+        result(m_Permutation[i], column) = y[i];
+      }
+    }
+    return result;
+  }
+
+  /** Returns the inverse of the decomposed matrix. */
+  MatrixType
+  GetInverse() const
+  {
+    MatrixType identity(m_Factors.rows(), m_Factors.rows());
+    identity.set_identity();
+    return this->Solve(identity);
+  }
+
+private:
+  /** Overwrites the lower triangle of m_Factors by D and the strictly lower part of L. */
+  void
+  Decompose()
+  {
+    const unsigned int n = m_Factors.rows();
+    MatrixType &       a = m_Factors;
+
+    // The Bunch-Kaufman constant, which bounds the element growth.
+    const TScalarType alpha = (1.0 + std::sqrt(17.0)) / 8.0;
+
+    m_BlockSizes.assign(n, 0);
+
+    for (unsigned int k = 0; k < n;)
+    {
+      unsigned int kstep = 1;
+      unsigned int kp = k;
+
+      const TScalarType absakk = std::abs(a(k, k));
+      TScalarType       colmax{};
+      unsigned int      imax = k;
+      for (unsigned int i = k + 1; i < n; ++i)
+      {
+        if (std::abs(a(i, k)) > colmax)
+        {
+          colmax = std::abs(a(i, k));
+          imax = i;
+        }
+      }
+
+      if (std::max(absakk, colmax) == TScalarType{})
+      {
+        itkGenericExceptionMacro("SymmetricLDLTDecomposition: the matrix is singular");
+      }
+
+      if (absakk < alpha * colmax)
+      {
+        // The largest off-diagonal element in row and column imax of the trailing submatrix.
+        TScalarType rowmax{};
+        for (unsigned int j = k; j < imax; ++j)
+        {
+          rowmax = std::max(rowmax, std::abs(a(imax, j)));
+        }
+        for (unsigned int j = imax + 1; j < n; ++j)
+        {
+          rowmax = std::max(rowmax, std::abs(a(j, imax)));
+        }
+
+        if (absakk >= alpha * colmax * (colmax / rowmax))
+        {
+          kp = k;
+        }
+        else if (std::abs(a(imax, imax)) >= alpha * rowmax)
+        {
+          kp = imax;
+        }
+        else
+        {
+          kp = imax;
+          kstep = 2;
+        }
+      }
+
+      const unsigned int kk = k + kstep - 1;
+      if (kp != kk)
+      {
+        // Symmetric interchange of rows and columns kk and kp of the trailing submatrix (lower triangle only).
+        for (unsigned int i = kp + 1; i < n; ++i)
+        {
+          std::swap(a(i, kk), a(i, kp));
+        }
+        for (unsigned int j = kk + 1; j < kp; ++j)
+        {
+          std::swap(a(j, kk), a(kp, j));
+        }
+        std::swap(a(kk, kk), a(kp, kp));
+        if (kstep == 2)
+        {
+          std::swap(a(kk, k), a(kp, k));
+        }
+
+        // Apply the same interchange to the columns of L that are already computed.
+        for (unsigned int j = 0; j < k; ++j)
+        {
+          std::swap(a(kk, j), a(kp, j));
+        }
+        std::swap(m_Permutation[kk], m_Permutation[kp]);
+      }
+
+      if (kstep == 1)
+      {
+        // Rank-1 update of the trailing submatrix, and store column k of L.
+        const TScalarType d11 = 1.0 / a(k, k);
+        for (unsigned int j = k + 1; j < n; ++j)
+        {
+          const TScalarType ajk = a(j, k) * d11;
+          for (unsigned int i = j; i < n; ++i)
+          {
+            a(i, j) -= a(i, k) * ajk;
+          }
+        }
+        for (unsigned int i = k + 1; i < n; ++i)
+        {
+          a(i, k) *= d11;
+        }
+      }
+      else
+      {
+        // Rank-2 update of the trailing submatrix, and store columns k and k+1 of L.
+        if (k + 2 < n)
+        {
+          TScalarType       d21 = a(k + 1, k);
+          const TScalarType d11 = a(k + 1, k + 1) / d21;
+          const TScalarType d22 = a(k, k) / d21;
+          const TScalarType t = 1.0 / (d11 * d22 - 1.0);
+          d21 = t / d21;
+
+          for (unsigned int j = k + 2; j < n; ++j)
+          {
+            const TScalarType wk = d21 * (d11 * a(j, k) - a(j, k + 1));
+            const TScalarType wkp1 = d21 * (d22 * a(j, k + 1) - a(j, k));
+            for (unsigned int i = j; i < n; ++i)
+            {
+              a(i, j) -= a(i, k) * wk + a(i, k + 1) * wkp1;
+            }
+            a(j, k) = wk;
+            a(j, k + 1) = wkp1;
+          }
+        }
+      }
+
+      m_BlockSizes[k] = kstep;
+      k += kstep;
+    }
+  }
+
+
+  /** Solves L D L^T y = b in place, for a permuted right-hand side b. */
+  void
+  SolveInPlace(std::vector<TScalarType> & y) const
+  {
+    const unsigned int n = m_Factors.rows();
+    const MatrixType & a = m_Factors;
+
+    // Forward substitution with L.
+    for (unsigned int k = 0; k < n; k += m_BlockSizes[k])
+    {
+      const unsigned int first = k + m_BlockSizes[k];
+      for (unsigned int i = first; i < n; ++i)
+      {
+        y[i] -= a(i, k) * y[k];
+      }
+      if (m_BlockSizes[k] == 2)
+      {
+        for (unsigned int i = first; i < n; ++i)
+        {
+          y[i] -= a(i, k + 1) * y[k + 1];
+        }
+      }
+    }
+
+    // Solve with the 1x1 and 2x2 blocks of D.
+    for (unsigned int k = 0; k < n; k += m_BlockSizes[k])
+    {
+      if (m_BlockSizes[k] == 1)
+      {
+        y[k] /= a(k, k);
+      }
+      else
+      {
+        const TScalarType d11 = a(k, k);
+        const TScalarType d21 = a(k + 1, k);
+        const TScalarType d22 = a(k + 1, k + 1);
+        const TScalarType determinant = d11 * d22 - d21 * d21;
+        const TScalarType y0 = y[k];
+        const TScalarType y1 = y[k + 1];
+        y[k] = (d22 * y0 - d21 * y1) / determinant;
+        y[k + 1] = (d11 * y1 - d21 * y0) / determinant;
+      }
+    }
+
+    // Backward substitution with L^T, block by block, starting at the last block.
+    for (unsigned int end = n; end > 0;)
+    {
+      const unsigned int k = (end >= 2 && m_BlockSizes[end - 2] == 2) ? end - 2 : end - 1;
+      for (unsigned int column = k; column < end; ++column)
+      {
+        TScalarType sum{};
+        for (unsigned int i = end; i < n; ++i)
+        {
+          sum += a(i, column) * y[i];
+        }
+        y[column] -= sum;
+      }
+      end = k;
+    }
+  }
+
+
+  MatrixType                m_Factors;
+  std::vector<unsigned int> m_Permutation;
+
+  /** The size (1 or 2) of the diagonal block of D that starts at each index, or 0 for the second index of a 2x2
+   * block. */
+  std::vector<unsigned int> m_BlockSizes{};
+};
+
+} // end namespace itk
+
+#endif // itkSymmetricLDLTDecomposition_h
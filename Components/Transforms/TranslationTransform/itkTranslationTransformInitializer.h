@@ -20,7 +20,7 @@
 #define itkTranslationTransformInitializer_h
 
 // ITK header files:
-#include <itkImageMomentsCalculator.h>
+#include "itkAdvancedImageMomentsCalculator.h"
 #include <itkObject.h>
 
 #include <iostream>
@@ -54,6 +54,8 @@ namespace itk
  * are similar for both images and hence the best initial guess for
  * registration is to superimpose both mass centers.  Note that this
  * assumption will probably not hold in multi-modality registration.
+ * The moments are computed multi-threaded, over all pixels of the images,
+ * by AdvancedImageMomentsCalculator.
  *
  * \ingroup Transforms
  */
@@ -95,8 +97,8 @@ public:
   using MovingMaskPointer = typename MovingMaskType::ConstPointer;
 
   /** Moment calculators */
-  using FixedImageCalculatorType = ImageMomentsCalculator<FixedImageType>;
-  using MovingImageCalculatorType = ImageMomentsCalculator<MovingImageType>;
+  using FixedImageCalculatorType = AdvancedImageMomentsCalculator<FixedImageType>;
+  using MovingImageCalculatorType = AdvancedImageMomentsCalculator<MovingImageType>;
 
   using FixedImageCalculatorPointer = typename FixedImageCalculatorType::Pointer;
   using MovingImageCalculatorPointer = typename MovingImageCalculatorType::Pointer;
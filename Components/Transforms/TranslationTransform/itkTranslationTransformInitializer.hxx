@@ -34,6 +34,10 @@ TranslationTransformInitializer<TTransform, TFixedImage, TMovingImage>::Translat
 {
   this->m_FixedCalculator = FixedImageCalculatorType::New();
   this->m_MovingCalculator = MovingImageCalculatorType::New();
+
+  /** Use all pixels, like the centers of gravity computed by itk::ImageMomentsCalculator. */
+  this->m_FixedCalculator->SetNumberOfSamplesForCenteredTransformInitialization(0);
+  this->m_MovingCalculator->SetNumberOfSamplesForCenteredTransformInitialization(0);
 }
 
 
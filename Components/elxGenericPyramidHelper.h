@@ -18,11 +18,13 @@
 #ifndef elxGenericPyramidHelper_h
 #define elxGenericPyramidHelper_h
 
+#include <algorithm>   // For min and max.
 #include <string>      // For is_same.
 #include <type_traits> // For is_same.
 
 #include "elxConfiguration.h"
 #include <itkDeref.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 namespace elastix
 {
@@ -199,6 +201,116 @@ public:
     bool computeThisResolution = false;
     configuration.ReadParameter(computeThisResolution, "ComputePyramidImagesPerResolution", 0, false);
     pyramid.SetComputeOnlyForCurrentLevel(computeThisResolution);
+
+    /** Decide whether or not to compute the pyramid images in a cascade, each
+     * level from the next finer level. This saves time for large images, since
+     * only the finest level is computed from the full resolution image. Only
+     * used when all resolutions are computed at once.
+     */
+    bool computeCascaded = false;
+    configuration.ReadParameter(computeCascaded, "ComputePyramidImagesCascaded", 0, false);
+    pyramid.SetUseCascadedSmoothing(computeCascaded);
+
+    /** Decide whether or not to compute the pyramid images only within the
+     * bounding box of the mask. This saves time and memory when the mask only
+     * covers a small part of the image.
+     */
+    bool computeInMaskBoundingBox = false;
+    configuration.ReadParameter(computeInMaskBoundingBox, "ComputePyramidImagesInMaskBoundingBox", 0, false);
+    pyramid.SetUseRegionOfInterest(false);
+    if (computeInMaskBoundingBox)
+    {
+      const auto & elastix = itk::Deref(pyramid.GetElastix());
+      const auto   numberOfMasks = isFixed ? elastix.GetNumberOfFixedMasks() : elastix.GetNumberOfMovingMasks();
+      const auto * const mask = [&elastix] {
+        if constexpr (isFixed)
+        {
+          return elastix.GetFixedMask();
+        }
+        else
+        {
+          return elastix.GetMovingMask();
+        }
+      }();
+
+      if (numberOfMasks == 1 && mask != nullptr)
+      {
+        typename TPyramid::PointType minimum;
+        typename TPyramid::PointType maximum;
+        if (ComputeMaskBoundingBox(*mask, minimum, maximum))
+        {
+          pyramid.SetRegionOfInterest(minimum, maximum);
+          pyramid.SetUseRegionOfInterest(true);
+          log::info(std::ostringstream{} << "The " << pyramidAdjective
+                                         << " pyramid is restricted to the mask bounding box:\n  minimum: " << minimum
+                                         << "\n  maximum: " << maximum);
+        }
+        else
+        {
+          log::warn(std::ostringstream{} << "WARNING: the " << pyramidAdjective
+                                         << " mask is empty, so the pyramid is not restricted to its bounding box.");
+        }
+      }
+      else
+      {
+        log::warn(std::ostringstream{} << "WARNING: ComputePyramidImagesInMaskBoundingBox is ignored, because not "
+                                       << "exactly one " << pyramidAdjective << " mask is specified.");
+      }
+    }
+  }
+
+private:
+  /** Computes the physical bounding box of the non-zero voxels of a mask. Returns false if the mask is empty. */
+  template <typename TMask, typename TPoint>
+  static bool
+  ComputeMaskBoundingBox(const TMask & mask, TPoint & minimum, TPoint & maximum)
+  {
+    constexpr unsigned int Dimension = TMask::ImageDimension;
+    using IndexType = typename TMask::IndexType;
+
+    IndexType  minimumIndex = IndexType::Filled(itk::NumericTraits<itk::IndexValueType>::max());
+    IndexType  maximumIndex = IndexType::Filled(itk::NumericTraits<itk::IndexValueType>::NonpositiveMin());
+    bool       isEmpty = true;
+
+    for (itk::ImageRegionConstIteratorWithIndex<TMask> it(&mask, mask.GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != 0)
+      {
+        const IndexType & index = it.GetIndex();
+        for (unsigned int dim = 0; dim < Dimension; ++dim)
+        {
+          minimumIndex[dim] = std::min(minimumIndex[dim], index[dim]);
+          maximumIndex[dim] = std::max(maximumIndex[dim], index[dim]);
+        }
+        isEmpty = false;
+      }
+    }
+
+    if (isEmpty)
+    {
+      return false;
+    }
+
+    /** Take the physical extent of the voxels into account, by converting all
+     * corners of the index bounding box, extended by half a voxel.
+     */
+    minimum.Fill(itk::NumericTraits<typename TPoint::ValueType>::max());
+    maximum.Fill(itk::NumericTraits<typename TPoint::ValueType>::NonpositiveMin());
+    for (unsigned int corner = 0; corner < (1u << Dimension); ++corner)
+    {
+      itk::ContinuousIndex<double, Dimension> cindex;
+      for (unsigned int dim = 0; dim < Dimension; ++dim)
+      {
+        cindex[dim] = ((corner >> dim) & 1) ? maximumIndex[dim] + 0.5 : minimumIndex[dim] - 0.5;
+      }
+      const auto point = mask.template TransformContinuousIndexToPhysicalPoint<double>(cindex);
+      for (unsigned int dim = 0; dim < Dimension; ++dim)
+      {
+        minimum[dim] = std::min(minimum[dim], point[dim]);
+        maximum[dim] = std::max(maximum[dim], point[dim]);
+      }
+    }
+    return true;
   }
 };
 
@@ -19,8 +19,11 @@
 #define elxFixedImagePyramidBase_hxx
 
 #include "elxFixedImagePyramidBase.h"
+#include "elxDerivedDataCache.h"
 #include <itkDeref.h>
 
+#include <iomanip> // For setprecision.
+
 #ifndef ELX_NO_FILESYSTEM_ACCESS
 #  include "itkImageFileCastWriter.h"
 #endif
@@ -39,6 +42,9 @@ FixedImagePyramidBase<TElastix>::BeforeRegistrationBase()
   /** Call SetFixedSchedule.*/
   this->SetFixedSchedule();
 
+  /** Reuse the outputs of a previous elastix level, if possible. */
+  this->RetrieveOrComputeOutputs();
+
 } // end BeforeRegistrationBase()
 
 
@@ -152,6 +158,104 @@ FixedImagePyramidBase<TElastix>::SetFixedSchedule()
 } // end SetFixedSchedule()
 
 
+/**
+ * ******************* GetDerivedDataCacheParameters ********************
+ */
+
+template <typename TElastix>
+std::string
+FixedImagePyramidBase<TElastix>::GetDerivedDataCacheParameters(const unsigned int level) const
+{
+  /** Only the pyramids that compute all their levels at once, in a single update, are supported. */
+  const std::string className = this->elxGetClassName();
+  if (className != "FixedRecursiveImagePyramid" && className != "FixedShrinkingImagePyramid" &&
+      className != "FixedSmoothingImagePyramid")
+  {
+    return {};
+  }
+
+  const ITKBaseType &  pyramid = *(this->GetAsITKBaseType());
+  const ScheduleType & schedule = pyramid.GetSchedule();
+
+  std::ostringstream parameters;
+  parameters << className << ", UseShrinkImageFilter " << pyramid.GetUseShrinkImageFilter() << ", MaximumError "
+             << std::setprecision(17) << pyramid.GetMaximumError() << ", Schedule";
+
+  for (unsigned int i = 0; i < schedule.rows(); ++i)
+  {
+    for (unsigned int j = 0; j < schedule.cols(); ++j)
+    {
+      parameters << ' ' << schedule[i][j];
+    }
+  }
+  parameters << ", Level " << level;
+  return parameters.str();
+
+} // end GetDerivedDataCacheParameters()
+
+
+/**
+ * ******************* RetrieveOrComputeOutputs ********************
+ */
+
+template <typename TElastix>
+void
+FixedImagePyramidBase<TElastix>::RetrieveOrComputeOutputs()
+{
+  const ElastixType * const elastix = Superclass::GetElastix();
+  DerivedDataCache * const  derivedDataCache = elastix == nullptr ? nullptr : elastix->GetDerivedDataCache();
+
+  if (derivedDataCache == nullptr || this->GetDerivedDataCacheParameters(0).empty())
+  {
+    return;
+  }
+
+  /** Connect the input that the registration connects to this pyramid: the fixed image with the same index, in case
+   * of multiple fixed images. */
+  unsigned int index = 0;
+  while (index < elastix->GetNumberOfFixedImagePyramids() && elastix->GetElxFixedImagePyramidBase(index) != this)
+  {
+    ++index;
+  }
+  const InputImageType * const inputImage =
+    elastix->GetFixedImage(elastix->GetNumberOfFixedImages() > 1 ? index : 0);
+
+  if (inputImage == nullptr)
+  {
+    return;
+  }
+
+  ITKBaseType & pyramid = *(this->GetAsITKBaseType());
+  pyramid.SetInput(inputImage);
+  pyramid.UpdateOutputInformation();
+
+  const unsigned int numberOfLevels = pyramid.GetNumberOfLevels();
+
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    /** Computes all levels, and returns a separate image object that shares the pixel buffer of the output at this
+     * level, so that the cached image is not affected when the pyramid is updated again. */
+    const auto computeOutput = [&pyramid, level] {
+      pyramid.UpdateLargestPossibleRegion();
+      const auto output = OutputImageType::New();
+      output->Graft(pyramid.GetOutput(level));
+      return output;
+    };
+
+    const auto cachedOutput = derivedDataCache->RetrieveOrCreate<OutputImageType>(
+      "fixed image pyramid output", *inputImage, this->GetDerivedDataCacheParameters(level), computeOutput);
+    pyramid.GetOutput(level)->Graft(cachedOutput);
+  }
+
+  /** Mark the outputs as up-to-date, after all of them are grafted, so that the pyramid does not execute again. */
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    pyramid.GetOutput(level)->DataHasBeenGenerated();
+  }
+
+} // end RetrieveOrComputeOutputs()
+
+
 /**
  * ******************* WritePyramidImage ********************
  */
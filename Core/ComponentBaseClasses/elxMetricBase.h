@@ -23,6 +23,7 @@
 
 #include "elxBaseComponentSE.h"
 #include "itkAdvancedImageToImageMetric.h"
+#include "itkSingleValuedPointSetToPointSetMetric.h"
 #include "itkImageGridSampler.h"
 #include "itkPointSet.h"
 
@@ -65,9 +66,32 @@ namespace elastix
  *    The default is 0.25.
  * \parameter UseMultiThreadingForMetrics: Flag that can set to "true" or "false".
  *    If "true" the metric may use multi-threading (at least if multi-threading is implemented for the selected
- *    metric). If "false", it will run single-threaded. This flag will not affect the output of the metric.\n
+ *    metric). If "false", it will run single-threaded. This flag will not affect the output of the metric, apart from
+ *    rounding differences for the point set metrics.\n
  *    example: <tt>(UseMultiThreadingForMetrics "false")</tt> \n
  *    Default is "true".
+ * \parameter UseSparseDerivativeAccumulation: Flag that can set to "true" or "false".
+ *    If "true" the metric accumulates the derivative of each thread in blocks of parameters that are only
+ *    allocated when touched, which bounds the memory per thread for transforms with many parameters.
+ *    Only has effect when multi-threading is used, and for metrics that support it (currently
+ *    AdvancedMeanSquares, and AdvancedMattesMutualInformation when UseFastAndLowMemoryVersion is "true" and
+ *    UseJacobianPreconditioning is "false"). This flag will not affect the output of the metric.\n
+ *    example: <tt>(UseSparseDerivativeAccumulation "true")</tt> \n
+ *    Default is "false".
+ * \parameter UseBSplineWeightCache: Flag that can set to "true" or "false".
+ *    If "true" and the transform is a B-spline, the B-spline weights at the fixed image samples are computed once
+ *    per resolution, instead of in each iteration. Only has effect for samplers that select the same samples in each
+ *    iteration, like the "Grid" and "Full" samplers. Penalty terms on the transform, like
+ *    TransformBendingEnergyPenalty and DisplacementMagnitudePenalty, cache the Jacobian of the spatial derivative
+ *    that they evaluate instead. This flag will not affect the output of the metric, apart from rounding differences
+ *    for these penalty terms.\n
+ *    example: <tt>(UseBSplineWeightCache "true")</tt> \n
+ *    Default is "false".
+ * \parameter MaximumBSplineWeightCacheSizeInMB: The maximum size of the cache of UseBSplineWeightCache. The metrics
+ *    of a multi-metric registration share the cache, which then holds the samples of all the metrics that use it.
+ *    The cache is not built when it would be larger. \n
+ *    example: <tt>(MaximumBSplineWeightCacheSizeInMB 1024)</tt> \n
+ *    Default is 512.
  *
  * \ingroup Metrics
  * \ingroup ComponentBaseClasses
@@ -127,6 +151,9 @@ public:
                                                                         CoordinateRepresentationType,
                                                                         CoordinateRepresentationType>>;
 
+  /** The base class of the point set metrics. */
+  using PointSetMetricType = itk::SingleValuedPointSetToPointSetMetric<FixedPointSetType, MovingPointSetType>;
+
   /** Typedefs for sampler support. */
   using ImageSamplerBaseType = typename AdvancedMetricType::ImageSamplerType;
 
@@ -159,6 +186,12 @@ public:
   void
   BeforeEachResolutionBase() override;
 
+  /** Execute stuff after each resolution:
+   * \li Report the size of the B-spline weight cache, if it was requested.
+   */
+  void
+  AfterEachResolutionBase() override;
+
   /** Execute stuff after each iteration:
    * \li Optionally compute the exact metric value and plot it to screen.
    */
@@ -242,6 +275,15 @@ protected:
 
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
+
+  using ImageExtremaType = typename AdvancedMetricType::ImageExtremaType;
+
+  /** Returns the extrema of the specified image. When the image is an output of one of the fixed or moving image
+   * pyramids, the extrema are retrieved from the cache of derived data, or computed and stored in the cache. */
+  static ImageExtremaType
+  RetrieveOrComputeImageExtrema(const ElastixType &                       elastix,
+                                const itk::DataObject &                   image,
+                                const std::function<ImageExtremaType()> & computeExtrema);
 };
 
 } // end namespace elastix
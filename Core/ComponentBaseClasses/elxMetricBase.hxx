@@ -19,6 +19,9 @@
 #define elxMetricBase_hxx
 
 #include "elxMetricBase.h"
+#include "elxDerivedDataCache.h"
+#include <itkDeref.h>
+#include <itkSimpleDataObjectDecorator.h>
 
 namespace elastix
 {
@@ -33,11 +36,87 @@ MetricBase<TElastix>::BeforeRegistrationBase()
 {
   if (auto * const thisAsAdvanced = dynamic_cast<AdvancedMetricType *>(this))
   {
+    ElastixType & elastix = itk::Deref(this->GetElastix());
+
     thisAsAdvanced->SetRandomVariateGenerator(Superclass::GetRandomVariateGenerator());
+    thisAsAdvanced->SetProfiler(&elastix.GetProfiler());
+
+    /** Reuse the extrema of the pyramid images of a previous elastix level, for the limiters and the normalization. */
+    if (elastix.GetDerivedDataCache() != nullptr)
+    {
+      thisAsAdvanced->SetImageExtremaFunction(
+        [&elastix](const itk::DataObject & image, const std::function<ImageExtremaType()> & computeExtrema) {
+          return RetrieveOrComputeImageExtrema(elastix, image, computeExtrema);
+        });
+    }
   }
 }
 
 
+/**
+ * ******************* RetrieveOrComputeImageExtrema ******************
+ */
+
+template <typename TElastix>
+auto
+MetricBase<TElastix>::RetrieveOrComputeImageExtrema(const ElastixType &                       elastix,
+                                                    const itk::DataObject &                   image,
+                                                    const std::function<ImageExtremaType()> & computeExtrema)
+  -> ImageExtremaType
+{
+  using ExtremaObjectType = itk::SimpleDataObjectDecorator<ImageExtremaType>;
+
+  DerivedDataCache & derivedDataCache = itk::Deref(elastix.GetDerivedDataCache());
+
+  const auto createExtremaObject = [&computeExtrema] {
+    const auto extremaObject = ExtremaObjectType::New();
+    extremaObject->Set(computeExtrema());
+    return extremaObject;
+  };
+
+  /** Looks for the image among the outputs of the specified pyramid. The extrema of a pyramid output are identified by
+   * the input of the pyramid, and the parameters that identify the output itself. */
+  const auto retrieveOrCreateFromPyramid = [&](auto * const pyramidBase) -> typename ExtremaObjectType::Pointer {
+    if (pyramidBase != nullptr)
+    {
+      auto & pyramid = itk::Deref(pyramidBase->GetAsITKBaseType());
+
+      for (unsigned int level = 0; level < pyramid.GetNumberOfLevels(); ++level)
+      {
+        if (pyramid.GetOutput(level) == &image && pyramid.GetInput() != nullptr)
+        {
+          const std::string parameters = pyramidBase->GetDerivedDataCacheParameters(level);
+
+          if (!parameters.empty())
+          {
+            return derivedDataCache.RetrieveOrCreate<ExtremaObjectType>(
+              "image pyramid output extrema", *pyramid.GetInput(), parameters, createExtremaObject);
+          }
+        }
+      }
+    }
+    return nullptr;
+  };
+
+  for (unsigned int i = 0; i < elastix.GetNumberOfFixedImagePyramids(); ++i)
+  {
+    if (const auto extremaObject = retrieveOrCreateFromPyramid(elastix.GetElxFixedImagePyramidBase(i)))
+    {
+      return extremaObject->Get();
+    }
+  }
+  for (unsigned int i = 0; i < elastix.GetNumberOfMovingImagePyramids(); ++i)
+  {
+    if (const auto extremaObject = retrieveOrCreateFromPyramid(elastix.GetElxMovingImagePyramidBase(i)))
+    {
+      return extremaObject->Get();
+    }
+  }
+  return computeExtrema();
+
+} // end RetrieveOrComputeImageExtrema()
+
+
 /**
  * ******************* BeforeEachResolutionBase ******************
  */
@@ -153,6 +232,24 @@ MetricBase<TElastix>::BeforeEachResolutionBase()
     configuration.ReadParameter(useMultiThreading, "UseMultiThreadingForMetrics", this->GetComponentLabel(), level, 0);
 
     thisAsAdvanced->SetUseMultiThread(useMultiThreading);
+
+    /** Should the per-thread derivatives be accumulated sparsely? */
+    bool useSparseDerivativeAccumulation = false;
+    configuration.ReadParameter(
+      useSparseDerivativeAccumulation, "UseSparseDerivativeAccumulation", this->GetComponentLabel(), level, 0);
+    thisAsAdvanced->SetUseSparseDerivativeAccumulation(useSparseDerivativeAccumulation);
+
+    /** Should the B-spline transform weights at the fixed image samples be cached, and how large may the cache be? */
+    bool useBSplineWeightCache = false;
+    configuration.ReadParameter(
+      useBSplineWeightCache, "UseBSplineWeightCache", this->GetComponentLabel(), level, 0, false);
+    thisAsAdvanced->SetUseBSplineWeightCache(useBSplineWeightCache);
+
+    unsigned int maximumCacheSizeInMB = 512;
+    configuration.ReadParameter(
+      maximumCacheSizeInMB, "MaximumBSplineWeightCacheSizeInMB", this->GetComponentLabel(), level, 0, false);
+    thisAsAdvanced->SetMaximumBSplineWeightCacheSize(itk::SizeValueType{ maximumCacheSizeInMB } * 1024 * 1024);
+
     if (useMultiThreading)
     {
       std::string tmp = configuration.GetCommandLineArgument("-threads");
@@ -165,9 +262,58 @@ MetricBase<TElastix>::BeforeEachResolutionBase()
 
   } // end advanced metric
 
+  /** Point set metrics may also distribute their points over multiple threads. */
+  if (auto * const thisAsPointSetMetric = dynamic_cast<PointSetMetricType *>(this))
+  {
+    bool useMultiThreading = true;
+    configuration.ReadParameter(useMultiThreading, "UseMultiThreadingForMetrics", this->GetComponentLabel(), level, 0);
+    thisAsPointSetMetric->SetUseMultiThread(useMultiThreading);
+
+    if (useMultiThreading)
+    {
+      const std::string threads = configuration.GetCommandLineArgument("-threads");
+      if (!threads.empty())
+      {
+        thisAsPointSetMetric->SetNumberOfWorkUnits(atoi(threads.c_str()));
+      }
+    }
+  } // end point set metric
+
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ******************* AfterEachResolutionBase ******************
+ */
+
+template <typename TElastix>
+void
+MetricBase<TElastix>::AfterEachResolutionBase()
+{
+  /** Report the memory used by the B-spline weight cache, if the user wanted it. */
+  if (const auto * const thisAsAdvanced = dynamic_cast<const AdvancedMetricType *>(this))
+  {
+    if (thisAsAdvanced->GetUseBSplineWeightCache() && thisAsAdvanced->GetBSplineWeightCacheSize() > 0)
+    {
+      constexpr double  bytesPerMB = 1024.0 * 1024.0;
+      const double      sizeInMB = thisAsAdvanced->GetBSplineWeightCacheSize() / bytesPerMB;
+      const std::string label = this->GetComponentLabel();
+      if (thisAsAdvanced->GetBSplineWeightCacheIsBuilt())
+      {
+        log::info(std::ostringstream{} << "  B-spline weight cache of " << label << ": " << sizeInMB << " MB");
+      }
+      else
+      {
+        log::info(std::ostringstream{} << "  B-spline weight cache of " << label << " not used: it would take "
+                                       << sizeInMB << " MB, which exceeds the maximum of "
+                                       << thisAsAdvanced->GetMaximumBSplineWeightCacheSize() / bytesPerMB << " MB");
+      }
+    }
+  }
+
+} // end AfterEachResolutionBase()
+
+
 /**
  * ******************* AfterEachIterationBase ******************
  */
@@ -52,6 +52,11 @@ namespace elastix
  *    example: <tt>(WritePyramidImagesAfterEachResolution "true")</tt>\n
  *    default "false".
  *
+ * The outputs of the recursive, shrinking, and smoothing pyramids are stored in the cache of derived data of elastix,
+ * identified by the input image, the pyramid type, and its schedule, and so are the extrema of these outputs. When a
+ * next elastix level of a chain of parameter files uses the same moving image and pyramid settings, the pyramid is not
+ * computed again.
+ *
  * \ingroup ImagePyramids
  * \ingroup ComponentBaseClasses
  */
@@ -115,6 +120,11 @@ public:
   virtual void
   SetMovingSchedule();
 
+  /** Returns a description of the settings that determine the output of this pyramid at the specified level, which
+   * identifies the output in the cache of derived data. Returns an empty string when the output is not cached. */
+  std::string
+  GetDerivedDataCacheParameters(const unsigned int level) const;
+
   /** Method to write the pyramid image. */
   void
   WritePyramidImage(const std::string & filename,
@@ -128,6 +138,11 @@ protected:
 
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
+
+  /** Retrieves the outputs of this pyramid from the cache of derived data, or computes and stores them, and marks them
+   * as up-to-date, so that the registration does not compute them again. */
+  void
+  RetrieveOrComputeOutputs();
 };
 
 } // end namespace elastix
@@ -23,6 +23,7 @@
 #include "elxMacro.h"
 
 #include "elxBaseComponentSE.h"
+#include "elxProfiler.h"
 #include "itkOptimizer.h"
 
 namespace elastix
@@ -92,12 +93,25 @@ public:
   virtual void
   SetCurrentPositionPublic(const ParametersType & param);
 
+  /** Execute stuff before the actual registration:
+   * \li Let the scaled cost function (if any) report its evaluations to the profiler.
+   */
+  void
+  BeforeRegistrationBase() override;
+
   /** Execute stuff before each new pyramid resolution:
    * \li Find out if new samples are used every new iteration in this resolution.
+   * \li Start measuring the duration of the first iteration.
    */
   void
   BeforeEachResolutionBase() override;
 
+  /** Execute stuff after each iteration:
+   * \li Add the duration of the iteration to the profiler.
+   */
+  void
+  AfterEachIterationBase() override;
+
   /** Execute stuff after registration:
    * \li Compute and print MD5 hash of the transform parameters.
    */
@@ -143,6 +157,9 @@ private:
    * samples each iteration.
    */
   bool m_NewSamplesEveryIteration{ false };
+
+  /** The time point at which the current iteration started, as far as the profiler is concerned. */
+  Profiler::ClockType::time_point m_IterationStartTime{};
 };
 
 } // end namespace elastix
@@ -21,6 +21,7 @@
 #include "elxOptimizerBase.h"
 #include <itkDeref.h>
 
+#include "itkScaledSingleValuedNonLinearOptimizer.h"
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itk_zlib.h"
 #include <cmath> // For round.
@@ -47,6 +48,24 @@ OptimizerBase<TElastix>::SetCurrentPositionPublic(const ParametersType & /** par
 } // end SetCurrentPositionPublic()
 
 
+/**
+ * ****************** BeforeRegistrationBase **********************
+ */
+
+template <typename TElastix>
+void
+OptimizerBase<TElastix>::BeforeRegistrationBase()
+{
+  using ScaledOptimizerType = itk::ScaledSingleValuedNonLinearOptimizer;
+
+  if (auto * const scaledOptimizer = dynamic_cast<ScaledOptimizerType *>(this->GetAsITKBaseType()))
+  {
+    scaledOptimizer->SetProfiler(&itk::Deref(this->GetElastix()).GetProfiler());
+  }
+
+} // end BeforeRegistrationBase()
+
+
 /**
  * ****************** BeforeEachResolutionBase **********************
  */
@@ -65,9 +84,31 @@ OptimizerBase<TElastix>::BeforeEachResolutionBase()
   configuration.ReadParameter(
     this->m_NewSamplesEveryIteration, "NewSamplesEveryIteration", this->GetComponentLabel(), level, 0);
 
+  this->m_IterationStartTime = Profiler::ClockType::now();
+
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ****************** AfterEachIterationBase **********************
+ */
+
+template <typename TElastix>
+void
+OptimizerBase<TElastix>::AfterEachIterationBase()
+{
+  /** The duration of an iteration includes the step of the optimizer, the evaluations of the cost function, and the
+   * per-iteration output of the previous iteration. */
+  if (Profiler & profiler = itk::Deref(this->GetElastix()).GetProfiler(); profiler.IsEnabled())
+  {
+    const auto now = Profiler::ClockType::now();
+    profiler.AddEvent("Optimizer::Iteration", this->m_IterationStartTime, now);
+    this->m_IterationStartTime = now;
+  }
+
+} // end AfterEachIterationBase()
+
+
 /**
  * ****************** AfterRegistrationBase **********************
  */
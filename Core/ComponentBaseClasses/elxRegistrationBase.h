@@ -22,12 +22,15 @@
 #include "elxMacro.h"
 
 #include "elxBaseComponentSE.h"
+#include "elxDerivedDataCache.h"
 #include "itkMultiResolutionImageRegistrationMethod2.h"
 
 /** Mask support. */
 #include "itkImageMaskSpatialObject.h"
 #include "itkErodeMaskImageFilter.h"
 
+#include <string>
+
 namespace elastix
 {
 
@@ -209,6 +212,12 @@ protected:
 
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
+
+  /** Returns a description of the parameters that define the erosion of a mask, as used by the derived data cache:
+   * the schedule of the pyramid and the resolution level. */
+  template <typename TPyramid>
+  static std::string
+  GetMaskErosionParameters(const TPyramid & pyramid, const unsigned int level);
 };
 
 } // end namespace elastix
@@ -21,6 +21,8 @@
 #include "elxRegistrationBase.h"
 #include <itkDeref.h>
 
+#include <sstream>
+
 namespace elastix
 {
 
@@ -104,53 +106,65 @@ RegistrationBase<TElastix>::GenerateFixedMaskSpatialObject(const FixedMaskImageT
                                                            const FixedImagePyramidType * pyramid,
                                                            unsigned int level) const -> FixedMaskSpatialObjectPointer
 {
-  FixedMaskSpatialObjectPointer fixedMaskSpatialObject; // default-constructed (null)
   if (!maskImage)
   {
-    return fixedMaskSpatialObject;
+    return nullptr;
   }
-  fixedMaskSpatialObject = FixedMaskSpatialObjectType::New();
 
   /** Just convert to spatial object if no erosion is needed. */
   if (!useMaskErosion || !pyramid)
   {
+    const auto fixedMaskSpatialObject = FixedMaskSpatialObjectType::New();
     fixedMaskSpatialObject->SetImage(maskImage);
     fixedMaskSpatialObject->Update();
     return fixedMaskSpatialObject;
   }
 
-  /** Erode, and convert to spatial object. */
-  FixedMaskErodeFilterPointer erosion = FixedMaskErodeFilterType::New();
-  erosion->SetInput(maskImage);
-  erosion->SetSchedule(pyramid->GetSchedule());
-  erosion->SetIsMovingMask(false);
-  erosion->SetResolutionLevel(level);
+  /** Erode, and convert to spatial object. The result of a previous elastix level may be reused. */
+  const auto erodeAndConvert = [maskImage, pyramid, level]() -> FixedMaskSpatialObjectPointer {
+    FixedMaskErodeFilterPointer erosion = FixedMaskErodeFilterType::New();
+    erosion->SetInput(maskImage);
+    erosion->SetSchedule(pyramid->GetSchedule());
+    erosion->SetIsMovingMask(false);
+    erosion->SetResolutionLevel(level);
 
-  /** Set output of the erosion to fixedImageMaskAsImage. */
-  FixedMaskImagePointer erodedFixedMaskAsImage = erosion->GetOutput();
+    /** Set output of the erosion to fixedImageMaskAsImage. */
+    FixedMaskImagePointer erodedFixedMaskAsImage = erosion->GetOutput();
 
-  /** Do the erosion. */
-  try
-  {
-    erodedFixedMaskAsImage->Update();
-  }
-  catch (itk::ExceptionObject & excp)
-  {
-    /** Add information to the exception. */
-    excp.SetLocation("RegistrationBase - UpdateMasks()");
-    std::string err_str = excp.GetDescription();
-    err_str += "\nError while eroding the fixed mask.\n";
-    excp.SetDescription(err_str);
-    /** Pass the exception to an higher level. */
-    throw;
-  }
+    /** Do the erosion. */
+    try
+    {
+      erodedFixedMaskAsImage->Update();
+    }
+    catch (itk::ExceptionObject & excp)
+    {
+      /** Add information to the exception. */
+      excp.SetLocation("RegistrationBase - UpdateMasks()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError while eroding the fixed mask.\n";
+      excp.SetDescription(err_str);
+      /** Pass the exception to an higher level. */
+      throw;
+    }
 
-  /** Release some memory. */
-  erodedFixedMaskAsImage->DisconnectPipeline();
+    /** Release some memory. */
+    erodedFixedMaskAsImage->DisconnectPipeline();
 
-  fixedMaskSpatialObject->SetImage(erodedFixedMaskAsImage);
-  fixedMaskSpatialObject->Update();
-  return fixedMaskSpatialObject;
+    const auto erodedMaskSpatialObject = FixedMaskSpatialObjectType::New();
+    erodedMaskSpatialObject->SetImage(erodedFixedMaskAsImage);
+    erodedMaskSpatialObject->Update();
+    return erodedMaskSpatialObject;
+  };
+
+  DerivedDataCache * const derivedDataCache =
+    Superclass::GetElastix() == nullptr ? nullptr : Superclass::GetElastix()->GetDerivedDataCache();
+
+  if (derivedDataCache == nullptr)
+  {
+    return erodeAndConvert();
+  }
+  return derivedDataCache->RetrieveOrCreate<FixedMaskSpatialObjectType>(
+    "eroded fixed mask", *maskImage, GetMaskErosionParameters(*pyramid, level), erodeAndConvert);
 
 } // end GenerateFixedMaskSpatialObject()
 
@@ -166,55 +180,92 @@ RegistrationBase<TElastix>::GenerateMovingMaskSpatialObject(const MovingMaskImag
                                                             const MovingImagePyramidType * pyramid,
                                                             unsigned int level) const -> MovingMaskSpatialObjectPointer
 {
-  MovingMaskSpatialObjectPointer movingMaskSpatialObject; // default-constructed (null)
   if (!maskImage)
   {
-    return movingMaskSpatialObject;
+    return nullptr;
   }
-  movingMaskSpatialObject = MovingMaskSpatialObjectType::New();
 
   /** Just convert to spatial object if no erosion is needed. */
   if (!useMaskErosion || !pyramid)
   {
+    const auto movingMaskSpatialObject = MovingMaskSpatialObjectType::New();
     movingMaskSpatialObject->SetImage(maskImage);
     movingMaskSpatialObject->Update();
     return movingMaskSpatialObject;
   }
 
-  /** Erode, and convert to spatial object. */
-  MovingMaskErodeFilterPointer erosion = MovingMaskErodeFilterType::New();
-  erosion->SetInput(maskImage);
-  erosion->SetSchedule(pyramid->GetSchedule());
-  erosion->SetIsMovingMask(true);
-  erosion->SetResolutionLevel(level);
+  /** Erode, and convert to spatial object. The result of a previous elastix level may be reused. */
+  const auto erodeAndConvert = [maskImage, pyramid, level]() -> MovingMaskSpatialObjectPointer {
+    MovingMaskErodeFilterPointer erosion = MovingMaskErodeFilterType::New();
+    erosion->SetInput(maskImage);
+    erosion->SetSchedule(pyramid->GetSchedule());
+    erosion->SetIsMovingMask(true);
+    erosion->SetResolutionLevel(level);
 
-  /** Set output of the erosion to movingImageMaskAsImage. */
-  MovingMaskImagePointer erodedMovingMaskAsImage = erosion->GetOutput();
+    /** Set output of the erosion to movingImageMaskAsImage. */
+    MovingMaskImagePointer erodedMovingMaskAsImage = erosion->GetOutput();
 
-  /** Do the erosion. */
-  try
-  {
-    erodedMovingMaskAsImage->Update();
-  }
-  catch (itk::ExceptionObject & excp)
+    /** Do the erosion. */
+    try
+    {
+      erodedMovingMaskAsImage->Update();
+    }
+    catch (itk::ExceptionObject & excp)
+    {
+      /** Add information to the exception. */
+      excp.SetLocation("RegistrationBase - UpdateMasks()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError while eroding the moving mask.\n";
+      excp.SetDescription(err_str);
+      /** Pass the exception to an higher level. */
+      throw;
+    }
+
+    /** Release some memory */
+    erodedMovingMaskAsImage->DisconnectPipeline();
+
+    const auto erodedMaskSpatialObject = MovingMaskSpatialObjectType::New();
+    erodedMaskSpatialObject->SetImage(erodedMovingMaskAsImage);
+    erodedMaskSpatialObject->Update();
+    return erodedMaskSpatialObject;
+  };
+
+  DerivedDataCache * const derivedDataCache =
+    Superclass::GetElastix() == nullptr ? nullptr : Superclass::GetElastix()->GetDerivedDataCache();
+
+  if (derivedDataCache == nullptr)
   {
-    /** Add information to the exception. */
-    excp.SetLocation("RegistrationBase - UpdateMasks()");
-    std::string err_str = excp.GetDescription();
-    err_str += "\nError while eroding the moving mask.\n";
-    excp.SetDescription(err_str);
-    /** Pass the exception to an higher level. */
-    throw;
+    return erodeAndConvert();
   }
+  return derivedDataCache->RetrieveOrCreate<MovingMaskSpatialObjectType>(
+    "eroded moving mask", *maskImage, GetMaskErosionParameters(*pyramid, level), erodeAndConvert);
 
-  /** Release some memory */
-  erodedMovingMaskAsImage->DisconnectPipeline();
+} // end GenerateMovingMaskSpatialObject()
 
-  movingMaskSpatialObject->SetImage(erodedMovingMaskAsImage);
-  movingMaskSpatialObject->Update();
-  return movingMaskSpatialObject;
 
-} // end GenerateMovingMaskSpatialObject()
+/**
+ * ******************* GetMaskErosionParameters **********************
+ */
+
+template <typename TElastix>
+template <typename TPyramid>
+std::string
+RegistrationBase<TElastix>::GetMaskErosionParameters(const TPyramid & pyramid, const unsigned int level)
+{
+  const auto &       schedule = pyramid.GetSchedule();
+  std::ostringstream parameters;
+  parameters << "Level " << level << ", Schedule";
+
+  for (unsigned int i = 0; i < schedule.rows(); ++i)
+  {
+    for (unsigned int j = 0; j < schedule.cols(); ++j)
+    {
+      parameters << ' ' << schedule[i][j];
+    }
+  }
+  return parameters.str();
+
+} // end GetMaskErosionParameters()
 
 
 } // end namespace elastix
@@ -21,6 +21,7 @@
 /** Needed for the macros */
 #include "elxMacro.h"
 
+#include "elxAsynchronousWriter.h"
 #include "elxBaseComponentSE.h"
 #include "elxPixelTypeToString.h"
 #include "itkResampleImageFilter.h"
@@ -183,9 +184,12 @@ public:
   void
   CreateTransformParameterMap(ParameterMapType & parameterMap) const;
 
-  /** Function to perform resample and write the result output image to a file. */
+  /** Function to perform resample and write the result output image to a file. When a writer is specified, the
+   * writing is done asynchronously, by the writer. */
   void
-  ResampleAndWriteResultImage(const std::string & filename, const bool showProgress);
+  ResampleAndWriteResultImage(const std::string &  filename,
+                              const bool           showProgress,
+                              AsynchronousWriter * writer = nullptr);
 
   /** Function to create the result image in the format of an itk::Image. */
   virtual void
@@ -210,9 +214,13 @@ private:
     return {};
   }
 
-  /** Function to write the result output image to a file. */
+  /** Function to write the result output image to a file. When a writer is specified, the writing is done
+   * asynchronously, by the writer, so the image should not be modified anymore afterwards. */
   void
-  WriteResultImage(OutputImageType * imageimage, const std::string & filename, const bool showProgress);
+  WriteResultImage(OutputImageType *    imageimage,
+                   const std::string &  filename,
+                   const bool           showProgress,
+                   AsynchronousWriter * writer = nullptr);
 
   /** Release memory. */
   void
@@ -20,6 +20,7 @@
 
 #include "elxResamplerBase.h"
 #include "elxConversion.h"
+#include "elxProfiler.h"
 #include <itkDeref.h>
 
 #include "itkChangeInformationImageFilter.h"
@@ -169,7 +170,7 @@ ResamplerBase<TElastix>::AfterEachIterationBase()
     /** Apply the final transform, and save the result. */
     try
     {
-      this->ResampleAndWriteResultImage(makeFileName.str(), false);
+      this->ResampleAndWriteResultImage(makeFileName.str(), false, this->GetElastix()->GetIterationOutputWriter());
     }
     catch (const itk::ExceptionObject & excp)
     {
@@ -298,7 +299,9 @@ ResamplerBase<TElastix>::SetComponents()
 
 template <typename TElastix>
 void
-ResamplerBase<TElastix>::ResampleAndWriteResultImage(const std::string & filename, const bool showProgress)
+ResamplerBase<TElastix>::ResampleAndWriteResultImage(const std::string &  filename,
+                                                     const bool           showProgress,
+                                                     AsynchronousWriter * writer)
 {
   ITKBaseType & resampleImageFilter = this->GetSelf();
 
@@ -315,6 +318,7 @@ ResamplerBase<TElastix>::ResampleAndWriteResultImage(const std::string & filenam
   /** Do the resampling. */
   try
   {
+    const elastix::ProfilerScope profilerScope(&this->m_Elastix->GetProfiler(), "Resampler::Update");
     resampleImageFilter.Update();
   }
   catch (itk::ExceptionObject & excp)
@@ -329,8 +333,18 @@ ResamplerBase<TElastix>::ResampleAndWriteResultImage(const std::string & filenam
     throw;
   }
 
-  /** Perform the writing. */
-  this->WriteResultImage(resampleImageFilter.GetOutput(), filename, showProgress);
+  /** Perform the writing. When it is done asynchronously, disconnect the output image from the resampler, to ensure
+   * that the image is not modified while it is being written. */
+  if (writer)
+  {
+    const itk::SmartPointer<OutputImageType> image = resampleImageFilter.GetOutput();
+    image->DisconnectPipeline();
+    this->WriteResultImage(image, filename, showProgress, writer);
+  }
+  else
+  {
+    this->WriteResultImage(resampleImageFilter.GetOutput(), filename, showProgress);
+  }
 
   /** Disconnect from the resampler. */
   if (showProgress && (progressObserver != nullptr))
@@ -347,9 +361,10 @@ ResamplerBase<TElastix>::ResampleAndWriteResultImage(const std::string & filenam
 
 template <typename TElastix>
 void
-ResamplerBase<TElastix>::WriteResultImage(OutputImageType *   image,
-                                          const std::string & filename,
-                                          const bool          showProgress)
+ResamplerBase<TElastix>::WriteResultImage(OutputImageType *    image,
+                                          const std::string &  filename,
+                                          const bool           showProgress,
+                                          AsynchronousWriter * writer)
 {
   ITKBaseType & resampleImageFilter = this->GetSelf();
 
@@ -397,30 +412,54 @@ ResamplerBase<TElastix>::WriteResultImage(OutputImageType *   image,
   {
     log::to_stdout("  Writing image ...");
   }
+  Profiler * const profiler = &this->m_Elastix->GetProfiler();
+  const auto       writeImage = [infoChanger, filename, resultImagePixelType, doCompression, profiler] {
 #ifndef ELX_NO_FILESYSTEM_ACCESS
-  try
-  {
-    itk::WriteCastedImage(*(infoChanger->GetOutput()), filename, resultImagePixelType, doCompression);
-  }
-  catch (itk::ExceptionObject & excp)
-  {
+    try
+    {
+      const elastix::ProfilerScope profilerScope(profiler, "Resampler::WriteResultImage");
+      itk::WriteCastedImage(*(infoChanger->GetOutput()), filename, resultImagePixelType, doCompression);
+    }
+    catch (itk::ExceptionObject & excp)
+    {
 #else
-  // Always throw -- do not include support code or access filesystem with wasm
-  itk::ExceptionObject excp;
+    // Always throw -- do not include support code or access filesystem with wasm
+    itk::ExceptionObject excp;
 #endif
-    /** Add information to the exception. */
-    excp.SetLocation("ResamplerBase - AfterRegistrationBase()");
-    std::string err_str = excp.GetDescription();
-    err_str += "\nError occurred while writing resampled image.\n";
-    excp.SetDescription(err_str);
+      /** Add information to the exception. */
+      excp.SetLocation("ResamplerBase - AfterRegistrationBase()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError occurred while writing resampled image.\n";
+      excp.SetDescription(err_str);
 
-    /** Pass the exception to an higher level. */
+      /** Pass the exception to an higher level. */
 #ifndef ELX_NO_FILESYSTEM_ACCESS
-    throw;
-  }
+      throw;
+    }
 #else
-  throw excp;
+    throw excp;
 #endif
+  };
+
+  if (writer)
+  {
+    /** An asynchronous write is only done for intermediate results, so an error is just reported. */
+    writer->AddTask([writeImage] {
+      try
+      {
+        writeImage();
+      }
+      catch (const itk::ExceptionObject & excp)
+      {
+        log::error(std::ostringstream{} << "Exception caught: \n" << excp << "Resuming elastix.");
+      }
+    });
+  }
+  else
+  {
+    writeImage();
+  }
+
 } // end WriteResultImage()
 
 
@@ -447,6 +486,7 @@ ResamplerBase<TElastix>::CreateItkResultImage()
   /** Do the resampling. */
   try
   {
+    const elastix::ProfilerScope profilerScope(&this->m_Elastix->GetProfiler(), "Resampler::Update");
     resampleImageFilter.Update();
   }
   catch (itk::ExceptionObject & excp)
@@ -57,6 +57,19 @@ namespace elastix
  *   "Compose" by composition: \f$T(x) = T_1 ( T_0(x) )\f$.\n
  *   example: <tt>(HowToCombineTransforms "Add")</tt>\n
  *   Default: "Add".
+ * \parameter TransformParametersOutputFileNameExtension: When specified, the transform parameters are written to a
+ *   separate binary image file with this extension (for example "mha", or "mhd" for a raw data file with a small
+ *   header), instead of as text to the transform parameter file. The transform parameter file then refers to the
+ *   binary file by its "TransformParametersFileName" entry. This avoids converting large numbers of transform
+ *   parameters (like the coefficients of a dense B-spline grid) to and from text.\n
+ *   example: <tt>(TransformParametersOutputFileNameExtension "mha")</tt>\n
+ *   Default: "", which means that the transform parameters are written as text.
+ * \parameter UseTransformParametersPayload: Library only. When "true", the final transform parameters are passed in
+ *   numeric form, as the transform parameters payload of the transform parameter object, instead of by the
+ *   "TransformParameters" entry of the transform parameter map. The transform parameter object of the registration
+ *   can be passed directly to transformix.\n
+ *   example: <tt>(UseTransformParametersPayload "true")</tt>\n
+ *   Default: "false".
  *
  * \transformparameter UseDirectionCosines: Controls whether to use or ignore the
  * direction cosines (world matrix, transform matrix) set in the images.
@@ -105,6 +118,12 @@ namespace elastix
  * \transformparameter TransformParameters: the transform parameter vector that defines the transformation.\n
  * example <tt>(TransformParameters 0.03 1.0 0.2 ...)</tt>\n
  * The number of entries is stored the NumberOfParameters entry.
+ * \transformparameter TransformParametersFileName: the name of a binary image file that holds the transform
+ * parameter vector, as alternative to TransformParameters. A relative path is relative to the directory of the
+ * transform parameter file, or to the current working directory when the transform parameter map is passed in
+ * memory. elastix writes the name of the file, without its directory, as the binary file is written next to the
+ * transform parameter file.\n
+ * example <tt>(TransformParametersFileName "TransformParameters.0-Parameters.mha")</tt>\n
  * \transformparameter NumberOfParameters: the length of the transform parameter vector.\n
  * example <tt>(NumberOfParameters 722)</tt>\n
  * \transformparameter InitialTransformParameterFileName: The location/name of an initial
@@ -238,11 +257,13 @@ public:
   virtual void
   ReadFromFile();
 
-  /** Function to create transform-parameters map. */
+  /** Function to create transform-parameters map. When a transform parameters payload is specified, the transform
+   * parameters are stored in that payload, in numeric form, instead of in the "TransformParameters" entry. */
   void
   CreateTransformParameterMap(const ParametersType & param,
                               ParameterMapType &     parameterMap,
-                              const bool             includeDerivedTransformParameters = true) const;
+                              const bool             includeDerivedTransformParameters = true,
+                              std::vector<double> *  transformParametersPayload = nullptr) const;
 
   /** Function to write transform-parameters to a file. */
   void
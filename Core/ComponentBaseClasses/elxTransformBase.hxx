@@ -32,6 +32,7 @@
 #include "itkTransformToDisplacementFieldFilter.h"
 #include "itkTransformToDeterminantOfSpatialJacobianSource.h"
 #include "itkTransformToSpatialJacobianSource.h"
+#include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
 #include "itkImageGridSampler.h"
 #include "itkContinuousIndex.h"
@@ -290,7 +291,54 @@ TransformBase<TElastix>::ReadFromFile()
   {
     const auto itkParameterValues = configuration.RetrieveValuesOfParameter<double>("ITKTransformParameters");
 
-    if (itkParameterValues == nullptr)
+    const auto & transformParametersPayload = configuration.GetTransformParametersPayload();
+    const auto   transformParametersFileName =
+      configuration.RetrieveParameterStringValue({}, "TransformParametersFileName", 0, false);
+
+    if (itkParameterValues == nullptr && !(transformParametersPayload.empty() && transformParametersFileName.empty()))
+    {
+      /** The transform parameters are in numeric form, either in memory, or in a binary file. */
+      unsigned int numberOfParameters = 0;
+      configuration.ReadParameter(numberOfParameters, "NumberOfParameters", 0);
+
+      if (transformParametersPayload.empty())
+      {
+        /** A relative path is relative to the directory of the transform parameter file. Files that were written
+         * before, with a path relative to the working directory, are still supported. */
+        const std::string parameterFileDirectory =
+          itksys::SystemTools::GetFilenamePath(configuration.GetParameterFileName());
+        std::string resolvedFileName = transformParametersFileName;
+
+        if (!itksys::SystemTools::FileIsFullPath(transformParametersFileName) && !parameterFileDirectory.empty())
+        {
+          resolvedFileName = parameterFileDirectory + '/' + transformParametersFileName;
+
+          if (!itksys::SystemTools::FileExists(resolvedFileName) &&
+              itksys::SystemTools::FileExists(transformParametersFileName))
+          {
+            resolvedFileName = transformParametersFileName;
+          }
+        }
+
+        const auto image = itk::ReadImage<itk::Image<ValueType, 1>>(resolvedFileName);
+
+        m_TransformParameters.SetSize(image->GetBufferedRegion().GetNumberOfPixels());
+        std::copy_n(image->GetBufferPointer(), m_TransformParameters.size(), m_TransformParameters.begin());
+      }
+      else
+      {
+        m_TransformParameters = Conversion::ToOptimizerParameters(transformParametersPayload);
+      }
+
+      if (m_TransformParameters.size() != numberOfParameters)
+      {
+        itkExceptionMacro("\nERROR: Invalid transform parameters!\n"
+                          << "The number of transform parameters in numeric form is " << m_TransformParameters.size()
+                          << ", which does not match the number specified in \"NumberOfParameters\" ("
+                          << numberOfParameters << ").\n");
+      }
+    }
+    else if (itkParameterValues == nullptr)
     {
       /** Get the number of TransformParameters. */
       unsigned int numberOfParameters = 0;
@@ -515,9 +563,37 @@ TransformBase<TElastix>::WriteToFile(std::ostream & transformationParameterInfo,
   const std::string itkTransformOutputFileNameExtension =
     itkTransformOutputFileNameExtensions.empty() ? "" : itkTransformOutputFileNameExtensions.front();
 
-  ParameterMapType parameterMap;
+  const std::string transformParametersOutputFileNameExtension =
+    configuration.RetrieveParameterStringValue("", "TransformParametersOutputFileNameExtension", 0, false);
 
-  this->CreateTransformParameterMap(param, parameterMap, itkTransformOutputFileNameExtension.empty());
+  ParameterMapType    parameterMap;
+  std::vector<double> transformParametersPayload;
+
+  this->CreateTransformParameterMap(param,
+                                    parameterMap,
+                                    itkTransformOutputFileNameExtension.empty(),
+                                    (transformParametersOutputFileNameExtension.empty() ||
+                                     !itkTransformOutputFileNameExtension.empty())
+                                      ? nullptr
+                                      : &transformParametersPayload);
+
+  if (!transformParametersPayload.empty())
+  {
+    /** Write the transform parameters to a separate binary image file, and refer to it by its name. */
+    const std::string transformParametersFileName =
+      std::string(m_TransformParameterFileName, 0, m_TransformParameterFileName.rfind('.')) + "-Parameters." +
+      transformParametersOutputFileNameExtension;
+
+    const auto image = itk::Image<double, 1>::New();
+    image->SetRegions(itk::Size<1>{ { transformParametersPayload.size() } });
+    image->Allocate();
+    std::copy(transformParametersPayload.cbegin(), transformParametersPayload.cend(), image->GetBufferPointer());
+    itk::WriteImage(image, transformParametersFileName);
+
+    /** The binary file is next to the transform parameter file, so it is referred to relative to that file, allowing
+     * both files to be moved together. */
+    parameterMap["TransformParametersFileName"] = { itksys::SystemTools::GetFilenameName(transformParametersFileName) };
+  }
 
   const auto & self = GetSelf();
 
@@ -583,7 +659,8 @@ template <typename TElastix>
 void
 TransformBase<TElastix>::CreateTransformParameterMap(const ParametersType & param,
                                                      ParameterMapType &     parameterMap,
-                                                     const bool             includeDerivedTransformParameters) const
+                                                     const bool             includeDerivedTransformParameters,
+                                                     std::vector<double> *  transformParametersPayload) const
 {
   const Configuration & configuration = itk::Deref(Superclass::GetConfiguration());
 
@@ -628,8 +705,16 @@ TransformBase<TElastix>::CreateTransformParameterMap(const ParametersType & para
   /** Write the parameters of this transform. */
   if (m_ReadWriteTransformParameters)
   {
-    /** In this case, write in a normal way to the parameter file. */
-    parameterMap["TransformParameters"] = { Conversion::ToVectorOfStrings(param) };
+    if (transformParametersPayload == nullptr)
+    {
+      /** In this case, write in a normal way to the parameter file. */
+      parameterMap["TransformParameters"] = { Conversion::ToVectorOfStrings(param) };
+    }
+    else
+    {
+      /** Skip the conversion to strings, and pass the parameters in numeric form. */
+      transformParametersPayload->assign(param.begin(), param.end());
+    }
   }
 
   if (includeDerivedTransformParameters)
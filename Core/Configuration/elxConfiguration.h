@@ -24,6 +24,7 @@
 #include "itkParameterFileParser.h"
 #include "itkParameterMapInterface.h"
 #include <map>
+#include <vector>
 #include "elxlog.h"
 
 namespace elastix
@@ -109,6 +110,20 @@ public:
   itkSetMacro(TotalNumberOfElastixLevels, unsigned int);
   itkGetConstMacro(TotalNumberOfElastixLevels, unsigned int);
 
+  /** Get and Set the transform parameters that come with a transform parameter map in numeric form, instead of as
+   * the strings of its "TransformParameters" entry. Empty when there are none. Library only. */
+  void
+  SetTransformParametersPayload(std::vector<double> transformParametersPayload)
+  {
+    m_TransformParametersPayload = std::move(transformParametersPayload);
+  }
+
+  const std::vector<double> &
+  GetTransformParametersPayload() const
+  {
+    return m_TransformParametersPayload;
+  }
+
   /***/
   bool
   GetPrintErrorMessages() const
@@ -322,6 +337,8 @@ private:
   bool         m_IsInitialized{ false };
   unsigned int m_ElastixLevel{ 0 };
   unsigned int m_TotalNumberOfElastixLevels{ 1 };
+
+  std::vector<double> m_TransformParametersPayload{};
 };
 
 } // end namespace elastix
@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "elxAsynchronousWriter.h" // Its own header
+
+#include <algorithm> // For max.
+#include <utility>   // For move and exchange.
+
+namespace elastix
+{
+
+AsynchronousWriter::AsynchronousWriter(const std::size_t maximumNumberOfPendingTasks)
+  : m_MaximumNumberOfPendingTasks(std::max<std::size_t>(maximumNumberOfPendingTasks, 1))
+  , m_Thread([this] { this->RunBackgroundThread(); })
+{}
+
+
+AsynchronousWriter::~AsynchronousWriter()
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_IsStopping = true;
+  }
+  m_TaskAdded.notify_one();
+  m_Thread.join();
+}
+
+
+void
+AsynchronousWriter::AddTask(TaskType task)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_TaskDone.wait(lock, [this] { return m_PendingTasks.size() < m_MaximumNumberOfPendingTasks; });
+    m_PendingTasks.push_back(std::move(task));
+  }
+  m_TaskAdded.notify_one();
+}
+
+
+void
+AsynchronousWriter::WaitUntilDone()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_TaskDone.wait(lock, [this] { return m_PendingTasks.empty() && !m_IsRunningTask; });
+
+  if (m_Exception)
+  {
+    std::rethrow_exception(std::exchange(m_Exception, nullptr));
+  }
+}
+
+
+void
+AsynchronousWriter::RunBackgroundThread()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  while (true)
+  {
+    m_TaskAdded.wait(lock, [this] { return m_IsStopping || !m_PendingTasks.empty(); });
+
+    if (m_PendingTasks.empty())
+    {
+      // Only stop when all pending tasks are done.
+      return;
+    }
+
+    TaskType task = std::move(m_PendingTasks.front());
+    m_PendingTasks.pop_front();
+    m_IsRunningTask = true;
+    lock.unlock();
+
+    std::exception_ptr exception{};
+    try
+    {
+      task();
+    }
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+
+    lock.lock();
+    m_IsRunningTask = false;
+    if (exception && !m_Exception)
+    {
+      m_Exception = exception;
+    }
+    m_TaskDone.notify_all();
+  }
+}
+
+} // namespace elastix
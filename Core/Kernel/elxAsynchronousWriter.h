@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef elxAsynchronousWriter_h
+#define elxAsynchronousWriter_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace elastix
+{
+
+/**
+ * \class AsynchronousWriter
+ * \brief Performs write tasks (to files, or to the log) on a background thread, in the order in which they were
+ * added.
+ *
+ * The number of pending tasks is bounded: when the backlog is full, AddTask waits until the background thread has
+ * finished a task. So each task should hold a snapshot of the data that it writes, rather than a reference to data
+ * that may still be modified.
+ *
+ * An exception thrown by a task is passed to the next call to WaitUntilDone.
+ *
+ * \ingroup Kernel
+ */
+
+class AsynchronousWriter
+{
+public:
+  using TaskType = std::function<void()>;
+
+  explicit AsynchronousWriter(const std::size_t maximumNumberOfPendingTasks);
+
+  /** Waits until all pending tasks are done, and stops the background thread. */
+  ~AsynchronousWriter();
+
+  AsynchronousWriter(const AsynchronousWriter &) = delete;
+  AsynchronousWriter &
+  operator=(const AsynchronousWriter &) = delete;
+
+  /** Adds a task to the backlog. Waits while the backlog is full. */
+  void
+  AddTask(TaskType task);
+
+  /** Waits until all pending tasks are done. Rethrows the first exception that was thrown by a task, if any. */
+  void
+  WaitUntilDone();
+
+private:
+  void
+  RunBackgroundThread();
+
+  const std::size_t m_MaximumNumberOfPendingTasks;
+
+  std::mutex              m_Mutex{};
+  std::condition_variable m_TaskAdded{};
+  std::condition_variable m_TaskDone{};
+  std::deque<TaskType>    m_PendingTasks{};
+  bool                    m_IsRunningTask{ false };
+  bool                    m_IsStopping{ false };
+  std::exception_ptr      m_Exception{};
+
+  /** The background thread. Declared last, so that it starts after the other data members are initialized. */
+  std::thread m_Thread;
+};
+
+} // namespace elastix
+
+#endif
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "elxDerivedDataCache.h" // Its own header
+#include "elxlog.h"
+
+#include <sstream>
+
+namespace elastix
+{
+
+void
+DerivedDataCache::Clear()
+{
+  m_Entries.clear();
+}
+
+
+void
+DerivedDataCache::RemoveUnusedEntries()
+{
+  std::size_t numberOfRemovedEntries{};
+
+  for (auto it = m_Entries.begin(); it != m_Entries.end();)
+  {
+    if (it->second.isUsed)
+    {
+      it->second.isUsed = false;
+      ++it;
+    }
+    else
+    {
+      it = m_Entries.erase(it);
+      ++numberOfRemovedEntries;
+    }
+  }
+
+  if (numberOfRemovedEntries > 0)
+  {
+    log::info(std::ostringstream{} << "Derived data cache: removed " << numberOfRemovedEntries
+                                   << " unused entries, keeping " << m_Entries.size() << '.');
+  }
+}
+
+
+std::string
+DerivedDataCache::MakeKey(const std::string & kind, const itk::DataObject & source, const std::string & parameters)
+{
+  std::ostringstream key;
+  key << kind << '|' << static_cast<const void *>(&source) << '|' << source.GetMTime() << '|' << parameters;
+  return key.str();
+}
+
+
+itk::Object *
+DerivedDataCache::Retrieve(const std::string & key, const std::string & kind)
+{
+  const auto found = m_Entries.find(key);
+
+  if (found == m_Entries.end())
+  {
+    return nullptr;
+  }
+
+  Entry & entry = found->second;
+  entry.isUsed = true;
+  ++m_NumberOfHits;
+  m_SavedTimeInSeconds += entry.computationTimeInSeconds;
+
+  log::info(std::ostringstream{} << "  Reusing " << kind << " from the derived data cache, saving "
+                                 << entry.computationTimeInSeconds << " s.");
+  return entry.object;
+}
+
+
+void
+DerivedDataCache::Store(const std::string &     key,
+                        const itk::DataObject & source,
+                        itk::Object * const     object,
+                        const double            computationTimeInSeconds)
+{
+  m_Entries[key] = { &source, object, computationTimeInSeconds };
+}
+
+
+void
+DerivedDataCache::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfEntries: " << m_Entries.size() << '\n';
+  os << indent << "NumberOfHits: " << m_NumberOfHits << '\n';
+  os << indent << "SavedTimeInSeconds: " << m_SavedTimeInSeconds << '\n';
+}
+
+} // namespace elastix
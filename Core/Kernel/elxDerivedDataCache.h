@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef elxDerivedDataCache_h
+#define elxDerivedDataCache_h
+
+#include <itkDataObject.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkTimeProbe.h>
+
+#include <map>
+#include <string>
+
+namespace elastix
+{
+
+/**
+ * \class DerivedDataCache
+ * \brief Stores data that is derived from the input images or masks, so that it can be reused by the next elastix
+ * level of a chain of parameter files, instead of being computed again. For example, the eroded masks, the outputs of
+ * the image pyramids, and the extrema of these outputs.
+ *
+ * Each entry is identified by a key that consists of a description of the kind of data, the identity of the source
+ * data object (its address and its modification time), and a description of the parameters that define the derived
+ * data. The cache holds a reference to the source object, so that its address cannot be reused by another object
+ * while the entry exists. Each hit is logged, together with the computation time that it saved.
+ *
+ * Entries that are neither stored nor retrieved during an elastix level are not expected to be reused by the next
+ * levels either, so they are removed by RemoveUnusedEntries() at the end of each level, to release their memory.
+ *
+ * The cache is not thread-safe: it is meant to be accessed by the elastix components during their initialization.
+ *
+ * \ingroup Kernel
+ */
+
+class DerivedDataCache : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(DerivedDataCache);
+
+  /** Standard itk. */
+  using Self = DerivedDataCache;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkOverrideGetNameOfClassMacro(DerivedDataCache);
+
+  /** Returns the cached object that was derived from the specified source, with the specified parameters, or
+   * creates it by calling create(), and stores it in the cache. */
+  template <typename TObject, typename TCreateFunction>
+  itk::SmartPointer<TObject>
+  RetrieveOrCreate(const std::string &     kind,
+                   const itk::DataObject & source,
+                   const std::string &     parameters,
+                   const TCreateFunction & create)
+  {
+    const std::string key = MakeKey(kind, source, parameters);
+
+    if (const auto cachedObject = dynamic_cast<TObject *>(this->Retrieve(key, kind)))
+    {
+      return cachedObject;
+    }
+
+    itk::TimeProbe timer;
+    timer.Start();
+    const itk::SmartPointer<TObject> object = create();
+    timer.Stop();
+
+    this->Store(key, source, object, timer.GetMean());
+    return object;
+  }
+
+  /** Removes all entries. */
+  void
+  Clear();
+
+  /** Removes the entries that are not stored or retrieved since the previous call, and logs their number. */
+  void
+  RemoveUnusedEntries();
+
+  /** Returns the number of entries. */
+  std::size_t
+  GetNumberOfEntries() const
+  {
+    return m_Entries.size();
+  }
+
+  /** Returns the total number of cache hits, and the total computation time that they saved. */
+  itkGetConstMacro(NumberOfHits, unsigned int);
+  itkGetConstMacro(SavedTimeInSeconds, double);
+
+protected:
+  DerivedDataCache() = default;
+  ~DerivedDataCache() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  struct Entry
+  {
+    itk::DataObject::ConstPointer source{};
+    itk::Object::Pointer          object{};
+    double                        computationTimeInSeconds{};
+    bool                          isUsed{ true };
+  };
+
+  static std::string
+  MakeKey(const std::string & kind, const itk::DataObject & source, const std::string & parameters);
+
+  /** Returns the cached object, or null when there is no entry with the specified key. Logs a hit. */
+  itk::Object *
+  Retrieve(const std::string & key, const std::string & kind);
+
+  void
+  Store(const std::string &     key,
+        const itk::DataObject & source,
+        itk::Object * const     object,
+        const double            computationTimeInSeconds);
+
+  std::map<std::string, Entry> m_Entries{};
+  unsigned int                 m_NumberOfHits{};
+  double                       m_SavedTimeInSeconds{};
+};
+
+} // namespace elastix
+
+#endif
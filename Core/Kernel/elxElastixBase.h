@@ -28,12 +28,15 @@
 #ifndef elxElastixBase_h
 #define elxElastixBase_h
 
+#include "elxAsynchronousWriter.h"
 #include "elxBaseComponent.h"
 #include "elxComponentDatabase.h"
 #include "elxConfiguration.h"
 #include "elxDefaultConstruct.h"
+#include "elxDerivedDataCache.h"
 #include "elxIterationInfo.h"
 #include "elxMacro.h"
+#include "elxProfiler.h"
 #include "elxlog.h"
 
 // ITK header files:
@@ -47,6 +50,7 @@
 
 #include <fstream>
 #include <iomanip>
+#include <memory>
 
 /** Like itkGet/SetObjectMacro, but in these macros the itkDebugMacro is
  * not called. Besides, they are not virtual, since
@@ -239,6 +243,10 @@ public:
   elxSetObjectMacro(FixedPoints, const itk::Object);
   elxSetObjectMacro(MovingPoints, const itk::Object);
 
+  /** Set/Get the cache of data derived from the images and masks, which may be shared by subsequent elastix levels. */
+  elxGetObjectMacro(DerivedDataCache, DerivedDataCache);
+  elxSetObjectMacro(DerivedDataCache, DerivedDataCache);
+
   /** Set/Get the result image container. */
   elxGetObjectMacro(ResultImageContainer, DataObjectContainerType);
   elxSetObjectMacro(ResultImageContainer, DataObjectContainerType);
@@ -361,6 +369,14 @@ public:
   ParameterMapType
   GetTransformParameterMap() const;
 
+  /** Gets the numeric transform parameters that come with the transformation parameters map, instead of its
+   * "TransformParameters" entry. Empty, unless the parameter "UseTransformParametersPayload" is true. */
+  const std::vector<double> &
+  GetTransformParametersPayload() const
+  {
+    return m_TransformParametersPayload;
+  }
+
   /** Set configuration vector. Library only. */
   void
   SetTransformConfigurations(const std::vector<Configuration::ConstPointer> & configurations);
@@ -396,6 +412,22 @@ public:
     m_IterationInfo.AddNewTargetCell(name);
   }
 
+  /** Returns the writer of the per-iteration output, or null when the per-iteration output is written synchronously.
+   * See the parameter "AsynchronousIterationOutput" of ElastixTemplate. */
+  AsynchronousWriter *
+  GetIterationOutputWriter() const
+  {
+    return m_IterationOutputWriter.get();
+  }
+
+  /** Returns the profiler of this registration, which is disabled by default. See the "-profile" command-line
+   * argument and the parameter "EnableProfiling" of ElastixTemplate. */
+  Profiler &
+  GetProfiler()
+  {
+    return m_Profiler;
+  }
+
 protected:
   ElastixBase();
   ~ElastixBase() override = default;
@@ -418,8 +450,19 @@ protected:
   /** Stores transformation parameters map. */
   ParameterMapType m_TransformParameterMap;
 
+  /** Stores the numeric transform parameters that come with the transformation parameters map. */
+  std::vector<double> m_TransformParametersPayload;
+
+  /** Measures the phases of this registration. Declared before m_IterationOutputWriter, as the pending writes may still
+   * add their events. */
+  Profiler m_Profiler{};
+
   std::ofstream m_IterationInfoFile;
 
+  /** Writes the per-iteration output on a background thread. Declared after m_IterationInfoFile, so that it is
+   * destructed (finishing the pending writes) before the file is closed. */
+  std::unique_ptr<AsynchronousWriter> m_IterationOutputWriter;
+
   /** Convenient mini class to load the files specified by a filename container
    * The function GenerateImageContainer can be used without instantiating an
    * object of this class, since it is static. It has 2 arguments: the
@@ -527,6 +570,9 @@ private:
   itk::SmartPointer<const itk::Object> m_FixedPoints{ nullptr };
   itk::SmartPointer<const itk::Object> m_MovingPoints{ nullptr };
 
+  /** The cache of data derived from the images and masks. */
+  DerivedDataCache::Pointer m_DerivedDataCache{ DerivedDataCache::New() };
+
   /** The result image container. These are stored as pointers to itk::DataObject. */
   DataObjectContainerPointer m_ResultImageContainer{ DataObjectContainerType::New() };
 
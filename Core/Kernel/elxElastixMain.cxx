@@ -157,6 +157,15 @@ ElastixMain::Run()
   elastixBase.SetFixedPoints(m_FixedPoints);
   elastixBase.SetMovingPoints(m_MovingPoints);
 
+  /** Set the derived data cache, possibly shared with a previous elastix level. */
+  if (m_DerivedDataCache.IsNull())
+  {
+    m_DerivedDataCache = DerivedDataCache::New();
+  }
+  const unsigned int numberOfPreviousCacheHits = m_DerivedDataCache->GetNumberOfHits();
+  const double       previouslySavedTime = m_DerivedDataCache->GetSavedTimeInSeconds();
+  elastixBase.SetDerivedDataCache(m_DerivedDataCache);
+
   /** Set the initial transform, if it happens to be there. */
   elastixBase.SetInitialTransform(this->GetModifiableInitialTransform());
 
@@ -190,11 +199,24 @@ ElastixMain::Run()
     errorCode = 1;
   }
 
+  /** Report the reuse of derived data by this elastix level. */
+  if (m_DerivedDataCache->GetNumberOfHits() > numberOfPreviousCacheHits)
+  {
+    log::info(std::ostringstream{} << "Derived data cache: "
+                                   << m_DerivedDataCache->GetNumberOfHits() - numberOfPreviousCacheHits
+                                   << " hit(s), saving "
+                                   << m_DerivedDataCache->GetSavedTimeInSeconds() - previouslySavedTime << " s.");
+  }
+
+  /** Release the derived data that is not used by this elastix level, as the next levels will not use it either. */
+  m_DerivedDataCache->RemoveUnusedEntries();
+
   /** Return the final transform. */
   m_FinalTransform = elastixBase.GetFinalTransform();
 
   /** Get the transformation parameter map */
   m_TransformParameterMap = elastixBase.GetTransformParameterMap();
+  m_TransformParametersPayload = elastixBase.GetTransformParametersPayload();
 
   /** Store the images in ElastixMain. */
   this->SetFixedImageContainer(elastixBase.GetFixedImageContainer());
@@ -233,6 +255,10 @@ ElastixMain::RunWithInitialTransformParameterMaps(const ArgumentMapType &
      */
     const auto configuration = Configuration::New();
     int        dummy = configuration->Initialize(argmap, initialTransformParameterMaps[i]);
+    if (i < m_TransformParametersPayloads.size())
+    {
+      configuration->SetTransformParametersPayload(std::move(m_TransformParametersPayloads[i]));
+    }
     m_TransformConfigurations[i] = configuration;
     if (dummy)
     {
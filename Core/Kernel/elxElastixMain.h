@@ -46,6 +46,12 @@ namespace elastix
  * to this type.\n
  * example: <tt>(MovingInternalImagePixelType "float")</tt>\n
  * Default/recommended: "float"\n
+ * The internal pixel types must be among the types elastix was compiled for
+ * (CMake: ELASTIX_IMAGE_nD_PIXELTYPES). For large 16-bit integer images (for example CT scans),
+ * "short" halves the memory of the internal images and their pyramids, compared to "float".
+ * The samplers and interpolators convert the stored pixel values to real values on the fly.
+ * In that case, use the FixedGenericImagePyramid and MovingGenericImagePyramid: they compute
+ * the smoothed levels in floating point and round them, whereas the other pyramids truncate.\n
  *
  * \transformparameter FixedImageDimension: the dimension of the fixed image. \n
  * example: <tt>(FixedImageDimension 2)</tt>\n
@@ -101,6 +107,13 @@ public:
   itkSetConstObjectMacro(FixedPoints, itk::Object);
   itkSetConstObjectMacro(MovingPoints, itk::Object);
 
+  /** Set/Get the cache of data derived from the images and masks. Passing the cache of one instance to the next
+   * one allows the next elastix level to reuse, for example, the eroded masks. If it is not set, Run() creates a new
+   * cache.
+   */
+  itkSetObjectMacro(DerivedDataCache, DerivedDataCache);
+  itkGetModifiableObjectMacro(DerivedDataCache, DerivedDataCache);
+
   /** Get the final transform (the result of running elastix).
    * You may pass this as an InitialTransform in an other instantiation
    * of ElastixMain.
@@ -156,6 +169,14 @@ public:
   virtual ParameterMapType
   GetTransformParameterMap() const;
 
+  /** Returns the numeric transform parameters that come with the transform parameter map, when the parameter
+   * "UseTransformParametersPayload" is true. Otherwise, returns an empty vector. */
+  const std::vector<double> &
+  GetTransformParametersPayload() const
+  {
+    return m_TransformParametersPayload;
+  }
+
 protected:
   ElastixMain();
   ~ElastixMain() override;
@@ -181,6 +202,8 @@ private:
   itk::SmartPointer<const itk::Object> m_FixedPoints{ nullptr };
   itk::SmartPointer<const itk::Object> m_MovingPoints{ nullptr };
 
+  DerivedDataCache::Pointer m_DerivedDataCache{ nullptr };
+
 
   /** A transform that is the result of registration. */
   ObjectPointer m_FinalTransform{ nullptr };
@@ -193,6 +216,9 @@ private:
    */
   ParameterMapType m_TransformParameterMap{};
 
+  /** The numeric transform parameters that come with m_TransformParameterMap, if any. */
+  std::vector<double> m_TransformParametersPayload{};
+
   FlatDirectionCosinesType m_OriginalFixedImageDirectionFlat{};
 };
 
@@ -83,6 +83,28 @@ namespace elastix
  *    example: <tt>(WriteTransformParametersEachResolution "true")</tt>\n
  *    This parameter can not be specified for each resolution separately.
  *    Default value: "false".
+ * \parameter EnableProfiling: Controls whether to measure the time spent in the phases of
+ *    the registration (optimizer iterations, image sampler update, metric computation, derivative
+ *    accumulation, resampling, etc.). When enabled, a summary (count, total, mean and maximum per
+ *    phase) is logged after each resolution, and a trace
+ *    is saved as "Profile.<elastix level>.json" in the output directory, which can be viewed
+ *    by chrome://tracing. Profiling may also be enabled by the command-line argument
+ *    <tt>-profile true</tt>.\n
+ *    example: <tt>(EnableProfiling "true")</tt>\n
+ *    This parameter can not be specified for each resolution separately.
+ *    Default value: "false".
+ * \parameter AsynchronousIterationOutput: Controls whether to write the output of each iteration
+ *    (the iteration info, and the files of WriteTransformParametersEachIteration and
+ *    WriteResultImageAfterEachIteration) on a background thread, so that the iterations do not
+ *    have to wait for the file system. The output of all iterations of a resolution is written
+ *    before the end of that resolution.\n
+ *    example: <tt>(AsynchronousIterationOutput "true")</tt>\n
+ *    This parameter can not be specified for each resolution separately.
+ *    Default value: "false".
+ * \parameter MaximumIterationOutputBacklog: The maximum number of pending writes, when
+ *    AsynchronousIterationOutput is true. When the backlog is full, the next iteration waits.\n
+ *    example: <tt>(MaximumIterationOutputBacklog 4)</tt>\n
+ *    Default value: 16.
  * \parameter UseDirectionCosines: Controls whether to use or ignore the
  * direction cosines (world matrix, transform matrix) set in the images.
  * Voxel spacing and image origin are always taken into account, regardless
@@ -263,9 +285,9 @@ private:
   AfterEachIterationCommandPointer   m_AfterEachIterationCommand{};
   AfterEachResolutionCommandPointer  m_AfterEachResolutionCommand{};
 
-  /** CreateTransformParameterFile. */
+  /** CreateTransformParameterFile. When a writer is specified, the file is written asynchronously, by the writer. */
   void
-  CreateTransformParameterFile(const std::string & FileName, const bool ToLog);
+  CreateTransformParameterFile(const std::string & FileName, const bool ToLog, AsynchronousWriter * writer = nullptr);
 
   /** CreateTransformParameterMap. */
   void
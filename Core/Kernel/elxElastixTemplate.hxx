@@ -19,6 +19,7 @@
 #  define elxElastixTemplate_hxx
 
 #  include "elxElastixTemplate.h"
+#  include "elxProfiler.h"
 #  include <itkDeref.h>
 
 #  define elxCheckAndSetComponentMacro(_name)                                                                         \
@@ -488,6 +489,25 @@ ElastixTemplate<TFixedImage, TMovingImage>::BeforeRegistration()
   ElastixBase::m_Timer0.Reset();
   ElastixBase::m_Timer0.Start();
 
+  /** Enable the profiler, if desired. Enabling clears the events of a previous registration. */
+  const Configuration & configuration = itk::Deref(ElastixBase::GetConfiguration());
+  const std::string     profileArgument = configuration.GetCommandLineArgument("-profile");
+  ElastixBase::GetProfiler().SetEnabled(profileArgument.empty()
+                                          ? configuration.RetrieveParameterValue(false, "EnableProfiling", 0, false)
+                                          : (profileArgument == "true"));
+
+  /** Optionally write the per-iteration output (iteration info, transform parameter files and result images) on a
+   * background thread, so that the iterations do not have to wait for the file system. */
+  if (configuration.RetrieveParameterValue(false, "AsynchronousIterationOutput", 0, false))
+  {
+    ElastixBase::m_IterationOutputWriter = std::make_unique<AsynchronousWriter>(
+      configuration.RetrieveParameterValue(16u, "MaximumIterationOutputBacklog", 0, false));
+  }
+  else
+  {
+    ElastixBase::m_IterationOutputWriter.reset();
+  }
+
   /** Call all the BeforeRegistration() functions. */
   this->BeforeRegistrationBase();
   CallInEachComponent(&BaseComponentType::BeforeRegistrationBase);
@@ -537,6 +557,9 @@ ElastixTemplate<TFixedImage, TMovingImage>::BeforeEachResolution()
   /** Reset the ElastixBase::m_IterationCounter. */
   ElastixBase::m_IterationCounter = 0;
 
+  /** Associate the profiled events from now on with this resolution. */
+  ElastixBase::GetProfiler().SetCurrentResolution(level);
+
   /** Print the current resolution. */
   log::info(std::ostringstream{} << "\nResolution: " << level);
 
@@ -584,12 +607,24 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachResolution()
   /** Get current resolution level. */
   unsigned long level = this->GetElxRegistrationBase()->GetAsITKBaseType()->GetCurrentLevel();
 
+  /** Finish writing the output of the iterations of this resolution. */
+  if (const auto writer = ElastixBase::GetIterationOutputWriter())
+  {
+    writer->WaitUntilDone();
+  }
+
   /** Print the total iteration time. */
   ElastixBase::m_ResolutionTimer.Stop();
   log::info(std::ostringstream{} << std::setprecision(3) << "Time spent in resolution " << (level)
                                  << " (ITK initialization and iterating): "
                                  << ElastixBase::m_ResolutionTimer.GetMean());
 
+  /** Print the time spent in each of the profiled phases of this resolution. */
+  if (const Profiler & profiler = ElastixBase::GetProfiler(); profiler.IsEnabled())
+  {
+    log::info(std::ostringstream{} << "Profile of resolution " << level << ":\n" << profiler.GetSummary(level));
+  }
+
   /** Call all the AfterEachResolution() functions. */
   this->AfterEachResolutionBase();
   CallInEachComponent(&BaseComponentType::AfterEachResolutionBase);
@@ -640,6 +675,8 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachIteration()
     this->GetIterationInfo().WriteHeaders();
   }
 
+  const ProfilerScope profilerScope(&ElastixBase::GetProfiler(), "ElastixTemplate::AfterEachIteration");
+
   /** Call all the AfterEachIteration() functions. */
   this->AfterEachIterationBase();
   CallInEachComponent(&BaseComponentType::AfterEachIterationBase);
@@ -653,7 +690,7 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachIteration()
   this->GetIterationInfoAt("Time[ms]") << ElastixBase::m_IterationTimer.GetMean() * 1000.0;
 
   /** Write the iteration info of this iteration. */
-  this->GetIterationInfo().WriteBufferedData();
+  this->GetIterationInfo().WriteBufferedData(ElastixBase::GetIterationOutputWriter());
 
   const Configuration & configuration = itk::Deref(ElastixBase::GetConfiguration());
 
@@ -695,7 +732,7 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachIteration()
     std::string tpFileName = makeFileName.str();
 
     /** Create a TransformParameterFile for this iteration. */
-    this->CreateTransformParameterFile(tpFileName, false);
+    this->CreateTransformParameterFile(tpFileName, false, ElastixBase::GetIterationOutputWriter());
   }
 
   /** Count the number of iterations. */
@@ -719,6 +756,13 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterRegistration()
   itk::TimeProbe timer;
   timer.Start();
 
+  /** The remaining output is written synchronously. */
+  if (ElastixBase::m_IterationOutputWriter)
+  {
+    ElastixBase::m_IterationOutputWriter->WaitUntilDone();
+    ElastixBase::m_IterationOutputWriter.reset();
+  }
+
   /** A white line. */
   elx::log::info("");
 
@@ -765,6 +809,28 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterRegistration()
   log::info(std::ostringstream{} << "Time spent on saving the results, applying the final transform etc.: "
                                  << static_cast<std::uint64_t>(ElastixBase::m_Timer0.GetMean() * 1000) << " ms.");
 
+  /** Save the profiled events, and stop profiling. */
+  if (Profiler & profiler = ElastixBase::GetProfiler(); profiler.IsEnabled())
+  {
+    profiler.SetEnabled(false);
+
+    if (!outputDirectoryPath.empty())
+    {
+      const std::string fileName =
+        outputDirectoryPath + "Profile." + std::to_string(configuration.GetElastixLevel()) + ".json";
+      std::ofstream traceFile(fileName);
+      if (traceFile.is_open())
+      {
+        traceFile << profiler.ToChromeTrace();
+        log::info("Profile written to " + fileName);
+      }
+      else
+      {
+        log::warn("WARNING: Failed to open " + fileName + " for writing the profile.");
+      }
+    }
+  }
+
 } // end AfterRegistration()
 
 
@@ -777,7 +843,9 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterRegistration()
 
 template <typename TFixedImage, typename TMovingImage>
 void
-ElastixTemplate<TFixedImage, TMovingImage>::CreateTransformParameterFile(const std::string & fileName, const bool toLog)
+ElastixTemplate<TFixedImage, TMovingImage>::CreateTransformParameterFile(const std::string &  fileName,
+                                                                         const bool           toLog,
+                                                                         AsynchronousWriter * writer)
 {
   /** Store CurrentTransformParameterFileName. */
   ElastixBase::m_CurrentTransformParameterFileName = fileName;
@@ -803,22 +871,34 @@ ElastixTemplate<TFixedImage, TMovingImage>::CreateTransformParameterFile(const s
   this->GetElxResampleInterpolatorBase()->WriteToFile(transformationParameterInfo);
   this->GetElxResamplerBase()->WriteToFile(transformationParameterInfo);
 
-  std::ofstream transformParameterFile(fileName);
+  /** Write the text that is created now (a snapshot of the current parameters) either directly, or by the writer. */
+  const auto writeTransformParameterFile = [fileName, text = transformationParameterInfo.str(), toLog] {
+    std::ofstream transformParameterFile(fileName);
 
-  if (transformParameterFile.is_open())
+    if (transformParameterFile.is_open())
+    {
+      transformParameterFile << text;
+    }
+    else
+    {
+      log::error(std::ostringstream{} << "ERROR: File \"" << fileName << "\" could not be opened!");
+    }
+
+    /** Separate clearly in log-file. */
+    if (toLog)
+    {
+      log::info_to_log_file(text);
+      log::info_to_log_file("=============== end of TransformParameterFile ===============");
+    }
+  };
+
+  if (writer)
   {
-    transformParameterFile << transformationParameterInfo.str();
+    writer->AddTask(writeTransformParameterFile);
   }
   else
   {
-    log::error(std::ostringstream{} << "ERROR: File \"" << fileName << "\" could not be opened!");
-  }
-
-  /** Separate clearly in log-file. */
-  if (toLog)
-  {
-    log::info_to_log_file(transformationParameterInfo.str());
-    log::info_to_log_file("=============== end of TransformParameterFile ===============");
+    writeTransformParameterFile();
   }
 
 } // end CreateTransformParameterFile()
@@ -832,8 +912,17 @@ template <typename TFixedImage, typename TMovingImage>
 void
 ElastixTemplate<TFixedImage, TMovingImage>::CreateTransformParameterMap()
 {
+  /** Optionally pass the transform parameters in numeric form, to avoid converting them to strings. */
+  const Configuration & configuration = itk::Deref(ElastixBase::GetConfiguration());
+  const bool            useTransformParametersPayload =
+    configuration.RetrieveParameterValue(false, "UseTransformParametersPayload", 0, false);
+
+  ElastixBase::m_TransformParametersPayload.clear();
   this->GetElxTransformBase()->CreateTransformParameterMap(
-    this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition(), ElastixBase::m_TransformParameterMap);
+    this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition(),
+    ElastixBase::m_TransformParameterMap,
+    true,
+    useTransformParametersPayload ? &ElastixBase::m_TransformParametersPayload : nullptr);
   this->GetElxResampleInterpolatorBase()->CreateTransformParameterMap(ElastixBase::m_TransformParameterMap);
   this->GetElxResamplerBase()->CreateTransformParameterMap(ElastixBase::m_TransformParameterMap);
 
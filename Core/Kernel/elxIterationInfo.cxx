@@ -18,12 +18,14 @@
 
 
 #include "elxIterationInfo.h" // Its own header
+#include "elxAsynchronousWriter.h"
 #include "elxlog.h"
 
 #include <fstream>
 #include <map>
 #include <sstream>
 #include <string>
+#include <utility> // For move.
 
 
 namespace elastix
@@ -76,7 +78,7 @@ IterationInfo::WriteHeaders() const
 
 
 void
-IterationInfo::WriteBufferedData()
+IterationInfo::WriteBufferedData(AsynchronousWriter * const writer)
 {
   std::string data;
   const auto  begin = m_CellMap.cbegin();
@@ -92,11 +94,22 @@ IterationInfo::WriteBufferedData()
       data += it->second.str();
     }
   }
-  log::info(data);
+  const auto writeData = [data = std::move(data), outputFile = m_OutputFile] {
+    log::info(data);
 
-  if (m_OutputFile)
+    if (outputFile)
+    {
+      *outputFile << data << std::endl;
+    }
+  };
+
+  if (writer)
+  {
+    writer->AddTask(writeData);
+  }
+  else
   {
-    *m_OutputFile << data << std::endl;
+    writeData();
   }
 
   for (auto & cell : m_CellMap)
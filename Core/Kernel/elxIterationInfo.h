@@ -26,6 +26,7 @@
 
 namespace elastix
 {
+class AsynchronousWriter;
 
 class IterationInfo
 {
@@ -42,8 +43,10 @@ public:
   void
   WriteHeaders() const;
 
+  /** Writes the buffered data to the log and the output file, and clears the buffer. When a writer is specified, the
+   * data is written asynchronously, by the writer. */
   void
-  WriteBufferedData();
+  WriteBufferedData(AsynchronousWriter * const writer = nullptr);
 
   void
   RemoveOutputFile();
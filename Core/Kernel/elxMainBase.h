@@ -113,6 +113,14 @@ public:
   itkSetObjectMacro(Configuration, Configuration);
   itkGetModifiableObjectMacro(Configuration, Configuration);
 
+  /** Set the numeric transform parameters that come with the transform parameter maps passed to Run(), one per map.
+   * An empty entry means that the corresponding map holds its own "TransformParameters". Library only. */
+  void
+  SetTransformParametersPayloads(std::vector<std::vector<double>> transformParametersPayloads)
+  {
+    m_TransformParametersPayloads = std::move(transformParametersPayloads);
+  }
+
   /** Functions to get pointers to the elastix components.
    * The components are returned as Object::Pointer.
    * Before calling this functions, call run().
@@ -183,6 +191,9 @@ protected:
   /** A vector of configuration objects, needed when transformix is used as library. */
   std::vector<Configuration::ConstPointer> m_TransformConfigurations{};
 
+  /** The numeric transform parameters for the transform configurations, if any. */
+  std::vector<std::vector<double>> m_TransformParametersPayloads{};
+
   /** Description of the ImageTypes. */
   PixelTypeDescriptionType m_FixedImagePixelType{};
   ImageDimensionType       m_FixedImageDimension{ 0 };
@@ -303,6 +303,10 @@ TransformixMain::EnterCommandLineArgumentsWithTransformParameterMaps(
      */
     const auto configuration = Configuration::New();
     int        dummy = configuration->Initialize(argmap, transformParameterMaps[i]);
+    if (i < m_TransformParametersPayloads.size())
+    {
+      configuration->SetTransformParametersPayload(std::move(m_TransformParametersPayloads[i]));
+    }
     m_TransformConfigurations[i] = configuration;
     if (dummy)
     {
@@ -47,8 +47,10 @@
 
 #include <algorithm> // For transform
 #include <cmath>     // For M_PI
+#include <fstream>
 #include <map>
 #include <random>
+#include <sstream>
 #include <string>
 #include <utility> // For pair
 
@@ -3103,3 +3105,204 @@ GTEST_TEST(itkElastixRegistrationMethod, OutputTransformParameterFileFormat)
 
   EXPECT_EQ(parameterMapsFromToml, parameterMapsFromText);
 }
+
+
+// Checks that a memory budget for the finite difference derivative of AdvancedMattesMutualInformation (which makes
+// the metric process the B-spline parameters in blocks) does not affect the registration result.
+GTEST_TEST(itkElastixRegistrationMethod, FiniteDifferenceDerivativeMaximumMemory)
+{
+  static constexpr auto ImageDimension = 2U;
+  using PixelType = float;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+
+  const auto imageSize = SizeType::Filled(64);
+  const auto fixedImage = CreateImageFilledWithSequenceOfNaturalNumbers<PixelType>(imageSize);
+  const auto movingImage = CreateImage<PixelType>(imageSize);
+  FillImageRegionWithSequenceOfNaturalNumbers(*movingImage, IndexType{ { 9, 7 } }, SizeType::Filled(48));
+
+  const auto getTransformParameters = [&fixedImage, &movingImage](const std::string & maximumMemory) {
+    elx::DefaultConstruct<ElastixRegistrationMethodType<ImageType>> registration{};
+    registration.SetFixedImage(fixedImage);
+    registration.SetMovingImage(movingImage);
+    registration.SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                            { "AutomaticTransformInitialization", "false" },
+                                                            { "FinalGridSpacingInVoxels", "4" },
+                                                            { "FiniteDifferenceDerivative", "true" },
+                                                            { "FiniteDifferenceDerivativeMaximumMemory", maximumMemory },
+                                                            { "ImageSampler", "Full" },
+                                                            { "MaximumNumberOfIterations", "2" },
+                                                            { "Metric", "AdvancedMattesMutualInformation" },
+                                                            { "NumberOfHistogramBins", "64" },
+                                                            { "NumberOfResolutions", "1" },
+                                                            { "Optimizer", "StandardGradientDescent" },
+                                                            { "Transform", "BSplineTransform" } }));
+    registration.Update();
+    return GetTransformParametersFromFilter(registration);
+  };
+
+  // With 64 histogram bins, a budget of one megabyte allows only a few dozen of the hundreds of parameters per block.
+  EXPECT_EQ(getTransformParameters("1"), getTransformParameters("0"));
+}
+
+
+// Checks that the two-pass derivative of AdvancedNormalizedCorrelation yields the same registration result as the
+// default single-pass derivative, apart from floating point rounding.
+GTEST_TEST(itkElastixRegistrationMethod, UseTwoPassDerivative)
+{
+  static constexpr auto ImageDimension = 2U;
+  using PixelType = float;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+
+  const auto imageSize = SizeType::Filled(32);
+  const auto fixedImage = CreateImageFilledWithSequenceOfNaturalNumbers<PixelType>(imageSize);
+  const auto movingImage = CreateImage<PixelType>(imageSize);
+  FillImageRegionWithSequenceOfNaturalNumbers(*movingImage, IndexType{ { 5, 3 } }, SizeType::Filled(24));
+
+  const auto getTransformParameters = [&fixedImage, &movingImage](const std::string & useTwoPassDerivative) {
+    elx::DefaultConstruct<ElastixRegistrationMethodType<ImageType>> registration{};
+    registration.SetFixedImage(fixedImage);
+    registration.SetMovingImage(movingImage);
+    registration.SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                            { "AutomaticTransformInitialization", "false" },
+                                                            { "FinalGridSpacingInVoxels", "4" },
+                                                            { "ImageSampler", "Full" },
+                                                            { "MaximumNumberOfIterations", "4" },
+                                                            { "Metric", "AdvancedNormalizedCorrelation" },
+                                                            { "NumberOfResolutions", "1" },
+                                                            { "Optimizer", "StandardGradientDescent" },
+                                                            { "Transform", "BSplineTransform" },
+                                                            { "UseTwoPassDerivative", useTwoPassDerivative } }));
+    registration.Update();
+    return GetTransformParametersFromFilter(registration);
+  };
+
+  const auto expectedTransformParameters = getTransformParameters("false");
+  const auto actualTransformParameters = getTransformParameters("true");
+
+  ASSERT_EQ(actualTransformParameters.size(), expectedTransformParameters.size());
+  for (std::size_t i{}; i < expectedTransformParameters.size(); ++i)
+  {
+    EXPECT_NEAR(actualTransformParameters[i], expectedTransformParameters[i], 1e-6);
+  }
+}
+
+
+// Checks that sparse accumulation of the per-thread derivatives of the metrics that support it yields exactly the same
+// registration result as the default dense accumulation. The B-spline has more parameters than a single derivative
+// block, so that multiple blocks are involved.
+GTEST_TEST(itkElastixRegistrationMethod, UseSparseDerivativeAccumulation)
+{
+  static constexpr auto ImageDimension = 2U;
+  using PixelType = float;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+
+  const auto imageSize = SizeType::Filled(64);
+  const auto fixedImage = CreateImageFilledWithSequenceOfNaturalNumbers<PixelType>(imageSize);
+  const auto movingImage = CreateImage<PixelType>(imageSize);
+  FillImageRegionWithSequenceOfNaturalNumbers(*movingImage, IndexType{ { 7, 5 } }, SizeType::Filled(48));
+
+  for (const std::string metric : { "AdvancedMeanSquares", "AdvancedMattesMutualInformation" })
+  {
+    const auto getTransformParameters = [&fixedImage, &movingImage, &metric](
+                                          const std::string & useSparseDerivativeAccumulation) {
+      elx::DefaultConstruct<ElastixRegistrationMethodType<ImageType>> registration{};
+      registration.SetFixedImage(fixedImage);
+      registration.SetMovingImage(movingImage);
+      registration.SetParameterObject(
+        CreateParameterObject({ // Parameters in alphabetic order:
+                                { "AutomaticTransformInitialization", "false" },
+                                { "FinalGridSpacingInVoxels", "4" },
+                                { "ImageSampler", "Full" },
+                                { "MaximumNumberOfIterations", "4" },
+                                { "Metric", metric },
+                                { "NumberOfResolutions", "1" },
+                                { "Optimizer", "StandardGradientDescent" },
+                                { "Transform", "BSplineTransform" },
+                                { "UseSparseDerivativeAccumulation", useSparseDerivativeAccumulation } }));
+      registration.Update();
+      return GetTransformParametersFromFilter(registration);
+    };
+
+    EXPECT_EQ(getTransformParameters("true"), getTransformParameters("false")) << metric;
+  }
+}
+
+
+// Tests that AsynchronousIterationOutput "true" produces the same per-iteration output files as the default
+// (synchronous) output.
+GTEST_TEST(itkElastixRegistrationMethod, AsynchronousIterationOutput)
+{
+  static constexpr auto ImageDimension = 2U;
+  using PixelType = float;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+
+  const IndexType fixedImageRegionIndex{ { 3, 5 } };
+  const SizeType  regionSize{ { 4, 3 } };
+  const SizeType  imageSize{ { 12, 16 } };
+
+  const auto fixedImage = CreateImage<PixelType>(imageSize);
+  FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+  const auto movingImage = CreateImage<PixelType>(imageSize);
+  FillImageRegion(*movingImage, fixedImageRegionIndex + itk::Offset<ImageDimension>{ { 1, -2 } }, regionSize);
+
+  const std::string rootOutputDirectoryPath = GetCurrentBinaryDirectoryPath() + '/' + GetNameOfTest(*this);
+  itk::FileTools::CreateDirectory(rootOutputDirectoryPath);
+
+  const auto        numberOfIterations = 4u;
+  const std::string iterationFileNames[] = { "TransformParameters.0.R0.It0000000.txt",
+                                             "TransformParameters.0.R0.It0000003.txt",
+                                             "result.0.R0.It0000000.mhd",
+                                             "result.0.R0.It0000003.mhd" };
+
+  const auto readFile = [](const std::string & filePath) {
+    std::ostringstream outputStream;
+    outputStream << std::ifstream(filePath).rdbuf();
+    return outputStream.str();
+  };
+
+  const auto getIterationFileContents = [&](const std::string & asynchronousIterationOutput) {
+    const std::string outputDirectoryPath = rootOutputDirectoryPath + "/AsynchronousIterationOutput_" +
+                                            asynchronousIterationOutput;
+    itk::FileTools::CreateDirectory(outputDirectoryPath);
+
+    elx::DefaultConstruct<ElastixRegistrationMethodType<ImageType>> registration{};
+    registration.SetFixedImage(fixedImage);
+    registration.SetMovingImage(movingImage);
+    registration.SetOutputDirectory(outputDirectoryPath);
+    registration.SetParameterObject(
+      CreateParameterObject({ // Parameters in alphabetic order:
+                              { "AsynchronousIterationOutput", asynchronousIterationOutput },
+                              { "ImageSampler", "Full" },
+                              { "MaximumIterationOutputBacklog", "2" },
+                              { "MaximumNumberOfIterations", std::to_string(numberOfIterations) },
+                              { "Metric", "AdvancedNormalizedCorrelation" },
+                              { "NumberOfResolutions", "1" },
+                              { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                              { "Transform", "TranslationTransform" },
+                              { "WriteResultImageAfterEachIteration", "true" },
+                              { "WriteTransformParametersEachIteration", "true" } }));
+    registration.Update();
+
+    std::vector<std::string> fileContents;
+
+    for (const auto & fileName : iterationFileNames)
+    {
+      const std::string filePath = outputDirectoryPath + '/' + fileName;
+      EXPECT_TRUE(itksys::SystemTools::FileExists(filePath));
+
+      // The header of an MHD file refers to its own raw data file, which has the same name in both directories.
+      fileContents.push_back(readFile(filePath));
+    }
+    return fileContents;
+  };
+
+  EXPECT_EQ(getIterationFileContents("true"), getIterationFileContents("false"));
+}
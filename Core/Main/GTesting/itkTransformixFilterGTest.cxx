@@ -66,6 +66,7 @@ using ParameterMapVectorType = elx::ParameterObject::ParameterMapVectorType;
 
 // Using-declarations:
 using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::ConvertStringsToVectorOfDouble;
 using elx::CoreMainGTestUtilities::CreateImage;
 using elx::CoreMainGTestUtilities::CreateImageFilledWithSequenceOfNaturalNumbers;
 using elx::CoreMainGTestUtilities::CreateParameterObject;
@@ -366,8 +367,18 @@ Expect_Transformix_output_equals_registration_output_from_file(const testing::Te
 
   const auto parameterObject = CheckNew<elx::ParameterObject>();
 
-  parameterObject->SetParameterMap(
-    itk::ParameterFileParser::ReadParameterMap(outputDirectoryPath + "/TransformParameters.0.txt"));
+  auto transformParameterMap =
+    itk::ParameterFileParser::ReadParameterMap(outputDirectoryPath + "/TransformParameters.0.txt");
+
+  // The map is passed in memory, without the location of the parameter file, so a relative path to the binary file of
+  // the transform parameters is resolved here.
+  if (const auto found = transformParameterMap.find("TransformParametersFileName");
+      found != transformParameterMap.end())
+  {
+    found->second = { outputDirectoryPath + '/' + found->second.front() };
+  }
+
+  parameterObject->SetParameterMap(transformParameterMap);
 
   transformixFilter.SetTransformParameterObject(parameterObject);
 
@@ -1121,6 +1132,89 @@ GTEST_TEST(itkTransformixFilter, OutputEqualsRegistrationOutputForBSplineStackTr
 }
 
 
+// Tests that the transform parameters can be written to a separate binary file, instead of as text.
+GTEST_TEST(itkTransformixFilter, OutputEqualsRegistrationOutputUsingTransformParametersFile)
+{
+  using PixelType = float;
+  static constexpr auto ImageDimension = 3U;
+
+  const auto image = CreateImageFilledWithSequenceOfNaturalNumbers<PixelType, ImageDimension>({ 5, 6, 4 });
+
+  for (const std::string fileNameExtension : { "mha", "mhd" })
+  {
+    Expect_Transformix_output_equals_registration_output_from_file(
+      *this,
+      fileNameExtension,
+      *image,
+      *image,
+      ParameterMapType{ // Parameters in alphabetic order:
+                        { "AutomaticTransformInitialization", { "false" } },
+                        { "ImageSampler", { "Full" } },
+                        { "MaximumNumberOfIterations", { "2" } },
+                        { "Metric", { "VarianceOverLastDimensionMetric" } },
+                        { "Optimizer", { "AdaptiveStochasticGradientDescent" } },
+                        { "Transform", { "BSplineStackTransform" } },
+                        { "TransformParametersOutputFileNameExtension", { fileNameExtension } } });
+
+    const auto transformParameterMap = itk::ParameterFileParser::ReadParameterMap(
+      GetCurrentBinaryDirectoryPath() + '/' + GetNameOfTest(*this) + '/' + fileNameExtension +
+      "/TransformParameters.0.txt");
+    EXPECT_EQ(transformParameterMap.count("TransformParameters"), 0);
+    EXPECT_EQ(transformParameterMap.count("TransformParametersFileName"), 1);
+
+    // The binary file is referred to relative to the directory of the transform parameter file.
+    EXPECT_EQ(transformParameterMap.at("TransformParametersFileName"),
+              std::vector<std::string>{ "TransformParameters.0-Parameters." + fileNameExtension });
+  }
+}
+
+
+// Tests that the transform parameter object of the registration can pass the transform parameters to transformix in
+// numeric form, as a transform parameters payload.
+GTEST_TEST(itkTransformixFilter, OutputEqualsRegistrationOutputUsingTransformParametersPayload)
+{
+  using PixelType = float;
+  static constexpr auto ImageDimension = 3U;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+
+  const auto image = CreateImageFilledWithSequenceOfNaturalNumbers<PixelType, ImageDimension>({ 5, 6, 4 });
+
+  elx::DefaultConstruct<itk::ElastixRegistrationMethod<ImageType, ImageType>> registration;
+  registration.SetFixedImage(image);
+  registration.SetMovingImage(image);
+  registration.SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                          { "AutomaticTransformInitialization", "false" },
+                                                          { "ImageSampler", "Full" },
+                                                          { "MaximumNumberOfIterations", "2" },
+                                                          { "Metric", "VarianceOverLastDimensionMetric" },
+                                                          { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                                                          { "Transform", "BSplineStackTransform" },
+                                                          { "UseTransformParametersPayload", "true" } }));
+  registration.Update();
+
+  const auto & transformParameterObject = Deref(registration.GetTransformParameterObject());
+  const auto & transformParameterMap = transformParameterObject.GetParameterMap(0);
+  const auto & transformParametersPayload = transformParameterObject.GetTransformParametersPayload(0);
+
+  EXPECT_EQ(transformParameterMap.count("TransformParameters"), 0);
+  ASSERT_FALSE(transformParametersPayload.empty());
+  EXPECT_EQ(transformParameterMap.at("NumberOfParameters"),
+            ParameterValuesType{ std::to_string(transformParametersPayload.size()) });
+
+  // The payload is converted to "TransformParameters" when needed.
+  EXPECT_EQ(ConvertStringsToVectorOfDouble(
+              transformParameterObject.GetParameterMapsWithTransformParameters().front().at("TransformParameters")),
+            transformParametersPayload);
+
+  DefaultConstructibleTransformixFilter<ImageType> transformixFilter;
+  transformixFilter.SetMovingImage(image);
+  transformixFilter.SetTransformParameterObject(registration.GetTransformParameterObject());
+  transformixFilter.Update();
+
+  EXPECT_EQ(Deref(transformixFilter.GetOutput()), Deref(registration.GetOutput()));
+}
+
+
 // Tests setting an `itk::TranslationTransform`, to transform a simple image and a small mesh.
 GTEST_TEST(itkTransformixFilter, SetTranslationTransform)
 {
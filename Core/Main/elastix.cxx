@@ -67,7 +67,9 @@ constexpr const char * elastixHelpText =
   "  -loglevel set the log level to \"off\", \"error\", \"warning\", or \"info\" (default),\n"
   "  -priority set the process priority to high, abovenormal, normal (default),\n"
   "            belownormal, or idle (Windows only option)\n"
-  "  -threads  set the maximum number of threads of elastix\n\n"
+  "  -threads  set the maximum number of threads of elastix\n"
+  "  -profile  set to \"true\" to write a profile of the registration to the\n"
+  "            output directory (Chrome trace format)\n\n"
 
   /** The parameter file.*/
   "The parameter-file must contain all the information "
@@ -278,6 +280,7 @@ main(int argc, char ** argv)
     DataObjectContainerPointer                fixedMaskContainer = nullptr;
     DataObjectContainerPointer                movingMaskContainer = nullptr;
     ElastixMainType::FlatDirectionCosinesType fixedImageOriginalDirectionFlat;
+    elx::DerivedDataCache::Pointer            derivedDataCache = nullptr;
 
     /**
      * ********************* START REGISTRATION *********************
@@ -300,6 +303,7 @@ main(int argc, char ** argv)
       elastixMain->SetFixedMaskContainer(fixedMaskContainer);
       elastixMain->SetMovingMaskContainer(movingMaskContainer);
       elastixMain->SetOriginalFixedImageDirectionFlat(fixedImageOriginalDirectionFlat);
+      elastixMain->SetDerivedDataCache(derivedDataCache);
 
       /** Set the current elastix-level. */
       elastixMain->SetElastixLevel(i);
@@ -342,6 +346,7 @@ main(int argc, char ** argv)
       fixedMaskContainer = elastixMain->GetModifiableFixedMaskContainer();
       movingMaskContainer = elastixMain->GetModifiableMovingMaskContainer();
       fixedImageOriginalDirectionFlat = elastixMain->GetOriginalFixedImageDirectionFlat();
+      derivedDataCache = elastixMain->GetModifiableDerivedDataCache();
 
       /** Print a finish message. */
       elx::log::info(std::ostringstream{} << "Running elastix with parameter file " << i << ": \"" << parameterFileName
@@ -371,6 +376,7 @@ main(int argc, char ** argv)
     movingImageContainer = nullptr;
     fixedMaskContainer = nullptr;
     movingMaskContainer = nullptr;
+    derivedDataCache = nullptr;
 
     /** Exit and return the error code. */
     return 0;
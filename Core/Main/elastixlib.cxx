@@ -213,6 +213,7 @@ ELASTIX::RegisterImages(ImagePointer                          fixedImage,
   DataObjectContainerPointer                movingMaskContainer = nullptr;
   DataObjectContainerPointer                resultImageContainer = nullptr;
   ElastixMainType::FlatDirectionCosinesType fixedImageOriginalDirectionFlat;
+  elx::DerivedDataCache::Pointer            derivedDataCache = nullptr;
 
   /* Allocate and store masks in containers if available*/
   if (fixedMask)
@@ -251,6 +252,7 @@ ELASTIX::RegisterImages(ImagePointer                          fixedImage,
     elastixMain->SetMovingMaskContainer(movingMaskContainer);
     elastixMain->SetResultImageContainer(resultImageContainer);
     elastixMain->SetOriginalFixedImageDirectionFlat(fixedImageOriginalDirectionFlat);
+    elastixMain->SetDerivedDataCache(derivedDataCache);
 
     /** Set the current elastix-level. */
     elastixMain->SetElastixLevel(i);
@@ -286,6 +288,7 @@ ELASTIX::RegisterImages(ImagePointer                          fixedImage,
     movingMaskContainer = elastixMain->GetModifiableMovingMaskContainer();
     resultImageContainer = elastixMain->GetModifiableResultImageContainer();
     fixedImageOriginalDirectionFlat = elastixMain->GetOriginalFixedImageDirectionFlat();
+    derivedDataCache = elastixMain->GetModifiableDerivedDataCache();
 
     /** Stop timer and print it. */
     timer.Stop();
@@ -329,6 +332,7 @@ ELASTIX::RegisterImages(ImagePointer                          fixedImage,
   fixedMaskContainer = nullptr;
   movingMaskContainer = nullptr;
   resultImageContainer = nullptr;
+  derivedDataCache = nullptr;
 
   /** Exit and return the error code. */
   return 0;
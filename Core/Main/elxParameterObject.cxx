@@ -64,6 +64,7 @@ ParameterObject::SetParameterMaps(const ParameterMapVectorType & parameterMaps)
   if (m_ParameterMaps != parameterMaps)
   {
     m_ParameterMaps = parameterMaps;
+    m_TransformParametersPayloads.clear();
     this->Modified();
   }
 }
@@ -109,6 +110,81 @@ ParameterObject::GetParameterMap(const unsigned int index) const
 }
 
 
+/**
+ * ********************* SetTransformParametersPayload *********************
+ */
+
+void
+ParameterObject::SetTransformParametersPayload(const unsigned int             index,
+                                               TransformParametersPayloadType transformParametersPayload)
+{
+  // Check the index.
+  (void)GetMutableParameterMap(index);
+
+  if (index >= m_TransformParametersPayloads.size())
+  {
+    m_TransformParametersPayloads.resize(index + 1);
+  }
+  m_TransformParametersPayloads[index] = std::move(transformParametersPayload);
+  this->Modified();
+}
+
+
+/**
+ * ********************* GetTransformParametersPayload *********************
+ */
+
+const ParameterObject::TransformParametersPayloadType &
+ParameterObject::GetTransformParametersPayload(const unsigned int index) const
+{
+  // Check the index.
+  (void)GetParameterMap(index);
+
+  static const TransformParametersPayloadType emptyTransformParametersPayload{};
+  return (index < m_TransformParametersPayloads.size()) ? m_TransformParametersPayloads[index]
+                                                         : emptyTransformParametersPayload;
+}
+
+
+/**
+ * ********************* SetTransformParametersPayloads *********************
+ */
+
+void
+ParameterObject::SetTransformParametersPayloads(TransformParametersPayloadVectorType transformParametersPayloads)
+{
+  if (const auto numberOfParameterMaps = m_ParameterMaps.size();
+      transformParametersPayloads.size() > numberOfParameterMaps)
+  {
+    itkExceptionMacro("The number of transform parameters payloads (" << transformParametersPayloads.size()
+                                                                      << ") exceeds the number of parameter maps ("
+                                                                      << numberOfParameterMaps << ")");
+  }
+  m_TransformParametersPayloads = std::move(transformParametersPayloads);
+  this->Modified();
+}
+
+
+/**
+ * ********************* GetParameterMapsWithTransformParameters *********************
+ */
+
+ParameterObject::ParameterMapVectorType
+ParameterObject::GetParameterMapsWithTransformParameters() const
+{
+  ParameterMapVectorType parameterMaps = m_ParameterMaps;
+
+  for (std::size_t i = 0; i < m_TransformParametersPayloads.size(); ++i)
+  {
+    if (const auto & transformParametersPayload = m_TransformParametersPayloads[i]; !transformParametersPayload.empty())
+    {
+      parameterMaps[i]["TransformParameters"] = Conversion::ToVectorOfStrings(transformParametersPayload);
+    }
+  }
+  return parameterMaps;
+}
+
+
 /**
  * ********************* SetParameter *********************
  */
@@ -261,6 +337,7 @@ ParameterObject::ReadParameterFiles(const ParameterFileNameVectorType & paramete
   }
 
   m_ParameterMaps.clear();
+  m_TransformParametersPayloads.clear();
 
   for (const auto & parameterFileName : parameterFileNameVector)
   {
@@ -348,7 +425,7 @@ ParameterObject::WriteParameterFile(const ParameterFileNameType & parameterFileN
                          "instead, and provide a vector of filenames.");
   }
 
-  this->WriteParameterFile(m_ParameterMaps[0], parameterFileName);
+  this->WriteParameterFile(this->GetParameterMapsWithTransformParameters().front(), parameterFileName);
 }
 
 
@@ -366,7 +443,7 @@ ParameterObject::WriteParameterFiles() const
     parameterFileNameVector.push_back("ParametersFile." + std::to_string(i) + ".txt");
   }
 
-  Self::WriteParameterFiles(m_ParameterMaps, parameterFileNameVector);
+  Self::WriteParameterFiles(this->GetParameterMapsWithTransformParameters(), parameterFileNameVector);
 }
 
 
@@ -404,7 +481,7 @@ ParameterObject::WriteParameterFiles(const ParameterMapVectorType &      paramet
 void
 ParameterObject::WriteParameterFiles(const ParameterFileNameVectorType & parameterFileNameVector) const
 {
-  Self::WriteParameterFiles(m_ParameterMaps, parameterFileNameVector);
+  Self::WriteParameterFiles(this->GetParameterMapsWithTransformParameters(), parameterFileNameVector);
 }
 
 
@@ -558,6 +635,11 @@ ParameterObject::PrintSelf(std::ostream & os, itk::Indent indent) const
 
       os << ')' << std::endl;
     }
+
+    if (const auto numberOfValues = this->GetTransformParametersPayload(i).size(); numberOfValues > 0)
+    {
+      os << "  TransformParametersPayload: " << numberOfValues << " values" << std::endl;
+    }
   }
 }
 
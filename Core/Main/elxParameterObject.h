@@ -78,6 +78,32 @@ public:
     return static_cast<unsigned int>(m_ParameterMaps.size());
   }
 
+  /* Set/Get the transform parameters payload of the parameter map at the specified index: its transform parameters in
+   * numeric form, instead of as the strings of its "TransformParameters" entry. This avoids converting large numbers
+   * of transform parameters to and from strings. An empty payload means that the parameter map holds its own
+   * "TransformParameters" (if any). The payloads are cleared when all the parameter maps are replaced. */
+  using TransformParametersPayloadType = std::vector<double>;
+  using TransformParametersPayloadVectorType = std::vector<TransformParametersPayloadType>;
+
+  void
+  SetTransformParametersPayload(const unsigned int index, TransformParametersPayloadType transformParametersPayload);
+
+  const TransformParametersPayloadType &
+  GetTransformParametersPayload(const unsigned int index) const;
+
+  void
+  SetTransformParametersPayloads(TransformParametersPayloadVectorType transformParametersPayloads);
+
+  const TransformParametersPayloadVectorType &
+  GetTransformParametersPayloads() const
+  {
+    return m_TransformParametersPayloads;
+  }
+
+  /* Returns the parameter maps, with the transform parameters payloads converted to "TransformParameters" entries. */
+  ParameterMapVectorType
+  GetParameterMapsWithTransformParameters() const;
+
   void
   SetParameter(const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value);
   void
@@ -136,7 +162,8 @@ private:
   ParameterMapType &
   GetMutableParameterMap(const unsigned int index);
 
-  ParameterMapVectorType m_ParameterMaps;
+  ParameterMapVectorType               m_ParameterMaps;
+  TransformParametersPayloadVectorType m_TransformParametersPayloads;
 };
 
 } // namespace elastix
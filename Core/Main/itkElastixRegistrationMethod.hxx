@@ -86,11 +86,12 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
 
   struct RegistrationData
   {
-    DataObjectContainerPointer fixedMaskContainer{ nullptr };
-    DataObjectContainerPointer movingMaskContainer{ nullptr };
-    DataObjectContainerPointer resultImageContainer{ nullptr };
-    ElastixMainObjectPointer   transform{ nullptr };
-    FlatDirectionCosinesType   fixedImageOriginalDirectionFlat{};
+    DataObjectContainerPointer     fixedMaskContainer{ nullptr };
+    DataObjectContainerPointer     movingMaskContainer{ nullptr };
+    DataObjectContainerPointer     resultImageContainer{ nullptr };
+    ElastixMainObjectPointer       transform{ nullptr };
+    FlatDirectionCosinesType       fixedImageOriginalDirectionFlat{};
+    elx::DerivedDataCache::Pointer derivedDataCache{ nullptr };
   };
 
   RegistrationData registrationData{};
@@ -241,6 +242,11 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
 
   ParameterMapVectorType transformParameterMapVector = getInitialTransformParameterMaps();
 
+  // The transform parameters in numeric form that go with transformParameterMapVector, if any.
+  std::vector<std::vector<double>> transformParametersPayloads =
+    m_InitialTransformParameterObject ? m_InitialTransformParameterObject->GetTransformParametersPayloads()
+                                      : std::vector<std::vector<double>>{};
+
   if (!transformParameterMapVector.empty() && !m_OutputDirectory.empty())
   {
     std::string initialTransformParameterFileName = "NoInitialTransform";
@@ -261,6 +267,12 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
     {
       transformParameterMap["InitialTransformParameterFileName"] = { initialTransformParameterFileName };
 
+      if (i < transformParametersPayloads.size() && !transformParametersPayloads[i].empty())
+      {
+        transformParameterMap["TransformParameters"] =
+          elx::Conversion::ToVectorOfStrings(transformParametersPayloads[i]);
+      }
+
       if (const auto transformFound = transformParameterMap.find("Transform");
           transformFound != transformParameterMap.end() &&
           transformFound->second == ParameterValueVectorType{ "ExternalTransform" })
@@ -369,6 +381,12 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
     elastixMain->SetMovingPoints(m_MovingPoints);
     elastixMain->SetResultImageContainer(registrationData.resultImageContainer);
     elastixMain->SetOriginalFixedImageDirectionFlat(registrationData.fixedImageOriginalDirectionFlat);
+    elastixMain->SetDerivedDataCache(registrationData.derivedDataCache);
+
+    if (i == 0)
+    {
+      elastixMain->SetTransformParametersPayloads(transformParametersPayloads);
+    }
 
     // Start registration
     unsigned int isError = 0;
@@ -394,9 +412,12 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
                          elastixMain->GetMovingMaskContainer(),
                          elastixMain->GetResultImageContainer(),
                          elastixMain->GetFinalTransform(),
-                         elastixMain->GetOriginalFixedImageDirectionFlat() };
+                         elastixMain->GetOriginalFixedImageDirectionFlat(),
+                         elastixMain->GetModifiableDerivedDataCache() };
 
     transformParameterMapVector.push_back(elastixMain->GetTransformParameterMap());
+    transformParametersPayloads.resize(transformParameterMapVector.size());
+    transformParametersPayloads.back() = elastixMain->GetTransformParametersPayload();
 
     // TODO: Fix elastix corrupting default pixel value parameter
     transformParameterMapVector.back()["DefaultPixelValue"] = parameterMap["DefaultPixelValue"];
@@ -426,6 +447,7 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
   // Save parameter map
   auto transformParameterObject = elx::ParameterObject::New();
   transformParameterObject->SetParameterMaps(transformParameterMapVector);
+  transformParameterObject->SetTransformParametersPayloads(std::move(transformParametersPayloads));
   this->SetNthOutput(1, transformParameterObject);
 }
 
@@ -259,6 +259,13 @@ TransformixFilter<TImage>::GenerateData()
     SetParameterValueAndWarnOnOverride(transformParameterMap, "ResultImagePixelType", movingImagePixelTypeString);
   }
 
+  // Pass the transform parameters that are stored in numeric form, unless the parameter maps were replaced by a
+  // specified transform.
+  if (!m_Transform && !m_ExternalTransform)
+  {
+    transformixMain->SetTransformParametersPayloads(transformParameterObject->GetTransformParametersPayloads());
+  }
+
   // Run transformix
   unsigned int isError = 0;
   try
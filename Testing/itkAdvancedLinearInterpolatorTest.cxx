@@ -32,6 +32,7 @@
 #include "elxDefaultConstruct.h"
 
 #include <cmath> // For abs.
+#include <vector>
 
 //-------------------------------------------------------------------------------------
 
@@ -113,9 +114,12 @@ TestInterpolators()
   /** Create and setup interpolators. */
   auto linear = LinearInterpolatorType::New();
   auto linearA = AdvancedLinearInterpolatorType::New();
+  auto linearB = AdvancedLinearInterpolatorType::New();
   auto bspline = BSplineInterpolatorType::New();
   linear->SetInputImage(image);
   linearA->SetInputImage(image);
+  linearB->SetUseBrickedLayout(true);
+  linearB->SetInputImage(image);
   bspline->SetSplineOrder(1); // prior to SetInputImage()
   bspline->SetInputImage(image);
 
@@ -159,13 +163,14 @@ TestInterpolators()
   }
 
   /** Compare results. */
-  OutputType          valueLinA, valueBSpline, valueBSpline2;
-  CovariantVectorType derivLinA, derivBSpline, derivBSpline2;
+  OutputType          valueLinA, valueLinB, valueBSpline, valueBSpline2;
+  CovariantVectorType derivLinA, derivLinB, derivBSpline, derivBSpline2;
   for (unsigned int i = 0; i < count; ++i)
   {
     ContinuousIndexType cindex(&darray1[i][0]);
 
     linearA->EvaluateValueAndDerivativeAtContinuousIndex(cindex, valueLinA, derivLinA);
+    linearB->EvaluateValueAndDerivativeAtContinuousIndex(cindex, valueLinB, derivLinB);
     valueBSpline = bspline->EvaluateAtContinuousIndex(cindex);
     derivBSpline = bspline->EvaluateDerivativeAtContinuousIndex(cindex);
     bspline->EvaluateValueAndDerivativeAtContinuousIndex(cindex, valueBSpline2, derivBSpline2);
@@ -184,6 +189,13 @@ TestInterpolators()
     std::cout << "B-spline: " << valueBSpline << "   " << derivBSpline << std::endl;
     std::cout << "B-spline: " << valueBSpline2 << "   " << derivBSpline2 << "\n" << std::endl;
 
+    if (valueLinA != valueLinB || derivLinA != derivLinB)
+    {
+      std::cerr << "ERROR: there is a difference between the advanced linear interpolator with and without bricked "
+                   "layout."
+                << std::endl;
+      return false;
+    }
     if (std::abs(valueLinA - valueBSpline) > 1.0e-3)
     {
       std::cerr << "ERROR: there is a difference in the interpolated value, between the linear and the 1st-order "
@@ -268,6 +280,51 @@ TestInterpolators()
   }
   timer.Stop();
   std::cout << "B-spline (v&d)  : " << 1.0e3 * timer.GetMean() / static_cast<double>(runs) << " ms" << std::endl;
+
+  /** Compare the row-major and the bricked layout, at randomly scattered positions in a large image, for which the
+   * memory access (cache misses) dominates the run time. */
+  auto largeImage = InputImageType::New();
+  largeImage->SetRegions(SizeType::Filled(Dimension == 2 ? 4096 : 256));
+  largeImage->Allocate();
+  for (IteratorType largeIt(largeImage, largeImage->GetBufferedRegion()); !largeIt.IsAtEnd(); ++largeIt)
+  {
+    largeIt.Set(randomVariateGenerator.GetUniformVariate(0, 255));
+  }
+
+  std::vector<ContinuousIndexType> scatteredIndices(runs);
+  for (auto & scatteredIndex : scatteredIndices)
+  {
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      scatteredIndex[j] = randomVariateGenerator.GetUniformVariate(0.0, largeImage->GetBufferedRegion().GetSize(j) - 1);
+    }
+  }
+
+  for (const bool useBrickedLayout : { false, true })
+  {
+    auto linearL = AdvancedLinearInterpolatorType::New();
+    linearL->SetUseBrickedLayout(useBrickedLayout);
+
+    /** With the bricked layout, SetInputImage copies the pixels into the bricks. */
+    timer.Reset();
+    timer.Start();
+    linearL->SetInputImage(largeImage);
+    timer.Stop();
+    const double setInputImageTime = timer.GetMean();
+
+    OutputType valueSum{};
+    timer.Reset();
+    timer.Start();
+    for (const auto & scatteredIndex : scatteredIndices)
+    {
+      linearL->EvaluateValueAndDerivativeAtContinuousIndex(scatteredIndex, value, deriv);
+      valueSum += value;
+    }
+    timer.Stop();
+    std::cout << (useBrickedLayout ? "linearA bricked, scattered (v&d)   : " : "linearA row-major, scattered (v&d) : ")
+              << 1.0e6 * timer.GetMean() / static_cast<double>(runs) << " us (sum " << valueSum << "), "
+              << 1.0e3 * setInputImageTime << " ms for SetInputImage" << std::endl;
+  }
 #endif
 
   return true;
@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+/** \file
+ \brief Compare the advanced ray cast interpolator with and without empty space skipping.
+ */
+
+#include "itkAdvancedRayCastInterpolateImageFunction.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTranslationTransform.h"
+
+#include <iostream>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+
+int
+main()
+{
+  constexpr unsigned int Dimension = 3;
+
+  using InputImageType = itk::Image<short, Dimension>;
+  using InterpolatorType = itk::AdvancedRayCastInterpolateImageFunction<InputImageType>;
+  using TransformType = itk::TranslationTransform<double, Dimension>;
+  using PointType = InterpolatorType::PointType;
+  using IteratorType = itk::ImageRegionIteratorWithIndex<InputImageType>;
+  using RandomNumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+
+  /** Create a volume of "air", with a ball of random values in its centre, like a CT scan of a small object. */
+  constexpr unsigned int imageSize = 128;
+  auto                   image = InputImageType::New();
+  image->SetRegions(InputImageType::SizeType::Filled(imageSize));
+  image->Allocate();
+
+  auto randomVariateGenerator = RandomNumberGeneratorType::GetInstance();
+  randomVariateGenerator->SetSeed(5489);
+
+  constexpr double centre = 0.5 * (imageSize - 1);
+  constexpr double radius = 0.25 * imageSize;
+  for (IteratorType it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      squaredDistance += (it.GetIndex()[i] - centre) * (it.GetIndex()[i] - centre);
+    }
+    it.Set(squaredDistance < radius * radius ? static_cast<short>(randomVariateGenerator->GetUniformVariate(-100, 1000))
+                                             : -1000);
+  }
+
+  /** The rays start on a plane in front of the volume, and converge to a focal point behind it. */
+  constexpr unsigned int numberOfRaysPerDimension = 96;
+  std::vector<PointType> rayStartPoints;
+  rayStartPoints.reserve(numberOfRaysPerDimension * numberOfRaysPerDimension);
+  for (unsigned int y = 0; y < numberOfRaysPerDimension; ++y)
+  {
+    for (unsigned int x = 0; x < numberOfRaysPerDimension; ++x)
+    {
+      const double step = (imageSize - 1.0) / (numberOfRaysPerDimension - 1);
+      rayStartPoints.push_back(itk::MakePoint(x * step, y * step, 4.0 * imageSize));
+    }
+  }
+
+  itk::TimeProbe      timer;
+  std::vector<double> integrals[2];
+
+  for (const bool useEmptySpaceSkipping : { false, true })
+  {
+    auto interpolator = InterpolatorType::New();
+    interpolator->SetUseEmptySpaceSkipping(useEmptySpaceSkipping);
+    interpolator->SetTransform(TransformType::New());
+    interpolator->SetFocalPoint(itk::MakePoint(centre, centre, -4.0 * imageSize));
+    interpolator->SetThreshold(0.0);
+
+    /** Time the computation of the empty space map, when it is used. */
+    timer.Reset();
+    timer.Start();
+    interpolator->SetInputImage(image);
+    timer.Stop();
+    const double setInputImageTime = timer.GetMean();
+
+    auto & integralsOfThisRun = integrals[useEmptySpaceSkipping];
+    integralsOfThisRun.reserve(rayStartPoints.size());
+
+    timer.Reset();
+    timer.Start();
+    for (const auto & rayStartPoint : rayStartPoints)
+    {
+      integralsOfThisRun.push_back(interpolator->Evaluate(rayStartPoint));
+    }
+    timer.Stop();
+
+#ifdef NDEBUG
+    std::cout << (useEmptySpaceSkipping ? "with empty space skipping    : " : "without empty space skipping : ")
+              << 1.0e6 * timer.GetMean() / static_cast<double>(rayStartPoints.size()) << " us per ray, "
+              << 1.0e3 * setInputImageTime << " ms for SetInputImage" << std::endl;
+#else
+    (void)setInputImageTime;
+#endif
+  }
+
+  /** Skipping the empty space should not change the integrals at all. */
+  if (integrals[0] != integrals[1])
+  {
+    std::cerr << "ERROR: empty space skipping changes the ray integrals!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Sanity check: some of the rays pass through the ball. */
+  bool anyNonZeroIntegral = false;
+  for (const double integral : integrals[0])
+  {
+    anyNonZeroIntegral = anyNonZeroIntegral || (integral != 0.0);
+  }
+  if (!anyNonZeroIntegral)
+  {
+    std::cerr << "ERROR: none of the rays passes through the ball!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main
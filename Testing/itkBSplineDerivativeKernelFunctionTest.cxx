@@ -17,11 +17,92 @@
  *=========================================================================*/
 #include "itkBSplineDerivativeKernelFunction.h"
 #include "itkBSplineDerivativeKernelFunction2.h"
+#include "itkBSplineInterpolationDerivativeWeightFunction.h"
 #include "itkKernelFunctionBase.h"
 
+#include <cmath>
 #include <ctime>
 #include <iomanip>
 
+//-------------------------------------------------------------------------------------
+// This function compares the derivative weights at the entire support, as computed at once
+// by a 1D BSplineInterpolationDerivativeWeightFunction, with the ITK derivative kernel,
+// evaluated at each of the support points separately. Both are also timed.
+
+template <unsigned int VSplineOrder>
+bool
+TestDerivativeWeightsAtEntireSupport(const unsigned int N, const double maxAllowedDistance)
+{
+  using KernelType_ITK = itk::BSplineDerivativeKernelFunction<VSplineOrder>;
+  using WeightFunctionType = itk::BSplineInterpolationDerivativeWeightFunction<double, 1, VSplineOrder>;
+  using ContinuousIndexType = typename WeightFunctionType::ContinuousIndexType;
+  using IndexType = typename WeightFunctionType::IndexType;
+
+  std::cerr << "Evaluating the entire support for spline order " << VSplineOrder << std::endl;
+
+  const auto kernel_ITK = KernelType_ITK::New();
+  const auto weightFunction = WeightFunctionType::New();
+
+  /** Create the evaluation points, including the knots of all spline orders. */
+  std::vector<ContinuousIndexType> cindices;
+  for (unsigned int j = 0; j <= 16; ++j)
+  {
+    cindices.push_back(itk::MakeFilled<ContinuousIndexType>(-1.0 + 0.125 * j));
+  }
+  cindices.push_back(itk::MakeFilled<ContinuousIndexType>(0.3));
+  cindices.push_back(itk::MakeFilled<ContinuousIndexType>(-0.7));
+
+  /** Time the ITK kernel, evaluated at each of the support points. */
+  clock_t startClock = clock();
+  for (const auto & cindex : cindices)
+  {
+    const IndexType startIndex = WeightFunctionType::ComputeStartIndex(cindex);
+    for (unsigned int i = 0; i < N; ++i)
+    {
+      double u = cindex[0] - static_cast<double>(startIndex[0]);
+      for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
+      {
+        kernel_ITK->Evaluate(u);
+        u -= 1.0;
+      }
+    }
+  }
+  std::cerr << "ITK per support point: " << (clock() - startClock) * 1000.0 / CLOCKS_PER_SEC << " ms" << std::endl;
+
+  /** Time the weight function, which evaluates the entire support at once. */
+  startClock = clock();
+  for (const auto & cindex : cindices)
+  {
+    const IndexType startIndex = WeightFunctionType::ComputeStartIndex(cindex);
+    for (unsigned int i = 0; i < N; ++i)
+    {
+      weightFunction->Evaluate(cindex, startIndex);
+    }
+  }
+  std::cerr << "elastix entire support: " << (clock() - startClock) * 1000.0 / CLOCKS_PER_SEC << " ms" << std::endl;
+
+  /** Compare the results. */
+  for (const auto & cindex : cindices)
+  {
+    const IndexType startIndex = WeightFunctionType::ComputeStartIndex(cindex);
+    const auto      weights = weightFunction->Evaluate(cindex, startIndex);
+    double          u = cindex[0] - static_cast<double>(startIndex[0]);
+    for (unsigned int k = 0; k < VSplineOrder + 1; ++k)
+    {
+      if (std::abs(weights[k] - kernel_ITK->Evaluate(u)) > maxAllowedDistance)
+      {
+        std::cerr << "ERROR: the weights at the entire support differ from ITK at " << cindex[0] << "." << std::endl;
+        return false;
+      }
+      u -= 1.0;
+    }
+  }
+  std::cerr << "The results are good.\n" << std::endl;
+  return true;
+
+} // end TestDerivativeWeightsAtEntireSupport()
+
+
 //-------------------------------------------------------------------------------------
 
 int
@@ -148,6 +229,15 @@ main()
 
   } // end for all spline orders
 
+  /** Compare the evaluation at the entire support with the evaluation per support point. */
+  N /= 10;
+  if (!TestDerivativeWeightsAtEntireSupport<1>(N, maxAllowedDistance) ||
+      !TestDerivativeWeightsAtEntireSupport<2>(N, maxAllowedDistance) ||
+      !TestDerivativeWeightsAtEntireSupport<3>(N, maxAllowedDistance))
+  {
+    return 1;
+  }
+
   /** Return a value. */
   return 0;
 
@@ -17,9 +17,14 @@
  *=========================================================================*/
 #include "itkBSplineInterpolationWeightFunction.h"
 #include "itkBSplineInterpolationWeightFunction2.h"
+#include "itkBSplineInterpolationDerivativeWeightFunction.h"
+#include "itkBSplineInterpolationSecondOrderDerivativeWeightFunction.h"
+#include "itkBSplineDerivativeKernelFunction.h"
+#include "itkBSplineSecondOrderDerivativeKernelFunction2.h"
 
 #include <ctime>
 #include <iomanip>
+#include <utility> // For pair.
 
 #include <itkMath.h>
 
@@ -27,6 +32,9 @@
 // This test tests the itkBSplineInterpolationWeightFunction2 and compares
 // it with the ITK implementation. It should give equal results and comparable
 // performance. The test is performed in 2D and 3D, with spline order 3.
+// The 3D first and second order derivative weight functions, which evaluate the
+// kernels at the entire support at once, are compared and timed against an
+// evaluation of the kernels at each support point separately.
 // Also the PrintSelf()-functions are called.
 
 int
@@ -227,6 +235,126 @@ main()
 #endif
   }
 
+  /**
+   * *********** 3D DERIVATIVE TESTING ************************************
+   */
+
+  std::cerr << "\n--------------------------------------------------------";
+  std::cerr << "\n3D DERIVATIVE TESTING:\n" << std::endl;
+
+  using DerivativeWeightFunctionType3D =
+    itk::BSplineInterpolationDerivativeWeightFunction<CoordinateRepresentationType, 3, SplineOrder>;
+  using SODerivativeWeightFunctionType3D =
+    itk::BSplineInterpolationSecondOrderDerivativeWeightFunction<CoordinateRepresentationType, 3, SplineOrder>;
+  using KernelType = itk::BSplineKernelFunction2<SplineOrder>;
+  using DerivativeKernelType = itk::BSplineDerivativeKernelFunction<SplineOrder>;
+  using SODerivativeKernelType = itk::BSplineSecondOrderDerivativeKernelFunction2<SplineOrder>;
+
+  /** Construct the derivative weight functions, differentiating twice with respect to x, and once to y and z. */
+  auto derivativeWeightFunction3D = DerivativeWeightFunctionType3D::New();
+  auto soDerivativeWeightFunction3D = SODerivativeWeightFunctionType3D::New();
+  derivativeWeightFunction3D->SetDerivativeDirection(0);
+  soDerivativeWeightFunction3D->SetDerivativeDirections(1, 2);
+  auto soEqualDerivativeWeightFunction3D = SODerivativeWeightFunctionType3D::New();
+  soEqualDerivativeWeightFunction3D->SetDerivativeDirections(0, 0);
+
+  /** Compute the reference weights by evaluating the kernels at each support point separately. */
+  const auto computeReferenceWeights = [&cindex3D](const unsigned int numberOfDerivativesX,
+                                                   const unsigned int numberOfDerivativesY,
+                                                   const unsigned int numberOfDerivativesZ) {
+    const unsigned int numberOfDerivatives[] = { numberOfDerivativesX, numberOfDerivativesY, numberOfDerivativesZ };
+    const auto         startIndex = DerivativeWeightFunctionType3D::ComputeStartIndex(cindex3D);
+
+    double weights1D[3][SplineOrder + 1];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      double x = cindex3D[i] - static_cast<double>(startIndex[i]);
+      for (unsigned int k = 0; k < SplineOrder + 1; ++k)
+      {
+        weights1D[i][k] = (numberOfDerivatives[i] == 0)   ? KernelType::FastEvaluate(x)
+                          : (numberOfDerivatives[i] == 1) ? DerivativeKernelType::FastEvaluate(x)
+                                                          : SODerivativeKernelType::FastEvaluate(x);
+        x -= 1.0;
+      }
+    }
+
+    WeightsType3D weights;
+    for (unsigned int n = 0; n < WeightsType3D::Length; ++n)
+    {
+      weights[n] = weights1D[0][n % (SplineOrder + 1)] * weights1D[1][(n / (SplineOrder + 1)) % (SplineOrder + 1)] *
+                   weights1D[2][n / ((SplineOrder + 1) * (SplineOrder + 1))];
+    }
+    return weights;
+  };
+
+  /** Compare the derivative weight functions with the reference weights. */
+  const std::pair<WeightsType3D, WeightsType3D> derivativeWeightsPairs[] = {
+    { derivativeWeightFunction3D->Evaluate(cindex3D), computeReferenceWeights(1, 0, 0) },
+    { soDerivativeWeightFunction3D->Evaluate(cindex3D), computeReferenceWeights(0, 1, 1) },
+    { soEqualDerivativeWeightFunction3D->Evaluate(cindex3D), computeReferenceWeights(2, 0, 0) }
+  };
+  for (const auto & derivativeWeightsPair : derivativeWeightsPairs)
+  {
+    error = 0.0;
+    for (unsigned int i = 0; i < WeightsType3D::Length; ++i)
+    {
+      error += vnl_math::sqr(derivativeWeightsPair.first[i] - derivativeWeightsPair.second[i]);
+    }
+    error = std::sqrt(error);
+    if (error > distance)
+    {
+      std::cerr << "ERROR: the derivative weights differ from the reference with more than " << distance << "."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::cerr << std::scientific;
+  std::cerr << std::setprecision(4);
+  std::cerr << "The derivative weights are equal to the reference." << std::endl;
+
+  /** Time the reference, and the derivative weight functions. */
+  startClock = clock();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    computeReferenceWeights(2, 0, 0);
+  }
+  endClock = clock();
+  const clock_t clockReference = endClock - startClock;
+  std::cerr << "The elapsed time for the reference implementation is: " << clockReference << std::endl;
+
+  startClock = clock();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    derivativeWeightFunction3D->Evaluate(cindex3D);
+  }
+  endClock = clock();
+  std::cerr << "The elapsed time for the derivative weight function is: " << endClock - startClock << std::endl;
+
+  startClock = clock();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    soEqualDerivativeWeightFunction3D->Evaluate(cindex3D);
+  }
+  endClock = clock();
+  clockOur = endClock - startClock;
+  std::cerr << "The elapsed time for the second order derivative weight function is: " << clockOur << std::endl;
+
+  /** TEST: Compare the two performance wise. */
+  timeDifference = static_cast<double>(clockReference) / static_cast<double>(clockOur);
+  std::cerr << std::fixed;
+  std::cerr << std::setprecision(1);
+  std::cerr << "The time difference is " << (timeDifference - 1.0) * 100.0 << "% in favor of "
+            << (timeDifference > 1.0 ? "our " : "the reference ") << "implementation." << std::endl;
+  if (timeDifference < (1.0 - allowedTimeDifference))
+  {
+    std::cerr << "ERROR: the reference implementation is more than "
+              << static_cast<unsigned int>(allowedTimeDifference * 100.0) << "% faster than our implementation."
+              << std::endl;
+#if _ELASTIX_TEST_TIMING
+    return EXIT_FAILURE;
+#endif
+  }
+
   /**
    * *********** Function TESTING ****************************************
    */
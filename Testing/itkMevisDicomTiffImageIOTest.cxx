@@ -32,7 +32,8 @@
 //-------------------------------------------------------------------------------------
 // This test tests the itkMevisDicomTiffImageIO library. The test is performed
 // in 2D, 3D, and 4D, for a unsigned char image. An artificial image is generated,
-// written to disk, read from disk, and compared to the original.
+// written to disk, read from disk, and compared to the original. Finally, a
+// region of the image is read (streaming), and compared to the original.
 
 template <unsigned int Dimension>
 int
@@ -206,6 +207,44 @@ testMevis()
     return 1;
   }
 
+  /** Read only a region of the image, which crosses the tile boundaries, and compare it to the original. */
+  typename ImageType::RegionType requestedRegion;
+  for (unsigned int i = 0; i < Dimension; ++i)
+  {
+    requestedRegion.SetIndex(i, 5);
+    requestedRegion.SetSize(i, 14);
+  }
+
+  auto streamingReader = ReaderType::New();
+  streamingReader->SetFileName(testfile);
+  try
+  {
+    streamingReader->UpdateOutputInformation();
+    streamingReader->GetOutput()->SetRequestedRegion(requestedRegion);
+    streamingReader->Update();
+  }
+  catch (const itk::ExceptionObject & err)
+  {
+    std::cerr << "ERROR: Reading a region of mevis dicomtiff failed." << std::endl;
+    std::cerr << err << std::endl;
+    return 1;
+  }
+
+  typename ImageType::Pointer streamedImage = streamingReader->GetOutput();
+  if (streamedImage->GetBufferedRegion() != requestedRegion)
+  {
+    std::cerr << "ERROR: the buffered region is not the requested region" << std::endl;
+    return 1;
+  }
+  for (IteratorType it(streamedImage, requestedRegion); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != inputImage->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "ERROR: the pixel values are not correct after reading a region" << std::endl;
+      return 1;
+    }
+  }
+
   return 0;
 
 } // end templated function
@@ -16,12 +16,15 @@
  *
  *=========================================================================*/
 #include "SplineKernelTransform/itkThinPlateSplineKernelTransform2.h"
+#include "SplineKernelTransform/itkSymmetricLDLTDecomposition.h"
 #include "itkTransformixInputPointFileReader.h"
 
 // Report timings
 #include "itkTimeProbe.h"
 #include "itkTimeProbesCollectorBase.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
 
@@ -185,7 +188,7 @@ main(int argc, char * argv[])
      * 2) Compute inverse of L
      */
 
-    LMatrixType lMatrixInverse1, lMatrixInverse2; //, lMatrixInverse4;
+    LMatrixType lMatrixInverse1, lMatrixInverse2, lMatrixInverse3; //, lMatrixInverse4;
 
     /** Task 1: compute L. */
     timeCollector.Start("ComputeL");
@@ -212,12 +215,25 @@ main(int argc, char * argv[])
     lMatrixInverse2 = vnl_qr<ScalarType>(lMatrix).inverse();
     timeCollector.Stop("ComputeLInverseByQR");
 
-    // Method 3: Cholesky decomposition
+    // Method 3: symmetric indefinite LDLT decomposition
+    timeCollector.Start("ComputeLInverseByLDLT");
+    lMatrixInverse3 = itk::SymmetricLDLTDecomposition<ScalarType>(lMatrix).GetInverse();
+    timeCollector.Stop("ComputeLInverseByLDLT");
+
+    const double diff_ldlt = (lMatrixInverse2 - lMatrixInverse3).frobenius_norm();
+    std::cerr << "Frobenius difference of method 3 with QR: " << diff_ldlt << std::endl;
+    if (diff_ldlt > tolerance)
+    {
+      std::cerr << "ERROR: Frobenius difference of LDLT matrix inversion too big: " << diff_ldlt << std::endl;
+      return 1;
+    }
+
+    // Method 4: Cholesky decomposition
     // Cholesky decomposition does not work due to lMatrix not being positive definite.
     //   startClock = clock();
     //   LMatrixType lMatrixInverse3 = vnl_cholesky( lMatrix,
     //     vnl_cholesky::Operation::estimate_condition ).inverse();
-    //   std::cerr << "L matrix inversion (method 3, cholesky ) took: "
+    //   std::cerr << "L matrix inversion (method 4, cholesky ) took: "
     //     << clock() - startClock << " ms." << std::endl;
 
     /** The following code is out-commented.
@@ -243,11 +259,11 @@ main(int argc, char * argv[])
     //     std::cerr << "Conversion to sparse matrix took: "
     //       << clock() - startClock << " ms." << std::endl;
     //
-    //     // Method 4: LU Decomposition
+    //     // Method 5: LU Decomposition
     //     // Depends on local ITK vnl_sparse_lu modification
     //     startClock = clock();
     //     lMatrixInverse4 = vnl_sparse_lu( lSparseMatrix ).inverse();
-    //     std::cerr << "L matrix inversion (method 4,  lu) took: "
+    //     std::cerr << "L matrix inversion (method 5,  lu) took: "
     //       << clock() - startClock << " ms." << std::endl;
 
     /** Compute error compared to SVD. */
@@ -257,7 +273,7 @@ main(int argc, char * argv[])
       // double diff_lu = (lMatrixInverse1a - lMatrixInverse4).frobenius_norm();
 
       std::cerr << "Frobenius difference of method 2 with SVD: " << diff_qr << std::endl;
-      // std::cerr << "Frobenius difference of method 4 with SVD: " << diff_lu << std::endl;
+      // std::cerr << "Frobenius difference of method 5 with SVD: " << diff_lu << std::endl;
 
       if (diff_qr > tolerance)
       {
@@ -267,7 +283,7 @@ main(int argc, char * argv[])
     }
     else
     {
-      std::cerr << "Frobenius difference of method 2,4 with SVD: unknown" << std::endl;
+      std::cerr << "Frobenius difference of method 2,5 with SVD: unknown" << std::endl;
     }
 
     //   startClock = clock();
@@ -349,6 +365,99 @@ main(int argc, char * argv[])
       return 1;
     }
 
+    //
+    // Test TransformPoint performance, exact versus approximated by a grid
+
+    /** Target landmarks: the source landmarks with a smooth displacement. */
+    auto targetLandmarkPoints = PointsContainerType::New();
+    auto targetLandmarks = PointSetType::New();
+    PointType minimum;
+    PointType maximum;
+    minimum.Fill(itk::NumericTraits<ScalarType>::max());
+    maximum.Fill(itk::NumericTraits<ScalarType>::NonpositiveMin());
+    for (unsigned long j = 0; j < numberOfLandmarks; ++j)
+    {
+      PointType landmark = usedLandmarkPoints->ElementAt(j);
+      for (unsigned int dim = 0; dim < Dimension; ++dim)
+      {
+        minimum[dim] = std::min(minimum[dim], landmark[dim]);
+        maximum[dim] = std::max(maximum[dim], landmark[dim]);
+      }
+      landmark[0] += 2.0 * std::sin(0.1 * landmark[1]);
+      landmark[1] += 2.0 * std::cos(0.1 * landmark[2]);
+      targetLandmarkPoints->push_back(landmark);
+    }
+    targetLandmarks->SetPoints(targetLandmarkPoints);
+    kernelTransform->SetSourceLandmarks(dummyLandmarks);
+    kernelTransform->SetMatrixInversionMethod("LDLT");
+    kernelTransform->SetSourceLandmarks(usedLandmarks);
+    kernelTransform->SetTargetLandmarks(targetLandmarks);
+
+    /** The points to transform: a regular grid over the bounding box of the landmarks. */
+    const unsigned int     numberOfPointsPerDimension = 40;
+    std::vector<PointType> points;
+    for (unsigned int k = 0; k < numberOfPointsPerDimension; ++k)
+    {
+      for (unsigned int j = 0; j < numberOfPointsPerDimension; ++j)
+      {
+        for (unsigned int i = 0; i < numberOfPointsPerDimension; ++i)
+        {
+          const unsigned int gridIndex[] = { i, j, k };
+          PointType          point;
+          for (unsigned int dim = 0; dim < Dimension; ++dim)
+          {
+            point[dim] =
+              minimum[dim] + (maximum[dim] - minimum[dim]) * gridIndex[dim] / (numberOfPointsPerDimension - 1);
+          }
+          points.push_back(point);
+        }
+      }
+    }
+
+    std::vector<PointType> exactPoints(points.size());
+    timeCollector.Start("TransformPointExact");
+    std::transform(points.cbegin(), points.cend(), exactPoints.begin(), [&kernelTransform](const PointType & point) {
+      return kernelTransform->TransformPoint(point);
+    });
+    timeCollector.Stop("TransformPointExact");
+
+    const double approximationTolerance = 0.01;
+    timeCollector.Start("UpdateDeformationApproximation");
+    const bool approximated =
+      kernelTransform->UpdateDeformationApproximation(minimum, maximum, 8.0, approximationTolerance, points.size());
+    timeCollector.Stop("UpdateDeformationApproximation");
+
+    if (approximated)
+    {
+      std::vector<PointType> approximatedPoints(points.size());
+      timeCollector.Start("TransformPointApproximated");
+      std::transform(
+        points.cbegin(), points.cend(), approximatedPoints.begin(), [&kernelTransform](const PointType & point) {
+          return kernelTransform->TransformPoint(point);
+        });
+      timeCollector.Stop("TransformPointApproximated");
+
+      // The tolerance is only checked at the cell centres of the approximation grid, so allow a wide margin.
+      double maximumError = 0.0;
+      for (std::size_t j = 0; j < points.size(); ++j)
+      {
+        maximumError = std::max(maximumError, exactPoints[j].EuclideanDistanceTo(approximatedPoints[j]));
+      }
+      std::cerr << "Maximum error of the approximated TransformPoint: " << maximumError << std::endl;
+      if (maximumError > 10.0 * approximationTolerance)
+      {
+        std::cerr << "ERROR: The error of the approximated TransformPoint is too big: " << maximumError << std::endl;
+        return 1;
+      }
+    }
+    else
+    {
+      std::cerr << "The deformation could not be approximated by a grid smaller than the number of points."
+                << std::endl;
+    }
+    kernelTransform->ClearDeformationApproximation();
+    kernelTransform->SetMatrixInversionMethod("SVD");
+
     // Report timings
     timeCollector.Report();
     std::cout << std::endl;